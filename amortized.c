@@ -0,0 +1,180 @@
+#include "amortized.h"
+#include "nonce.h"
+#include "transcript.h"
+#include <stdlib.h>
+#include <string.h>
+
+size_t
+csigma_amortized_proof_size(const linear_relation_t* relation)
+{
+    const linear_map_t* map = &relation->map;
+
+    if (map->num_constraints == 0 || linear_relation_validate(relation) != 0)
+        return 0;
+    return map->num_constraints * CSIGMA_POINT_BYTES + map->num_scalars * CSIGMA_SCALAR_BYTES;
+}
+
+// Start a proof transcript: the shared map and every image (internal)
+static void
+start_transcript(csigma_transcript_t* transcript, const linear_relation_t* relation,
+                 const uint8_t* images, size_t k)
+{
+    csigma_transcript_init(transcript, "amortized");
+    csigma_transcript_absorb_map(transcript, &relation->map);
+    csigma_transcript_absorb_u64(transcript, k);
+    csigma_transcript_absorb(transcript, images,
+                             k * relation->map.num_constraints * CSIGMA_POINT_BYTES);
+}
+
+// Fiat-Shamir challenge over a started transcript, the commitment and the message
+// (internal)
+static void
+generate_challenge(uint8_t challenge[CSIGMA_SCALAR_BYTES], csigma_transcript_t* transcript,
+                   const linear_relation_t* relation, const uint8_t* commitment,
+                   const uint8_t* message, size_t message_len)
+{
+    csigma_transcript_absorb(transcript, commitment,
+                             relation->map.num_constraints * CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb(transcript, message, message ? message_len : 0);
+    csigma_transcript_challenge(transcript, challenge);
+}
+
+int
+csigma_amortized_prove(uint8_t* proof, const linear_relation_t* relation,
+                       const uint8_t* images, const uint8_t* witnesses, size_t k,
+                       const uint8_t* message, size_t message_len)
+{
+    if (!proof || !images || !witnesses || k == 0 || csigma_amortized_proof_size(relation) == 0)
+        return -1;
+
+    const linear_map_t* map         = &relation->map;
+    size_t              num_scalars = map->num_scalars;
+    uint8_t*            commitment  = proof;
+    uint8_t*            response    = &proof[map->num_constraints * CSIGMA_POINT_BYTES];
+
+    uint8_t* nonces = malloc(num_scalars * CSIGMA_SCALAR_BYTES);
+    if (!nonces)
+        return -1;
+
+    // Single commitment for all instances, with hedged nonces bound to the statement,
+    // the message and every witness
+    csigma_transcript_t transcript;
+    shake128_ctx        nonce_transcript;
+    uint8_t             context[CSIGMA_NONCE_CONTEXT_BYTES];
+    start_transcript(&transcript, relation, images, k);
+    csigma_transcript_nonce_context(&transcript, message, message_len, context);
+    csigma_nonce_init(&nonce_transcript);
+    csigma_nonce_absorb_context(&nonce_transcript, context, sizeof(context));
+    csigma_nonce_derive(nonces, num_scalars, &nonce_transcript, witnesses,
+                        k * num_scalars * CSIGMA_SCALAR_BYTES);
+    if (linear_map_eval(map, nonces, commitment) != 0) {
+        sodium_memzero(nonces, num_scalars * CSIGMA_SCALAR_BYTES);
+        free(nonces);
+        return -1;
+    }
+
+    uint8_t challenge[CSIGMA_SCALAR_BYTES];
+    generate_challenge(challenge, &transcript, relation, commitment, message, message_len);
+
+    // z = nonces + c*(x_1 + c*(x_2 + ... + c*x_k)), evaluated with Horner's rule
+    for (size_t i = 0; i < num_scalars; i++) {
+        uint8_t acc[CSIGMA_SCALAR_BYTES] = { 0 };
+        for (size_t j = k; j-- > 0;) {
+            crypto_core_ristretto255_scalar_add(
+                acc, acc, &witnesses[(j * num_scalars + i) * CSIGMA_SCALAR_BYTES]);
+            crypto_core_ristretto255_scalar_mul(acc, acc, challenge);
+        }
+        crypto_core_ristretto255_scalar_add(&response[i * CSIGMA_SCALAR_BYTES],
+                                            &nonces[i * CSIGMA_SCALAR_BYTES], acc);
+        sodium_memzero(acc, sizeof(acc));
+    }
+
+    sodium_memzero(nonces, num_scalars * CSIGMA_SCALAR_BYTES);
+    free(nonces);
+    return 0;
+}
+
+bool
+csigma_amortized_verify(const uint8_t* proof, size_t proof_len,
+                        const linear_relation_t* relation, const uint8_t* images, size_t k,
+                        const uint8_t* message, size_t message_len)
+{
+    if (!proof || !images || k == 0 || proof_len == 0 ||
+        proof_len != csigma_amortized_proof_size(relation))
+        return false;
+
+    const linear_map_t* map             = &relation->map;
+    size_t              num_constraints = map->num_constraints;
+    const uint8_t*      commitment      = proof;
+    const uint8_t*      response        = &proof[num_constraints * CSIGMA_POINT_BYTES];
+
+    csigma_transcript_t transcript;
+    uint8_t             challenge[CSIGMA_SCALAR_BYTES];
+    start_transcript(&transcript, relation, images, k);
+    generate_challenge(challenge, &transcript, relation, commitment, message, message_len);
+
+    // powers[j] = c^(j+1); sum = sum of all powers (weight of the constant terms)
+    uint8_t* powers = malloc(k * CSIGMA_SCALAR_BYTES);
+    if (!powers)
+        return false;
+    uint8_t sum[CSIGMA_SCALAR_BYTES];
+    memcpy(powers, challenge, CSIGMA_SCALAR_BYTES);
+    memcpy(sum, challenge, CSIGMA_SCALAR_BYTES);
+    for (size_t j = 1; j < k; j++) {
+        uint8_t* power = &powers[j * CSIGMA_SCALAR_BYTES];
+        crypto_core_ristretto255_scalar_mul(power, power - CSIGMA_SCALAR_BYTES, challenge);
+        crypto_core_ristretto255_scalar_add(sum, sum, power);
+    }
+
+    // For every equation i, with a random weight rho_i:
+    // rho_i * (map(z)_i - T_i - sum_j c^j * image_j,i + sum_j c^j * k_i * constant_i)
+    msm_t msm;
+    msm_init(&msm);
+    bool valid = false;
+
+    for (size_t i = 0; i < num_constraints; i++) {
+        const linear_combination_t* lc = &map->combinations[i];
+        uint8_t                     rho[CSIGMA_SCALAR_BYTES], scalar[CSIGMA_SCALAR_BYTES];
+        crypto_core_ristretto255_scalar_random(rho);
+
+        for (size_t t = 0; t < lc->num_terms; t++) {
+            crypto_core_ristretto255_scalar_mul(
+                scalar, rho, &response[lc->scalar_indices[t] * CSIGMA_SCALAR_BYTES]);
+            if (lc->coefficients) {
+                crypto_core_ristretto255_scalar_mul(scalar, scalar,
+                                                    &lc->coefficients[t * CSIGMA_SCALAR_BYTES]);
+            }
+            if (msm_add_term(&msm, scalar,
+                             &map->group_elements[lc->element_indices[t] * CSIGMA_POINT_BYTES]) !=
+                0)
+                goto done;
+        }
+
+        crypto_core_ristretto255_scalar_negate(scalar, rho);
+        if (msm_add_term(&msm, scalar, &commitment[i * CSIGMA_POINT_BYTES]) != 0)
+            goto done;
+
+        for (size_t j = 0; j < k; j++) {
+            crypto_core_ristretto255_scalar_mul(scalar, rho, &powers[j * CSIGMA_SCALAR_BYTES]);
+            crypto_core_ristretto255_scalar_negate(scalar, scalar);
+            if (msm_add_term(&msm, scalar,
+                             &images[(j * num_constraints + i) * CSIGMA_POINT_BYTES]) != 0)
+                goto done;
+        }
+
+        if (lc->constant_index >= 0) {
+            crypto_core_ristretto255_scalar_mul(scalar, rho, sum);
+            crypto_core_ristretto255_scalar_mul(scalar, scalar, lc->constant_coefficient);
+            if (msm_add_term(&msm, scalar,
+                             &map->group_elements[lc->constant_index * CSIGMA_POINT_BYTES]) != 0)
+                goto done;
+        }
+    }
+
+    valid = msm_is_identity(&msm);
+
+done:
+    msm_destroy(&msm);
+    free(powers);
+    return valid;
+}
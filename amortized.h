@@ -0,0 +1,39 @@
+#ifndef AMORTIZED_H
+#define AMORTIZED_H
+
+#include "csigma.h"
+#include "linear_relation.h"
+
+// Amortized proofs for many instances of the same linear relation
+// Proves k statements image_j = linear_map(witness_j) + constant, j = 1..k, that
+// share one linear map and differ only in their images, with a single commitment
+// T = linear_map(nonces) and a single combined response
+//   z = nonces + sum_j c^j * witness_j
+// where c is the Fiat-Shamir challenge. The verifier checks
+//   linear_map(z) = T + sum_j c^j * (image_j - constant)
+// for every equation with one multi-scalar multiplication. Soundness follows from
+// the k + 1 distinct challenge powers (knowledge error k / group order).
+//
+// The proof has the size of a single proof for the relation, whatever k is.
+// The relation describes the shared shape: its own image is not used.
+
+// Calculate amortized proof size in bytes (num_constraints points + num_scalars scalars)
+// Returns 0 if the relation is malformed
+size_t csigma_amortized_proof_size(const linear_relation_t* relation);
+
+// Prove k instances of the relation
+// proof: output buffer of csigma_amortized_proof_size() bytes
+// images: array of k images, num_constraints 32-byte points each
+// witnesses: array of k witnesses, num_scalars 32-byte scalars each
+// Returns 0 on success, -1 on error
+int csigma_amortized_prove(uint8_t* proof, const linear_relation_t* relation,
+                           const uint8_t* images, const uint8_t* witnesses, size_t k,
+                           const uint8_t* message, size_t message_len);
+
+// Verify an amortized proof for k instances with a single multi-scalar multiplication
+// Returns true if valid, false otherwise
+bool csigma_amortized_verify(const uint8_t* proof, size_t proof_len,
+                             const linear_relation_t* relation, const uint8_t* images, size_t k,
+                             const uint8_t* message, size_t message_len);
+
+#endif
@@ -0,0 +1,572 @@
+#include "cmz.h"
+#include "linear_relation.h"
+#include "nonce.h"
+#include "pedersen.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// Parameters
+// ============================================================================
+
+// Absorb the parameters under a given backend (internal)
+static void
+compile_transcript(csigma_transcript_t* transcript, const csigma_cmz_params_t* params,
+                   csigma_hash_t hash)
+{
+    csigma_transcript_init_with(transcript, hash, "cmz_presentation");
+    csigma_transcript_absorb(transcript, params->G, CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb(transcript, params->H, CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb(transcript, params->Cx0, CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb(transcript, params->X, params->num_attributes * CSIGMA_POINT_BYTES);
+}
+
+int
+csigma_cmz_issuer_init(csigma_cmz_issuer_t* issuer, size_t num_attributes,
+                       const uint8_t G[CSIGMA_POINT_BYTES], const uint8_t H[CSIGMA_POINT_BYTES])
+{
+    csigma_cmz_params_t* params = &issuer->params;
+
+    memset(issuer, 0, sizeof(*issuer));
+    if (num_attributes == 0 || num_attributes > CSIGMA_CMZ_MAX_ATTRIBUTES || !G || !H)
+        return -1;
+
+    params->num_attributes = num_attributes;
+    params->X              = malloc(num_attributes * CSIGMA_POINT_BYTES);
+    issuer->x              = malloc(num_attributes * CSIGMA_SCALAR_BYTES);
+    if (!params->X || !issuer->x)
+        goto fail;
+    memcpy(params->G, G, CSIGMA_POINT_BYTES);
+    memcpy(params->H, H, CSIGMA_POINT_BYTES);
+
+    // Cx0 = x0*G + x0~*H, X_i = x_i*H
+    crypto_core_ristretto255_scalar_random(issuer->x0);
+    crypto_core_ristretto255_scalar_random(issuer->x0_tilde);
+    if (csigma_pedersen_commit(params->Cx0, issuer->x0, issuer->x0_tilde, G, H) != 0)
+        goto fail;
+    for (size_t i = 0; i < num_attributes; i++) {
+        uint8_t* x_i = &issuer->x[i * CSIGMA_SCALAR_BYTES];
+        crypto_core_ristretto255_scalar_random(x_i);
+        if (csigma_scalarmult(&params->X[i * CSIGMA_POINT_BYTES], x_i, H) != 0)
+            goto fail;
+    }
+
+    compile_transcript(&params->transcript, params, csigma_transcript_get_hash());
+    return 0;
+
+fail:
+    csigma_cmz_issuer_destroy(issuer);
+    return -1;
+}
+
+void
+csigma_cmz_issuer_destroy(csigma_cmz_issuer_t* issuer)
+{
+    if (issuer->x) {
+        sodium_memzero(issuer->x, issuer->params.num_attributes * CSIGMA_SCALAR_BYTES);
+    }
+    free(issuer->x);
+    sodium_memzero(issuer->x0, sizeof(issuer->x0));
+    sodium_memzero(issuer->x0_tilde, sizeof(issuer->x0_tilde));
+    issuer->x = NULL;
+    csigma_cmz_params_destroy(&issuer->params);
+}
+
+void
+csigma_cmz_params_serialize(uint8_t* output, const csigma_cmz_params_t* params)
+{
+    memcpy(&output[0], params->G, CSIGMA_POINT_BYTES);
+    memcpy(&output[CSIGMA_POINT_BYTES], params->H, CSIGMA_POINT_BYTES);
+    memcpy(&output[2 * CSIGMA_POINT_BYTES], params->Cx0, CSIGMA_POINT_BYTES);
+    memcpy(&output[3 * CSIGMA_POINT_BYTES], params->X,
+           params->num_attributes * CSIGMA_POINT_BYTES);
+}
+
+int
+csigma_cmz_params_load(csigma_cmz_params_t* params, const uint8_t* data, size_t data_len)
+{
+    memset(params, 0, sizeof(*params));
+    if (!data || data_len % CSIGMA_POINT_BYTES != 0 ||
+        data_len < csigma_cmz_params_size(1) ||
+        data_len > csigma_cmz_params_size(CSIGMA_CMZ_MAX_ATTRIBUTES))
+        return -1;
+
+    for (size_t offset = 0; offset < data_len; offset += CSIGMA_POINT_BYTES) {
+        if (crypto_core_ristretto255_is_valid_point(&data[offset]) != 1)
+            return -1;
+    }
+
+    params->num_attributes = data_len / CSIGMA_POINT_BYTES - 3;
+    params->X              = malloc(params->num_attributes * CSIGMA_POINT_BYTES);
+    if (!params->X)
+        return -1;
+    memcpy(params->G, &data[0], CSIGMA_POINT_BYTES);
+    memcpy(params->H, &data[CSIGMA_POINT_BYTES], CSIGMA_POINT_BYTES);
+    memcpy(params->Cx0, &data[2 * CSIGMA_POINT_BYTES], CSIGMA_POINT_BYTES);
+    memcpy(params->X, &data[3 * CSIGMA_POINT_BYTES], params->num_attributes * CSIGMA_POINT_BYTES);
+
+    compile_transcript(&params->transcript, params, csigma_transcript_get_hash());
+    return 0;
+}
+
+void
+csigma_cmz_params_destroy(csigma_cmz_params_t* params)
+{
+    free(params->X);
+    params->X              = NULL;
+    params->num_attributes = 0;
+}
+
+// ============================================================================
+// Issuance
+// ============================================================================
+
+// Issuance statement (internal): knowledge of the issuer key (x0, x0~, x_1..x_n) with
+//   Cx0 = x0*G + x0~*H, X_i = x_i*H, U' = x0*U + sum of m_i*x_i*U
+static int
+build_issuance_relation(linear_relation_t* relation, const csigma_cmz_params_t* params,
+                        const uint8_t credential[CSIGMA_CMZ_CREDENTIAL_BYTES],
+                        const uint8_t* attributes)
+{
+    size_t n = params->num_attributes;
+
+    int*     scalar_indices  = malloc((n + 1) * sizeof(int));
+    int*     element_indices = malloc((n + 1) * sizeof(int));
+    uint8_t* coefficients    = malloc((n + 1) * CSIGMA_SCALAR_BYTES);
+    if (!scalar_indices || !element_indices || !coefficients) {
+        free(scalar_indices);
+        free(element_indices);
+        free(coefficients);
+        return -1;
+    }
+
+    csigma_relation_init(relation);
+
+    int var_x0  = csigma_relation_allocate_scalars(relation, n + 2);
+    int var_x0t = var_x0 + 1;
+    int var_x   = var_x0 + 2;
+    int var_G   = csigma_relation_add_element(relation, params->G);
+    int var_H   = csigma_relation_add_element(relation, params->H);
+    int var_U   = csigma_relation_add_element(relation, &credential[0]);
+    int var_Cx0 = csigma_relation_add_element(relation, params->Cx0);
+    int var_Up  = csigma_relation_add_element(relation, &credential[CSIGMA_POINT_BYTES]);
+
+    // Cx0 = x0*G + x0~*H
+    scalar_indices[0]  = var_x0;
+    scalar_indices[1]  = var_x0t;
+    element_indices[0] = var_G;
+    element_indices[1] = var_H;
+    csigma_relation_add_equation(relation, var_Cx0, scalar_indices, element_indices, 2);
+    memcpy(&relation->image[0], params->Cx0, CSIGMA_POINT_BYTES);
+
+    // X_i = x_i*H
+    for (size_t i = 0; i < n; i++) {
+        int var_X = csigma_relation_add_element(relation, &params->X[i * CSIGMA_POINT_BYTES]);
+        csigma_relation_add_equation_simple(relation, var_X, var_x + (int) i, var_H);
+        memcpy(&relation->image[(i + 1) * CSIGMA_POINT_BYTES], &params->X[i * CSIGMA_POINT_BYTES],
+               CSIGMA_POINT_BYTES);
+    }
+
+    // U' = 1*x0*U + sum of m_i*x_i*U
+    memset(coefficients, 0, CSIGMA_SCALAR_BYTES);
+    coefficients[0]    = 1;
+    scalar_indices[0]  = var_x0;
+    element_indices[0] = var_U;
+    for (size_t i = 0; i < n; i++) {
+        scalar_indices[i + 1]  = var_x + (int) i;
+        element_indices[i + 1] = var_U;
+        memcpy(&coefficients[(i + 1) * CSIGMA_SCALAR_BYTES], &attributes[i * CSIGMA_SCALAR_BYTES],
+               CSIGMA_SCALAR_BYTES);
+    }
+    csigma_relation_add_weighted_equation(relation, var_Up, scalar_indices, element_indices,
+                                          coefficients, n + 1);
+    memcpy(&relation->image[(n + 1) * CSIGMA_POINT_BYTES], &credential[CSIGMA_POINT_BYTES],
+           CSIGMA_POINT_BYTES);
+
+    free(scalar_indices);
+    free(element_indices);
+    free(coefficients);
+    return 0;
+}
+
+// Start an issuance proof transcript: domain and statement (internal)
+static void
+issuance_transcript_init(csigma_transcript_t* transcript, const linear_relation_t* relation)
+{
+    csigma_transcript_init(transcript, "cmz_issuance");
+    csigma_transcript_absorb_relation(transcript, relation);
+}
+
+// Fiat-Shamir challenge for issuance proofs from a started transcript (internal)
+static void
+generate_issuance_challenge(uint8_t challenge[CSIGMA_SCALAR_BYTES],
+                            csigma_transcript_t* transcript, const linear_relation_t* relation,
+                            const uint8_t* commitment)
+{
+    csigma_transcript_absorb(transcript, commitment,
+                             relation->map.num_constraints * CSIGMA_POINT_BYTES);
+    csigma_transcript_challenge(transcript, challenge);
+}
+
+int
+csigma_cmz_issue(uint8_t credential[CSIGMA_CMZ_CREDENTIAL_BYTES], uint8_t* proof,
+                 const csigma_cmz_issuer_t* issuer, const uint8_t* attributes)
+{
+    if (!credential || !issuer || !issuer->x || !attributes)
+        return -1;
+
+    const csigma_cmz_params_t* params = &issuer->params;
+    size_t                     n      = params->num_attributes;
+
+    // U = u*G for a fresh u, U' = (x0 + sum of x_i*m_i)*U
+    uint8_t u[CSIGMA_SCALAR_BYTES], mac_key[CSIGMA_SCALAR_BYTES], tmp[CSIGMA_SCALAR_BYTES];
+    crypto_core_ristretto255_scalar_random(u);
+    memcpy(mac_key, issuer->x0, CSIGMA_SCALAR_BYTES);
+    for (size_t i = 0; i < n; i++) {
+        crypto_core_ristretto255_scalar_mul(tmp, &issuer->x[i * CSIGMA_SCALAR_BYTES],
+                                            &attributes[i * CSIGMA_SCALAR_BYTES]);
+        crypto_core_ristretto255_scalar_add(mac_key, mac_key, tmp);
+    }
+    int ret = -1;
+    if (csigma_scalarmult(&credential[0], u, params->G) != 0 ||
+        csigma_scalarmult(&credential[CSIGMA_POINT_BYTES], mac_key, &credential[0]) != 0)
+        goto done;
+
+    if (proof) {
+        linear_relation_t relation;
+        if (build_issuance_relation(&relation, params, credential, attributes) != 0)
+            goto done;
+
+        // Witness: [x0, x0~, x_1..x_n]
+        uint8_t* witness = malloc((n + 2) * CSIGMA_SCALAR_BYTES);
+        if (witness) {
+            memcpy(&witness[0], issuer->x0, CSIGMA_SCALAR_BYTES);
+            memcpy(&witness[CSIGMA_SCALAR_BYTES], issuer->x0_tilde, CSIGMA_SCALAR_BYTES);
+            memcpy(&witness[2 * CSIGMA_SCALAR_BYTES], issuer->x, n * CSIGMA_SCALAR_BYTES);
+
+            // Issuance proofs carry no message: the context is the statement transcript
+            csigma_transcript_t transcript;
+            uint8_t             context[CSIGMA_NONCE_CONTEXT_BYTES];
+            issuance_transcript_init(&transcript, &relation);
+            csigma_transcript_nonce_context(&transcript, NULL, 0, context);
+
+            prover_state_t state;
+            if (csigma_prover_commit_with_context(&relation, witness, context, sizeof(context),
+                                                  proof, &state) == 0) {
+                uint8_t challenge[CSIGMA_SCALAR_BYTES];
+                generate_issuance_challenge(challenge, &transcript, &relation, proof);
+                csigma_prover_response(&state, challenge,
+                                       &proof[(n + 2) * CSIGMA_POINT_BYTES]);
+                csigma_prover_state_destroy(&state);
+                ret = 0;
+            }
+            sodium_memzero(witness, (n + 2) * CSIGMA_SCALAR_BYTES);
+            free(witness);
+        }
+        csigma_relation_destroy(&relation);
+    } else {
+        ret = 0;
+    }
+
+done:
+    sodium_memzero(u, sizeof(u));
+    sodium_memzero(mac_key, sizeof(mac_key));
+    sodium_memzero(tmp, sizeof(tmp));
+    return ret;
+}
+
+bool
+csigma_cmz_issuance_verify(const uint8_t* proof, size_t proof_len,
+                           const csigma_cmz_params_t* params,
+                           const uint8_t credential[CSIGMA_CMZ_CREDENTIAL_BYTES],
+                           const uint8_t* attributes)
+{
+    if (!proof || !params || !params->X || !credential || !attributes ||
+        proof_len != csigma_cmz_issuance_proof_size(params->num_attributes))
+        return false;
+
+    static const uint8_t identity[CSIGMA_POINT_BYTES] = { 0 };
+    if (sodium_memcmp(&credential[0], identity, CSIGMA_POINT_BYTES) == 0)
+        return false;
+
+    size_t            n = params->num_attributes;
+    linear_relation_t relation;
+    if (build_issuance_relation(&relation, params, credential, attributes) != 0)
+        return false;
+
+    csigma_transcript_t transcript;
+    uint8_t             challenge[CSIGMA_SCALAR_BYTES];
+    issuance_transcript_init(&transcript, &relation);
+    generate_issuance_challenge(challenge, &transcript, &relation, proof);
+
+    msm_t msm;
+    msm_init(&msm);
+    bool valid = linear_relation_append_check(&relation, proof, challenge,
+                                              &proof[(n + 2) * CSIGMA_POINT_BYTES], &msm) == 0 &&
+                 msm_is_identity(&msm);
+    msm_destroy(&msm);
+    csigma_relation_destroy(&relation);
+    return valid;
+}
+
+// ============================================================================
+// Presentation
+// ============================================================================
+
+// Start a presentation transcript under the current backend: a copy of the parameter
+// transcript, or a new one if the backend has changed since it was computed (internal)
+static void
+start_presentation_transcript(csigma_transcript_t*       transcript,
+                              const csigma_cmz_params_t* params)
+{
+    csigma_hash_t hash = csigma_transcript_get_hash();
+    if (params->transcript.hash == hash) {
+        *transcript = params->transcript;
+    } else {
+        compile_transcript(transcript, params, hash);
+    }
+}
+
+// Presentation challenge over a started transcript, the proof points and the message
+// (internal)
+static void
+generate_presentation_challenge(uint8_t challenge[CSIGMA_SCALAR_BYTES],
+                                csigma_transcript_t*       transcript,
+                                const csigma_cmz_params_t* params, const uint8_t* points,
+                                const uint8_t* message, size_t message_len)
+{
+    csigma_transcript_absorb(transcript, points,
+                             (2 * params->num_attributes + 3) * CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb(transcript, message, message ? message_len : 0);
+    csigma_transcript_challenge(transcript, challenge);
+}
+
+int
+csigma_cmz_present(uint8_t* presentation, const csigma_cmz_params_t* params,
+                   const uint8_t credential[CSIGMA_CMZ_CREDENTIAL_BYTES],
+                   const uint8_t* attributes, const uint8_t* message, size_t message_len)
+{
+    if (!presentation || !params || !params->X || !credential || !attributes)
+        return -1;
+
+    size_t   n   = params->num_attributes;
+    uint8_t* U   = presentation;
+    uint8_t* CUp = &U[CSIGMA_POINT_BYTES];
+    uint8_t* Cm  = &CUp[CSIGMA_POINT_BYTES];
+    uint8_t* T   = &Cm[n * CSIGMA_POINT_BYTES];
+    uint8_t* T_V = &T[n * CSIGMA_POINT_BYTES];
+    uint8_t* s_m = &T_V[CSIGMA_POINT_BYTES];
+    uint8_t* s_z = &s_m[n * CSIGMA_SCALAR_BYTES];
+    uint8_t* s_r = &s_z[n * CSIGMA_SCALAR_BYTES];
+
+    // Secrets: z_i, nonces k_m_i, k_z_i, a, r, k_r, the scalars of the T_V
+    // multiplication, and the witness (credential and attributes) the others are
+    // derived from
+    size_t   secret_len = (5 * n + 6) * CSIGMA_SCALAR_BYTES;
+    uint8_t* secret     = malloc(secret_len);
+    uint8_t* points     = malloc((n + 1) * CSIGMA_POINT_BYTES);
+    uint8_t  tmp[CSIGMA_SCALAR_BYTES];
+    uint8_t  Up[CSIGMA_POINT_BYTES], rG[CSIGMA_POINT_BYTES];
+    int      ret = -1;
+
+    if (!secret || !points)
+        goto done;
+
+    uint8_t* z       = secret;
+    uint8_t* k_m     = &z[n * CSIGMA_SCALAR_BYTES];
+    uint8_t* k_z     = &k_m[n * CSIGMA_SCALAR_BYTES];
+    uint8_t* a       = &k_z[n * CSIGMA_SCALAR_BYTES];
+    uint8_t* r       = &a[CSIGMA_SCALAR_BYTES];
+    uint8_t* k_r     = &r[CSIGMA_SCALAR_BYTES];
+    uint8_t* scalars = &k_r[CSIGMA_SCALAR_BYTES];
+    uint8_t* witness = &scalars[(n + 1) * CSIGMA_SCALAR_BYTES];
+
+    // Every random scalar is a hedged nonce bound to the parameters, the credential,
+    // the attributes and the message
+    csigma_transcript_t transcript;
+    shake128_ctx        nonce_transcript;
+    uint8_t             context[CSIGMA_NONCE_CONTEXT_BYTES];
+    start_presentation_transcript(&transcript, params);
+    csigma_transcript_nonce_context(&transcript, message, message_len, context);
+    memcpy(witness, credential, CSIGMA_CMZ_CREDENTIAL_BYTES);
+    memcpy(&witness[CSIGMA_CMZ_CREDENTIAL_BYTES], attributes, n * CSIGMA_SCALAR_BYTES);
+    csigma_nonce_init(&nonce_transcript);
+    csigma_nonce_absorb_context(&nonce_transcript, context, sizeof(context));
+    csigma_nonce_derive(z, 3 * n + 3, &nonce_transcript, witness,
+                        CSIGMA_CMZ_CREDENTIAL_BYTES + n * CSIGMA_SCALAR_BYTES);
+
+    // Re-randomize the credential: (a*U, a*U')
+    if (csigma_scalarmult(U, a, &credential[0]) != 0 ||
+        csigma_scalarmult(Up, a, &credential[CSIGMA_POINT_BYTES]) != 0)
+        goto done;
+
+    // CU' = U' + r*G
+    if (csigma_scalarmult(rG, r, params->G) != 0 || crypto_core_ristretto255_add(CUp, Up, rG) != 0)
+        goto done;
+
+    // Cm_i = m_i*U + z_i*H, T_i = k_m_i*U + k_z_i*H
+    for (size_t i = 0; i < n; i++) {
+        if (csigma_pedersen_commit(&Cm[i * CSIGMA_POINT_BYTES],
+                                   &attributes[i * CSIGMA_SCALAR_BYTES],
+                                   &z[i * CSIGMA_SCALAR_BYTES], U, params->H) != 0 ||
+            csigma_pedersen_commit(&T[i * CSIGMA_POINT_BYTES], &k_m[i * CSIGMA_SCALAR_BYTES],
+                                   &k_z[i * CSIGMA_SCALAR_BYTES], U, params->H) != 0)
+            goto done;
+    }
+
+    // T_V = sum of k_z_i*X_i - k_r*G
+    memcpy(scalars, k_z, n * CSIGMA_SCALAR_BYTES);
+    crypto_core_ristretto255_scalar_negate(&scalars[n * CSIGMA_SCALAR_BYTES], k_r);
+    memcpy(points, params->X, n * CSIGMA_POINT_BYTES);
+    memcpy(&points[n * CSIGMA_POINT_BYTES], params->G, CSIGMA_POINT_BYTES);
+    if (csigma_msm(T_V, scalars, points, n + 1) != 0)
+        goto done;
+
+    uint8_t c[CSIGMA_SCALAR_BYTES];
+    generate_presentation_challenge(c, &transcript, params, presentation, message, message_len);
+
+    // s_m = k_m + c*m, s_z = k_z + c*z, s_r = k_r + c*r
+    for (size_t i = 0; i < n; i++) {
+        crypto_core_ristretto255_scalar_mul(tmp, c, &attributes[i * CSIGMA_SCALAR_BYTES]);
+        crypto_core_ristretto255_scalar_add(&s_m[i * CSIGMA_SCALAR_BYTES],
+                                            &k_m[i * CSIGMA_SCALAR_BYTES], tmp);
+        crypto_core_ristretto255_scalar_mul(tmp, c, &z[i * CSIGMA_SCALAR_BYTES]);
+        crypto_core_ristretto255_scalar_add(&s_z[i * CSIGMA_SCALAR_BYTES],
+                                            &k_z[i * CSIGMA_SCALAR_BYTES], tmp);
+    }
+    crypto_core_ristretto255_scalar_mul(tmp, c, r);
+    crypto_core_ristretto255_scalar_add(s_r, k_r, tmp);
+    ret = 0;
+
+done:
+    if (secret) {
+        sodium_memzero(secret, secret_len);
+    }
+    free(secret);
+    free(points);
+    sodium_memzero(tmp, sizeof(tmp));
+    return ret;
+}
+
+// Add the checks of one presentation to a multi-scalar multiplication (internal)
+// With random weights rho_i and rho_V, and the issuer key folded in:
+//   rho_i * (s_m_i*U + s_z_i*H - T_i - c*Cm_i)
+//   rho_V * ((sum of s_z_i*x_i)*H - s_r*G - T_V - c*(x0*U + sum of x_i*Cm_i - CU'))
+// The terms on G and H are accumulated into g_scalar and h_scalar.
+static int
+cmz_append_checks(msm_t* msm, uint8_t g_scalar[CSIGMA_SCALAR_BYTES],
+                  uint8_t h_scalar[CSIGMA_SCALAR_BYTES], const uint8_t* presentation,
+                  const csigma_cmz_issuer_t* issuer, const uint8_t* message, size_t message_len)
+{
+    const csigma_cmz_params_t* params = &issuer->params;
+    size_t                     n      = params->num_attributes;
+    const uint8_t*             U      = presentation;
+    const uint8_t*             CUp    = &U[CSIGMA_POINT_BYTES];
+    const uint8_t*             Cm     = &CUp[CSIGMA_POINT_BYTES];
+    const uint8_t*             T      = &Cm[n * CSIGMA_POINT_BYTES];
+    const uint8_t*             T_V    = &T[n * CSIGMA_POINT_BYTES];
+    const uint8_t*             s_m    = &T_V[CSIGMA_POINT_BYTES];
+    const uint8_t*             s_z    = &s_m[n * CSIGMA_SCALAR_BYTES];
+    const uint8_t*             s_r    = &s_z[n * CSIGMA_SCALAR_BYTES];
+
+    // A presentation on the identity would hold for any key
+    static const uint8_t identity[CSIGMA_POINT_BYTES] = { 0 };
+    if (sodium_memcmp(U, identity, CSIGMA_POINT_BYTES) == 0)
+        return -1;
+
+    uint8_t c[CSIGMA_SCALAR_BYTES], rho_V[CSIGMA_SCALAR_BYTES], rho_V_c[CSIGMA_SCALAR_BYTES];
+    uint8_t u_scalar[CSIGMA_SCALAR_BYTES], scalar[CSIGMA_SCALAR_BYTES], tmp[CSIGMA_SCALAR_BYTES];
+    csigma_transcript_t transcript;
+    start_presentation_transcript(&transcript, params);
+    generate_presentation_challenge(c, &transcript, params, presentation, message, message_len);
+    crypto_core_ristretto255_scalar_random(rho_V);
+    crypto_core_ristretto255_scalar_mul(rho_V_c, rho_V, c);
+
+    // U: sum of rho_i*s_m_i - rho_V*c*x0
+    crypto_core_ristretto255_scalar_mul(u_scalar, rho_V_c, issuer->x0);
+    crypto_core_ristretto255_scalar_negate(u_scalar, u_scalar);
+
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t* x_i = &issuer->x[i * CSIGMA_SCALAR_BYTES];
+        uint8_t        rho[CSIGMA_SCALAR_BYTES];
+        crypto_core_ristretto255_scalar_random(rho);
+
+        crypto_core_ristretto255_scalar_mul(tmp, rho, &s_m[i * CSIGMA_SCALAR_BYTES]);
+        crypto_core_ristretto255_scalar_add(u_scalar, u_scalar, tmp);
+
+        // H: rho_i*s_z_i + rho_V*s_z_i*x_i
+        crypto_core_ristretto255_scalar_mul(tmp, rho_V, x_i);
+        crypto_core_ristretto255_scalar_add(tmp, tmp, rho);
+        crypto_core_ristretto255_scalar_mul(tmp, tmp, &s_z[i * CSIGMA_SCALAR_BYTES]);
+        crypto_core_ristretto255_scalar_add(h_scalar, h_scalar, tmp);
+
+        // Cm_i: -c*(rho_i + rho_V*x_i); T_i: -rho_i
+        crypto_core_ristretto255_scalar_mul(tmp, rho_V, x_i);
+        crypto_core_ristretto255_scalar_add(tmp, tmp, rho);
+        crypto_core_ristretto255_scalar_mul(tmp, tmp, c);
+        crypto_core_ristretto255_scalar_negate(scalar, tmp);
+        if (msm_add_term(msm, scalar, &Cm[i * CSIGMA_POINT_BYTES]) != 0)
+            return -1;
+        crypto_core_ristretto255_scalar_negate(scalar, rho);
+        if (msm_add_term(msm, scalar, &T[i * CSIGMA_POINT_BYTES]) != 0)
+            return -1;
+    }
+    if (msm_add_term(msm, u_scalar, U) != 0)
+        return -1;
+
+    // T_V: -rho_V; CU': rho_V*c; G: -rho_V*s_r
+    crypto_core_ristretto255_scalar_negate(scalar, rho_V);
+    if (msm_add_term(msm, scalar, T_V) != 0 || msm_add_term(msm, rho_V_c, CUp) != 0)
+        return -1;
+    crypto_core_ristretto255_scalar_mul(tmp, rho_V, s_r);
+    crypto_core_ristretto255_scalar_sub(g_scalar, g_scalar, tmp);
+    return 0;
+}
+
+bool
+csigma_cmz_verify(const uint8_t* presentation, size_t presentation_len,
+                  const csigma_cmz_issuer_t* issuer, const uint8_t* message, size_t message_len)
+{
+    if (!presentation || !issuer ||
+        presentation_len != csigma_cmz_presentation_size(issuer->params.num_attributes))
+        return false;
+
+    const uint8_t* messages[1]     = { message };
+    size_t         message_lens[1] = { message_len };
+    return csigma_cmz_batch_verify(presentation, 1, issuer, messages, message_lens);
+}
+
+bool
+csigma_cmz_batch_verify(const uint8_t* presentations, size_t n,
+                        const csigma_cmz_issuer_t* issuer, const uint8_t* const* messages,
+                        const size_t* message_lens)
+{
+    if (!presentations || n == 0 || !issuer || !issuer->x)
+        return false;
+
+    size_t presentation_len = csigma_cmz_presentation_size(issuer->params.num_attributes);
+
+    uint8_t g_scalar[CSIGMA_SCALAR_BYTES] = { 0 };
+    uint8_t h_scalar[CSIGMA_SCALAR_BYTES] = { 0 };
+    bool    valid                         = false;
+    msm_t   msm;
+    msm_init(&msm);
+
+    for (size_t j = 0; j < n; j++) {
+        const uint8_t* message     = messages ? messages[j] : NULL;
+        size_t         message_len = message_lens ? message_lens[j] : 0;
+
+        if (cmz_append_checks(&msm, g_scalar, h_scalar, &presentations[j * presentation_len],
+                              issuer, message, message_len) != 0)
+            goto done;
+    }
+    if (msm_add_term(&msm, g_scalar, issuer->params.G) != 0 ||
+        msm_add_term(&msm, h_scalar, issuer->params.H) != 0)
+        goto done;
+
+    valid = msm_is_identity(&msm);
+
+done:
+    msm_destroy(&msm);
+    return valid;
+}
@@ -0,0 +1,123 @@
+#ifndef CMZ_H
+#define CMZ_H
+
+#include "csigma.h"
+#include "transcript.h"
+
+// Keyed-verification anonymous credentials (CMZ, algebraic MACs in MAC_GGM style)
+// The issuer holds secret scalars x0, x0~, x_1..x_n and publishes the parameters
+//   G, H, Cx0 = x0*G + x0~*H, X_i = x_i*H
+// A credential on attributes m_1..m_n is (U, U') with U' = (x0 + sum of x_i*m_i)*U.
+//
+// Presentations re-randomize the credential and commit to every attribute,
+//   Cm_i = m_i*U + z_i*H, CU' = U' + r*G
+// and prove knowledge of (m_i, z_i, r) such that V = sum of z_i*X_i - r*G, where the
+// issuer computes V = x0*U + sum of x_i*Cm_i - CU' with its key. The attributes stay
+// hidden; the commitments Cm_i can be tied to other statements about them.
+//
+// The presentation shape depends only on the number of attributes, so nothing is
+// rebuilt per presentation: parameters carry a Fiat-Shamir transcript prefix over
+// the issuer parameters, computed once (and again per presentation if the transcript
+// backend is changed afterwards), and the verifier folds its secret key into the check,
+// which then needs neither V nor the X_i. A presentation is verified with one
+// multi-scalar multiplication of 2n + 5 terms, and batches share one.
+//
+// G and H must be independent generators (for example from csigma_derive_generators()).
+
+#define CSIGMA_CMZ_MAX_ATTRIBUTES 64
+#define CSIGMA_CMZ_CREDENTIAL_BYTES (2 * CSIGMA_POINT_BYTES)
+
+// Issuer public parameters
+typedef struct {
+    size_t              num_attributes;
+    uint8_t             G[CSIGMA_POINT_BYTES];
+    uint8_t             H[CSIGMA_POINT_BYTES];
+    uint8_t             Cx0[CSIGMA_POINT_BYTES];
+    uint8_t*            X; // num_attributes points
+    csigma_transcript_t transcript; // Presentation transcript over the parameters, under the
+                                    // backend active when they were set up
+} csigma_cmz_params_t;
+
+// Issuer key and parameters
+typedef struct {
+    csigma_cmz_params_t params;
+    uint8_t             x0[CSIGMA_SCALAR_BYTES];
+    uint8_t             x0_tilde[CSIGMA_SCALAR_BYTES];
+    uint8_t*            x; // num_attributes scalars
+} csigma_cmz_issuer_t;
+
+// Serialized parameters: G || H || Cx0 || X_1..X_n
+static inline size_t
+csigma_cmz_params_size(size_t num_attributes)
+{
+    return (num_attributes + 3) * CSIGMA_POINT_BYTES;
+}
+
+// Issuance proof: n + 2 commitment points and n + 2 responses
+static inline size_t
+csigma_cmz_issuance_proof_size(size_t num_attributes)
+{
+    return 2 * (num_attributes + 2) * CSIGMA_SCALAR_BYTES;
+}
+
+// Presentation: U, CU', Cm_i, T_i, T_V (points) then s_m_i, s_z_i, s_r (scalars)
+static inline size_t
+csigma_cmz_presentation_size(size_t num_attributes)
+{
+    return (4 * num_attributes + 4) * CSIGMA_POINT_BYTES;
+}
+
+// Generate an issuer key for credentials with num_attributes attributes
+// Returns 0 on success, -1 on error
+int csigma_cmz_issuer_init(csigma_cmz_issuer_t* issuer, size_t num_attributes,
+                           const uint8_t G[CSIGMA_POINT_BYTES],
+                           const uint8_t H[CSIGMA_POINT_BYTES]);
+
+// Erase and release an issuer key
+void csigma_cmz_issuer_destroy(csigma_cmz_issuer_t* issuer);
+
+// Serialize public parameters into csigma_cmz_params_size() bytes
+void csigma_cmz_params_serialize(uint8_t* output, const csigma_cmz_params_t* params);
+
+// Load public parameters from their serialization
+// Returns 0 on success, -1 if the length or a point is invalid
+int csigma_cmz_params_load(csigma_cmz_params_t* params, const uint8_t* data, size_t data_len);
+
+// Release loaded parameters
+void csigma_cmz_params_destroy(csigma_cmz_params_t* params);
+
+// Issue a credential on num_attributes attribute scalars
+// proof: optional output of csigma_cmz_issuance_proof_size() bytes proving that the
+// credential was computed with the key behind the public parameters (NULL to skip)
+// Returns 0 on success, -1 on error
+int csigma_cmz_issue(uint8_t credential[CSIGMA_CMZ_CREDENTIAL_BYTES], uint8_t* proof,
+                     const csigma_cmz_issuer_t* issuer, const uint8_t* attributes);
+
+// Check an issuance proof on the holder side
+// Returns true if valid, false otherwise
+bool csigma_cmz_issuance_verify(const uint8_t* proof, size_t proof_len,
+                                const csigma_cmz_params_t* params,
+                                const uint8_t credential[CSIGMA_CMZ_CREDENTIAL_BYTES],
+                                const uint8_t* attributes);
+
+// Present a credential, bound to a message
+// presentation: output buffer of csigma_cmz_presentation_size() bytes
+// Returns 0 on success, -1 on error
+int csigma_cmz_present(uint8_t* presentation, const csigma_cmz_params_t* params,
+                       const uint8_t credential[CSIGMA_CMZ_CREDENTIAL_BYTES],
+                       const uint8_t* attributes, const uint8_t* message, size_t message_len);
+
+// Verify a presentation with the issuer key, with one multi-scalar multiplication
+// Returns true if valid, false otherwise
+bool csigma_cmz_verify(const uint8_t* presentation, size_t presentation_len,
+                       const csigma_cmz_issuer_t* issuer, const uint8_t* message,
+                       size_t message_len);
+
+// Verify n presentations together (contiguous, csigma_cmz_presentation_size() each)
+// messages, message_lens: per-presentation messages (both may be NULL for no messages)
+// Returns true only if every presentation is valid
+bool csigma_cmz_batch_verify(const uint8_t* presentations, size_t n,
+                             const csigma_cmz_issuer_t* issuer, const uint8_t* const* messages,
+                             const size_t* message_lens);
+
+#endif
@@ -0,0 +1,514 @@
+#include "composition.h"
+#include "transcript.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Initial capacity for the node array
+#define INITIAL_NODES_CAPACITY 4
+
+// ============================================================================
+// Composition Builder
+// ============================================================================
+
+void
+csigma_composition_init(csigma_composition_t* composition)
+{
+    composition->nodes     = malloc(INITIAL_NODES_CAPACITY * sizeof(composition_node_t));
+    composition->num_nodes = 0;
+    composition->capacity  = INITIAL_NODES_CAPACITY;
+}
+
+void
+csigma_composition_destroy(csigma_composition_t* composition)
+{
+    for (size_t i = 0; i < composition->num_nodes; i++) {
+        free(composition->nodes[i].children);
+    }
+    free(composition->nodes);
+    composition->nodes     = NULL;
+    composition->num_nodes = 0;
+    composition->capacity  = 0;
+}
+
+// Append a node (internal)
+static int
+add_node(csigma_composition_t* composition, csigma_node_kind_t kind,
+         const linear_relation_t* relation, const int* children, size_t num_children)
+{
+    // Children must exist and must not have a parent yet
+    for (size_t i = 0; i < num_children; i++) {
+        if (children[i] < 0 || (size_t) children[i] >= composition->num_nodes)
+            return -1;
+        for (size_t j = 0; j < i; j++) {
+            if (children[j] == children[i])
+                return -1;
+        }
+        for (size_t n = 0; n < composition->num_nodes; n++) {
+            const composition_node_t* node = &composition->nodes[n];
+            for (size_t k = 0; k < node->num_children; k++) {
+                if (node->children[k] == children[i])
+                    return -1;
+            }
+        }
+    }
+
+    if (composition->num_nodes >= composition->capacity) {
+        composition->capacity *= 2;
+        composition->nodes =
+            realloc(composition->nodes, composition->capacity * sizeof(composition_node_t));
+    }
+
+    composition_node_t* node = &composition->nodes[composition->num_nodes];
+    node->kind               = kind;
+    node->relation           = relation;
+    node->children           = NULL;
+    node->num_children       = num_children;
+    if (num_children > 0) {
+        node->children = malloc(num_children * sizeof(int));
+        memcpy(node->children, children, num_children * sizeof(int));
+    }
+    return (int) composition->num_nodes++;
+}
+
+int
+csigma_composition_add_relation(csigma_composition_t*    composition,
+                                const linear_relation_t* relation)
+{
+    return add_node(composition, CSIGMA_NODE_RELATION, relation, NULL, 0);
+}
+
+int
+csigma_composition_add_and(csigma_composition_t* composition, const int* children,
+                           size_t num_children)
+{
+    if (num_children == 0)
+        return -1;
+    return add_node(composition, CSIGMA_NODE_AND, NULL, children, num_children);
+}
+
+int
+csigma_composition_add_or(csigma_composition_t* composition, const int* children,
+                          size_t num_children)
+{
+    if (num_children == 0)
+        return -1;
+    return add_node(composition, CSIGMA_NODE_OR, NULL, children, num_children);
+}
+
+// ============================================================================
+// Proof Layout (Internal)
+// ============================================================================
+
+// Byte offsets of each node's data in the proof
+typedef struct {
+    size_t* commitment_offsets; // Leaf commitments
+    size_t* challenge_offsets; // OR-branch challenges
+    size_t* response_offsets; // Leaf responses
+    size_t  total_len;
+} proof_layout_t;
+
+// Check that the nodes form a single tree rooted at the last node
+static int
+validate_tree(const csigma_composition_t* composition)
+{
+    size_t num_nodes = composition->num_nodes;
+    if (num_nodes == 0)
+        return -1;
+
+    size_t num_edges = 0;
+    for (size_t i = 0; i < num_nodes; i++) {
+        const composition_node_t* node = &composition->nodes[i];
+        if (node->kind == CSIGMA_NODE_RELATION && (!node->relation ||
+                                                   linear_relation_validate(node->relation) != 0))
+            return -1;
+        num_edges += node->num_children;
+    }
+
+    // Children always precede their parent and have a single parent, so the
+    // nodes form a tree exactly when every node but the root has a parent
+    return num_edges == num_nodes - 1 ? 0 : -1;
+}
+
+static int
+layout_init(proof_layout_t* layout, const csigma_composition_t* composition)
+{
+    size_t num_nodes           = composition->num_nodes;
+    layout->commitment_offsets = malloc(num_nodes * sizeof(size_t));
+    layout->challenge_offsets  = malloc(num_nodes * sizeof(size_t));
+    layout->response_offsets   = malloc(num_nodes * sizeof(size_t));
+    if (!layout->commitment_offsets || !layout->challenge_offsets || !layout->response_offsets) {
+        free(layout->commitment_offsets);
+        free(layout->challenge_offsets);
+        free(layout->response_offsets);
+        return -1;
+    }
+
+    size_t offset = 0;
+    for (size_t i = 0; i < num_nodes; i++) {
+        const composition_node_t* node = &composition->nodes[i];
+        layout->commitment_offsets[i]  = offset;
+        if (node->kind == CSIGMA_NODE_RELATION)
+            offset += node->relation->map.num_constraints * CSIGMA_POINT_BYTES;
+    }
+    for (size_t i = 0; i < num_nodes; i++) {
+        const composition_node_t* node = &composition->nodes[i];
+        layout->challenge_offsets[i]   = offset;
+        if (node->kind == CSIGMA_NODE_OR)
+            offset += (node->num_children - 1) * CSIGMA_SCALAR_BYTES;
+    }
+    for (size_t i = 0; i < num_nodes; i++) {
+        const composition_node_t* node = &composition->nodes[i];
+        layout->response_offsets[i]    = offset;
+        if (node->kind == CSIGMA_NODE_RELATION)
+            offset += node->relation->map.num_scalars * CSIGMA_SCALAR_BYTES;
+    }
+    layout->total_len = offset;
+    return 0;
+}
+
+static void
+layout_destroy(proof_layout_t* layout)
+{
+    free(layout->commitment_offsets);
+    free(layout->challenge_offsets);
+    free(layout->response_offsets);
+}
+
+size_t
+csigma_composition_proof_size(const csigma_composition_t* composition)
+{
+    proof_layout_t layout;
+    if (validate_tree(composition) != 0 || layout_init(&layout, composition) != 0)
+        return 0;
+    size_t len = layout.total_len;
+    layout_destroy(&layout);
+    return len;
+}
+
+// Start a composition transcript: tree structure and every leaf statement (internal)
+static void
+composition_transcript_init(csigma_transcript_t*        transcript,
+                            const csigma_composition_t* composition)
+{
+    csigma_transcript_init(transcript, "composition");
+
+    csigma_transcript_absorb_u64(transcript, composition->num_nodes);
+    for (size_t i = 0; i < composition->num_nodes; i++) {
+        const composition_node_t* node = &composition->nodes[i];
+        csigma_transcript_absorb_u64(transcript, (uint64_t) node->kind);
+        csigma_transcript_absorb_u64(transcript, node->num_children);
+        for (size_t k = 0; k < node->num_children; k++) {
+            csigma_transcript_absorb_u64(transcript, (uint64_t) node->children[k]);
+        }
+        if (node->kind == CSIGMA_NODE_RELATION)
+            csigma_transcript_absorb_relation(transcript, node->relation);
+    }
+}
+
+// Fiat-Shamir challenge over a started transcript, every commitment and the message
+// (internal)
+static void
+generate_challenge(uint8_t challenge[CSIGMA_SCALAR_BYTES], csigma_transcript_t* transcript,
+                   const uint8_t* commitments, size_t commitments_len, const uint8_t* message,
+                   size_t message_len)
+{
+    csigma_transcript_absorb(transcript, commitments, commitments_len);
+    csigma_transcript_absorb(transcript, message, message ? message_len : 0);
+    csigma_transcript_challenge(transcript, challenge);
+}
+
+// ============================================================================
+// Prover
+// ============================================================================
+
+// Simulated transcript for a leaf: commitment = linear_map(response) - challenge * (image - constant)
+static int
+simulate_leaf(const linear_relation_t* relation, const uint8_t challenge[CSIGMA_SCALAR_BYTES],
+              uint8_t* commitment, uint8_t* response)
+{
+    const linear_map_t* map = &relation->map;
+
+    for (size_t i = 0; i < map->num_scalars; i++) {
+        crypto_core_ristretto255_scalar_random(&response[i * CSIGMA_SCALAR_BYTES]);
+    }
+    if (linear_map_eval(map, response, commitment) != 0)
+        return -1;
+
+    for (size_t i = 0; i < map->num_constraints; i++) {
+        const linear_combination_t* lc = &map->combinations[i];
+        uint8_t                     scalars[2 * CSIGMA_SCALAR_BYTES];
+        uint8_t                     points[2 * CSIGMA_POINT_BYTES];
+        size_t                      num_terms = 1;
+
+        crypto_core_ristretto255_scalar_negate(&scalars[0], challenge);
+        memcpy(&points[0], &relation->image[i * CSIGMA_POINT_BYTES], CSIGMA_POINT_BYTES);
+        if (lc->constant_index >= 0) {
+            crypto_core_ristretto255_scalar_mul(&scalars[CSIGMA_SCALAR_BYTES], challenge,
+                                                lc->constant_coefficient);
+            memcpy(&points[CSIGMA_POINT_BYTES],
+                   &map->group_elements[lc->constant_index * CSIGMA_POINT_BYTES],
+                   CSIGMA_POINT_BYTES);
+            num_terms++;
+        }
+
+        uint8_t shift[CSIGMA_POINT_BYTES];
+        if (csigma_msm(shift, scalars, points, num_terms) != 0)
+            return -1;
+        uint8_t* commitment_i = &commitment[i * CSIGMA_POINT_BYTES];
+        if (crypto_core_ristretto255_add(commitment_i, commitment_i, shift) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+int
+csigma_composition_prove(uint8_t* proof, const csigma_composition_t* composition,
+                         const uint8_t* const* witnesses, const uint8_t* message,
+                         size_t message_len)
+{
+    if (!proof || !composition || !witnesses || validate_tree(composition) != 0)
+        return -1;
+
+    size_t         num_nodes = composition->num_nodes;
+    size_t         root      = num_nodes - 1;
+    proof_layout_t layout;
+    if (layout_init(&layout, composition) != 0)
+        return -1;
+
+    bool*           known      = calloc(num_nodes, sizeof(bool));
+    bool*           simulated  = calloc(num_nodes, sizeof(bool));
+    bool*           committed  = calloc(num_nodes, sizeof(bool));
+    uint8_t*        challenges = calloc(num_nodes, CSIGMA_SCALAR_BYTES);
+    prover_state_t* states     = calloc(num_nodes, sizeof(prover_state_t));
+    int             ret        = -1;
+
+    if (!known || !simulated || !committed || !challenges || !states)
+        goto done;
+
+    // Which subtrees can be proven honestly (children precede parents)
+    for (size_t i = 0; i < num_nodes; i++) {
+        const composition_node_t* node = &composition->nodes[i];
+        if (node->kind == CSIGMA_NODE_RELATION) {
+            known[i] = witnesses[i] != NULL;
+        } else {
+            known[i] = node->kind == CSIGMA_NODE_AND;
+            for (size_t k = 0; k < node->num_children; k++) {
+                if (node->kind == CSIGMA_NODE_AND)
+                    known[i] = known[i] && known[node->children[k]];
+                else
+                    known[i] = known[i] || known[node->children[k]];
+            }
+        }
+    }
+    if (!known[root])
+        goto done;
+
+    // Decide top-down which branches are simulated, and fix their challenges
+    for (size_t i = num_nodes; i-- > 0;) {
+        const composition_node_t* node      = &composition->nodes[i];
+        uint8_t*                  challenge = &challenges[i * CSIGMA_SCALAR_BYTES];
+
+        if (node->kind == CSIGMA_NODE_AND) {
+            for (size_t k = 0; k < node->num_children; k++) {
+                int child        = node->children[k];
+                simulated[child] = simulated[i];
+                memcpy(&challenges[child * CSIGMA_SCALAR_BYTES], challenge, CSIGMA_SCALAR_BYTES);
+            }
+        } else if (node->kind == CSIGMA_NODE_OR) {
+            // Answer the first provable branch honestly, simulate the others
+            int real = -1;
+            for (size_t k = 0; k < node->num_children && !simulated[i]; k++) {
+                if (known[node->children[k]]) {
+                    real = node->children[k];
+                    break;
+                }
+            }
+
+            uint8_t sum[CSIGMA_SCALAR_BYTES] = { 0 };
+            for (size_t k = 0; k < node->num_children; k++) {
+                int      child           = node->children[k];
+                uint8_t* child_challenge = &challenges[child * CSIGMA_SCALAR_BYTES];
+                simulated[child]         = child != real;
+                if (child == real)
+                    continue;
+                if (simulated[i] && k == node->num_children - 1) {
+                    // Challenges of a simulated disjunction must still add up
+                    crypto_core_ristretto255_scalar_sub(child_challenge, challenge, sum);
+                } else {
+                    crypto_core_ristretto255_scalar_random(child_challenge);
+                }
+                crypto_core_ristretto255_scalar_add(sum, sum, child_challenge);
+            }
+        }
+    }
+
+    // Commitments: honest for real leaves, simulated for the others
+    // Real leaves bind their nonces to the whole statement, their position and the
+    // message, as two leaves can share a relation and a witness but not a challenge
+    csigma_transcript_t transcript;
+    composition_transcript_init(&transcript, composition);
+    for (size_t i = 0; i < num_nodes; i++) {
+        const composition_node_t* node = &composition->nodes[i];
+        if (node->kind != CSIGMA_NODE_RELATION)
+            continue;
+
+        uint8_t* commitment = &proof[layout.commitment_offsets[i]];
+        if (simulated[i]) {
+            if (simulate_leaf(node->relation, &challenges[i * CSIGMA_SCALAR_BYTES], commitment,
+                              &proof[layout.response_offsets[i]]) != 0)
+                goto done;
+        } else {
+            csigma_transcript_t leaf = transcript;
+            uint8_t             context[CSIGMA_NONCE_CONTEXT_BYTES];
+            csigma_transcript_absorb_u64(&leaf, i);
+            csigma_transcript_nonce_context(&leaf, message, message_len, context);
+            if (csigma_prover_commit_with_context(node->relation, witnesses[i], context,
+                                                  sizeof(context), commitment, &states[i]) != 0)
+                goto done;
+            committed[i] = true;
+        }
+    }
+
+    // Single Fiat-Shamir challenge for the whole tree
+    uint8_t root_challenge[CSIGMA_SCALAR_BYTES];
+    generate_challenge(root_challenge, &transcript, proof, layout.challenge_offsets[0], message,
+                       message_len);
+
+    // Propagate the challenge down the real branches
+    for (size_t i = num_nodes; i-- > 0;) {
+        const composition_node_t* node = &composition->nodes[i];
+        const uint8_t* challenge = i == root ? root_challenge : &challenges[i * CSIGMA_SCALAR_BYTES];
+        if (simulated[i])
+            continue;
+
+        if (node->kind == CSIGMA_NODE_RELATION) {
+            csigma_prover_response(&states[i], challenge, &proof[layout.response_offsets[i]]);
+        } else if (node->kind == CSIGMA_NODE_AND) {
+            for (size_t k = 0; k < node->num_children; k++) {
+                memcpy(&challenges[node->children[k] * CSIGMA_SCALAR_BYTES], challenge,
+                       CSIGMA_SCALAR_BYTES);
+            }
+        } else {
+            // The real branch gets whatever makes the challenges add up
+            int     real                     = -1;
+            uint8_t sum[CSIGMA_SCALAR_BYTES] = { 0 };
+            for (size_t k = 0; k < node->num_children; k++) {
+                int child = node->children[k];
+                if (!simulated[child])
+                    real = child;
+                else
+                    crypto_core_ristretto255_scalar_add(sum, sum,
+                                                        &challenges[child * CSIGMA_SCALAR_BYTES]);
+            }
+            crypto_core_ristretto255_scalar_sub(&challenges[real * CSIGMA_SCALAR_BYTES], challenge,
+                                                sum);
+        }
+    }
+
+    // OR-branch challenges, the last child of each disjunction being implied
+    for (size_t i = 0; i < num_nodes; i++) {
+        const composition_node_t* node = &composition->nodes[i];
+        if (node->kind != CSIGMA_NODE_OR)
+            continue;
+        for (size_t k = 0; k + 1 < node->num_children; k++) {
+            memcpy(&proof[layout.challenge_offsets[i] + k * CSIGMA_SCALAR_BYTES],
+                   &challenges[node->children[k] * CSIGMA_SCALAR_BYTES], CSIGMA_SCALAR_BYTES);
+        }
+    }
+    ret = 0;
+
+done:
+    if (states && committed) {
+        for (size_t i = 0; i < num_nodes; i++) {
+            if (committed[i])
+                csigma_prover_state_destroy(&states[i]);
+        }
+    }
+    if (challenges)
+        sodium_memzero(challenges, num_nodes * CSIGMA_SCALAR_BYTES);
+    free(known);
+    free(simulated);
+    free(committed);
+    free(challenges);
+    free(states);
+    layout_destroy(&layout);
+    return ret;
+}
+
+// ============================================================================
+// Verifier
+// ============================================================================
+
+bool
+csigma_composition_verify(const uint8_t* proof, size_t proof_len,
+                          const csigma_composition_t* composition, const uint8_t* message,
+                          size_t message_len)
+{
+    if (!proof || !composition || validate_tree(composition) != 0)
+        return false;
+
+    size_t         num_nodes = composition->num_nodes;
+    size_t         root      = num_nodes - 1;
+    proof_layout_t layout;
+    if (layout_init(&layout, composition) != 0)
+        return false;
+    if (proof_len != layout.total_len) {
+        layout_destroy(&layout);
+        return false;
+    }
+
+    uint8_t* challenges = calloc(num_nodes, CSIGMA_SCALAR_BYTES);
+    if (!challenges) {
+        layout_destroy(&layout);
+        return false;
+    }
+
+    csigma_transcript_t transcript;
+    uint8_t             root_challenge[CSIGMA_SCALAR_BYTES];
+    composition_transcript_init(&transcript, composition);
+    generate_challenge(root_challenge, &transcript, proof, layout.challenge_offsets[0], message,
+                       message_len);
+
+    // Recover every node's challenge top-down
+    for (size_t i = num_nodes; i-- > 0;) {
+        const composition_node_t* node = &composition->nodes[i];
+        const uint8_t* challenge = i == root ? root_challenge : &challenges[i * CSIGMA_SCALAR_BYTES];
+
+        if (node->kind == CSIGMA_NODE_AND) {
+            for (size_t k = 0; k < node->num_children; k++) {
+                memcpy(&challenges[node->children[k] * CSIGMA_SCALAR_BYTES], challenge,
+                       CSIGMA_SCALAR_BYTES);
+            }
+        } else if (node->kind == CSIGMA_NODE_OR) {
+            uint8_t sum[CSIGMA_SCALAR_BYTES] = { 0 };
+            for (size_t k = 0; k + 1 < node->num_children; k++) {
+                const uint8_t* stored = &proof[layout.challenge_offsets[i] + k * CSIGMA_SCALAR_BYTES];
+                memcpy(&challenges[node->children[k] * CSIGMA_SCALAR_BYTES], stored,
+                       CSIGMA_SCALAR_BYTES);
+                crypto_core_ristretto255_scalar_add(sum, sum, stored);
+            }
+            int last = node->children[node->num_children - 1];
+            crypto_core_ristretto255_scalar_sub(&challenges[last * CSIGMA_SCALAR_BYTES], challenge,
+                                                sum);
+        }
+    }
+
+    // Every equation of every leaf in one randomized multi-scalar multiplication
+    msm_t msm;
+    msm_init(&msm);
+    bool valid = true;
+    for (size_t i = 0; i < num_nodes && valid; i++) {
+        const composition_node_t* node = &composition->nodes[i];
+        if (node->kind != CSIGMA_NODE_RELATION)
+            continue;
+        valid = linear_relation_append_check(node->relation, &proof[layout.commitment_offsets[i]],
+                                             &challenges[i * CSIGMA_SCALAR_BYTES],
+                                             &proof[layout.response_offsets[i]], &msm) == 0;
+    }
+    valid = valid && msm_is_identity(&msm);
+
+    msm_destroy(&msm);
+    free(challenges);
+    layout_destroy(&layout);
+    return valid;
+}
@@ -0,0 +1,75 @@
+#ifndef COMPOSITION_H
+#define COMPOSITION_H
+
+#include "csigma.h"
+#include "linear_relation.h"
+
+// AND/OR composition of linear relations (spec section 2.3)
+// A composition is a tree whose leaves are linear relations and whose inner nodes
+// are conjunctions (every child holds) or disjunctions (at least one child holds).
+// The whole tree is proven with a single Fiat-Shamir challenge:
+//   - AND: every child is answered with the parent's challenge
+//   - OR: children challenges sum to the parent's challenge; the prover simulates
+//     every branch except one it knows a witness for
+// Verification checks every equation of every leaf with a single multi-scalar
+// multiplication.
+
+typedef enum {
+    CSIGMA_NODE_RELATION, // Leaf: a linear relation
+    CSIGMA_NODE_AND, // Conjunction of children
+    CSIGMA_NODE_OR, // Disjunction of children
+} csigma_node_kind_t;
+
+// Composition node
+typedef struct {
+    csigma_node_kind_t       kind;
+    const linear_relation_t* relation; // Leaf relation (not owned)
+    int*                     children; // Child node indices (inner nodes)
+    size_t                   num_children; // Number of children
+} composition_node_t;
+
+// Composition: nodes are added bottom-up, and the last node added is the root
+typedef struct {
+    composition_node_t* nodes; // Array of nodes
+    size_t              num_nodes; // Number of nodes
+    size_t              capacity; // Allocated capacity
+} csigma_composition_t;
+
+void csigma_composition_init(csigma_composition_t* composition);
+void csigma_composition_destroy(csigma_composition_t* composition);
+
+// Add a leaf relation (the relation must outlive the composition)
+// Returns the node index
+int csigma_composition_add_relation(csigma_composition_t*    composition,
+                                    const linear_relation_t* relation);
+
+// Add a conjunction or disjunction of previously added nodes
+// Every node may be the child of at most one parent
+// Returns the node index, or -1 on invalid children
+int csigma_composition_add_and(csigma_composition_t* composition, const int* children,
+                               size_t num_children);
+int csigma_composition_add_or(csigma_composition_t* composition, const int* children,
+                              size_t num_children);
+
+// Calculate proof size in bytes
+// Layout: leaf commitments || OR-branch challenges || leaf responses
+// Leaves appear in node order; each OR node stores the challenges of all children
+// but the last, which is implied by the parent's challenge
+size_t csigma_composition_proof_size(const csigma_composition_t* composition);
+
+// Prove the composition
+// proof: output buffer of csigma_composition_proof_size() bytes
+// witnesses: array indexed by node; the witness of each leaf relation the prover knows,
+//            NULL for unknown leaves and inner nodes
+// Returns 0 on success, -1 if the witnesses do not satisfy the root or on error
+int csigma_composition_prove(uint8_t* proof, const csigma_composition_t* composition,
+                             const uint8_t* const* witnesses, const uint8_t* message,
+                             size_t message_len);
+
+// Verify a composition proof with a single merged multi-scalar multiplication
+// Returns true if valid, false otherwise
+bool csigma_composition_verify(const uint8_t* proof, size_t proof_len,
+                               const csigma_composition_t* composition, const uint8_t* message,
+                               size_t message_len);
+
+#endif
@@ -0,0 +1,354 @@
+#include "compressed.h"
+#include "transcript.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// Proof Layout (Internal)
+// ============================================================================
+
+// Number of folding rounds: ceil(log2(num_scalars))
+static size_t
+num_rounds(size_t num_scalars)
+{
+    size_t rounds = 0;
+    while (((size_t) 1 << rounds) < num_scalars) {
+        rounds++;
+    }
+    return rounds;
+}
+
+size_t
+csigma_compressed_proof_size(const linear_relation_t* relation)
+{
+    const linear_map_t* map = &relation->map;
+
+    if (map->num_constraints == 0 || linear_relation_validate(relation) != 0)
+        return 0;
+    return map->num_constraints * (1 + 2 * num_rounds(map->num_scalars)) * CSIGMA_POINT_BYTES +
+           CSIGMA_SCALAR_BYTES;
+}
+
+// ============================================================================
+// Fiat-Shamir Transcript (Internal)
+// ============================================================================
+
+// Start a proof transcript: domain and statement
+static void
+start_transcript(csigma_transcript_t* transcript, const linear_relation_t* relation)
+{
+    csigma_transcript_init(transcript, "compressed");
+    csigma_transcript_absorb_relation(transcript, relation);
+}
+
+// Initial challenge over the started transcript, the commitment and the message
+// The 64-byte digest seeds the chain of round challenges
+static void
+generate_challenge(uint8_t digest[64], csigma_transcript_t* transcript,
+                   const linear_relation_t* relation, const uint8_t* commitment,
+                   const uint8_t* message, size_t message_len)
+{
+    csigma_transcript_absorb(transcript, commitment,
+                             relation->map.num_constraints * CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb(transcript, message, message ? message_len : 0);
+    csigma_transcript_squeeze(transcript, digest, 64);
+}
+
+// Round challenge: chains the previous digest with the round's cross terms
+static void
+generate_round_challenge(uint8_t digest[64], const uint8_t* cross_terms, size_t cross_terms_len)
+{
+    csigma_transcript_t transcript;
+    csigma_transcript_init(&transcript, "compressed_round");
+    csigma_transcript_absorb(&transcript, digest, 64);
+    csigma_transcript_absorb(&transcript, cross_terms, cross_terms_len);
+    csigma_transcript_squeeze(&transcript, digest, 64);
+}
+
+// ============================================================================
+// Prover
+// ============================================================================
+
+// Point table of the linear map: columns[row * width + j] = sum of the terms of
+// that row on scalar j (identity where the scalar does not appear)
+static int
+build_columns(const linear_map_t* map, size_t width, uint8_t* columns)
+{
+    memset(columns, 0, map->num_constraints * width * CSIGMA_POINT_BYTES);
+
+    for (size_t i = 0; i < map->num_constraints; i++) {
+        const linear_combination_t* lc = &map->combinations[i];
+
+        for (size_t j = 0; j < lc->num_terms; j++) {
+            const uint8_t* element =
+                &map->group_elements[lc->element_indices[j] * CSIGMA_POINT_BYTES];
+            uint8_t* column = &columns[(i * width + lc->scalar_indices[j]) * CSIGMA_POINT_BYTES];
+            uint8_t  term[CSIGMA_POINT_BYTES];
+
+            if (lc->coefficients) {
+                if (csigma_scalarmult(term, &lc->coefficients[j * CSIGMA_SCALAR_BYTES], element) !=
+                    0)
+                    return -1;
+            } else {
+                memcpy(term, element, CSIGMA_POINT_BYTES);
+            }
+
+            if (sodium_is_zero(column, CSIGMA_POINT_BYTES)) {
+                memcpy(column, term, CSIGMA_POINT_BYTES);
+            } else if (crypto_core_ristretto255_add(column, column, term) != 0) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int
+csigma_compressed_prove(uint8_t* proof, const linear_relation_t* relation,
+                        const uint8_t* witness, const uint8_t* message, size_t message_len)
+{
+    const linear_map_t* map = &relation->map;
+
+    if (!proof || !witness || csigma_compressed_proof_size(relation) == 0)
+        return -1;
+
+    size_t num_constraints = map->num_constraints;
+    size_t rounds          = num_rounds(map->num_scalars);
+    size_t width           = (size_t) 1 << rounds;
+
+    // Scalars are padded with zeros up to a power of two
+    uint8_t* z         = calloc(width, CSIGMA_SCALAR_BYTES);
+    uint8_t* columns   = malloc(num_constraints * width * CSIGMA_POINT_BYTES);
+    bool     committed = false;
+    int      ret       = -1;
+
+    prover_state_t state;
+
+    if (!z || !columns)
+        goto done;
+
+    // Standard commitment and response; the response is folded instead of sent
+    csigma_transcript_t transcript;
+    uint8_t             context[CSIGMA_NONCE_CONTEXT_BYTES];
+    start_transcript(&transcript, relation);
+    csigma_transcript_nonce_context(&transcript, message, message_len, context);
+
+    uint8_t* commitment = proof;
+    if (csigma_prover_commit_with_context(relation, witness, context, sizeof(context), commitment,
+                                          &state) != 0)
+        goto done;
+    committed = true;
+
+    uint8_t digest[64];
+    uint8_t challenge[CSIGMA_SCALAR_BYTES];
+    generate_challenge(digest, &transcript, relation, commitment, message, message_len);
+    crypto_core_ristretto255_scalar_reduce(challenge, digest);
+    csigma_prover_response(&state, challenge, z);
+
+    if (build_columns(map, width, columns) != 0)
+        goto done;
+
+    // Folding rounds
+    uint8_t* out = &proof[num_constraints * CSIGMA_POINT_BYTES];
+    for (size_t n = width; n > 1; n /= 2) {
+        size_t   half = n / 2;
+        uint8_t* a    = out;
+        uint8_t* b    = &out[num_constraints * CSIGMA_POINT_BYTES];
+
+        // Cross terms: A = f_right(z_left), B = f_left(z_right)
+        for (size_t i = 0; i < num_constraints; i++) {
+            const uint8_t* left    = &columns[i * width * CSIGMA_POINT_BYTES];
+            const uint8_t* right   = &left[half * CSIGMA_POINT_BYTES];
+            const uint8_t* z_right = &z[half * CSIGMA_SCALAR_BYTES];
+
+            if (csigma_msm(&a[i * CSIGMA_POINT_BYTES], z, right, half) != 0 ||
+                csigma_msm(&b[i * CSIGMA_POINT_BYTES], z_right, left, half) != 0)
+                goto done;
+        }
+
+        uint8_t rho[CSIGMA_SCALAR_BYTES];
+        generate_round_challenge(digest, out, 2 * num_constraints * CSIGMA_POINT_BYTES);
+        crypto_core_ristretto255_scalar_reduce(rho, digest);
+        out += 2 * num_constraints * CSIGMA_POINT_BYTES;
+
+        // z' = z_left + rho * z_right
+        for (size_t j = 0; j < half; j++) {
+            uint8_t* zl = &z[j * CSIGMA_SCALAR_BYTES];
+            uint8_t  t[CSIGMA_SCALAR_BYTES];
+            crypto_core_ristretto255_scalar_mul(t, rho, &z[(half + j) * CSIGMA_SCALAR_BYTES]);
+            crypto_core_ristretto255_scalar_add(zl, zl, t);
+        }
+
+        // columns' = rho * columns_left + columns_right
+        for (size_t i = 0; i < num_constraints; i++) {
+            uint8_t* row = &columns[i * width * CSIGMA_POINT_BYTES];
+            for (size_t j = 0; j < half; j++) {
+                uint8_t*       left  = &row[j * CSIGMA_POINT_BYTES];
+                const uint8_t* right = &row[(half + j) * CSIGMA_POINT_BYTES];
+
+                if (sodium_is_zero(left, CSIGMA_POINT_BYTES)) {
+                    memcpy(left, right, CSIGMA_POINT_BYTES);
+                    continue;
+                }
+                if (csigma_scalarmult(left, rho, left) != 0 ||
+                    crypto_core_ristretto255_add(left, left, right) != 0)
+                    goto done;
+            }
+        }
+    }
+
+    memcpy(out, z, CSIGMA_SCALAR_BYTES);
+    ret = 0;
+
+done:
+    if (committed)
+        csigma_prover_state_destroy(&state);
+    if (z)
+        sodium_memzero(z, width * CSIGMA_SCALAR_BYTES);
+    free(z);
+    free(columns);
+    return ret;
+}
+
+// ============================================================================
+// Verifier
+// ============================================================================
+
+// The folded statement after the last round is z * column = P where
+//   column = sum_j s_j * column_j, with s_j the product of the round challenges
+//            of the rounds in which scalar j sat in the left half
+//   P      = pi * (T + c * (Y - k * K)) + sum_k pi_k * (A_k + rho_k^2 * B_k)
+//            with pi the product of all round challenges and pi_k the product
+//            of the challenges after round k
+// Each equation becomes one row of a single merged multi-scalar multiplication.
+bool
+csigma_compressed_verify(const uint8_t* proof, size_t proof_len,
+                         const linear_relation_t* relation, const uint8_t* message,
+                         size_t message_len)
+{
+    const linear_map_t* map = &relation->map;
+
+    if (!proof || proof_len == 0 || proof_len != csigma_compressed_proof_size(relation))
+        return false;
+
+    size_t         num_constraints = map->num_constraints;
+    size_t         num_scalars     = map->num_scalars;
+    size_t         rounds          = num_rounds(num_scalars);
+    size_t         width           = (size_t) 1 << rounds;
+    size_t         round_len       = 2 * num_constraints * CSIGMA_POINT_BYTES;
+    const uint8_t* commitment      = proof;
+    const uint8_t* cross_terms     = &proof[num_constraints * CSIGMA_POINT_BYTES];
+    const uint8_t* z               = &proof[proof_len - CSIGMA_SCALAR_BYTES];
+
+    uint8_t* rhos    = malloc((rounds + 1) * CSIGMA_SCALAR_BYTES);
+    uint8_t* suffix  = malloc((rounds + 1) * CSIGMA_SCALAR_BYTES);
+    uint8_t* weights = malloc(num_scalars * CSIGMA_SCALAR_BYTES);
+    bool     valid   = false;
+    msm_t    msm;
+    msm_init(&msm);
+
+    if (!rhos || !suffix || !weights)
+        goto done;
+
+    // Replay the transcript
+    csigma_transcript_t transcript;
+    uint8_t             digest[64];
+    uint8_t             challenge[CSIGMA_SCALAR_BYTES];
+    start_transcript(&transcript, relation);
+    generate_challenge(digest, &transcript, relation, commitment, message, message_len);
+    crypto_core_ristretto255_scalar_reduce(challenge, digest);
+    for (size_t k = 0; k < rounds; k++) {
+        generate_round_challenge(digest, &cross_terms[k * round_len], round_len);
+        crypto_core_ristretto255_scalar_reduce(&rhos[k * CSIGMA_SCALAR_BYTES], digest);
+    }
+
+    // suffix[k] = product of rho_l for l >= k (suffix[rounds] = 1)
+    memset(&suffix[rounds * CSIGMA_SCALAR_BYTES], 0, CSIGMA_SCALAR_BYTES);
+    suffix[rounds * CSIGMA_SCALAR_BYTES] = 1;
+    for (size_t k = rounds; k-- > 0;) {
+        crypto_core_ristretto255_scalar_mul(&suffix[k * CSIGMA_SCALAR_BYTES],
+                                            &suffix[(k + 1) * CSIGMA_SCALAR_BYTES],
+                                            &rhos[k * CSIGMA_SCALAR_BYTES]);
+    }
+
+    // weights[j] = z * s_j
+    for (size_t j = 0; j < num_scalars; j++) {
+        uint8_t* w = &weights[j * CSIGMA_SCALAR_BYTES];
+        memcpy(w, z, CSIGMA_SCALAR_BYTES);
+        size_t n = width;
+        for (size_t k = 0; k < rounds; k++, n /= 2) {
+            if ((j & (n - 1)) < n / 2)
+                crypto_core_ristretto255_scalar_mul(w, w, &rhos[k * CSIGMA_SCALAR_BYTES]);
+        }
+    }
+
+    const uint8_t* pi = suffix;
+    uint8_t        pi_c[CSIGMA_SCALAR_BYTES];
+    crypto_core_ristretto255_scalar_mul(pi_c, pi, challenge);
+
+    for (size_t i = 0; i < num_constraints; i++) {
+        const linear_combination_t* lc = &map->combinations[i];
+        uint8_t                     w[CSIGMA_SCALAR_BYTES], scalar[CSIGMA_SCALAR_BYTES];
+        crypto_core_ristretto255_scalar_random(w);
+
+        // w * z * s_j * coefficient on each element
+        for (size_t j = 0; j < lc->num_terms; j++) {
+            crypto_core_ristretto255_scalar_mul(
+                scalar, w, &weights[lc->scalar_indices[j] * CSIGMA_SCALAR_BYTES]);
+            if (lc->coefficients) {
+                crypto_core_ristretto255_scalar_mul(scalar, scalar,
+                                                    &lc->coefficients[j * CSIGMA_SCALAR_BYTES]);
+            }
+            if (msm_add_term(&msm, scalar,
+                             &map->group_elements[lc->element_indices[j] * CSIGMA_POINT_BYTES]) !=
+                0)
+                goto done;
+        }
+
+        // -w * pi * commitment
+        crypto_core_ristretto255_scalar_mul(scalar, w, pi);
+        crypto_core_ristretto255_scalar_negate(scalar, scalar);
+        if (msm_add_term(&msm, scalar, &commitment[i * CSIGMA_POINT_BYTES]) != 0)
+            goto done;
+
+        // -w * pi * challenge * image
+        crypto_core_ristretto255_scalar_mul(scalar, w, pi_c);
+        crypto_core_ristretto255_scalar_negate(scalar, scalar);
+        if (msm_add_term(&msm, scalar, &relation->image[i * CSIGMA_POINT_BYTES]) != 0)
+            goto done;
+
+        // +w * pi * challenge * k * constant
+        if (lc->constant_index >= 0) {
+            crypto_core_ristretto255_scalar_mul(scalar, w, pi_c);
+            crypto_core_ristretto255_scalar_mul(scalar, scalar, lc->constant_coefficient);
+            if (msm_add_term(&msm, scalar,
+                             &map->group_elements[lc->constant_index * CSIGMA_POINT_BYTES]) != 0)
+                goto done;
+        }
+
+        // -w * pi_k * (A_k + rho_k^2 * B_k)
+        for (size_t k = 0; k < rounds; k++) {
+            const uint8_t* a   = &cross_terms[k * round_len + i * CSIGMA_POINT_BYTES];
+            const uint8_t* b   = &a[num_constraints * CSIGMA_POINT_BYTES];
+            const uint8_t* rho = &rhos[k * CSIGMA_SCALAR_BYTES];
+
+            crypto_core_ristretto255_scalar_mul(scalar, w, &suffix[(k + 1) * CSIGMA_SCALAR_BYTES]);
+            crypto_core_ristretto255_scalar_negate(scalar, scalar);
+            if (msm_add_term(&msm, scalar, a) != 0)
+                goto done;
+            crypto_core_ristretto255_scalar_mul(scalar, scalar, rho);
+            crypto_core_ristretto255_scalar_mul(scalar, scalar, rho);
+            if (msm_add_term(&msm, scalar, b) != 0)
+                goto done;
+        }
+    }
+
+    valid = msm_is_identity(&msm);
+
+done:
+    msm_destroy(&msm);
+    free(rhos);
+    free(suffix);
+    free(weights);
+    return valid;
+}
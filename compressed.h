@@ -0,0 +1,40 @@
+#ifndef COMPRESSED_H
+#define COMPRESSED_H
+
+#include "csigma.h"
+#include "linear_relation.h"
+
+// Compressed Sigma protocols (Attema-Cramer)
+// A standard proof carries one response scalar per witness scalar. In compressed
+// mode the prover does not send the response z; instead it proves knowledge of z
+// such that linear_map(z) = commitment + challenge * (image - constant) with a
+// folding argument: each round halves the number of scalars by sending two cross
+// terms per equation, until a single scalar remains.
+//
+// For a relation with m equations and n scalars the proof holds
+// m * (1 + 2 * ceil(log2(n))) points and one scalar, instead of m points and n scalars.
+// The verifier unrolls every folding round into one multi-scalar multiplication over
+// the relation's group elements, so verification stays linear in the relation size.
+//
+// Compressed mode pays off for relations with many scalars and few equations
+// (for example vector commitments); the prover keeps an n x m table of points.
+
+// Calculate compressed proof size in bytes
+// Layout: commitment (m points) || per round: A (m points) || B (m points) || final scalar
+// Returns 0 if the relation is malformed or has no equations
+size_t csigma_compressed_proof_size(const linear_relation_t* relation);
+
+// Prove the relation in compressed form
+// proof: output buffer of csigma_compressed_proof_size() bytes
+// witness: array of num_scalars 32-byte scalars
+// Returns 0 on success, -1 on error
+int csigma_compressed_prove(uint8_t* proof, const linear_relation_t* relation,
+                            const uint8_t* witness, const uint8_t* message, size_t message_len);
+
+// Verify a compressed proof with a single multi-scalar multiplication
+// Returns true if valid, false otherwise
+bool csigma_compressed_verify(const uint8_t* proof, size_t proof_len,
+                              const linear_relation_t* relation, const uint8_t* message,
+                              size_t message_len);
+
+#endif
@@ -0,0 +1,241 @@
+#include "elgamal.h"
+#include "amortized.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Batches at least this large are processed on several threads
+#define ELGAMAL_PARALLEL_THRESHOLD 256
+
+// Upper bound on batch threads
+#define ELGAMAL_MAX_THREADS 8
+
+int
+csigma_elgamal_encrypt(uint8_t       ciphertext[CSIGMA_ELGAMAL_CIPHERTEXT_BYTES],
+                       const uint8_t M[CSIGMA_POINT_BYTES], const uint8_t r[CSIGMA_SCALAR_BYTES],
+                       const uint8_t G[CSIGMA_POINT_BYTES], const uint8_t Y[CSIGMA_POINT_BYTES])
+{
+    uint8_t rY[CSIGMA_POINT_BYTES];
+
+    if (csigma_scalarmult(&ciphertext[0], r, G) != 0 || csigma_scalarmult(rY, r, Y) != 0 ||
+        crypto_core_ristretto255_add(&ciphertext[CSIGMA_POINT_BYTES], M, rY) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+int
+csigma_elgamal_decrypt(uint8_t                  M[CSIGMA_POINT_BYTES],
+                       const uint8_t ciphertext[CSIGMA_ELGAMAL_CIPHERTEXT_BYTES],
+                       const uint8_t            x[CSIGMA_SCALAR_BYTES])
+{
+    uint8_t xA[CSIGMA_POINT_BYTES];
+
+    if (csigma_scalarmult(xA, x, &ciphertext[0]) != 0 ||
+        crypto_core_ristretto255_sub(M, &ciphertext[CSIGMA_POINT_BYTES], xA) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+int
+csigma_elgamal_reencrypt(uint8_t       output[CSIGMA_ELGAMAL_CIPHERTEXT_BYTES],
+                         const uint8_t input[CSIGMA_ELGAMAL_CIPHERTEXT_BYTES],
+                         const uint8_t s[CSIGMA_SCALAR_BYTES], const uint8_t G[CSIGMA_POINT_BYTES],
+                         const uint8_t Y[CSIGMA_POINT_BYTES])
+{
+    uint8_t sG[CSIGMA_POINT_BYTES], sY[CSIGMA_POINT_BYTES];
+
+    if (csigma_scalarmult(sG, s, G) != 0 || csigma_scalarmult(sY, s, Y) != 0 ||
+        crypto_core_ristretto255_add(&output[0], &input[0], sG) != 0 ||
+        crypto_core_ristretto255_add(&output[CSIGMA_POINT_BYTES], &input[CSIGMA_POINT_BYTES],
+                                     sY) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// ============================================================================
+// Batch Processing (Internal)
+// ============================================================================
+
+// One share of a batch: re-encryption when randomness is set, otherwise the
+// differences outputs - inputs (the images of the re-encryption statements)
+typedef struct {
+    uint8_t*       outputs;
+    const uint8_t* inputs;
+    const uint8_t* others;
+    const uint8_t* randomness;
+    const uint8_t* G;
+    const uint8_t* Y;
+    size_t         first;
+    size_t         last;
+    int            ret;
+} batch_job_t;
+
+static void*
+batch_worker(void* arg)
+{
+    batch_job_t* job = arg;
+
+    job->ret = 0;
+    for (size_t j = job->first; j < job->last; j++) {
+        uint8_t*       out = &job->outputs[j * CSIGMA_ELGAMAL_CIPHERTEXT_BYTES];
+        const uint8_t* in  = &job->inputs[j * CSIGMA_ELGAMAL_CIPHERTEXT_BYTES];
+
+        if (job->randomness) {
+            if (csigma_elgamal_reencrypt(out, in, &job->randomness[j * CSIGMA_SCALAR_BYTES],
+                                         job->G, job->Y) != 0) {
+                job->ret = -1;
+                return NULL;
+            }
+        } else {
+            const uint8_t* other = &job->others[j * CSIGMA_ELGAMAL_CIPHERTEXT_BYTES];
+            if (crypto_core_ristretto255_sub(&out[0], &other[0], &in[0]) != 0 ||
+                crypto_core_ristretto255_sub(&out[CSIGMA_POINT_BYTES], &other[CSIGMA_POINT_BYTES],
+                                             &in[CSIGMA_POINT_BYTES]) != 0) {
+                job->ret = -1;
+                return NULL;
+            }
+        }
+    }
+    return NULL;
+}
+
+// Split a batch evenly across threads; the calling thread takes the first share
+static int
+run_batch(const batch_job_t* template, size_t n)
+{
+    long num_threads = 1;
+    if (n >= ELGAMAL_PARALLEL_THRESHOLD) {
+        num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+        if (num_threads > ELGAMAL_MAX_THREADS) {
+            num_threads = ELGAMAL_MAX_THREADS;
+        }
+    }
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+
+    pthread_t   threads[ELGAMAL_MAX_THREADS];
+    bool        started[ELGAMAL_MAX_THREADS] = { false };
+    batch_job_t jobs[ELGAMAL_MAX_THREADS];
+    for (long t = 0; t < num_threads; t++) {
+        jobs[t]       = *template;
+        jobs[t].first = n * (size_t) t / (size_t) num_threads;
+        jobs[t].last  = n * (size_t) (t + 1) / (size_t) num_threads;
+    }
+    for (long t = 1; t < num_threads; t++) {
+        started[t] = pthread_create(&threads[t], NULL, batch_worker, &jobs[t]) == 0;
+        if (!started[t]) {
+            batch_worker(&jobs[t]);
+        }
+    }
+    batch_worker(&jobs[0]);
+
+    int ret = jobs[0].ret;
+    for (long t = 1; t < num_threads; t++) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        }
+        if (jobs[t].ret != 0) {
+            ret = -1;
+        }
+    }
+    return ret;
+}
+
+int
+csigma_elgamal_reencrypt_batch(uint8_t* outputs, const uint8_t* inputs, const uint8_t* randomness,
+                               size_t n, const uint8_t G[CSIGMA_POINT_BYTES],
+                               const uint8_t Y[CSIGMA_POINT_BYTES])
+{
+    if (!outputs || !inputs || !randomness || !G || !Y)
+        return -1;
+
+    batch_job_t job = { .outputs = outputs, .inputs = inputs, .randomness = randomness,
+                        .G = G, .Y = Y };
+    return run_batch(&job, n);
+}
+
+// ============================================================================
+// Re-encryption Proofs
+// ============================================================================
+
+// Shared DLEQ shape (s*G, s*Y); its own image is not used by amortized proofs (internal)
+static void
+build_relation(linear_relation_t* relation, const uint8_t G[CSIGMA_POINT_BYTES],
+               const uint8_t Y[CSIGMA_POINT_BYTES])
+{
+    csigma_relation_init(relation);
+    int var_s = csigma_relation_add_scalar(relation);
+    int var_G = csigma_relation_add_element(relation, G);
+    int var_Y = csigma_relation_add_element(relation, Y);
+    csigma_relation_add_equation_simple(relation, var_G, var_s, var_G);
+    csigma_relation_add_equation_simple(relation, var_Y, var_s, var_Y);
+}
+
+// Images of the re-encryption statements: outputs - inputs (internal)
+static uint8_t*
+compute_differences(const uint8_t* inputs, const uint8_t* outputs, size_t n)
+{
+    uint8_t* differences = malloc(n * CSIGMA_ELGAMAL_CIPHERTEXT_BYTES);
+    if (!differences)
+        return NULL;
+
+    batch_job_t job = { .outputs = differences, .inputs = inputs, .others = outputs };
+    if (run_batch(&job, n) != 0) {
+        free(differences);
+        return NULL;
+    }
+    return differences;
+}
+
+int
+csigma_elgamal_reencryption_prove(uint8_t proof[CSIGMA_ELGAMAL_REENCRYPTION_PROOF_SIZE],
+                                  const uint8_t* inputs, const uint8_t* outputs,
+                                  const uint8_t* randomness, size_t n,
+                                  const uint8_t G[CSIGMA_POINT_BYTES],
+                                  const uint8_t Y[CSIGMA_POINT_BYTES], const uint8_t* message,
+                                  size_t message_len)
+{
+    if (!proof || !inputs || !outputs || !randomness || n == 0 || !G || !Y)
+        return -1;
+
+    uint8_t* differences = compute_differences(inputs, outputs, n);
+    if (!differences)
+        return -1;
+
+    linear_relation_t relation;
+    build_relation(&relation, G, Y);
+    int ret = csigma_amortized_prove(proof, &relation, differences, randomness, n, message,
+                                     message_len);
+    csigma_relation_destroy(&relation);
+    free(differences);
+    return ret;
+}
+
+bool
+csigma_elgamal_reencryption_verify(const uint8_t* proof, size_t proof_len, const uint8_t* inputs,
+                                   const uint8_t* outputs, size_t n,
+                                   const uint8_t G[CSIGMA_POINT_BYTES],
+                                   const uint8_t Y[CSIGMA_POINT_BYTES], const uint8_t* message,
+                                   size_t message_len)
+{
+    if (!proof || !inputs || !outputs || n == 0 || !G || !Y ||
+        proof_len != CSIGMA_ELGAMAL_REENCRYPTION_PROOF_SIZE)
+        return false;
+
+    uint8_t* differences = compute_differences(inputs, outputs, n);
+    if (!differences)
+        return false;
+
+    linear_relation_t relation;
+    build_relation(&relation, G, Y);
+    bool valid = csigma_amortized_verify(proof, proof_len, &relation, differences, n, message,
+                                         message_len);
+    csigma_relation_destroy(&relation);
+    free(differences);
+    return valid;
+}
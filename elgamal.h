@@ -0,0 +1,73 @@
+#ifndef ELGAMAL_H
+#define ELGAMAL_H
+
+#include "csigma.h"
+
+// ElGamal encryption over Ristretto255, for mix networks
+// A ciphertext of a point M under the public key Y = x*G is
+//   (A, B) = (r*G, M + r*Y)
+// and is re-encrypted (re-randomized) by adding (s*G, s*Y) for a fresh s.
+//
+// A re-encryption proof shows that every output ciphertext is a re-encryption of
+// the input ciphertext at the same position: for each j,
+//   output_j - input_j = (s_j*G, s_j*Y)
+// which is one DLEQ statement per ciphertext. All of them are proven together as
+// an amortized proof (see amortized.h): 96 bytes whatever the batch size, proven
+// in linear time and verified with one multi-scalar multiplication.
+//
+// Batch operations run on several threads for large batches.
+
+#define CSIGMA_ELGAMAL_CIPHERTEXT_BYTES (2 * CSIGMA_POINT_BYTES)
+#define CSIGMA_ELGAMAL_REENCRYPTION_PROOF_SIZE (2 * CSIGMA_POINT_BYTES + CSIGMA_SCALAR_BYTES)
+
+// Encrypt a point: ciphertext = (r*G, M + r*Y)
+// Returns 0 on success, -1 on error
+int csigma_elgamal_encrypt(uint8_t       ciphertext[CSIGMA_ELGAMAL_CIPHERTEXT_BYTES],
+                           const uint8_t M[CSIGMA_POINT_BYTES],
+                           const uint8_t r[CSIGMA_SCALAR_BYTES],
+                           const uint8_t G[CSIGMA_POINT_BYTES],
+                           const uint8_t Y[CSIGMA_POINT_BYTES]);
+
+// Decrypt a ciphertext with the secret key x: M = B - x*A
+// Returns 0 on success, -1 on error
+int csigma_elgamal_decrypt(uint8_t       M[CSIGMA_POINT_BYTES],
+                           const uint8_t ciphertext[CSIGMA_ELGAMAL_CIPHERTEXT_BYTES],
+                           const uint8_t x[CSIGMA_SCALAR_BYTES]);
+
+// Re-encrypt a ciphertext: output = input + (s*G, s*Y)
+// output may alias input
+// Returns 0 on success, -1 on error
+int csigma_elgamal_reencrypt(uint8_t       output[CSIGMA_ELGAMAL_CIPHERTEXT_BYTES],
+                             const uint8_t input[CSIGMA_ELGAMAL_CIPHERTEXT_BYTES],
+                             const uint8_t s[CSIGMA_SCALAR_BYTES],
+                             const uint8_t G[CSIGMA_POINT_BYTES],
+                             const uint8_t Y[CSIGMA_POINT_BYTES]);
+
+// Re-encrypt n ciphertexts
+// outputs, inputs: arrays of n ciphertexts
+// randomness: array of n scalars s_j
+// Returns 0 on success, -1 on error
+int csigma_elgamal_reencrypt_batch(uint8_t* outputs, const uint8_t* inputs,
+                                   const uint8_t* randomness, size_t n,
+                                   const uint8_t G[CSIGMA_POINT_BYTES],
+                                   const uint8_t Y[CSIGMA_POINT_BYTES]);
+
+// Prove that outputs_j is a re-encryption of inputs_j with randomness_j, for every j
+// proof: output buffer of CSIGMA_ELGAMAL_REENCRYPTION_PROOF_SIZE bytes
+// Returns 0 on success, -1 on error
+int csigma_elgamal_reencryption_prove(uint8_t proof[CSIGMA_ELGAMAL_REENCRYPTION_PROOF_SIZE],
+                                      const uint8_t* inputs, const uint8_t* outputs,
+                                      const uint8_t* randomness, size_t n,
+                                      const uint8_t G[CSIGMA_POINT_BYTES],
+                                      const uint8_t Y[CSIGMA_POINT_BYTES], const uint8_t* message,
+                                      size_t message_len);
+
+// Verify a batched re-encryption proof
+// Returns true if valid, false otherwise
+bool csigma_elgamal_reencryption_verify(const uint8_t* proof, size_t proof_len,
+                                        const uint8_t* inputs, const uint8_t* outputs, size_t n,
+                                        const uint8_t G[CSIGMA_POINT_BYTES],
+                                        const uint8_t Y[CSIGMA_POINT_BYTES],
+                                        const uint8_t* message, size_t message_len);
+
+#endif
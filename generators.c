@@ -0,0 +1,283 @@
+#include "generators.h"
+#include "keccak.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Requests at least this large are derived on several threads
+#define GENERATORS_PARALLEL_THRESHOLD 1024
+
+// Upper bound on derivation threads
+#define GENERATORS_MAX_THREADS 8
+
+// Cache file layout: magic || count (8 bytes LE) || label digest || points || checksum
+static const uint8_t cache_magic[8] = { 'C', 'S', 'G', 'E', 'N', '0', '0', '2' };
+
+#define CACHE_HEADER_BYTES (sizeof(cache_magic) + 8 + 32)
+#define CACHE_CHECKSUM_BYTES 32
+
+// ============================================================================
+// Derivation
+// ============================================================================
+
+// Absorb an integer as I2OSP(value, 8), like the transcript (internal)
+static void
+absorb_u64(shake128_ctx* ctx, uint64_t value)
+{
+    uint8_t bytes[8];
+    for (size_t i = 0; i < 8; i++) {
+        bytes[i] = (uint8_t) (value >> (8 * (7 - i)));
+    }
+    shake128_absorb(ctx, bytes, sizeof(bytes));
+}
+
+// Derive the generators of blocks [first_block, last_block) (internal)
+static int
+derive_blocks(const char* label, size_t label_len, size_t n, size_t first_block,
+              size_t last_block, uint8_t* out)
+{
+    uint8_t hash[CSIGMA_GENERATORS_PER_BLOCK * crypto_core_ristretto255_HASHBYTES];
+
+    for (size_t block = first_block; block < last_block; block++) {
+        size_t first = block * CSIGMA_GENERATORS_PER_BLOCK;
+        size_t count = n - first;
+        if (count > CSIGMA_GENERATORS_PER_BLOCK) {
+            count = CSIGMA_GENERATORS_PER_BLOCK;
+        }
+
+        // One stream per block, squeezed for every generator of the block at once
+        shake128_ctx ctx;
+        shake128_init(&ctx);
+        shake128_absorb(&ctx, (const uint8_t*) "csigma_generators", 17);
+        absorb_u64(&ctx, label_len);
+        shake128_absorb(&ctx, (const uint8_t*) label, label_len);
+        absorb_u64(&ctx, block);
+        shake128_squeeze(&ctx, hash, count * crypto_core_ristretto255_HASHBYTES);
+
+        for (size_t i = 0; i < count; i++) {
+            if (crypto_core_ristretto255_from_hash(
+                    &out[(first + i) * CSIGMA_POINT_BYTES],
+                    &hash[i * crypto_core_ristretto255_HASHBYTES]) != 0) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+// Derivation job for one thread (internal)
+typedef struct {
+    const char* label;
+    size_t      label_len;
+    size_t      n;
+    size_t      first_block;
+    size_t      last_block;
+    uint8_t*    out;
+    int         ret;
+} derive_job_t;
+
+static void*
+derive_worker(void* arg)
+{
+    derive_job_t* job = arg;
+    job->ret = derive_blocks(job->label, job->label_len, job->n, job->first_block,
+                             job->last_block, job->out);
+    return NULL;
+}
+
+int
+csigma_derive_generators(const char* label, size_t n, uint8_t* out)
+{
+    if (!label || (n > 0 && !out)) {
+        return -1;
+    }
+
+    size_t label_len  = strlen(label);
+    size_t num_blocks = (n + CSIGMA_GENERATORS_PER_BLOCK - 1) / CSIGMA_GENERATORS_PER_BLOCK;
+
+    long num_threads = 1;
+    if (n >= GENERATORS_PARALLEL_THRESHOLD) {
+        num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+        if (num_threads > GENERATORS_MAX_THREADS) {
+            num_threads = GENERATORS_MAX_THREADS;
+        }
+        if (num_threads > (long) num_blocks) {
+            num_threads = (long) num_blocks;
+        }
+    }
+    if (num_threads <= 1) {
+        return derive_blocks(label, label_len, n, 0, num_blocks, out);
+    }
+
+    // Split the blocks evenly; the calling thread takes the first share
+    pthread_t    threads[GENERATORS_MAX_THREADS];
+    bool         started[GENERATORS_MAX_THREADS] = { false };
+    derive_job_t jobs[GENERATORS_MAX_THREADS];
+    for (long t = 0; t < num_threads; t++) {
+        jobs[t].label       = label;
+        jobs[t].label_len   = label_len;
+        jobs[t].n           = n;
+        jobs[t].first_block = num_blocks * (size_t) t / (size_t) num_threads;
+        jobs[t].last_block  = num_blocks * (size_t) (t + 1) / (size_t) num_threads;
+        jobs[t].out         = out;
+        jobs[t].ret         = 0;
+    }
+    for (long t = 1; t < num_threads; t++) {
+        started[t] = pthread_create(&threads[t], NULL, derive_worker, &jobs[t]) == 0;
+        if (!started[t]) {
+            derive_worker(&jobs[t]);
+        }
+    }
+    derive_worker(&jobs[0]);
+
+    int ret = jobs[0].ret;
+    for (long t = 1; t < num_threads; t++) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        }
+        if (jobs[t].ret != 0) {
+            ret = -1;
+        }
+    }
+    return ret;
+}
+
+// ============================================================================
+// Persistent Cache
+// ============================================================================
+
+// Checksum of the cache contents preceding it (internal)
+static void
+cache_checksum(uint8_t checksum[CACHE_CHECKSUM_BYTES], const uint8_t* data, size_t len)
+{
+    shake128_ctx ctx;
+    shake128_init(&ctx);
+    shake128_absorb(&ctx, (const uint8_t*) "csigma_generators_cache", 23);
+    shake128_absorb(&ctx, data, len);
+    shake128_squeeze(&ctx, checksum, CACHE_CHECKSUM_BYTES);
+}
+
+// Cache header for a label and a generator count (internal)
+static void
+cache_header(uint8_t header[CACHE_HEADER_BYTES], const char* label, size_t count)
+{
+    memcpy(header, cache_magic, sizeof(cache_magic));
+    for (size_t i = 0; i < 8; i++) {
+        header[sizeof(cache_magic) + i] = (uint8_t) ((uint64_t) count >> (8 * i));
+    }
+    shake128(&header[sizeof(cache_magic) + 8], 32, (const uint8_t*) label, strlen(label));
+}
+
+// Load the first n generators from a cache file (internal)
+// Returns 0 if the file is intact and holds at least n generators for the label
+static int
+cache_load(const char* cache_path, const char* label, size_t n, uint8_t* out)
+{
+    FILE* fp = fopen(cache_path, "rb");
+    if (!fp) {
+        return -1;
+    }
+
+    uint8_t header[CACHE_HEADER_BYTES], expected[CACHE_HEADER_BYTES];
+    uint8_t checksum[CACHE_CHECKSUM_BYTES], computed[CACHE_CHECKSUM_BYTES];
+    uint8_t* data = NULL;
+    int      ret  = -1;
+
+    if (fread(header, 1, sizeof(header), fp) != sizeof(header)) {
+        goto done;
+    }
+
+    uint64_t count = 0;
+    for (size_t i = 0; i < 8; i++) {
+        count |= (uint64_t) header[sizeof(cache_magic) + i] << (8 * i);
+    }
+    cache_header(expected, label, (size_t) count);
+    if (memcmp(header, expected, sizeof(header)) != 0 || count < n ||
+        count > SIZE_MAX / CSIGMA_POINT_BYTES - CACHE_HEADER_BYTES) {
+        goto done;
+    }
+
+    // The checksum covers every stored generator, so read them all
+    size_t len = CACHE_HEADER_BYTES + (size_t) count * CSIGMA_POINT_BYTES;
+    data       = malloc(len);
+    if (!data) {
+        goto done;
+    }
+    memcpy(data, header, sizeof(header));
+    if (fread(&data[sizeof(header)], 1, len - sizeof(header), fp) != len - sizeof(header) ||
+        fread(checksum, 1, sizeof(checksum), fp) != sizeof(checksum)) {
+        goto done;
+    }
+    cache_checksum(computed, data, len);
+    if (memcmp(checksum, computed, sizeof(checksum)) != 0) {
+        goto done;
+    }
+
+    memcpy(out, &data[sizeof(header)], n * CSIGMA_POINT_BYTES);
+    ret = 0;
+
+done:
+    free(data);
+    fclose(fp);
+    return ret;
+}
+
+// Write n generators to a cache file, atomically replacing it (internal)
+static int
+cache_store(const char* cache_path, const char* label, size_t n, const uint8_t* generators)
+{
+    size_t path_len = strlen(cache_path);
+    char*  tmp_path = malloc(path_len + 5);
+    if (!tmp_path) {
+        return -1;
+    }
+    memcpy(tmp_path, cache_path, path_len);
+    memcpy(&tmp_path[path_len], ".tmp", 5);
+
+    size_t   len  = CACHE_HEADER_BYTES + n * CSIGMA_POINT_BYTES;
+    uint8_t* data = malloc(len + CACHE_CHECKSUM_BYTES);
+    int      ret  = -1;
+    if (data) {
+        cache_header(data, label, n);
+        memcpy(&data[CACHE_HEADER_BYTES], generators, n * CSIGMA_POINT_BYTES);
+        cache_checksum(&data[len], data, len);
+
+        FILE* fp = fopen(tmp_path, "wb");
+        if (fp) {
+            bool written = fwrite(data, 1, len + CACHE_CHECKSUM_BYTES, fp) ==
+                           len + CACHE_CHECKSUM_BYTES;
+            if (fclose(fp) == 0 && written && rename(tmp_path, cache_path) == 0) {
+                ret = 0;
+            } else {
+                remove(tmp_path);
+            }
+        }
+    }
+
+    free(data);
+    free(tmp_path);
+    return ret;
+}
+
+int
+csigma_derive_generators_cached(const char* label, size_t n, uint8_t* out,
+                                const char* cache_path)
+{
+    if (!label || (n > 0 && !out)) {
+        return -1;
+    }
+    if (!cache_path) {
+        return csigma_derive_generators(label, n, out);
+    }
+
+    if (cache_load(cache_path, label, n, out) == 0) {
+        return 0;
+    }
+    if (csigma_derive_generators(label, n, out) != 0) {
+        return -1;
+    }
+    cache_store(cache_path, label, n, out);
+    return 0;
+}
@@ -0,0 +1,35 @@
+#ifndef GENERATORS_H
+#define GENERATORS_H
+
+#include "csigma.h"
+
+// Deterministic generator derivation (hash-to-group)
+// Derives independent "nothing-up-my-sleeve" generators from a label, so that no
+// one knows the discrete logarithm of any generator with respect to another.
+//
+// Generator i is crypto_core_ristretto255_from_hash() of 64 bytes of SHAKE128 output.
+// Generators are derived in blocks of CSIGMA_GENERATORS_PER_BLOCK; each block is one
+// SHAKE128 stream over the label and the block index, squeezed for the whole block.
+// Blocks are independent, so large requests are derived on several threads, and the
+// first k generators of a label are the same whatever n is requested.
+
+// Number of generators squeezed from one SHAKE128 stream
+#define CSIGMA_GENERATORS_PER_BLOCK 64
+
+// Derive n generators for a label
+// label: NUL-terminated domain separation label
+// out: output array of n 32-byte points
+// Returns 0 on success, -1 on error
+int csigma_derive_generators(const char* label, size_t n, uint8_t* out);
+
+// Derive n generators for a label, using a persistent cache file
+// If cache_path holds at least n generators for the same label, they are loaded
+// from it; otherwise they are derived and the cache file is (re)written.
+// The file carries a checksum against truncation and corruption; it must be
+// protected like the application itself, since it defines the generators.
+// Failing to write the cache is not an error.
+// Returns 0 on success, -1 on error
+int csigma_derive_generators_cached(const char* label, size_t n, uint8_t* out,
+                                    const char* cache_path);
+
+#endif
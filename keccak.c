@@ -1,7 +1,7 @@
 #include "keccak.h"
 #include <string.h>
 
-// Reference Keccak implementation based on the official specification
+// Keccak implementation based on the official specification
 static const uint64_t keccakf_rndc[24] = {
     0x0000000000000001, 0x0000000000008082, 0x800000000000808a, 0x8000000080008000,
     0x000000000000808b, 0x0000000080000001, 0x8000000080008081, 0x8000000000008009,
@@ -11,58 +11,76 @@ static const uint64_t keccakf_rndc[24] = {
     0x8000000080008081, 0x8000000000008080, 0x0000000080000001, 0x8000000080008008
 };
 
-static const int keccakf_rotc[24] = { 1,  3,  6,  10, 15, 21, 28, 36, 45, 55, 2,  14,
-                                      27, 41, 56, 8,  25, 43, 62, 18, 39, 61, 20, 44 };
-
-static const int keccakf_piln[24] = { 10, 7,  11, 17, 18, 3, 5,  16, 8,  21, 24, 4,
-                                      15, 23, 19, 13, 12, 2, 20, 14, 22, 9,  6,  1 };
-
 #define ROTL64(x, y) (((x) << (y)) | ((x) >> (64 - (y))))
 
-// Fixed Keccak-f[1600] permutation
+// Keccak-p[1600, rounds]: the last rounds rounds of Keccak-f[1600]
+// Theta, rho and pi are merged into one pass over the lanes
 void
-keccak_f1600(uint64_t st[25])
+keccak_p1600(uint64_t a[25], int rounds)
 {
-    int      i, j, r;
-    uint64_t t, bc[5];
+    uint64_t b[25];
 
-    for (r = 0; r < 24; r++) {
+    for (int r = KECCAK_ROUNDS - rounds; r < KECCAK_ROUNDS; r++) {
         // Theta
-        for (i = 0; i < 5; i++) {
-            bc[i] = st[i] ^ st[i + 5] ^ st[i + 10] ^ st[i + 15] ^ st[i + 20];
-        }
-
-        for (i = 0; i < 5; i++) {
-            t = bc[(i + 4) % 5] ^ ROTL64(bc[(i + 1) % 5], 1);
-            for (j = 0; j < 25; j += 5) {
-                st[j + i] ^= t;
-            }
-        }
+        uint64_t c0 = a[0] ^ a[5] ^ a[10] ^ a[15] ^ a[20];
+        uint64_t c1 = a[1] ^ a[6] ^ a[11] ^ a[16] ^ a[21];
+        uint64_t c2 = a[2] ^ a[7] ^ a[12] ^ a[17] ^ a[22];
+        uint64_t c3 = a[3] ^ a[8] ^ a[13] ^ a[18] ^ a[23];
+        uint64_t c4 = a[4] ^ a[9] ^ a[14] ^ a[19] ^ a[24];
+        uint64_t d0 = c4 ^ ROTL64(c1, 1);
+        uint64_t d1 = c0 ^ ROTL64(c2, 1);
+        uint64_t d2 = c1 ^ ROTL64(c3, 1);
+        uint64_t d3 = c2 ^ ROTL64(c4, 1);
+        uint64_t d4 = c3 ^ ROTL64(c0, 1);
 
         // Rho Pi
-        t = st[1];
-        for (i = 0; i < 24; i++) {
-            j     = keccakf_piln[i];
-            bc[0] = st[j];
-            st[j] = ROTL64(t, keccakf_rotc[i]);
-            t     = bc[0];
-        }
+        b[0] = a[0] ^ d0;
+        b[1] = ROTL64(a[6] ^ d1, 44);
+        b[2] = ROTL64(a[12] ^ d2, 43);
+        b[3] = ROTL64(a[18] ^ d3, 21);
+        b[4] = ROTL64(a[24] ^ d4, 14);
+        b[5] = ROTL64(a[3] ^ d3, 28);
+        b[6] = ROTL64(a[9] ^ d4, 20);
+        b[7] = ROTL64(a[10] ^ d0, 3);
+        b[8] = ROTL64(a[16] ^ d1, 45);
+        b[9] = ROTL64(a[22] ^ d2, 61);
+        b[10] = ROTL64(a[1] ^ d1, 1);
+        b[11] = ROTL64(a[7] ^ d2, 6);
+        b[12] = ROTL64(a[13] ^ d3, 25);
+        b[13] = ROTL64(a[19] ^ d4, 8);
+        b[14] = ROTL64(a[20] ^ d0, 18);
+        b[15] = ROTL64(a[4] ^ d4, 27);
+        b[16] = ROTL64(a[5] ^ d0, 36);
+        b[17] = ROTL64(a[11] ^ d1, 10);
+        b[18] = ROTL64(a[17] ^ d2, 15);
+        b[19] = ROTL64(a[23] ^ d3, 56);
+        b[20] = ROTL64(a[2] ^ d2, 62);
+        b[21] = ROTL64(a[8] ^ d3, 55);
+        b[22] = ROTL64(a[14] ^ d4, 39);
+        b[23] = ROTL64(a[15] ^ d0, 41);
+        b[24] = ROTL64(a[21] ^ d1, 2);
 
         // Chi
-        for (j = 0; j < 25; j += 5) {
-            for (i = 0; i < 5; i++) {
-                bc[i] = st[j + i];
-            }
-            for (i = 0; i < 5; i++) {
-                st[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
-            }
+        for (int j = 0; j < 25; j += 5) {
+            a[j + 0] = b[j + 0] ^ (~b[j + 1] & b[j + 2]);
+            a[j + 1] = b[j + 1] ^ (~b[j + 2] & b[j + 3]);
+            a[j + 2] = b[j + 2] ^ (~b[j + 3] & b[j + 4]);
+            a[j + 3] = b[j + 3] ^ (~b[j + 4] & b[j + 0]);
+            a[j + 4] = b[j + 4] ^ (~b[j + 0] & b[j + 1]);
         }
 
         // Iota
-        st[0] ^= keccakf_rndc[r];
+        a[0] ^= keccakf_rndc[r];
     }
 }
 
+// Fixed Keccak-f[1600] permutation
+void
+keccak_f1600(uint64_t st[25])
+{
+    keccak_p1600(st, KECCAK_ROUNDS);
+}
+
 void
 shake128_init(shake128_ctx* ctx)
 {
@@ -70,9 +88,18 @@ shake128_init(shake128_ctx* ctx)
     ctx->rate      = 168; // SHAKE128 rate = 1344/8 = 168 bytes
     ctx->pos       = 0;
     ctx->delim     = 0x1F; // SHAKE128 domain separator
+    ctx->rounds    = KECCAK_ROUNDS;
     ctx->squeezing = 0;
 }
 
+void
+turboshake128_init(shake128_ctx* ctx, uint8_t domain)
+{
+    shake128_init(ctx);
+    ctx->delim  = domain;
+    ctx->rounds = TURBOSHAKE_ROUNDS;
+}
+
 void
 shake128_absorb(shake128_ctx* ctx, const uint8_t* data, size_t len)
 {
@@ -80,15 +107,34 @@ shake128_absorb(shake128_ctx* ctx, const uint8_t* data, size_t len)
         return; // Cannot absorb after squeezing starts
     }
 
-    for (size_t i = 0; i < len; i++) {
-        ((uint8_t*) ctx->state)[ctx->pos] ^= data[i];
-        ctx->pos++;
+    uint8_t* bytes = (uint8_t*) ctx->state;
 
+    // Complete a partially filled block
+    while (ctx->pos != 0 && len > 0) {
+        bytes[ctx->pos++] ^= *data++;
+        len--;
         if (ctx->pos == ctx->rate) {
-            keccak_f1600(ctx->state);
+            keccak_p1600(ctx->state, ctx->rounds);
             ctx->pos = 0;
         }
     }
+
+    // Whole blocks, one lane at a time (the state is laid out in host byte order)
+    while (len >= ctx->rate) {
+        for (size_t i = 0; i < ctx->rate / 8; i++) {
+            uint64_t lane;
+            memcpy(&lane, &data[i * 8], 8);
+            ctx->state[i] ^= lane;
+        }
+        keccak_p1600(ctx->state, ctx->rounds);
+        data += ctx->rate;
+        len -= ctx->rate;
+    }
+
+    // Start the next block
+    for (size_t i = 0; i < len; i++) {
+        bytes[ctx->pos++] ^= data[i];
+    }
 }
 
 void
@@ -102,7 +148,7 @@ shake128_finalize(shake128_ctx* ctx)
     ((uint8_t*) ctx->state)[ctx->pos] ^= ctx->delim;
     ((uint8_t*) ctx->state)[ctx->rate - 1] ^= 0x80;
 
-    keccak_f1600(ctx->state);
+    keccak_p1600(ctx->state, ctx->rounds);
     ctx->pos       = 0;
     ctx->squeezing = 1;
 }
@@ -114,13 +160,20 @@ shake128_squeeze(shake128_ctx* ctx, uint8_t* out, size_t len)
         shake128_finalize(ctx);
     }
 
-    for (size_t i = 0; i < len; i++) {
+    // Copy whole runs of the rate portion at a time
+    while (len > 0) {
         if (ctx->pos == ctx->rate) {
-            keccak_f1600(ctx->state);
+            keccak_p1600(ctx->state, ctx->rounds);
             ctx->pos = 0;
         }
-        out[i] = ((uint8_t*) ctx->state)[ctx->pos];
-        ctx->pos++;
+        size_t n = ctx->rate - ctx->pos;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(out, &((uint8_t*) ctx->state)[ctx->pos], n);
+        ctx->pos += n;
+        out += n;
+        len -= n;
     }
 }
 
@@ -7,16 +7,24 @@
 #define KECCAK_ROUNDS 24
 
 void keccak_f1600(uint64_t state[25]);
+void keccak_p1600(uint64_t state[25], int rounds);
+
+#define TURBOSHAKE_ROUNDS 12
 
 typedef struct {
     uint64_t state[25]; // 1600 bits
-    size_t   rate; // Rate in bytes (136 for SHAKE128)
+    size_t   rate; // Rate in bytes (168 for SHAKE128 and TurboSHAKE128)
     size_t   pos; // Current position in buffer
     uint8_t  delim; // Domain separation byte
+    uint8_t  rounds; // Permutation rounds (24, or 12 for TurboSHAKE)
     int      squeezing; // 0 = absorbing, 1 = squeezing
 } shake128_ctx;
 
 void shake128_init(shake128_ctx* ctx);
+
+// TurboSHAKE128: the SHAKE128 sponge over Keccak-p[1600, 12], with a domain separation
+// byte in 0x01..0x7F (0x1F by default)
+void turboshake128_init(shake128_ctx* ctx, uint8_t domain);
 void shake128_absorb(shake128_ctx* ctx, const uint8_t* data, size_t len);
 void shake128_finalize(shake128_ctx* ctx);
 void shake128_squeeze(shake128_ctx* ctx, uint8_t* out, size_t len);
@@ -0,0 +1,273 @@
+#include "key_cache.h"
+#include "msm.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define NO_ENTRY UINT32_MAX
+
+int
+csigma_key_cache_init(csigma_key_cache_t* cache, size_t max_bytes)
+{
+    size_t per_entry = sizeof(csigma_key_entry_t) + sizeof(uint32_t);
+    size_t capacity  = max_bytes / (CSIGMA_KEY_CACHE_SHARDS * per_entry);
+    if (capacity == 0) {
+        capacity = 1;
+    }
+    if (capacity >= NO_ENTRY) {
+        capacity = NO_ENTRY - 1;
+    }
+
+    memset(cache, 0, sizeof(*cache));
+    randombytes_buf(cache->hash_key, sizeof(cache->hash_key));
+    uint8_t one[CSIGMA_SCALAR_BYTES] = { 1 };
+    crypto_scalarmult_ristretto255_base(cache->generator, one);
+
+    for (size_t s = 0; s < CSIGMA_KEY_CACHE_SHARDS; s++) {
+        csigma_key_shard_t* shard = &cache->shards[s];
+        shard->entries            = calloc(capacity, sizeof(csigma_key_entry_t));
+        shard->buckets            = malloc(capacity * sizeof(uint32_t));
+        shard->capacity           = capacity;
+        if (!shard->entries || !shard->buckets || pthread_mutex_init(&shard->lock, NULL) != 0) {
+            free(shard->entries);
+            free(shard->buckets);
+            shard->entries = NULL;
+            shard->buckets = NULL;
+            csigma_key_cache_destroy(cache);
+            return -1;
+        }
+        for (size_t b = 0; b < capacity; b++) {
+            shard->buckets[b] = NO_ENTRY;
+        }
+    }
+    return 0;
+}
+
+void
+csigma_key_cache_destroy(csigma_key_cache_t* cache)
+{
+    for (size_t s = 0; s < CSIGMA_KEY_CACHE_SHARDS; s++) {
+        csigma_key_shard_t* shard = &cache->shards[s];
+        if (shard->entries) {
+            pthread_mutex_destroy(&shard->lock);
+        }
+        free(shard->entries);
+        free(shard->buckets);
+        shard->entries  = NULL;
+        shard->buckets  = NULL;
+        shard->capacity = 0;
+    }
+}
+
+void
+csigma_key_cache_stats(csigma_key_cache_t* cache, csigma_key_cache_stats_t* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    for (size_t s = 0; s < CSIGMA_KEY_CACHE_SHARDS; s++) {
+        csigma_key_shard_t* shard = &cache->shards[s];
+        pthread_mutex_lock(&shard->lock);
+        stats->hits += shard->hits;
+        stats->misses += shard->misses;
+        stats->evictions += shard->evictions;
+        stats->entries += shard->count;
+        stats->bytes += shard->capacity * (sizeof(csigma_key_entry_t) + sizeof(uint32_t));
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
+
+// ============================================================================
+// Lookup and Insertion (Internal)
+// ============================================================================
+
+// Find an entry in a locked shard; returns NO_ENTRY if absent
+static uint32_t
+shard_find(const csigma_key_shard_t* shard, uint32_t bucket, const uint8_t* key, size_t key_len)
+{
+    for (uint32_t i = shard->buckets[bucket]; i != NO_ENTRY; i = shard->entries[i].next) {
+        const csigma_key_entry_t* entry = &shard->entries[i];
+        if (entry->key_len == key_len && memcmp(entry->key, key, key_len) == 0) {
+            return i;
+        }
+    }
+    return NO_ENTRY;
+}
+
+// Pick a slot in a locked shard: a free one, or the CLOCK victim
+static uint32_t
+shard_allocate(csigma_key_shard_t* shard)
+{
+    if (shard->count < shard->capacity) {
+        return (uint32_t) shard->count++;
+    }
+
+    // Sweep, clearing reference bits, until an unreferenced entry comes up
+    for (;;) {
+        csigma_key_entry_t* entry = &shard->entries[shard->hand];
+        uint32_t            index = (uint32_t) shard->hand;
+        shard->hand               = (shard->hand + 1) % shard->capacity;
+        if (entry->referenced) {
+            entry->referenced = 0;
+            continue;
+        }
+
+        // Unlink the victim from its bucket
+        uint32_t* link = &shard->buckets[entry->bucket];
+        while (*link != index) {
+            link = &shard->entries[*link].next;
+        }
+        *link = entry->next;
+        shard->evictions++;
+        return index;
+    }
+}
+
+// Look a key up, preparing and inserting it on a miss
+// prefix is the protocol name absorbed before the key, and inputs_len the length of the
+// public inputs message the key starts; the entry is copied out so that no lock is held
+// during verification. An entry prepared under another transcript backend is a miss,
+// and is replaced.
+static void
+cache_get(csigma_key_cache_t* cache, const uint8_t* key, size_t key_len, size_t inputs_len,
+          const char* prefix, csigma_key_entry_t* out)
+{
+    uint8_t hash_bytes[crypto_shorthash_BYTES];
+    crypto_shorthash(hash_bytes, key, key_len, cache->hash_key);
+    uint64_t hash = 0;
+    for (size_t i = 0; i < sizeof(hash_bytes); i++) {
+        hash |= (uint64_t) hash_bytes[i] << (8 * i);
+    }
+
+    csigma_key_shard_t* shard  = &cache->shards[hash % CSIGMA_KEY_CACHE_SHARDS];
+    uint32_t            bucket = (uint32_t) ((hash / CSIGMA_KEY_CACHE_SHARDS) % shard->capacity);
+
+    csigma_hash_t backend = csigma_transcript_get_hash();
+
+    pthread_mutex_lock(&shard->lock);
+    uint32_t index = shard_find(shard, bucket, key, key_len);
+    if (index != NO_ENTRY && shard->entries[index].transcript.hash == backend) {
+        shard->entries[index].referenced = 1;
+        shard->hits++;
+        *out = shard->entries[index];
+        pthread_mutex_unlock(&shard->lock);
+        return;
+    }
+    shard->misses++;
+    pthread_mutex_unlock(&shard->lock);
+
+    // Prepare the entry without holding the lock
+    memset(out, 0, sizeof(*out));
+    memcpy(out->key, key, key_len);
+    out->key_len = (uint8_t) key_len;
+    out->bucket  = bucket;
+    out->valid   = 1;
+    for (size_t offset = 0; offset < key_len; offset += CSIGMA_POINT_BYTES) {
+        if (crypto_core_ristretto255_is_valid_point(&key[offset]) != 1) {
+            out->valid = 0;
+        }
+    }
+    csigma_transcript_init_with(&out->transcript, backend, prefix);
+    csigma_transcript_begin(&out->transcript, inputs_len);
+    csigma_transcript_update(&out->transcript, key, key_len);
+
+    // Another thread may have inserted the same key meanwhile; an entry for another
+    // backend is updated in place
+    pthread_mutex_lock(&shard->lock);
+    index = shard_find(shard, bucket, key, key_len);
+    if (index == NO_ENTRY) {
+        index                      = shard_allocate(shard);
+        shard->entries[index]      = *out;
+        shard->entries[index].next = shard->buckets[bucket];
+        shard->buckets[bucket]     = index;
+    } else if (shard->entries[index].transcript.hash != backend) {
+        shard->entries[index].transcript = out->transcript;
+    }
+    pthread_mutex_unlock(&shard->lock);
+}
+
+// Finish a challenge from a cached transcript (internal)
+// Same messages as the challenges of sigma.c: public inputs, commitment, message. The
+// cached transcript is in the middle of the public inputs; the rest of them follows.
+static void
+finish_challenge(uint8_t challenge[CSIGMA_SCALAR_BYTES], const csigma_transcript_t* transcript,
+                 const csigma_iovec_t* more_inputs, size_t num_more_inputs,
+                 const uint8_t* commitment, size_t commitment_len, const uint8_t* message,
+                 size_t message_len)
+{
+    csigma_transcript_t ctx = *transcript;
+
+    for (size_t i = 0; i < num_more_inputs; i++) {
+        csigma_transcript_update(&ctx, more_inputs[i].data, more_inputs[i].len);
+    }
+    csigma_transcript_absorb(&ctx, commitment, commitment_len);
+    csigma_transcript_absorb(&ctx, message, message ? message_len : 0);
+    csigma_transcript_challenge(&ctx, challenge);
+}
+
+// Check z*base - c*image == commitment (internal)
+static bool
+check_equation(const uint8_t z[CSIGMA_SCALAR_BYTES], const uint8_t base[CSIGMA_POINT_BYTES],
+               const uint8_t c[CSIGMA_SCALAR_BYTES], const uint8_t image[CSIGMA_POINT_BYTES],
+               const uint8_t commitment[CSIGMA_POINT_BYTES])
+{
+    uint8_t z_base[CSIGMA_POINT_BYTES], c_image[CSIGMA_POINT_BYTES], expected[CSIGMA_POINT_BYTES];
+
+    if (csigma_msm(z_base, z, base, 1) != 0 || csigma_scalarmult(c_image, c, image) != 0 ||
+        crypto_core_ristretto255_sub(expected, z_base, c_image) != 0)
+        return false;
+    return sodium_memcmp(expected, commitment, CSIGMA_POINT_BYTES) == 0;
+}
+
+// ============================================================================
+// Cached Verifiers
+// ============================================================================
+
+bool
+csigma_schnorr_verify_cached(csigma_key_cache_t* cache,
+                             const uint8_t       proof[CSIGMA_SCHNORR_PROOF_SIZE],
+                             const uint8_t       public_key[CSIGMA_POINT_BYTES],
+                             const uint8_t* message, size_t message_len)
+{
+    if (!cache || !proof || !public_key)
+        return false;
+
+    csigma_key_entry_t entry;
+    cache_get(cache, public_key, CSIGMA_POINT_BYTES, CSIGMA_POINT_BYTES, "schnorr", &entry);
+    if (!entry.valid)
+        return false;
+
+    // z*G - c*Y == T
+    uint8_t challenge[CSIGMA_SCALAR_BYTES];
+    finish_challenge(challenge, &entry.transcript, NULL, 0, proof, CSIGMA_POINT_BYTES, message,
+                     message_len);
+    return check_equation(&proof[CSIGMA_POINT_BYTES], cache->generator, challenge, public_key,
+                          proof);
+}
+
+bool
+csigma_dleq_verify_cached(csigma_key_cache_t* cache, const uint8_t proof[CSIGMA_DLEQ_PROOF_SIZE],
+                          const uint8_t g1[CSIGMA_POINT_BYTES],
+                          const uint8_t h1[CSIGMA_POINT_BYTES],
+                          const uint8_t g2[CSIGMA_POINT_BYTES],
+                          const uint8_t h2[CSIGMA_POINT_BYTES], const uint8_t* message,
+                          size_t message_len)
+{
+    if (!cache || !proof || !g1 || !h1 || !g2 || !h2)
+        return false;
+
+    uint8_t key[2 * CSIGMA_POINT_BYTES];
+    memcpy(&key[0], g1, CSIGMA_POINT_BYTES);
+    memcpy(&key[CSIGMA_POINT_BYTES], h1, CSIGMA_POINT_BYTES);
+    csigma_iovec_t rest[2] = { { g2, CSIGMA_POINT_BYTES }, { h2, CSIGMA_POINT_BYTES } };
+
+    csigma_key_entry_t entry;
+    cache_get(cache, key, sizeof(key), 4 * CSIGMA_POINT_BYTES, "dleq", &entry);
+    if (!entry.valid)
+        return false;
+
+    // z*g1 - c*h1 == T1 and z*g2 - c*h2 == T2
+    uint8_t challenge[CSIGMA_SCALAR_BYTES];
+    finish_challenge(challenge, &entry.transcript, rest, 2, proof, 2 * CSIGMA_POINT_BYTES, message,
+                     message_len);
+    const uint8_t* z = &proof[2 * CSIGMA_POINT_BYTES];
+    return check_equation(z, g1, challenge, h1, &proof[0]) &&
+           check_equation(z, g2, challenge, h2, &proof[CSIGMA_POINT_BYTES]);
+}
@@ -0,0 +1,88 @@
+#ifndef KEY_CACHE_H
+#define KEY_CACHE_H
+
+#include "csigma.h"
+#include "transcript.h"
+#include <pthread.h>
+
+// Per-public-key verifier cache
+// Keeps what Schnorr and DLEQ verification can prepare once per public key: the
+// result of validating the key's encoding, and the Fiat-Shamir transcript with the
+// protocol name and key already absorbed. Verification through the cache skips key
+// validation and relation building, and checks the proof equation directly.
+//
+// Entries are keyed by the key encoding (the public key for Schnorr, g1 || h1 for
+// DLEQ), spread over independently locked shards, and evicted with the CLOCK
+// algorithm once the byte budget is used up. All functions are thread-safe.
+// Invalid keys are cached too, so that they are rejected without decoding. Transcripts
+// are prepared under the backend selected with csigma_transcript_set_hash() when the
+// key is looked up; entries prepared under another backend are prepared again.
+
+#define CSIGMA_KEY_CACHE_SHARDS 16
+#define CSIGMA_KEY_CACHE_MAX_KEY_BYTES (2 * CSIGMA_POINT_BYTES)
+
+// Cached key (internal)
+typedef struct {
+    uint8_t             key[CSIGMA_KEY_CACHE_MAX_KEY_BYTES];
+    uint8_t             key_len; // 0 for a free entry
+    uint8_t             valid; // 1 if every point of the key has a valid encoding
+    uint8_t             referenced; // CLOCK reference bit
+    uint32_t            bucket; // Bucket of the entry
+    uint32_t            next; // Next entry in the same bucket
+    csigma_transcript_t transcript; // Protocol name and key absorbed, and its backend
+} csigma_key_entry_t;
+
+// One shard: chained hash table over a fixed array of entries (internal)
+typedef struct {
+    pthread_mutex_t     lock;
+    csigma_key_entry_t* entries;
+    uint32_t*           buckets; // Head entry of each bucket
+    size_t              capacity; // Number of entries (and buckets)
+    size_t              count;
+    size_t              hand; // CLOCK hand
+    uint64_t            hits;
+    uint64_t            misses;
+    uint64_t            evictions;
+} csigma_key_shard_t;
+
+typedef struct {
+    csigma_key_shard_t shards[CSIGMA_KEY_CACHE_SHARDS];
+    uint8_t            generator[CSIGMA_POINT_BYTES];
+    uint8_t            hash_key[crypto_shorthash_KEYBYTES];
+} csigma_key_cache_t;
+
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t   entries;
+    size_t   bytes; // Memory used by the entries and buckets
+} csigma_key_cache_stats_t;
+
+// Create a cache using at most about max_bytes bytes (at least one entry per shard)
+// Returns 0 on success, -1 on error
+int csigma_key_cache_init(csigma_key_cache_t* cache, size_t max_bytes);
+
+// Release the cache
+void csigma_key_cache_destroy(csigma_key_cache_t* cache);
+
+// Read the hit, miss and eviction counters and the current occupancy
+void csigma_key_cache_stats(csigma_key_cache_t* cache, csigma_key_cache_stats_t* stats);
+
+// csigma_schnorr_verify() through the cache; accepts exactly the same proofs
+bool csigma_schnorr_verify_cached(csigma_key_cache_t* cache,
+                                  const uint8_t       proof[CSIGMA_SCHNORR_PROOF_SIZE],
+                                  const uint8_t       public_key[CSIGMA_POINT_BYTES],
+                                  const uint8_t* message, size_t message_len);
+
+// csigma_dleq_verify() through the cache, keyed by (g1, h1); accepts exactly the
+// same proofs
+bool csigma_dleq_verify_cached(csigma_key_cache_t* cache,
+                               const uint8_t proof[CSIGMA_DLEQ_PROOF_SIZE],
+                               const uint8_t g1[CSIGMA_POINT_BYTES],
+                               const uint8_t h1[CSIGMA_POINT_BYTES],
+                               const uint8_t g2[CSIGMA_POINT_BYTES],
+                               const uint8_t h2[CSIGMA_POINT_BYTES], const uint8_t* message,
+                               size_t message_len);
+
+#endif
@@ -1,4 +1,7 @@
 #include "linear_relation.h"
+#include "msm.h"
+#include "nonce.h"
+#include "optimizer.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -17,8 +20,11 @@ linear_combination_init(linear_combination_t* lc)
 {
     lc->scalar_indices  = malloc(INITIAL_TERMS_CAPACITY * sizeof(int));
     lc->element_indices = malloc(INITIAL_TERMS_CAPACITY * sizeof(int));
+    lc->coefficients    = NULL;
     lc->num_terms       = 0;
     lc->capacity        = INITIAL_TERMS_CAPACITY;
+    lc->constant_index  = -1;
+    memset(lc->constant_coefficient, 0, CSIGMA_SCALAR_BYTES);
 }
 
 void
@@ -28,19 +34,45 @@ linear_combination_add_term(linear_combination_t* lc, int scalar_idx, int elemen
         lc->capacity *= 2;
         lc->scalar_indices  = realloc(lc->scalar_indices, lc->capacity * sizeof(int));
         lc->element_indices = realloc(lc->element_indices, lc->capacity * sizeof(int));
+        if (lc->coefficients) {
+            lc->coefficients = realloc(lc->coefficients, lc->capacity * CSIGMA_SCALAR_BYTES);
+        }
     }
     lc->scalar_indices[lc->num_terms]  = scalar_idx;
     lc->element_indices[lc->num_terms] = element_idx;
+    if (lc->coefficients) {
+        uint8_t* coefficient = &lc->coefficients[lc->num_terms * CSIGMA_SCALAR_BYTES];
+        memset(coefficient, 0, CSIGMA_SCALAR_BYTES);
+        coefficient[0] = 1;
+    }
     lc->num_terms++;
 }
 
+void
+linear_combination_add_weighted_term(linear_combination_t* lc, int scalar_idx, int element_idx,
+                                     const uint8_t coefficient[CSIGMA_SCALAR_BYTES])
+{
+    // Materialize the implicit unit coefficients on first use
+    if (!lc->coefficients) {
+        lc->coefficients = calloc(lc->capacity, CSIGMA_SCALAR_BYTES);
+        for (size_t i = 0; i < lc->num_terms; i++) {
+            lc->coefficients[i * CSIGMA_SCALAR_BYTES] = 1;
+        }
+    }
+    linear_combination_add_term(lc, scalar_idx, element_idx);
+    memcpy(&lc->coefficients[(lc->num_terms - 1) * CSIGMA_SCALAR_BYTES], coefficient,
+           CSIGMA_SCALAR_BYTES);
+}
+
 void
 linear_combination_destroy(linear_combination_t* lc)
 {
     free(lc->scalar_indices);
     free(lc->element_indices);
+    free(lc->coefficients);
     lc->scalar_indices  = NULL;
     lc->element_indices = NULL;
+    lc->coefficients    = NULL;
     lc->num_terms       = 0;
     lc->capacity        = 0;
 }
@@ -59,6 +91,7 @@ linear_map_init(linear_map_t* map)
     map->num_elements         = 0;
     map->constraints_capacity = INITIAL_CONSTRAINTS_CAPACITY;
     map->elements_capacity    = INITIAL_ELEMENTS_CAPACITY;
+    map->plan                 = NULL;
 }
 
 void
@@ -69,57 +102,80 @@ linear_map_destroy(linear_map_t* map)
     }
     free(map->combinations);
     free(map->group_elements);
+    linear_map_plan_destroy(map->plan);
     map->combinations   = NULL;
     map->group_elements = NULL;
+    map->plan           = NULL;
 }
 
-// Evaluate linear map: output[i] = sum_j(scalars[j] * elements[k])
-int
-linear_map_eval(const linear_map_t* map, const uint8_t* scalars, uint8_t* output)
+// Drop the evaluation plan after the map has been modified (internal)
+static void
+linear_map_invalidate_plan(linear_map_t* map)
 {
+    linear_map_plan_destroy(map->plan);
+    map->plan = NULL;
+}
+
+// Evaluate linear map with a caller-provided term buffer (internal)
+// The buffer keeps its allocation, so repeated evaluations do not allocate
+static int
+linear_map_eval_with(const linear_map_t* map, const uint8_t* scalars, uint8_t* output, msm_t* msm)
+{
+    // Optimized maps have validated indices and shared products
+    if (map->plan) {
+        return linear_map_plan_eval(map, scalars, output);
+    }
+
     for (size_t i = 0; i < map->num_constraints; i++) {
         const linear_combination_t* lc = &map->combinations[i];
 
-        // Start with identity element
-        uint8_t result[CSIGMA_POINT_BYTES];
-        bool    first_term = true;
+        // If no terms, this is an error (empty linear combination)
+        if (lc->num_terms == 0) {
+            return -1;
+        }
 
-        // Accumulate: result = sum of scalars[j] * elements[k]
+        // Accumulate: result = sum of coefficients[j] * scalars[j] * elements[k]
+        // Public coefficients are folded into the scalars, so they cost no point operation
+        msm_reset(msm);
         for (size_t j = 0; j < lc->num_terms; j++) {
-            int      scalar_idx  = lc->scalar_indices[j];
-            int      element_idx = lc->element_indices[j];
-            uint8_t* element     = &map->group_elements[element_idx * CSIGMA_POINT_BYTES];
-
-            // Compute term = scalar * element
-            uint8_t term[CSIGMA_POINT_BYTES];
-            if (crypto_scalarmult_ristretto255(term, &scalars[scalar_idx * CSIGMA_SCALAR_BYTES],
-                                               element) != 0) {
-                return -1; // Invalid point
+            int scalar_idx  = lc->scalar_indices[j];
+            int element_idx = lc->element_indices[j];
+            if (scalar_idx < 0 || (size_t) scalar_idx >= map->num_scalars || element_idx < 0 ||
+                (size_t) element_idx >= map->num_elements) {
+                return -1; // Index out of range
             }
 
-            if (first_term) {
-                memcpy(result, term, CSIGMA_POINT_BYTES);
-                first_term = false;
-            } else {
-                // result += term
-                uint8_t new_result[CSIGMA_POINT_BYTES];
-                if (crypto_core_ristretto255_add(new_result, result, term) != 0) {
-                    return -1; // Addition failed
-                }
-                memcpy(result, new_result, CSIGMA_POINT_BYTES);
+            const uint8_t* scalar = &scalars[scalar_idx * CSIGMA_SCALAR_BYTES];
+            uint8_t        weighted[CSIGMA_SCALAR_BYTES];
+            if (lc->coefficients) {
+                crypto_core_ristretto255_scalar_mul(
+                    weighted, &lc->coefficients[j * CSIGMA_SCALAR_BYTES], scalar);
+                scalar = weighted;
+            }
+            const uint8_t* point = &map->group_elements[element_idx * CSIGMA_POINT_BYTES];
+            if (msm_add_term(msm, scalar, point) != 0) {
+                return -1;
             }
         }
 
-        // If no terms, this is an error (empty linear combination)
-        if (first_term) {
-            return -1;
+        if (msm_eval(msm, &output[i * CSIGMA_POINT_BYTES]) != 0) {
+            return -1; // Invalid point
         }
-
-        memcpy(&output[i * CSIGMA_POINT_BYTES], result, CSIGMA_POINT_BYTES);
     }
     return 0;
 }
 
+// Evaluate linear map: output[i] = sum_j(coefficients[j] * scalars[j] * elements[k])
+int
+linear_map_eval(const linear_map_t* map, const uint8_t* scalars, uint8_t* output)
+{
+    msm_t msm;
+    msm_init(&msm);
+    int ret = linear_map_eval_with(map, scalars, output, &msm);
+    msm_destroy(&msm);
+    return ret;
+}
+
 // ============================================================================
 // Linear Relation Builder API
 // ============================================================================
@@ -169,6 +225,7 @@ csigma_relation_set_element(linear_relation_t* relation, int index,
                             const uint8_t element[CSIGMA_POINT_BYTES])
 {
     memcpy(&relation->map.group_elements[index * CSIGMA_POINT_BYTES], element, CSIGMA_POINT_BYTES);
+    linear_map_invalidate_plan(&relation->map);
 }
 
 // SIMPLIFIED API: Add element and get index
@@ -190,9 +247,19 @@ csigma_relation_add_scalar(linear_relation_t* relation)
 void
 csigma_relation_add_equation(linear_relation_t* relation, int lhs, const int* rhs_scalar_indices,
                              const int* rhs_element_indices, size_t num_terms)
+{
+    csigma_relation_add_weighted_equation(relation, lhs, rhs_scalar_indices, rhs_element_indices,
+                                          NULL, num_terms);
+}
+
+void
+csigma_relation_add_weighted_equation(linear_relation_t* relation, int lhs,
+                                      const int* rhs_scalar_indices, const int* rhs_element_indices,
+                                      const uint8_t* coefficients, size_t num_terms)
 {
     (void) lhs; // Reserved for future use
     linear_map_t* map = &relation->map;
+    linear_map_invalidate_plan(map);
 
     // Resize combinations array if needed
     if (map->num_constraints >= map->constraints_capacity) {
@@ -207,7 +274,12 @@ csigma_relation_add_equation(linear_relation_t* relation, int lhs, const int* rh
 
     // Add all terms
     for (size_t i = 0; i < num_terms; i++) {
-        linear_combination_add_term(lc, rhs_scalar_indices[i], rhs_element_indices[i]);
+        if (coefficients) {
+            linear_combination_add_weighted_term(lc, rhs_scalar_indices[i], rhs_element_indices[i],
+                                                 &coefficients[i * CSIGMA_SCALAR_BYTES]);
+        } else {
+            linear_combination_add_term(lc, rhs_scalar_indices[i], rhs_element_indices[i]);
+        }
     }
 
     map->num_constraints++;
@@ -216,6 +288,23 @@ csigma_relation_add_equation(linear_relation_t* relation, int lhs, const int* rh
     relation->image = realloc(relation->image, map->num_constraints * CSIGMA_POINT_BYTES);
 }
 
+void
+csigma_relation_set_constant(linear_relation_t* relation, size_t equation, int element_idx,
+                             const uint8_t coefficient[CSIGMA_SCALAR_BYTES])
+{
+    if (equation >= relation->map.num_constraints) {
+        return;
+    }
+    linear_combination_t* lc = &relation->map.combinations[equation];
+    lc->constant_index       = element_idx;
+    if (coefficient) {
+        memcpy(lc->constant_coefficient, coefficient, CSIGMA_SCALAR_BYTES);
+    } else {
+        memset(lc->constant_coefficient, 0, CSIGMA_SCALAR_BYTES);
+        lc->constant_coefficient[0] = 1;
+    }
+}
+
 // SIMPLIFIED API: Add equation with single term
 void
 csigma_relation_add_equation_simple(linear_relation_t* relation, int lhs_idx, int scalar_idx,
@@ -236,17 +325,26 @@ csigma_prover_state_init(prover_state_t* state, size_t num_scalars)
     state->num_scalars = num_scalars;
     state->witness     = malloc(num_scalars * CSIGMA_SCALAR_BYTES);
     state->nonces      = malloc(num_scalars * CSIGMA_SCALAR_BYTES);
+    state->witness_ref = NULL;
 }
 
 void
 csigma_prover_state_destroy(prover_state_t* state)
 {
-    sodium_memzero(state->witness, state->num_scalars * CSIGMA_SCALAR_BYTES);
-    sodium_memzero(state->nonces, state->num_scalars * CSIGMA_SCALAR_BYTES);
+    if (state->witness) {
+        sodium_memzero(state->witness, state->num_scalars * CSIGMA_SCALAR_BYTES);
+    }
+    if (state->nonces) {
+        sodium_memzero(state->nonces, state->num_scalars * CSIGMA_SCALAR_BYTES);
+    }
+    if (state->witness_ref) {
+        sodium_memzero(&state->nonce_stream, sizeof(state->nonce_stream));
+    }
     free(state->witness);
     free(state->nonces);
     state->witness     = NULL;
     state->nonces      = NULL;
+    state->witness_ref = NULL;
     state->num_scalars = 0;
 }
 
@@ -254,6 +352,14 @@ csigma_prover_state_destroy(prover_state_t* state)
 int
 csigma_prover_commit(const linear_relation_t* relation, const uint8_t* witness, uint8_t* commitment,
                      prover_state_t* state)
+{
+    return csigma_prover_commit_with_context(relation, witness, NULL, 0, commitment, state);
+}
+
+int
+csigma_prover_commit_with_context(const linear_relation_t* relation, const uint8_t* witness,
+                                  const uint8_t* context, size_t context_len, uint8_t* commitment,
+                                  prover_state_t* state)
 {
     size_t num_scalars = relation->map.num_scalars;
 
@@ -263,10 +369,13 @@ csigma_prover_commit(const linear_relation_t* relation, const uint8_t* witness,
     // Copy witness
     memcpy(state->witness, witness, num_scalars * CSIGMA_SCALAR_BYTES);
 
-    // Generate random nonces
-    for (size_t i = 0; i < num_scalars; i++) {
-        crypto_core_ristretto255_scalar_random(&state->nonces[i * CSIGMA_SCALAR_BYTES]);
-    }
+    // Hedged nonces from the statement, the context, the witness and a fresh seed
+    shake128_ctx transcript;
+    csigma_nonce_init(&transcript);
+    linear_relation_absorb(relation, &transcript);
+    csigma_nonce_absorb_context(&transcript, context, context_len);
+    csigma_nonce_derive(state->nonces, num_scalars, &transcript, witness,
+                        num_scalars * CSIGMA_SCALAR_BYTES);
 
     // Compute commitment = linear_map(nonces)
     if (linear_map_eval(&relation->map, state->nonces, commitment) != 0) {
@@ -277,21 +386,150 @@ csigma_prover_commit(const linear_relation_t* relation, const uint8_t* witness,
     return 0;
 }
 
+int
+csigma_prover_commit_compact(const linear_relation_t* relation, const uint8_t* witness,
+                             uint8_t* commitment, prover_state_t* state)
+{
+    size_t   num_scalars = relation->map.num_scalars;
+    uint8_t* nonces      = malloc(num_scalars * CSIGMA_SCALAR_BYTES);
+    if (!nonces)
+        return -1;
+
+    msm_t msm;
+    msm_init(&msm);
+    int ret = linear_relation_commit_compact(relation, witness, NULL, 0, commitment, state, nonces,
+                                             &msm);
+    msm_destroy(&msm);
+    free(nonces);
+    return ret;
+}
+
+int
+linear_relation_commit_compact(const linear_relation_t* relation, const uint8_t* witness,
+                               const uint8_t* context, size_t context_len, uint8_t* commitment,
+                               prover_state_t* state, uint8_t* nonces, msm_t* msm)
+{
+    size_t num_scalars = relation->map.num_scalars;
+
+    state->num_scalars = num_scalars;
+    state->witness     = NULL;
+    state->nonces      = NULL;
+    state->witness_ref = witness;
+
+    shake128_ctx transcript;
+    csigma_nonce_init(&transcript);
+    linear_relation_absorb(relation, &transcript);
+    csigma_nonce_absorb_context(&transcript, context, context_len);
+    csigma_nonce_start(&state->nonce_stream, &transcript, witness,
+                       num_scalars * CSIGMA_SCALAR_BYTES);
+
+    // The commitment needs every nonce once; they are regenerated for the response
+    shake128_ctx stream = state->nonce_stream;
+    csigma_nonce_squeeze(&stream, nonces, num_scalars);
+    int ret = linear_map_eval_with(&relation->map, nonces, commitment, msm);
+
+    sodium_memzero(&stream, sizeof(stream));
+    sodium_memzero(nonces, num_scalars * CSIGMA_SCALAR_BYTES);
+    if (ret != 0) {
+        csigma_prover_state_destroy(state);
+    }
+    return ret;
+}
+
+int
+csigma_prover_commit_batch(const linear_relation_t* relation, const uint8_t* witnesses, size_t k,
+                           const uint8_t* images, const uint8_t* contexts, size_t context_len,
+                           uint8_t* commitments, prover_state_t* states)
+{
+    if (k == 0)
+        return 0;
+    if (!relation || !witnesses || !commitments || !states || (context_len > 0 && !contexts) ||
+        linear_relation_validate(relation) != 0)
+        return -1;
+
+    const linear_map_t* map         = &relation->map;
+    size_t              num_scalars = map->num_scalars;
+    size_t              witness_len = num_scalars * CSIGMA_SCALAR_BYTES;
+    size_t              image_len   = map->num_constraints * CSIGMA_POINT_BYTES;
+    msm_t               msm;
+    msm_init(&msm);
+
+    // Hedged nonces: the map is absorbed once, then each witness gets its own image,
+    // context and seed (the image follows the map, as in linear_relation_absorb())
+    shake128_ctx shared;
+    csigma_nonce_init(&shared);
+    linear_map_absorb(map, &shared);
+    for (size_t j = 0; j < k; j++) {
+        const uint8_t* witness    = &witnesses[j * witness_len];
+        shake128_ctx   transcript = shared;
+        shake128_absorb(&transcript, images ? &images[j * image_len] : relation->image,
+                        image_len);
+        csigma_nonce_absorb_context(&transcript, contexts ? &contexts[j * context_len] : NULL,
+                                    context_len);
+        csigma_prover_state_init(&states[j], num_scalars);
+        memcpy(states[j].witness, witness, witness_len);
+        csigma_nonce_derive(states[j].nonces, num_scalars, &transcript, witness, witness_len);
+    }
+
+    // Commitments share the validated map and one term buffer
+    int ret = 0;
+    for (size_t j = 0; j < k && ret == 0; j++) {
+        ret = linear_map_eval_with(map, states[j].nonces,
+                                   &commitments[j * map->num_constraints * CSIGMA_POINT_BYTES],
+                                   &msm);
+    }
+    msm_destroy(&msm);
+
+    if (ret != 0) {
+        for (size_t j = 0; j < k; j++) {
+            csigma_prover_state_destroy(&states[j]);
+        }
+    }
+    return ret;
+}
+
+// Nonces regenerated per chunk when responding from a compact state
+#define RESPONSE_CHUNK 64
+
 // Prover response phase (spec section 2.2.2.2)
 void
 csigma_prover_response(const prover_state_t* state, const uint8_t challenge[CSIGMA_SCALAR_BYTES],
                        uint8_t* response)
 {
+    // Compact states replay their nonce stream chunk by chunk
+    shake128_ctx   stream;
+    uint8_t        chunk[RESPONSE_CHUNK * CSIGMA_SCALAR_BYTES];
+    const uint8_t* witnesses = state->witness;
+    if (!state->nonces) {
+        stream    = state->nonce_stream;
+        witnesses = state->witness_ref;
+    }
+
     // response[i] = nonces[i] + witness[i] * challenge
     for (size_t i = 0; i < state->num_scalars; i++) {
-        const uint8_t* nonce   = &state->nonces[i * CSIGMA_SCALAR_BYTES];
-        const uint8_t* witness = &state->witness[i * CSIGMA_SCALAR_BYTES];
+        const uint8_t* nonce;
+        if (state->nonces) {
+            nonce = &state->nonces[i * CSIGMA_SCALAR_BYTES];
+        } else {
+            if (i % RESPONSE_CHUNK == 0) {
+                size_t remaining = state->num_scalars - i;
+                csigma_nonce_squeeze(&stream, chunk,
+                                     remaining < RESPONSE_CHUNK ? remaining : RESPONSE_CHUNK);
+            }
+            nonce = &chunk[(i % RESPONSE_CHUNK) * CSIGMA_SCALAR_BYTES];
+        }
+        const uint8_t* witness = &witnesses[i * CSIGMA_SCALAR_BYTES];
         uint8_t*       resp    = &response[i * CSIGMA_SCALAR_BYTES];
 
         uint8_t c_times_witness[CSIGMA_SCALAR_BYTES];
         crypto_core_ristretto255_scalar_mul(c_times_witness, challenge, witness);
         crypto_core_ristretto255_scalar_add(resp, nonce, c_times_witness);
     }
+
+    if (!state->nonces) {
+        sodium_memzero(&stream, sizeof(stream));
+        sodium_memzero(chunk, sizeof(chunk));
+    }
 }
 
 // Verifier algorithm (spec section 2.2.3)
@@ -299,25 +537,46 @@ bool
 csigma_verify(const linear_relation_t* relation, const uint8_t* commitment,
               const uint8_t challenge[CSIGMA_SCALAR_BYTES], const uint8_t* response)
 {
-    // Check: linear_map(response) == commitment + image * challenge
-    size_t num_constraints = relation->map.num_constraints;
+    // Check: linear_map(response) == commitment + (image - constant) * challenge
+    const linear_map_t* map             = &relation->map;
+    size_t              num_constraints = map->num_constraints;
 
     // Compute expected = linear_map(response)
     uint8_t* expected = malloc(num_constraints * CSIGMA_POINT_BYTES);
-    if (linear_map_eval(&relation->map, response, expected) != 0) {
+    if (linear_map_eval(map, response, expected) != 0) {
         free(expected);
         return false;
     }
 
-    // Compute got[i] = commitment[i] + image[i] * challenge
+    // Compute got[i] = commitment[i] + challenge * image[i] - challenge * k[i] * constant[i]
+    // The constant's coefficient is folded into the challenge scalar
+    uint8_t scalars[2 * CSIGMA_SCALAR_BYTES];
+    uint8_t points[2 * CSIGMA_POINT_BYTES];
     for (size_t i = 0; i < num_constraints; i++) {
-        const uint8_t* image_i      = &relation->image[i * CSIGMA_POINT_BYTES];
-        const uint8_t* commitment_i = &commitment[i * CSIGMA_POINT_BYTES];
-        uint8_t*       expected_i   = &expected[i * CSIGMA_POINT_BYTES];
+        const linear_combination_t* lc           = &map->combinations[i];
+        const uint8_t*              commitment_i = &commitment[i * CSIGMA_POINT_BYTES];
+        const uint8_t*              expected_i   = &expected[i * CSIGMA_POINT_BYTES];
+        size_t                      num_terms    = 1;
+
+        memcpy(&scalars[0], challenge, CSIGMA_SCALAR_BYTES);
+        memcpy(&points[0], &relation->image[i * CSIGMA_POINT_BYTES], CSIGMA_POINT_BYTES);
+
+        if (lc->constant_index >= 0) {
+            if ((size_t) lc->constant_index >= map->num_elements) {
+                free(expected);
+                return false;
+            }
+            uint8_t c_times_k[CSIGMA_SCALAR_BYTES];
+            crypto_core_ristretto255_scalar_mul(c_times_k, challenge, lc->constant_coefficient);
+            crypto_core_ristretto255_scalar_negate(&scalars[CSIGMA_SCALAR_BYTES], c_times_k);
+            memcpy(&points[CSIGMA_POINT_BYTES],
+                   &map->group_elements[lc->constant_index * CSIGMA_POINT_BYTES],
+                   CSIGMA_POINT_BYTES);
+            num_terms++;
+        }
 
-        // c_times_image = challenge * image[i]
         uint8_t c_times_image[CSIGMA_POINT_BYTES];
-        if (crypto_scalarmult_ristretto255(c_times_image, challenge, image_i) != 0) {
+        if (csigma_msm(c_times_image, scalars, points, num_terms) != 0) {
             free(expected);
             return false;
         }
@@ -339,3 +598,186 @@ csigma_verify(const linear_relation_t* relation, const uint8_t* commitment,
     free(expected);
     return true;
 }
+
+// ============================================================================
+// Statement Encoding and Batch Verification (Internal)
+// ============================================================================
+
+int
+linear_relation_validate(const linear_relation_t* relation)
+{
+    const linear_map_t* map = &relation->map;
+
+    for (size_t i = 0; i < map->num_constraints; i++) {
+        const linear_combination_t* lc = &map->combinations[i];
+        if (lc->num_terms == 0) {
+            return -1;
+        }
+        for (size_t j = 0; j < lc->num_terms; j++) {
+            if (lc->scalar_indices[j] < 0 || (size_t) lc->scalar_indices[j] >= map->num_scalars ||
+                lc->element_indices[j] < 0 ||
+                (size_t) lc->element_indices[j] >= map->num_elements) {
+                return -1;
+            }
+        }
+        if (lc->constant_index >= 0 && (size_t) lc->constant_index >= map->num_elements) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Encode an integer as 8 little-endian bytes (internal)
+static void
+encode_u64(linear_absorb_fn absorb, void* ctx, uint64_t value)
+{
+    uint8_t bytes[8];
+    for (size_t i = 0; i < 8; i++) {
+        bytes[i] = (uint8_t) (value >> (8 * i));
+    }
+    absorb(ctx, bytes, sizeof(bytes));
+}
+
+void
+linear_map_encode(const linear_map_t* map, linear_absorb_fn absorb, void* ctx)
+{
+    uint8_t one[CSIGMA_SCALAR_BYTES] = { 1 };
+
+    encode_u64(absorb, ctx, map->num_scalars);
+    encode_u64(absorb, ctx, map->num_elements);
+    encode_u64(absorb, ctx, map->num_constraints);
+    absorb(ctx, map->group_elements, map->num_elements * CSIGMA_POINT_BYTES);
+
+    for (size_t i = 0; i < map->num_constraints; i++) {
+        const linear_combination_t* lc = &map->combinations[i];
+
+        encode_u64(absorb, ctx, lc->num_terms);
+        for (size_t j = 0; j < lc->num_terms; j++) {
+            encode_u64(absorb, ctx, (uint64_t) lc->scalar_indices[j]);
+            encode_u64(absorb, ctx, (uint64_t) lc->element_indices[j]);
+            absorb(ctx, lc->coefficients ? &lc->coefficients[j * CSIGMA_SCALAR_BYTES] : one,
+                   CSIGMA_SCALAR_BYTES);
+        }
+        encode_u64(absorb, ctx, (uint64_t) (int64_t) lc->constant_index);
+        absorb(ctx, lc->constant_coefficient, CSIGMA_SCALAR_BYTES);
+    }
+}
+
+void
+linear_relation_encode(const linear_relation_t* relation, linear_absorb_fn absorb, void* ctx)
+{
+    linear_map_encode(&relation->map, absorb, ctx);
+    absorb(ctx, relation->image, relation->map.num_constraints * CSIGMA_POINT_BYTES);
+}
+
+// Adapter from the encoders to a SHAKE128 sponge (internal)
+static void
+shake128_absorb_fn(void* ctx, const uint8_t* data, size_t len)
+{
+    shake128_absorb(ctx, data, len);
+}
+
+void
+linear_map_absorb(const linear_map_t* map, shake128_ctx* ctx)
+{
+    linear_map_encode(map, shake128_absorb_fn, ctx);
+}
+
+void
+linear_relation_absorb(const linear_relation_t* relation, shake128_ctx* ctx)
+{
+    linear_relation_encode(relation, shake128_absorb_fn, ctx);
+}
+
+uint64_t
+linear_map_encoded_len(const linear_map_t* map)
+{
+    uint64_t len = 24 + (uint64_t) map->num_elements * CSIGMA_POINT_BYTES;
+    for (size_t i = 0; i < map->num_constraints; i++) {
+        len += 8 + (uint64_t) map->combinations[i].num_terms * (16 + CSIGMA_SCALAR_BYTES);
+        len += 8 + CSIGMA_SCALAR_BYTES;
+    }
+    return len;
+}
+
+int
+linear_relation_append_check(const linear_relation_t* relation, const uint8_t* commitment,
+                             const uint8_t challenge[CSIGMA_SCALAR_BYTES], const uint8_t* response,
+                             msm_t* msm)
+{
+    if (linear_relation_validate(relation) != 0) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < relation->map.num_constraints; i++) {
+        if (linear_relation_append_row_check(relation, i, commitment, challenge, response, msm) !=
+            0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int
+linear_relation_append_row_check(const linear_relation_t* relation, size_t row,
+                                 const uint8_t* commitment,
+                                 const uint8_t  challenge[CSIGMA_SCALAR_BYTES],
+                                 const uint8_t* response, msm_t* msm)
+{
+    uint8_t rho[CSIGMA_SCALAR_BYTES];
+    crypto_core_ristretto255_scalar_random(rho);
+    return linear_relation_append_row_terms(relation, row, rho, commitment, challenge, response,
+                                            0, linear_relation_row_check_terms(relation, row),
+                                            msm);
+}
+
+size_t
+linear_relation_row_check_terms(const linear_relation_t* relation, size_t row)
+{
+    const linear_combination_t* lc = &relation->map.combinations[row];
+    return lc->num_terms + 2 + (lc->constant_index >= 0);
+}
+
+int
+linear_relation_append_row_terms(const linear_relation_t* relation, size_t row,
+                                 const uint8_t  rho[CSIGMA_SCALAR_BYTES],
+                                 const uint8_t* commitment,
+                                 const uint8_t  challenge[CSIGMA_SCALAR_BYTES],
+                                 const uint8_t* response, size_t first, size_t last, msm_t* msm)
+{
+    const linear_map_t*         map = &relation->map;
+    const linear_combination_t* lc  = &map->combinations[row];
+
+    uint8_t scalar[CSIGMA_SCALAR_BYTES], rho_c[CSIGMA_SCALAR_BYTES];
+    crypto_core_ristretto255_scalar_mul(rho_c, rho, challenge);
+
+    for (size_t t = first; t < last; t++) {
+        const uint8_t* point;
+        if (t < lc->num_terms) {
+            // rho * coefficient * response on each element
+            const uint8_t* z = &response[lc->scalar_indices[t] * CSIGMA_SCALAR_BYTES];
+            crypto_core_ristretto255_scalar_mul(scalar, rho, z);
+            if (lc->coefficients) {
+                crypto_core_ristretto255_scalar_mul(scalar, scalar,
+                                                    &lc->coefficients[t * CSIGMA_SCALAR_BYTES]);
+            }
+            point = &map->group_elements[lc->element_indices[t] * CSIGMA_POINT_BYTES];
+        } else if (t == lc->num_terms) {
+            // -rho * commitment
+            crypto_core_ristretto255_scalar_negate(scalar, rho);
+            point = &commitment[row * CSIGMA_POINT_BYTES];
+        } else if (t == lc->num_terms + 1) {
+            // -rho * challenge * image
+            crypto_core_ristretto255_scalar_negate(scalar, rho_c);
+            point = &relation->image[row * CSIGMA_POINT_BYTES];
+        } else {
+            // +rho * challenge * k * constant
+            crypto_core_ristretto255_scalar_mul(scalar, rho_c, lc->constant_coefficient);
+            point = &map->group_elements[lc->constant_index * CSIGMA_POINT_BYTES];
+        }
+        if (msm_add_term(msm, scalar, point) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
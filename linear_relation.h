@@ -2,29 +2,41 @@
 #define LINEAR_RELATION_H
 
 #include "csigma.h"
+#include "keccak.h"
+#include "msm.h"
 
 // General framework for Sigma protocols over Ristretto255
 // Implements the LinearRelation abstraction from draft-irtf-cfrg-sigma-protocols-00
 
-// Linear combination: represents sum of (scalar_i * element_i) terms
+// Linear combination: represents sum of (coefficient_i * scalar_i * element_i) terms
 // This is one row in the linear map matrix (in sparse format)
+// Coefficients are public scalars; a row without coefficients uses 1 for every term.
+// A row may also carry a public constant term (constant_coefficient * element) that
+// is part of the image but involves no secret scalar.
 typedef struct {
-    int*   scalar_indices; // Indices into the scalar array
-    int*   element_indices; // Indices into the group element array
-    size_t num_terms; // Number of terms in this linear combination
-    size_t capacity; // Allocated capacity
+    int*     scalar_indices; // Indices into the scalar array
+    int*     element_indices; // Indices into the group element array
+    uint8_t* coefficients; // Public coefficient of each term (NULL if all are 1)
+    size_t   num_terms; // Number of terms in this linear combination
+    size_t   capacity; // Allocated capacity
+    int      constant_index; // Element index of the constant term (-1 if none)
+    uint8_t  constant_coefficient[CSIGMA_SCALAR_BYTES]; // Coefficient of the constant term
 } linear_combination_t;
 
+// Optional evaluation plan attached by csigma_relation_optimize() (see optimizer.h)
+struct linear_map_plan;
+
 // Linear map: function from scalars to group elements
 // Represents matrix multiplication in sparse format
 typedef struct {
-    linear_combination_t* combinations; // Array of linear combinations (rows)
-    uint8_t*              group_elements; // Array of group elements (32 bytes each)
-    size_t                num_constraints; // Number of equations (rows)
-    size_t                num_scalars; // Number of scalar variables
-    size_t                num_elements; // Number of group elements
-    size_t                constraints_capacity; // Allocated capacity for constraints
-    size_t                elements_capacity; // Allocated capacity for elements
+    linear_combination_t*   combinations; // Array of linear combinations (rows)
+    uint8_t*                group_elements; // Array of group elements (32 bytes each)
+    size_t                  num_constraints; // Number of equations (rows)
+    size_t                  num_scalars; // Number of scalar variables
+    size_t                  num_elements; // Number of group elements
+    size_t                  constraints_capacity; // Allocated capacity for constraints
+    size_t                  elements_capacity; // Allocated capacity for elements
+    struct linear_map_plan* plan; // Evaluation plan (NULL if not optimized)
 } linear_map_t;
 
 // Linear relation: statement proving knowledge of preimage
@@ -35,15 +47,23 @@ typedef struct {
 } linear_relation_t;
 
 // Prover state for interactive/non-interactive protocols
+// A compact state (csigma_prover_commit_compact()) holds no copies: witness and nonces
+// are NULL, the witness stays in caller memory and the nonces are replayed from
+// nonce_stream by csigma_prover_response().
 typedef struct {
-    uint8_t* witness; // Secret scalars
-    uint8_t* nonces; // Random nonces used in commitment
-    size_t   num_scalars;
+    uint8_t*       witness; // Secret scalars
+    uint8_t*       nonces; // Random nonces used in commitment
+    size_t         num_scalars;
+    const uint8_t* witness_ref; // Caller-owned witness (compact states only)
+    shake128_ctx   nonce_stream; // Nonce stream at its first nonce (compact states only)
 } prover_state_t;
 
 // Linear combination operations (internal, for advanced use)
 void linear_combination_init(linear_combination_t* lc);
 void linear_combination_add_term(linear_combination_t* lc, int scalar_idx, int element_idx);
+void linear_combination_add_weighted_term(linear_combination_t* lc, int scalar_idx,
+                                          int element_idx,
+                                          const uint8_t coefficient[CSIGMA_SCALAR_BYTES]);
 void linear_combination_destroy(linear_combination_t* lc);
 
 // Linear map operations (internal, for advanced use)
@@ -51,8 +71,10 @@ void linear_map_init(linear_map_t* map);
 void linear_map_destroy(linear_map_t* map);
 
 // Evaluate: map(scalars) -> group elements
+// Only the terms involving scalars are evaluated; constant terms are not included.
 // scalars: array of num_scalars 32-byte scalars
 // output: array of num_constraints 32-byte group elements (must be pre-allocated)
+// Uses the evaluation plan when the map has been optimized
 int linear_map_eval(const linear_map_t* map, const uint8_t* scalars, uint8_t* output);
 
 // Linear relation builder API (following spec section 2.2.6)
@@ -98,9 +120,26 @@ void csigma_relation_add_equation(linear_relation_t* relation, int lhs,
 void csigma_relation_add_equation_simple(linear_relation_t* relation, int lhs_idx, int scalar_idx,
                                          int element_idx);
 
+// Append equation with public coefficients:
+// lhs = sum of (coefficients[i] * scalar[rhs_scalar_indices[i]] * element[rhs_element_indices[i]])
+// coefficients: array of num_terms 32-byte scalars (NULL means every coefficient is 1)
+// Example: C1 - C2 = r*H with C1, C2 public becomes a constant term, and
+// V = sum of 2^i * b_i * G expresses a bit decomposition without new elements
+void csigma_relation_add_weighted_equation(linear_relation_t* relation, int lhs,
+                                           const int*     rhs_scalar_indices,
+                                           const int*     rhs_element_indices,
+                                           const uint8_t* coefficients, size_t num_terms);
+
+// Set the public constant term of an equation: image += coefficient * element[element_idx]
+// equation: equation index (0 for the first equation added, and so on)
+// coefficient: 32-byte scalar (NULL means 1)
+void csigma_relation_set_constant(linear_relation_t* relation, size_t equation, int element_idx,
+                                  const uint8_t coefficient[CSIGMA_SCALAR_BYTES]);
+
 // General sigma protocol interface (spec section 1.1)
 
 // Prover commit: generate commitment and prover state
+// Nonces are hedged: derived from the statement, the witness and a fresh seed (see nonce.h)
 // witness: array of num_scalars 32-byte scalars
 // commitment: output array (num_constraints 32-byte points, pre-allocated)
 // state: output prover state (must be freed with csigma_prover_state_destroy)
@@ -108,6 +147,40 @@ void csigma_relation_add_equation_simple(linear_relation_t* relation, int lhs_id
 int csigma_prover_commit(const linear_relation_t* relation, const uint8_t* witness,
                          uint8_t* commitment, prover_state_t* state);
 
+// Prover commit for non-interactive proofs: the nonces are also bound to the proof's
+// Fiat-Shamir context (see csigma_transcript_nonce_context()), so that a repeated seed
+// never answers two different challenges with the same nonces
+// context: context_len bytes (NULL if context_len is 0, which is csigma_prover_commit())
+// Returns 0 on success, -1 on error
+int csigma_prover_commit_with_context(const linear_relation_t* relation, const uint8_t* witness,
+                                      const uint8_t* context, size_t context_len,
+                                      uint8_t* commitment, prover_state_t* state);
+
+// Prover commit keeping a compact state of constant size, whatever the relation size
+// The nonces are regenerated from their seeded stream in csigma_prover_response(), and
+// the witness is read from the caller's memory, which must stay unchanged until the
+// state is destroyed. The state must still be freed with csigma_prover_state_destroy().
+// As with any prover state, responding to two different challenges reveals the witness.
+// Returns 0 on success, -1 on error
+int csigma_prover_commit_compact(const linear_relation_t* relation, const uint8_t* witness,
+                                 uint8_t* commitment, prover_state_t* state);
+
+// Prover commit for k witnesses of statements sharing one linear map
+// Validates and hashes the map once and reuses one evaluation buffer; the nonces of
+// witness j are derived from image j and context j, exactly as
+// csigma_prover_commit_with_context() would for the relation with that image, and each
+// state is then used like one from it
+// witnesses: array of k witnesses, num_scalars 32-byte scalars each
+// images: array of k images, num_constraints 32-byte points each (NULL: the relation's
+// image for every witness)
+// contexts: array of k contexts, context_len bytes each (NULL if context_len is 0)
+// commitments: output array of k commitments, num_constraints 32-byte points each
+// states: output array of k prover states (each freed with csigma_prover_state_destroy)
+// Returns 0 on success, -1 on error (no state is left allocated)
+int csigma_prover_commit_batch(const linear_relation_t* relation, const uint8_t* witnesses,
+                               size_t k, const uint8_t* images, const uint8_t* contexts,
+                               size_t context_len, uint8_t* commitments, prover_state_t* states);
+
 // Prover response: compute response given challenge
 // state: prover state from commit phase
 // challenge: 32-byte challenge scalar
@@ -124,6 +197,71 @@ void csigma_prover_response(const prover_state_t* state,
 bool csigma_verify(const linear_relation_t* relation, const uint8_t* commitment,
                    const uint8_t challenge[CSIGMA_SCALAR_BYTES], const uint8_t* response);
 
+// Check that every scalar, element and constant index of the relation is in range
+// Returns 0 if the relation is well formed, -1 otherwise
+int linear_relation_validate(const linear_relation_t* relation);
+
+// Absorb a canonical encoding of the linear map (structure, coefficients and group
+// elements) into a Fiat-Shamir transcript (internal)
+void linear_map_absorb(const linear_map_t* map, shake128_ctx* ctx);
+
+// Absorb a canonical encoding of the statement (structure, coefficients, group
+// elements and image) into a Fiat-Shamir transcript (internal)
+void linear_relation_absorb(const linear_relation_t* relation, shake128_ctx* ctx);
+
+// Same encodings, passed piece by piece to absorb(ctx, data, len) (internal)
+typedef void (*linear_absorb_fn)(void* ctx, const uint8_t* data, size_t len);
+void linear_map_encode(const linear_map_t* map, linear_absorb_fn absorb, void* ctx);
+void linear_relation_encode(const linear_relation_t* relation, linear_absorb_fn absorb,
+                            void* ctx);
+
+// Length in bytes of the encoding absorbed by linear_map_absorb() (internal)
+uint64_t linear_map_encoded_len(const linear_map_t* map);
+
+// Append the verification equation of a proof to a multi-scalar multiplication (internal)
+// Adds rho_i * (linear_map(response)_i - commitment_i - challenge * (image_i - constant_i))
+// for every row i with a fresh random weight rho_i, so that any number of proofs and rows
+// can be checked at once with msm_is_identity(): the combined sum is the identity if
+// and only if every equation holds, except with negligible probability.
+// Returns 0 on success, -1 if the relation is malformed or on allocation failure
+int linear_relation_append_check(const linear_relation_t* relation, const uint8_t* commitment,
+                                 const uint8_t challenge[CSIGMA_SCALAR_BYTES],
+                                 const uint8_t* response, msm_t* msm);
+
+// Append the verification equation of a single row (internal)
+// The relation must have been checked with linear_relation_validate()
+// Returns 0 on success, -1 on allocation failure
+int linear_relation_append_row_check(const linear_relation_t* relation, size_t row,
+                                     const uint8_t* commitment,
+                                     const uint8_t  challenge[CSIGMA_SCALAR_BYTES],
+                                     const uint8_t* response, msm_t* msm);
+
+// Number of terms in the verification equation of a row (internal)
+// The terms of each linear combination come first, then the commitment, the image and
+// the constant term, if any
+size_t linear_relation_row_check_terms(const linear_relation_t* relation, size_t row);
+
+// Append terms first to last - 1 of the verification equation of a row, weighted by
+// rho (internal)
+// The relation must have been checked with linear_relation_validate()
+// Returns 0 on success, -1 on allocation failure
+int linear_relation_append_row_terms(const linear_relation_t* relation, size_t row,
+                                     const uint8_t  rho[CSIGMA_SCALAR_BYTES],
+                                     const uint8_t* commitment,
+                                     const uint8_t  challenge[CSIGMA_SCALAR_BYTES],
+                                     const uint8_t* response, size_t first, size_t last,
+                                     msm_t* msm);
+
+// csigma_prover_commit_compact() with caller-provided buffers (internal)
+// nonces: scratch space for num_scalars 32-byte scalars, wiped before returning
+// msm: term buffer; once it has room for the largest equation, no allocation is made
+// unless the map has an evaluation plan
+// Returns 0 on success, -1 on error
+int linear_relation_commit_compact(const linear_relation_t* relation, const uint8_t* witness,
+                                   const uint8_t* context, size_t context_len,
+                                   uint8_t* commitment, prover_state_t* state, uint8_t* nonces,
+                                   msm_t* msm);
+
 // Prover state management
 void csigma_prover_state_init(prover_state_t* state, size_t num_scalars);
 void csigma_prover_state_destroy(prover_state_t* state);
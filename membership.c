@@ -0,0 +1,442 @@
+#include "membership.h"
+#include "transcript.h"
+#include "msm.h"
+#include "nonce.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ============================================================================
+// Point Sets
+// ============================================================================
+
+void
+csigma_point_set_init(csigma_point_set_t* set, const uint8_t* points, size_t num_points)
+{
+    set->points      = points;
+    set->num_points  = num_points;
+    set->mapping     = NULL;
+    set->mapping_len = 0;
+}
+
+int
+csigma_point_set_map(csigma_point_set_t* set, const char* path)
+{
+    csigma_point_set_init(set, NULL, 0);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 || st.st_size % CSIGMA_POINT_BYTES != 0) {
+        close(fd);
+        return -1;
+    }
+
+    size_t len     = (size_t) st.st_size;
+    void*  mapping = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return -1;
+    }
+
+    csigma_point_set_init(set, mapping, len / CSIGMA_POINT_BYTES);
+    set->mapping     = mapping;
+    set->mapping_len = len;
+    return 0;
+}
+
+void
+csigma_point_set_destroy(csigma_point_set_t* set)
+{
+    if (set->mapping) {
+        munmap(set->mapping, set->mapping_len);
+    }
+    csigma_point_set_init(set, NULL, 0);
+}
+
+// ============================================================================
+// Proof Layout (Internal)
+// ============================================================================
+
+// Number of index bits: max(1, ceil(log2(num_points)))
+static size_t
+num_bits(size_t num_points)
+{
+    size_t bits = 1;
+    while (((size_t) 1 << bits) < num_points) {
+        bits++;
+    }
+    return bits;
+}
+
+// Points: B_j (bit commitments), A_j, C_j (for each bit), then G_k (k < n)
+// Scalars: f_j, z_a_j, z_b_j (for each bit), then z_d
+#define POINTS_PER_BIT 4
+#define SCALARS_PER_BIT 3
+
+size_t
+csigma_membership_proof_size(size_t num_points)
+{
+    if (num_points == 0)
+        return 0;
+    size_t n = num_bits(num_points);
+    return POINTS_PER_BIT * n * CSIGMA_POINT_BYTES +
+           (SCALARS_PER_BIT * n + 1) * CSIGMA_SCALAR_BYTES;
+}
+
+// Start a proof transcript: the generators, the set and C (internal)
+static void
+start_transcript(csigma_transcript_t* transcript, const csigma_point_set_t* set,
+                 const uint8_t G[CSIGMA_POINT_BYTES], const uint8_t H[CSIGMA_POINT_BYTES],
+                 const uint8_t C[CSIGMA_POINT_BYTES])
+{
+    csigma_transcript_init(transcript, "one_of_many");
+
+    csigma_transcript_absorb(transcript, G, CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb(transcript, H, CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb(transcript, set->points, set->num_points * CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb(transcript, C, CSIGMA_POINT_BYTES);
+}
+
+// Fiat-Shamir challenge over a started transcript, the proof points and the message
+// (internal)
+static void
+generate_challenge(uint8_t challenge[CSIGMA_SCALAR_BYTES], csigma_transcript_t* transcript,
+                   const uint8_t* points, size_t points_len, const uint8_t* message,
+                   size_t message_len)
+{
+    csigma_transcript_absorb(transcript, points, points_len);
+    csigma_transcript_absorb(transcript, message, message ? message_len : 0);
+    csigma_transcript_challenge(transcript, challenge);
+}
+
+// Pedersen commitment m*G + r*H (internal)
+static int
+commit(uint8_t out[CSIGMA_POINT_BYTES], const uint8_t m[CSIGMA_SCALAR_BYTES],
+       const uint8_t r[CSIGMA_SCALAR_BYTES], const uint8_t G[CSIGMA_POINT_BYTES],
+       const uint8_t H[CSIGMA_POINT_BYTES])
+{
+    uint8_t scalars[2 * CSIGMA_SCALAR_BYTES], points[2 * CSIGMA_POINT_BYTES];
+    memcpy(&scalars[0], m, CSIGMA_SCALAR_BYTES);
+    memcpy(&scalars[CSIGMA_SCALAR_BYTES], r, CSIGMA_SCALAR_BYTES);
+    memcpy(&points[0], G, CSIGMA_POINT_BYTES);
+    memcpy(&points[CSIGMA_POINT_BYTES], H, CSIGMA_POINT_BYTES);
+    int ret = csigma_msm(out, scalars, points, 2);
+    sodium_memzero(scalars, sizeof(scalars));
+    return ret;
+}
+
+// ============================================================================
+// Prover
+// ============================================================================
+
+// Multiply the polynomial at index src by (alpha*X + beta), alpha in {0, 1}, and
+// store it at index dst; dst may equal src (internal)
+// alpha is a secret index bit, so it is applied as a scalar rather than branched on
+// Coefficients are stored coefficient-major: coeffs[k * width + i]
+static void
+poly_mul_linear(uint8_t* coeffs, size_t width, size_t dst, size_t src, size_t degree,
+                const uint8_t alpha[CSIGMA_SCALAR_BYTES], const uint8_t beta[CSIGMA_SCALAR_BYTES])
+{
+    for (size_t k = degree + 2; k-- > 0;) {
+        uint8_t t[CSIGMA_SCALAR_BYTES] = { 0 };
+        uint8_t u[CSIGMA_SCALAR_BYTES];
+        if (k <= degree) {
+            crypto_core_ristretto255_scalar_mul(t, beta, &coeffs[(k * width + src) *
+                                                                 CSIGMA_SCALAR_BYTES]);
+        }
+        if (k >= 1) {
+            crypto_core_ristretto255_scalar_mul(
+                u, alpha, &coeffs[((k - 1) * width + src) * CSIGMA_SCALAR_BYTES]);
+            crypto_core_ristretto255_scalar_add(t, t, u);
+        }
+        memcpy(&coeffs[(k * width + dst) * CSIGMA_SCALAR_BYTES], t, CSIGMA_SCALAR_BYTES);
+    }
+}
+
+int
+csigma_membership_prove(uint8_t* proof, const csigma_point_set_t* set, size_t index,
+                        const uint8_t randomness[CSIGMA_SCALAR_BYTES],
+                        const uint8_t G[CSIGMA_POINT_BYTES], const uint8_t H[CSIGMA_POINT_BYTES],
+                        const uint8_t C[CSIGMA_POINT_BYTES], const uint8_t* message,
+                        size_t message_len)
+{
+    if (!proof || !set || !set->points || set->num_points == 0 || index >= set->num_points ||
+        !randomness || !G || !H || !C)
+        return -1;
+
+    size_t num_points = set->num_points;
+    size_t n          = num_bits(num_points);
+    size_t width      = (size_t) 1 << n;
+
+    uint8_t* B      = proof;
+    uint8_t* A      = &B[n * CSIGMA_POINT_BYTES];
+    uint8_t* Cb     = &A[n * CSIGMA_POINT_BYTES];
+    uint8_t* Gk     = &Cb[n * CSIGMA_POINT_BYTES];
+    uint8_t* f      = &Gk[n * CSIGMA_POINT_BYTES];
+    uint8_t* z_a    = &f[n * CSIGMA_SCALAR_BYTES];
+    uint8_t* z_b    = &z_a[n * CSIGMA_SCALAR_BYTES];
+    uint8_t* z_d    = &z_b[n * CSIGMA_SCALAR_BYTES];
+    uint8_t* coeffs = calloc((n + 1) * width, CSIGMA_SCALAR_BYTES);
+    uint8_t* secret = malloc(6 * n * CSIGMA_SCALAR_BYTES);
+    int      ret    = -1;
+
+    if (!coeffs || !secret)
+        goto done;
+
+    // Per-bit secrets: l_j (index bit), a_j, r_j, s_j, t_j, and the G_k blinders rho_k
+    uint8_t* l   = secret;
+    uint8_t* a   = &l[n * CSIGMA_SCALAR_BYTES];
+    uint8_t* r   = &a[n * CSIGMA_SCALAR_BYTES];
+    uint8_t* s   = &r[n * CSIGMA_SCALAR_BYTES];
+    uint8_t* t   = &s[n * CSIGMA_SCALAR_BYTES];
+    uint8_t* rho = &t[n * CSIGMA_SCALAR_BYTES];
+
+    // a, r, s, t and rho are hedged nonces bound to the statement, the message, the
+    // index and the randomness
+    csigma_transcript_t transcript;
+    shake128_ctx        nonce_transcript;
+    uint8_t             context[CSIGMA_NONCE_CONTEXT_BYTES];
+    uint8_t             witness[8 + CSIGMA_SCALAR_BYTES];
+    start_transcript(&transcript, set, G, H, C);
+    csigma_transcript_nonce_context(&transcript, message, message_len, context);
+    for (size_t i = 0; i < 8; i++) {
+        witness[i] = (uint8_t) ((uint64_t) index >> (8 * i));
+    }
+    memcpy(&witness[8], randomness, CSIGMA_SCALAR_BYTES);
+    csigma_nonce_init(&nonce_transcript);
+    csigma_nonce_absorb_context(&nonce_transcript, context, sizeof(context));
+    csigma_nonce_derive(a, 5 * n, &nonce_transcript, witness, sizeof(witness));
+    sodium_memzero(witness, sizeof(witness));
+
+    for (size_t j = 0; j < n; j++) {
+        uint8_t* l_j = &l[j * CSIGMA_SCALAR_BYTES];
+        uint8_t  la[CSIGMA_SCALAR_BYTES];
+
+        memset(l_j, 0, CSIGMA_SCALAR_BYTES);
+        l_j[0] = (uint8_t) ((index >> j) & 1);
+        crypto_core_ristretto255_scalar_mul(la, l_j, &a[j * CSIGMA_SCALAR_BYTES]);
+
+        // B_j = Com(l_j; r_j), A_j = Com(a_j; s_j), C_j = Com(l_j * a_j; t_j)
+        if (commit(&B[j * CSIGMA_POINT_BYTES], l_j, &r[j * CSIGMA_SCALAR_BYTES], G, H) != 0 ||
+            commit(&A[j * CSIGMA_POINT_BYTES], &a[j * CSIGMA_SCALAR_BYTES],
+                   &s[j * CSIGMA_SCALAR_BYTES], G, H) != 0 ||
+            commit(&Cb[j * CSIGMA_POINT_BYTES], la, &t[j * CSIGMA_SCALAR_BYTES], G, H) != 0) {
+            sodium_memzero(la, sizeof(la));
+            goto done;
+        }
+        sodium_memzero(la, sizeof(la));
+    }
+
+    // p_i(X) = product over bits j of (i_j ? l_j*X + a_j : (1 - l_j)*X - a_j)
+    // Built level by level; p_index has degree n, every other p_i degree < n
+    coeffs[0] = 1;
+    for (size_t j = 0; j < n; j++) {
+        size_t   half = (size_t) 1 << j;
+        uint8_t* l_j  = &l[j * CSIGMA_SCALAR_BYTES];
+        uint8_t  neg_a[CSIGMA_SCALAR_BYTES], not_l[CSIGMA_SCALAR_BYTES] = { 1 };
+        crypto_core_ristretto255_scalar_negate(neg_a, &a[j * CSIGMA_SCALAR_BYTES]);
+        crypto_core_ristretto255_scalar_sub(not_l, not_l, l_j);
+
+        for (size_t i = 0; i < half; i++) {
+            poly_mul_linear(coeffs, width, i + half, i, j, l_j, &a[j * CSIGMA_SCALAR_BYTES]);
+            poly_mul_linear(coeffs, width, i, i, j, not_l, neg_a);
+        }
+        sodium_memzero(not_l, sizeof(not_l));
+    }
+
+    // G_k = sum of p_i,k * P_i + rho_k * H; padded indices repeat the last point
+    for (size_t k = 0; k < n; k++) {
+        uint8_t* p_k  = &coeffs[k * width * CSIGMA_SCALAR_BYTES];
+        uint8_t* last = &p_k[(num_points - 1) * CSIGMA_SCALAR_BYTES];
+        uint8_t* G_k  = &Gk[k * CSIGMA_POINT_BYTES];
+        uint8_t  term[CSIGMA_POINT_BYTES];
+
+        for (size_t i = num_points; i < width; i++) {
+            crypto_core_ristretto255_scalar_add(last, last, &p_k[i * CSIGMA_SCALAR_BYTES]);
+        }
+        if (csigma_msm(G_k, p_k, set->points, num_points) != 0 ||
+            csigma_scalarmult(term, &rho[k * CSIGMA_SCALAR_BYTES], H) != 0 ||
+            crypto_core_ristretto255_add(G_k, G_k, term) != 0)
+            goto done;
+    }
+
+    uint8_t x[CSIGMA_SCALAR_BYTES];
+    generate_challenge(x, &transcript, proof, POINTS_PER_BIT * n * CSIGMA_POINT_BYTES, message,
+                       message_len);
+
+    // f_j = l_j*x + a_j, z_a_j = r_j*x + s_j, z_b_j = r_j*(x - f_j) + t_j
+    for (size_t j = 0; j < n; j++) {
+        uint8_t* f_j = &f[j * CSIGMA_SCALAR_BYTES];
+        uint8_t  tmp[CSIGMA_SCALAR_BYTES];
+
+        crypto_core_ristretto255_scalar_mul(tmp, &l[j * CSIGMA_SCALAR_BYTES], x);
+        crypto_core_ristretto255_scalar_add(f_j, tmp, &a[j * CSIGMA_SCALAR_BYTES]);
+
+        crypto_core_ristretto255_scalar_mul(tmp, &r[j * CSIGMA_SCALAR_BYTES], x);
+        crypto_core_ristretto255_scalar_add(&z_a[j * CSIGMA_SCALAR_BYTES], tmp,
+                                            &s[j * CSIGMA_SCALAR_BYTES]);
+
+        crypto_core_ristretto255_scalar_sub(tmp, x, f_j);
+        crypto_core_ristretto255_scalar_mul(tmp, tmp, &r[j * CSIGMA_SCALAR_BYTES]);
+        crypto_core_ristretto255_scalar_add(&z_b[j * CSIGMA_SCALAR_BYTES], tmp,
+                                            &t[j * CSIGMA_SCALAR_BYTES]);
+    }
+
+    // z_d = randomness * x^n + sum of rho_k * x^k
+    uint8_t power[CSIGMA_SCALAR_BYTES] = { 1 }, tmp[CSIGMA_SCALAR_BYTES];
+    memset(z_d, 0, CSIGMA_SCALAR_BYTES);
+    for (size_t k = 0; k < n; k++) {
+        crypto_core_ristretto255_scalar_mul(tmp, &rho[k * CSIGMA_SCALAR_BYTES], power);
+        crypto_core_ristretto255_scalar_add(z_d, z_d, tmp);
+        crypto_core_ristretto255_scalar_mul(power, power, x);
+    }
+    crypto_core_ristretto255_scalar_mul(tmp, randomness, power);
+    crypto_core_ristretto255_scalar_add(z_d, z_d, tmp);
+    sodium_memzero(tmp, sizeof(tmp));
+    ret = 0;
+
+done:
+    if (secret) {
+        sodium_memzero(secret, 6 * n * CSIGMA_SCALAR_BYTES);
+    }
+    if (coeffs) {
+        sodium_memzero(coeffs, (n + 1) * width * CSIGMA_SCALAR_BYTES);
+    }
+    free(secret);
+    free(coeffs);
+    return ret;
+}
+
+// ============================================================================
+// Verifier
+// ============================================================================
+
+// Checks, combined with random weights w_j, v_j into one multi-scalar multiplication:
+//   x*B_j + A_j = f_j*G + z_a_j*H                  (f_j opens x*l_j + a_j)
+//   (x - f_j)*B_j + C_j = z_b_j*H                  (l_j is a bit)
+//   sum of p_i(x)*P_i - x^n*C - sum of x^k*G_k + z_d*H = 0
+// where p_i(x) = product over bits j of (i_j ? f_j : x - f_j). For the prover's
+// index p_l(x) = x^n + lower terms, every other p_i has degree < n, and the G_k
+// cancel the lower terms.
+bool
+csigma_membership_verify(const uint8_t* proof, size_t proof_len, const csigma_point_set_t* set,
+                         const uint8_t G[CSIGMA_POINT_BYTES], const uint8_t H[CSIGMA_POINT_BYTES],
+                         const uint8_t C[CSIGMA_POINT_BYTES], const uint8_t* message,
+                         size_t message_len)
+{
+    if (!proof || !set || !set->points || !G || !H || !C || set->num_points == 0 ||
+        proof_len != csigma_membership_proof_size(set->num_points))
+        return false;
+
+    size_t         num_points = set->num_points;
+    size_t         n          = num_bits(num_points);
+    size_t         width      = (size_t) 1 << n;
+    const uint8_t* B          = proof;
+    const uint8_t* A          = &B[n * CSIGMA_POINT_BYTES];
+    const uint8_t* Cb         = &A[n * CSIGMA_POINT_BYTES];
+    const uint8_t* Gk         = &Cb[n * CSIGMA_POINT_BYTES];
+    const uint8_t* f          = &Gk[n * CSIGMA_POINT_BYTES];
+    const uint8_t* z_a        = &f[n * CSIGMA_SCALAR_BYTES];
+    const uint8_t* z_b        = &z_a[n * CSIGMA_SCALAR_BYTES];
+    const uint8_t* z_d        = &z_b[n * CSIGMA_SCALAR_BYTES];
+
+    csigma_transcript_t transcript;
+    uint8_t             x[CSIGMA_SCALAR_BYTES];
+    start_transcript(&transcript, set, G, H, C);
+    generate_challenge(x, &transcript, proof, POINTS_PER_BIT * n * CSIGMA_POINT_BYTES, message,
+                       message_len);
+
+    uint8_t* p     = malloc(width * CSIGMA_SCALAR_BYTES);
+    bool     valid = false;
+    msm_t    msm;
+    msm_init(&msm);
+    if (!p)
+        goto done;
+
+    // p_i(x) for every index, doubling the number of known values per bit
+    memset(p, 0, CSIGMA_SCALAR_BYTES);
+    p[0] = 1;
+    for (size_t j = 0; j < n; j++) {
+        size_t         half = (size_t) 1 << j;
+        const uint8_t* f_j  = &f[j * CSIGMA_SCALAR_BYTES];
+        uint8_t        g_j[CSIGMA_SCALAR_BYTES];
+        crypto_core_ristretto255_scalar_sub(g_j, x, f_j);
+
+        for (size_t i = 0; i < half; i++) {
+            uint8_t* p_i = &p[i * CSIGMA_SCALAR_BYTES];
+            crypto_core_ristretto255_scalar_mul(&p[(i + half) * CSIGMA_SCALAR_BYTES], p_i, f_j);
+            crypto_core_ristretto255_scalar_mul(p_i, p_i, g_j);
+        }
+    }
+
+    // Padded indices repeat the last point
+    uint8_t* last = &p[(num_points - 1) * CSIGMA_SCALAR_BYTES];
+    for (size_t i = num_points; i < width; i++) {
+        crypto_core_ristretto255_scalar_add(last, last, &p[i * CSIGMA_SCALAR_BYTES]);
+    }
+
+    // Set sum: one term per set point
+    for (size_t i = 0; i < num_points; i++) {
+        if (msm_add_term(&msm, &p[i * CSIGMA_SCALAR_BYTES], &set->points[i * CSIGMA_POINT_BYTES]) !=
+            0)
+            goto done;
+    }
+
+    // -x^k * G_k, then -x^n * C
+    uint8_t power[CSIGMA_SCALAR_BYTES] = { 1 }, scalar[CSIGMA_SCALAR_BYTES];
+    for (size_t k = 0; k < n; k++) {
+        crypto_core_ristretto255_scalar_negate(scalar, power);
+        if (msm_add_term(&msm, scalar, &Gk[k * CSIGMA_POINT_BYTES]) != 0)
+            goto done;
+        crypto_core_ristretto255_scalar_mul(power, power, x);
+    }
+    crypto_core_ristretto255_scalar_negate(scalar, power);
+    if (msm_add_term(&msm, scalar, C) != 0)
+        goto done;
+
+    // Scalars of G and H accumulate across all equations
+    uint8_t g_scalar[CSIGMA_SCALAR_BYTES] = { 0 };
+    uint8_t h_scalar[CSIGMA_SCALAR_BYTES];
+    memcpy(h_scalar, z_d, CSIGMA_SCALAR_BYTES);
+
+    for (size_t j = 0; j < n; j++) {
+        const uint8_t* f_j = &f[j * CSIGMA_SCALAR_BYTES];
+        uint8_t        w[CSIGMA_SCALAR_BYTES], v[CSIGMA_SCALAR_BYTES], tmp[CSIGMA_SCALAR_BYTES];
+        crypto_core_ristretto255_scalar_random(w);
+        crypto_core_ristretto255_scalar_random(v);
+
+        // B_j: w*x + v*(x - f_j)
+        crypto_core_ristretto255_scalar_sub(tmp, x, f_j);
+        crypto_core_ristretto255_scalar_mul(tmp, tmp, v);
+        crypto_core_ristretto255_scalar_mul(scalar, w, x);
+        crypto_core_ristretto255_scalar_add(scalar, scalar, tmp);
+        if (msm_add_term(&msm, scalar, &B[j * CSIGMA_POINT_BYTES]) != 0 ||
+            msm_add_term(&msm, w, &A[j * CSIGMA_POINT_BYTES]) != 0 ||
+            msm_add_term(&msm, v, &Cb[j * CSIGMA_POINT_BYTES]) != 0)
+            goto done;
+
+        // G: -w*f_j; H: -w*z_a_j - v*z_b_j
+        crypto_core_ristretto255_scalar_mul(tmp, w, f_j);
+        crypto_core_ristretto255_scalar_sub(g_scalar, g_scalar, tmp);
+        crypto_core_ristretto255_scalar_mul(tmp, w, &z_a[j * CSIGMA_SCALAR_BYTES]);
+        crypto_core_ristretto255_scalar_sub(h_scalar, h_scalar, tmp);
+        crypto_core_ristretto255_scalar_mul(tmp, v, &z_b[j * CSIGMA_SCALAR_BYTES]);
+        crypto_core_ristretto255_scalar_sub(h_scalar, h_scalar, tmp);
+    }
+    if (msm_add_term(&msm, g_scalar, G) != 0 || msm_add_term(&msm, h_scalar, H) != 0)
+        goto done;
+
+    valid = msm_is_identity(&msm);
+
+done:
+    msm_destroy(&msm);
+    free(p);
+    return valid;
+}
@@ -0,0 +1,61 @@
+#ifndef MEMBERSHIP_H
+#define MEMBERSHIP_H
+
+#include "csigma.h"
+
+// One-out-of-many membership proofs (Groth-Kohlweiss)
+// Proves knowledge of an index l and a scalar r such that C = P_l + r*H for a public
+// set of points P_0..P_{N-1}, without revealing l. Typical use: C is a re-randomized
+// public key, and the proof shows that it comes from a key of the set.
+//
+// The index is committed to bit by bit with Pedersen commitments m*G + r*H; G and H
+// must be independent generators (for example from csigma_derive_generators()).
+// Sets are padded to a power of two by repeating the last point.
+//
+// With n = max(1, ceil(log2(N))) the proof holds 4n points and 3n + 1 scalars
+// (224n + 32 bytes), and the verifier checks everything with one multi-scalar
+// multiplication over the N set points plus O(n) proof points.
+// The prover computes n multi-scalar multiplications over the set.
+
+// Point set: a contiguous array of N 32-byte points, either borrowed from the
+// caller or memory-mapped from a file. Points are validated when they are used.
+typedef struct {
+    const uint8_t* points; // N points (32 bytes each)
+    size_t         num_points; // N
+    void*          mapping; // Memory mapping (NULL if borrowed)
+    size_t         mapping_len; // Length of the mapping
+} csigma_point_set_t;
+
+// Use a caller-owned array of points (must outlive the set)
+void csigma_point_set_init(csigma_point_set_t* set, const uint8_t* points, size_t num_points);
+
+// Map a file holding N contiguous 32-byte points, read-only
+// Returns 0 on success, -1 if the file cannot be mapped or its size is not a
+// non-zero multiple of 32 bytes
+int csigma_point_set_map(csigma_point_set_t* set, const char* path);
+
+// Release the set (unmaps the file if the set was mapped)
+void csigma_point_set_destroy(csigma_point_set_t* set);
+
+// Calculate membership proof size in bytes for a set of num_points points
+size_t csigma_membership_proof_size(size_t num_points);
+
+// Prove that C = P_index + randomness*H for a point of the set
+// proof: output buffer of csigma_membership_proof_size(N) bytes
+// Returns 0 on success, -1 on error
+int csigma_membership_prove(uint8_t* proof, const csigma_point_set_t* set, size_t index,
+                            const uint8_t randomness[CSIGMA_SCALAR_BYTES],
+                            const uint8_t G[CSIGMA_POINT_BYTES],
+                            const uint8_t H[CSIGMA_POINT_BYTES],
+                            const uint8_t C[CSIGMA_POINT_BYTES], const uint8_t* message,
+                            size_t message_len);
+
+// Verify a membership proof with a single multi-scalar multiplication
+// Returns true if valid, false otherwise
+bool csigma_membership_verify(const uint8_t* proof, size_t proof_len,
+                              const csigma_point_set_t* set, const uint8_t G[CSIGMA_POINT_BYTES],
+                              const uint8_t H[CSIGMA_POINT_BYTES],
+                              const uint8_t C[CSIGMA_POINT_BYTES], const uint8_t* message,
+                              size_t message_len);
+
+#endif
@@ -0,0 +1,210 @@
+#include "msm.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Initial capacity for the term arrays
+#define INITIAL_MSM_CAPACITY 8
+
+// Largest one-shot sum sorted without a heap allocation
+#define MSM_STACK_TERMS 32
+
+// Encoding of the standard Ristretto255 generator
+static const uint8_t ristretto255_basepoint[CSIGMA_POINT_BYTES] = {
+    0xe2, 0xf2, 0xae, 0x0a, 0x6a, 0xbc, 0x4e, 0x71, 0xa8, 0x84, 0xa9, 0x61, 0xc5, 0x00, 0x51, 0x5f,
+    0x58, 0xe3, 0x0b, 0x6a, 0xa5, 0x82, 0xdd, 0x8d, 0xb6, 0xa6, 0x59, 0x45, 0xe0, 0x8d, 0x2d, 0x76
+};
+
+// Sort key for merging terms on the same point (internal)
+typedef struct {
+    const uint8_t* point;
+    size_t         index;
+} point_ref_t;
+
+static int
+compare_point_refs(const void* a, const void* b)
+{
+    const point_ref_t* x = a;
+    const point_ref_t* y = b;
+
+    int c = memcmp(x->point, y->point, CSIGMA_POINT_BYTES);
+    if (c != 0)
+        return c;
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+// Multi-scalar multiplication with a caller-provided sort buffer of n entries (internal)
+static int
+msm_compute(uint8_t out[CSIGMA_POINT_BYTES], const uint8_t* scalars, const uint8_t* points,
+            size_t n, point_ref_t* refs)
+{
+    memset(out, 0, CSIGMA_POINT_BYTES);
+    if (n == 0) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        refs[i].point = &points[i * CSIGMA_POINT_BYTES];
+        refs[i].index = i;
+    }
+    qsort(refs, n, sizeof(point_ref_t), compare_point_refs);
+
+    bool first = true;
+    for (size_t i = 0; i < n;) {
+        // Fold the scalars of every term on this point
+        uint8_t scalar[CSIGMA_SCALAR_BYTES];
+        memcpy(scalar, &scalars[refs[i].index * CSIGMA_SCALAR_BYTES], CSIGMA_SCALAR_BYTES);
+        size_t j = i + 1;
+        while (j < n && memcmp(refs[j].point, refs[i].point, CSIGMA_POINT_BYTES) == 0) {
+            crypto_core_ristretto255_scalar_add(scalar, scalar,
+                                                &scalars[refs[j].index * CSIGMA_SCALAR_BYTES]);
+            j++;
+        }
+
+        // Reduce before the zero test: callers may pass unreduced scalars
+        uint8_t wide[crypto_core_ristretto255_NONREDUCEDSCALARBYTES] = { 0 };
+        memcpy(wide, scalar, CSIGMA_SCALAR_BYTES);
+        crypto_core_ristretto255_scalar_reduce(scalar, wide);
+
+        // Zero scalars and identity points contribute nothing
+        if (!sodium_is_zero(scalar, CSIGMA_SCALAR_BYTES) &&
+            !sodium_is_zero(refs[i].point, CSIGMA_POINT_BYTES)) {
+            uint8_t term[CSIGMA_POINT_BYTES];
+            if (csigma_scalarmult(term, scalar, refs[i].point) != 0) {
+                return -1;
+            }
+            if (first) {
+                memcpy(out, term, CSIGMA_POINT_BYTES);
+                first = false;
+            } else if (crypto_core_ristretto255_add(out, out, term) != 0) {
+                return -1;
+            }
+        } else if (crypto_core_ristretto255_is_valid_point(refs[i].point) != 1) {
+            // Skipped terms must still carry valid points
+            return -1;
+        }
+        i = j;
+    }
+    return 0;
+}
+
+void
+msm_init(msm_t* msm)
+{
+    msm->scalars   = NULL;
+    msm->points    = NULL;
+    msm->refs      = NULL;
+    msm->num_terms = 0;
+    msm->capacity  = 0;
+}
+
+void
+msm_destroy(msm_t* msm)
+{
+    if (msm->scalars) {
+        sodium_memzero(msm->scalars, msm->capacity * CSIGMA_SCALAR_BYTES);
+    }
+    free(msm->scalars);
+    free(msm->points);
+    free(msm->refs);
+    msm_init(msm);
+}
+
+void
+msm_reset(msm_t* msm)
+{
+    msm->num_terms = 0;
+}
+
+int
+msm_reserve(msm_t* msm, size_t capacity)
+{
+    if (capacity <= msm->capacity) {
+        return 0;
+    }
+    uint8_t* scalars = realloc(msm->scalars, capacity * CSIGMA_SCALAR_BYTES);
+    if (!scalars) {
+        return -1;
+    }
+    msm->scalars = scalars;
+    uint8_t* points = realloc(msm->points, capacity * CSIGMA_POINT_BYTES);
+    if (!points) {
+        return -1;
+    }
+    msm->points = points;
+    void* refs  = realloc(msm->refs, capacity * sizeof(point_ref_t));
+    if (!refs) {
+        return -1;
+    }
+    msm->refs     = refs;
+    msm->capacity = capacity;
+    return 0;
+}
+
+int
+msm_add_term(msm_t* msm, const uint8_t scalar[CSIGMA_SCALAR_BYTES],
+             const uint8_t point[CSIGMA_POINT_BYTES])
+{
+    if (msm->num_terms >= msm->capacity &&
+        msm_reserve(msm, msm->capacity ? msm->capacity * 2 : INITIAL_MSM_CAPACITY) != 0) {
+        return -1;
+    }
+    memcpy(&msm->scalars[msm->num_terms * CSIGMA_SCALAR_BYTES], scalar, CSIGMA_SCALAR_BYTES);
+    memcpy(&msm->points[msm->num_terms * CSIGMA_POINT_BYTES], point, CSIGMA_POINT_BYTES);
+    msm->num_terms++;
+    return 0;
+}
+
+int
+msm_eval(const msm_t* msm, uint8_t out[CSIGMA_POINT_BYTES])
+{
+    return msm_compute(out, msm->scalars, msm->points, msm->num_terms, msm->refs);
+}
+
+bool
+msm_is_identity(const msm_t* msm)
+{
+    uint8_t sum[CSIGMA_POINT_BYTES];
+    if (msm_eval(msm, sum) != 0) {
+        return false;
+    }
+    return sodium_is_zero(sum, CSIGMA_POINT_BYTES) == 1;
+}
+
+int
+csigma_scalarmult(uint8_t out[CSIGMA_POINT_BYTES], const uint8_t scalar[CSIGMA_SCALAR_BYTES],
+                  const uint8_t point[CSIGMA_POINT_BYTES])
+{
+    int ret;
+    if (memcmp(point, ristretto255_basepoint, CSIGMA_POINT_BYTES) == 0) {
+        ret = crypto_scalarmult_ristretto255_base(out, scalar);
+    } else {
+        ret = crypto_scalarmult_ristretto255(out, scalar, point);
+    }
+    if (ret != 0) {
+        // libsodium refuses to return the identity: distinguish it from an invalid point
+        if (crypto_core_ristretto255_is_valid_point(point) != 1) {
+            return -1;
+        }
+        memset(out, 0, CSIGMA_POINT_BYTES);
+    }
+    return 0;
+}
+
+int
+csigma_msm(uint8_t out[CSIGMA_POINT_BYTES], const uint8_t* scalars, const uint8_t* points,
+           size_t n)
+{
+    // Small sums sort on the stack
+    point_ref_t  stack_refs[MSM_STACK_TERMS];
+    point_ref_t* refs = n <= MSM_STACK_TERMS ? stack_refs : malloc(n * sizeof(point_ref_t));
+    if (!refs) {
+        memset(out, 0, CSIGMA_POINT_BYTES);
+        return -1;
+    }
+
+    int ret = msm_compute(out, scalars, points, n, refs);
+    if (refs != stack_refs) {
+        free(refs);
+    }
+    return ret;
+}
@@ -0,0 +1,57 @@
+#ifndef MSM_H
+#define MSM_H
+
+#include "csigma.h"
+
+// Multi-scalar multiplication over Ristretto255
+// Computes sum_i (scalar_i * point_i). Terms sharing the same point are merged
+// (their scalars are added) before any point arithmetic, zero scalars and identity
+// points are skipped, and terms on the standard generator use the faster fixed-base
+// multiplication.
+// An identity result is encoded as 32 zero bytes.
+
+// MSM accumulator: collects (scalar, point) terms to evaluate together
+typedef struct {
+    uint8_t* scalars; // Term scalars (32 bytes each)
+    uint8_t* points; // Term points (32 bytes each)
+    void*    refs; // Sort buffer used by msm_eval()
+    size_t   num_terms; // Number of terms
+    size_t   capacity; // Allocated capacity
+} msm_t;
+
+// MSM accumulator operations (internal, for advanced use)
+void msm_init(msm_t* msm);
+void msm_destroy(msm_t* msm);
+void msm_reset(msm_t* msm);
+
+// Preallocate room for capacity terms, so that adding and evaluating up to that many
+// terms does not allocate
+// Returns 0 on success, -1 on allocation failure
+int msm_reserve(msm_t* msm, size_t capacity);
+
+// Append scalar * point
+// Returns 0 on success, -1 on allocation failure
+int msm_add_term(msm_t* msm, const uint8_t scalar[CSIGMA_SCALAR_BYTES],
+                 const uint8_t point[CSIGMA_POINT_BYTES]);
+
+// Evaluate the accumulated sum
+// Returns 0 on success, -1 if a point is invalid
+int msm_eval(const msm_t* msm, uint8_t out[CSIGMA_POINT_BYTES]);
+
+// Evaluate the accumulated sum and check that it is the identity
+// Returns false if the sum is not the identity or a point is invalid
+bool msm_is_identity(const msm_t* msm);
+
+// One-shot multi-scalar multiplication
+// scalars: array of n 32-byte scalars
+// points: array of n 32-byte points
+// Returns 0 on success, -1 if a point is invalid
+int csigma_msm(uint8_t out[CSIGMA_POINT_BYTES], const uint8_t* scalars, const uint8_t* points,
+               size_t n);
+
+// Scalar multiplication that encodes an identity result instead of failing
+// Returns 0 on success, -1 if the point is invalid
+int csigma_scalarmult(uint8_t out[CSIGMA_POINT_BYTES], const uint8_t scalar[CSIGMA_SCALAR_BYTES],
+                      const uint8_t point[CSIGMA_POINT_BYTES]);
+
+#endif
@@ -0,0 +1,141 @@
+#include "nonce.h"
+#include <pthread.h>
+#include <string.h>
+
+// Output bytes produced per refill, after the next key
+#define RANDOM_BUFFER_BYTES 512
+
+// Per-thread generator state (internal)
+typedef struct {
+    uint8_t key[randombytes_SEEDBYTES];
+    uint8_t buffer[RANDOM_BUFFER_BYTES];
+    size_t  available; // Unused bytes at the end of the buffer
+    size_t  since_reseed; // Output bytes since the key was drawn from the system
+    size_t  generation; // Fork generation the key was drawn in
+    int     seeded; // 0 before the first use
+} random_state_t;
+
+static _Thread_local random_state_t random_state;
+
+// Source of nonce seeds (see csigma_nonce_set_seed_source())
+static csigma_seed_fn seed_source = csigma_random_bytes;
+
+// Incremented in the child after every fork, so that no syscall is needed to detect one
+static size_t         fork_generation;
+static pthread_once_t fork_handler_once = PTHREAD_ONCE_INIT;
+
+static void
+on_fork_child(void)
+{
+    fork_generation++;
+}
+
+static void
+register_fork_handler(void)
+{
+    pthread_atfork(NULL, NULL, on_fork_child);
+}
+
+// Refill the buffer, replacing the key with the first bytes of its own stream (internal)
+static void
+random_refill(random_state_t* state)
+{
+    if (!state->seeded || state->generation != fork_generation ||
+        state->since_reseed >= CSIGMA_RANDOM_RESEED_BYTES) {
+        randombytes_buf(state->key, sizeof(state->key));
+        state->seeded       = 1;
+        state->generation   = fork_generation;
+        state->since_reseed = 0;
+    }
+
+    uint8_t stream[randombytes_SEEDBYTES + RANDOM_BUFFER_BYTES];
+    randombytes_buf_deterministic(stream, sizeof(stream), state->key);
+    memcpy(state->key, stream, sizeof(state->key));
+    memcpy(state->buffer, &stream[sizeof(state->key)], RANDOM_BUFFER_BYTES);
+    sodium_memzero(stream, sizeof(stream));
+    state->available = RANDOM_BUFFER_BYTES;
+}
+
+void
+csigma_random_bytes(uint8_t* out, size_t len)
+{
+    random_state_t* state = &random_state;
+    pthread_once(&fork_handler_once, register_fork_handler);
+
+    while (len > 0) {
+        // A forked child must not reuse what is left of the parent's buffer
+        if (state->available == 0 || state->generation != fork_generation) {
+            random_refill(state);
+        }
+        size_t   count  = len < state->available ? len : state->available;
+        uint8_t* source = &state->buffer[RANDOM_BUFFER_BYTES - state->available];
+        memcpy(out, source, count);
+        sodium_memzero(source, count);
+        state->available -= count;
+        state->since_reseed += count;
+        out += count;
+        len -= count;
+    }
+}
+
+void
+csigma_nonce_init(shake128_ctx* transcript)
+{
+    shake128_init(transcript);
+    shake128_absorb(transcript, (const uint8_t*) "csigma_nonces", 13);
+}
+
+void
+csigma_nonce_absorb_context(shake128_ctx* transcript, const uint8_t* context, size_t context_len)
+{
+    uint8_t len[8];
+    for (size_t i = 0; i < 8; i++) {
+        len[i] = (uint8_t) ((uint64_t) context_len >> (8 * (7 - i)));
+    }
+    shake128_absorb(transcript, len, sizeof(len));
+    if (context_len > 0) {
+        shake128_absorb(transcript, context, context_len);
+    }
+}
+
+void
+csigma_nonce_set_seed_source(csigma_seed_fn source)
+{
+    seed_source = source ? source : csigma_random_bytes;
+}
+
+void
+csigma_nonce_start(shake128_ctx* stream, const shake128_ctx* transcript, const uint8_t* witness,
+                   size_t witness_len)
+{
+    uint8_t seed[CSIGMA_NONCE_SEED_BYTES];
+    seed_source(seed, sizeof(seed));
+
+    *stream = *transcript;
+    shake128_absorb(stream, seed, sizeof(seed));
+    if (witness_len > 0) {
+        shake128_absorb(stream, witness, witness_len);
+    }
+    sodium_memzero(seed, sizeof(seed));
+}
+
+void
+csigma_nonce_squeeze(shake128_ctx* stream, uint8_t* nonces, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        uint8_t wide[64];
+        shake128_squeeze(stream, wide, sizeof(wide));
+        crypto_core_ristretto255_scalar_reduce(&nonces[i * CSIGMA_SCALAR_BYTES], wide);
+        sodium_memzero(wide, sizeof(wide));
+    }
+}
+
+void
+csigma_nonce_derive(uint8_t* nonces, size_t n, const shake128_ctx* transcript,
+                    const uint8_t* witness, size_t witness_len)
+{
+    shake128_ctx stream;
+    csigma_nonce_start(&stream, transcript, witness, witness_len);
+    csigma_nonce_squeeze(&stream, nonces, n);
+    sodium_memzero(&stream, sizeof(stream));
+}
@@ -0,0 +1,60 @@
+#ifndef NONCE_H
+#define NONCE_H
+
+#include "csigma.h"
+#include "keccak.h"
+
+// Hedged nonce generation
+// Prover nonces are derived in one SHAKE128 stream from the statement, the
+// Fiat-Shamir context of the proof, the witness and a fresh 32-byte seed:
+//   nonces = SHAKE128("csigma_nonces" || statement || I2OSP(len(context), 8) ||
+//                     context || seed || witness)
+// with 64 output bytes reduced per nonce. The context is a digest of everything the
+// challenge depends on besides the commitment: protocol identifier, public inputs
+// and message (see csigma_transcript_nonce_context()). A failing or predictable random
+// generator then no longer leaks the witness: two proofs can only share nonces if
+// they share their challenge, and a good seed keeps nonces unpredictable even to
+// someone who knows the witness. Interactive provers, whose challenge is not derived
+// from a transcript, have no context and rely on the seed alone.
+//
+// Seeds come from a per-thread generator: a ChaCha20 key is expanded into a buffer,
+// whose first 32 bytes replace the key (fast key erasure). The generator draws a new
+// key from the system every CSIGMA_RANDOM_RESEED_BYTES output bytes, and after a
+// fork, so that parent and child never share a stream.
+
+#define CSIGMA_NONCE_SEED_BYTES 32
+#define CSIGMA_RANDOM_RESEED_BYTES (1 << 20)
+
+// Fill out with bytes from the calling thread's generator
+void csigma_random_bytes(uint8_t* out, size_t len);
+
+// Start a nonce transcript: the statement is absorbed after this call, then the
+// context, and the transcript can be copied to derive nonces for several witnesses
+void csigma_nonce_init(shake128_ctx* transcript);
+
+// Absorb the Fiat-Shamir context of a proof (context may be NULL if context_len is 0)
+void csigma_nonce_absorb_context(shake128_ctx* transcript, const uint8_t* context,
+                                 size_t context_len);
+
+// Replace the source of nonce seeds; NULL restores csigma_random_bytes()
+// For tests only: a constant source makes nonces a function of the statement, the
+// context and the witness. Set it while no proof is being computed.
+typedef void (*csigma_seed_fn)(uint8_t* seed, size_t len);
+void csigma_nonce_set_seed_source(csigma_seed_fn source);
+
+// Start a nonce stream: a copy of the transcript with a fresh seed and the witness
+// absorbed. The stream is a compact stand-in for the nonces: a copy of it yields them
+// again, in chunks of any size.
+void csigma_nonce_start(shake128_ctx* stream, const shake128_ctx* transcript,
+                        const uint8_t* witness, size_t witness_len);
+
+// Next n nonces of a stream
+void csigma_nonce_squeeze(shake128_ctx* stream, uint8_t* nonces, size_t n);
+
+// Derive n nonces from a nonce transcript with the statement and the context absorbed
+// witness: witness_len bytes
+// nonces: output array of n 32-byte scalars
+void csigma_nonce_derive(uint8_t* nonces, size_t n, const shake128_ctx* transcript,
+                         const uint8_t* witness, size_t witness_len);
+
+#endif
@@ -0,0 +1,597 @@
+#include "optimizer.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Shared-sum extraction only looks at rows up to this many products
+#define CSE_MAX_ROW_TERMS 32
+// Maximum number of shared-sum extraction rounds
+#define CSE_MAX_ROUNDS 16
+
+// Evaluation plan
+// Nodes [0, num_products) are products (sum_k coeff_k * scalar_k) * element.
+// Nodes [num_products, num_products + num_sums) are sums of two earlier nodes.
+// Each row is the sum of a list of nodes.
+struct linear_map_plan {
+    size_t   num_products;
+    int*     product_elements; // Canonical element of each product
+    size_t*  product_offsets; // num_products + 1 offsets into product_scalars
+    int*     product_scalars; // Scalar indices of each product
+    uint8_t* product_coeffs; // Coefficient of each scalar index (32-byte scalars)
+    size_t   num_sums;
+    int*     sum_operands; // Two node indices per sum
+    size_t   num_rows;
+    size_t*  row_offsets; // num_rows + 1 offsets into row_nodes
+    int*     row_nodes; // Nodes summed by each row
+};
+
+// ============================================================================
+// Sort helpers (internal)
+// ============================================================================
+
+typedef struct {
+    const uint8_t* encoding;
+    int            index;
+} element_ref_t;
+
+static int
+compare_element_refs(const void* a, const void* b)
+{
+    const element_ref_t* x = a;
+    const element_ref_t* y = b;
+
+    int c = memcmp(x->encoding, y->encoding, CSIGMA_POINT_BYTES);
+    if (c != 0)
+        return c;
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+typedef struct {
+    int            element;
+    int            scalar;
+    const uint8_t* coeff; // NULL for a unit coefficient
+} term_ref_t;
+
+static int
+compare_term_refs(const void* a, const void* b)
+{
+    const term_ref_t* x = a;
+    const term_ref_t* y = b;
+
+    if (x->element != y->element)
+        return (x->element > y->element) - (x->element < y->element);
+    return (x->scalar > y->scalar) - (x->scalar < y->scalar);
+}
+
+typedef struct {
+    int            element;
+    const int*     scalars;
+    const uint8_t* coeffs;
+    size_t         len;
+    size_t         candidate; // Position in the per-row candidate list
+} product_ref_t;
+
+static int
+compare_product_refs(const void* a, const void* b)
+{
+    const product_ref_t* x = a;
+    const product_ref_t* y = b;
+
+    if (x->element != y->element)
+        return (x->element > y->element) - (x->element < y->element);
+    if (x->len != y->len)
+        return (x->len > y->len) - (x->len < y->len);
+    for (size_t i = 0; i < x->len; i++) {
+        if (x->scalars[i] != y->scalars[i])
+            return (x->scalars[i] > y->scalars[i]) - (x->scalars[i] < y->scalars[i]);
+    }
+    int c = memcmp(x->coeffs, y->coeffs, x->len * CSIGMA_SCALAR_BYTES);
+    if (c != 0)
+        return c;
+    return (x->candidate > y->candidate) - (x->candidate < y->candidate);
+}
+
+typedef struct {
+    int    a, b;
+    size_t row;
+} pair_ref_t;
+
+static int
+compare_pair_refs(const void* a, const void* b)
+{
+    const pair_ref_t* x = a;
+    const pair_ref_t* y = b;
+
+    if (x->a != y->a)
+        return (x->a > y->a) - (x->a < y->a);
+    if (x->b != y->b)
+        return (x->b > y->b) - (x->b < y->b);
+    return (x->row > y->row) - (x->row < y->row);
+}
+
+typedef struct {
+    size_t start;
+    size_t count;
+} pair_group_t;
+
+static int
+compare_pair_groups(const void* a, const void* b)
+{
+    const pair_group_t* x = a;
+    const pair_group_t* y = b;
+
+    // Most frequent pairs first, ties in input order
+    if (x->count != y->count)
+        return (x->count < y->count) - (x->count > y->count);
+    return (x->start > y->start) - (x->start < y->start);
+}
+
+// ============================================================================
+// Plan construction (internal)
+// ============================================================================
+
+// Row of node indices being rewritten by shared-sum extraction
+typedef struct {
+    int*   nodes;
+    size_t len;
+} plan_row_t;
+
+static int
+row_find(const plan_row_t* row, int node)
+{
+    for (size_t i = 0; i < row->len; i++) {
+        if (row->nodes[i] == node)
+            return (int) i;
+    }
+    return -1;
+}
+
+static void
+row_remove(plan_row_t* row, int node)
+{
+    int pos = row_find(row, node);
+    row->nodes[pos] = row->nodes[row->len - 1];
+    row->len--;
+}
+
+static void
+coeff_accumulate(uint8_t coeff[CSIGMA_SCALAR_BYTES], const uint8_t* term_coeff)
+{
+    uint8_t one[CSIGMA_SCALAR_BYTES] = { 1 };
+    crypto_core_ristretto255_scalar_add(coeff, coeff, term_coeff ? term_coeff : one);
+}
+
+// One round of shared-sum extraction
+// Returns the number of sum nodes created, or -1 on allocation failure
+static int
+extract_shared_sums(plan_row_t* rows, size_t num_rows, int** sum_operands, size_t* num_sums,
+                    size_t* sums_capacity, size_t num_products)
+{
+    size_t num_pairs = 0;
+    for (size_t r = 0; r < num_rows; r++) {
+        if (rows[r].len >= 2 && rows[r].len <= CSE_MAX_ROW_TERMS)
+            num_pairs += rows[r].len * (rows[r].len - 1) / 2;
+    }
+    if (num_pairs < 2)
+        return 0;
+
+    pair_ref_t*   pairs  = malloc(num_pairs * sizeof(pair_ref_t));
+    pair_group_t* groups = malloc(num_pairs * sizeof(pair_group_t));
+    if (!pairs || !groups) {
+        free(pairs);
+        free(groups);
+        return -1;
+    }
+
+    size_t n = 0;
+    for (size_t r = 0; r < num_rows; r++) {
+        if (rows[r].len < 2 || rows[r].len > CSE_MAX_ROW_TERMS)
+            continue;
+        for (size_t i = 0; i < rows[r].len; i++) {
+            for (size_t j = i + 1; j < rows[r].len; j++) {
+                int a      = rows[r].nodes[i];
+                int b      = rows[r].nodes[j];
+                pairs[n].a = a < b ? a : b;
+                pairs[n].b = a < b ? b : a;
+                pairs[n].row = r;
+                n++;
+            }
+        }
+    }
+    qsort(pairs, n, sizeof(pair_ref_t), compare_pair_refs);
+
+    // Group identical pairs occurring in at least two rows
+    size_t num_groups = 0;
+    for (size_t i = 0; i < n;) {
+        size_t j = i + 1;
+        while (j < n && pairs[j].a == pairs[i].a && pairs[j].b == pairs[i].b)
+            j++;
+        if (j - i >= 2) {
+            groups[num_groups].start = i;
+            groups[num_groups].count = j - i;
+            num_groups++;
+        }
+        i = j;
+    }
+    qsort(groups, num_groups, sizeof(pair_group_t), compare_pair_groups);
+
+    int created = 0;
+    for (size_t g = 0; g < num_groups; g++) {
+        const pair_ref_t* group = &pairs[groups[g].start];
+        int               a     = group[0].a;
+        int               b     = group[0].b;
+
+        // Earlier extractions in this round may have consumed a or b
+        size_t live = 0;
+        for (size_t k = 0; k < groups[g].count; k++) {
+            const plan_row_t* row = &rows[group[k].row];
+            if (row_find(row, a) >= 0 && row_find(row, b) >= 0)
+                live++;
+        }
+        if (live < 2)
+            continue;
+
+        if (*num_sums >= *sums_capacity) {
+            size_t new_capacity = *sums_capacity ? *sums_capacity * 2 : 16;
+            int*   resized      = realloc(*sum_operands, new_capacity * 2 * sizeof(int));
+            if (!resized) {
+                free(pairs);
+                free(groups);
+                return -1;
+            }
+            *sum_operands  = resized;
+            *sums_capacity = new_capacity;
+        }
+        int node                          = (int) (num_products + *num_sums);
+        (*sum_operands)[2 * *num_sums]     = a;
+        (*sum_operands)[2 * *num_sums + 1] = b;
+        (*num_sums)++;
+        created++;
+
+        for (size_t k = 0; k < groups[g].count; k++) {
+            plan_row_t* row = &rows[group[k].row];
+            if (row_find(row, a) < 0 || row_find(row, b) < 0)
+                continue;
+            row_remove(row, a);
+            row_remove(row, b);
+            row->nodes[row->len++] = node;
+        }
+    }
+
+    free(pairs);
+    free(groups);
+    return created;
+}
+
+void
+linear_map_plan_destroy(struct linear_map_plan* plan)
+{
+    if (!plan)
+        return;
+    free(plan->product_elements);
+    free(plan->product_offsets);
+    free(plan->product_scalars);
+    free(plan->product_coeffs);
+    free(plan->sum_operands);
+    free(plan->row_offsets);
+    free(plan->row_nodes);
+    free(plan);
+}
+
+// Validate indices and compute the canonical index of every group element
+static int
+canonicalize_elements(const linear_map_t* map, int* canonical, csigma_optimize_stats_t* stats)
+{
+    for (size_t i = 0; i < map->num_constraints; i++) {
+        const linear_combination_t* lc = &map->combinations[i];
+        if (lc->num_terms == 0)
+            return -1;
+        for (size_t j = 0; j < lc->num_terms; j++) {
+            if (lc->scalar_indices[j] < 0 || (size_t) lc->scalar_indices[j] >= map->num_scalars)
+                return -1;
+            if (lc->element_indices[j] < 0 || (size_t) lc->element_indices[j] >= map->num_elements)
+                return -1;
+        }
+        if (lc->constant_index >= 0 && (size_t) lc->constant_index >= map->num_elements)
+            return -1;
+    }
+
+    element_ref_t* refs = malloc((map->num_elements + 1) * sizeof(element_ref_t));
+    if (!refs)
+        return -1;
+    for (size_t i = 0; i < map->num_elements; i++) {
+        refs[i].encoding = &map->group_elements[i * CSIGMA_POINT_BYTES];
+        refs[i].index    = (int) i;
+    }
+    qsort(refs, map->num_elements, sizeof(element_ref_t), compare_element_refs);
+
+    // Each run of equal encodings maps to its lowest index
+    for (size_t i = 0; i < map->num_elements;) {
+        size_t j = i + 1;
+        while (j < map->num_elements &&
+               memcmp(refs[j].encoding, refs[i].encoding, CSIGMA_POINT_BYTES) == 0) {
+            canonical[refs[j].index] = refs[i].index;
+            stats->elements_merged++;
+            j++;
+        }
+        canonical[refs[i].index] = refs[i].index;
+        i = j;
+    }
+    free(refs);
+
+    // Validate every referenced element once
+    for (size_t i = 0; i < map->num_constraints; i++) {
+        const linear_combination_t* lc = &map->combinations[i];
+        for (size_t j = 0; j < lc->num_terms; j++) {
+            const uint8_t* element =
+                &map->group_elements[canonical[lc->element_indices[j]] * CSIGMA_POINT_BYTES];
+            if (crypto_core_ristretto255_is_valid_point(element) != 1)
+                return -1;
+        }
+    }
+    return 0;
+}
+
+int
+linear_map_optimize(linear_map_t* map, csigma_optimize_stats_t* stats)
+{
+    csigma_optimize_stats_t local_stats;
+    if (!stats)
+        stats = &local_stats;
+    memset(stats, 0, sizeof(*stats));
+
+    size_t total_terms = 0;
+    for (size_t i = 0; i < map->num_constraints; i++) {
+        total_terms += map->combinations[i].num_terms;
+    }
+
+    struct linear_map_plan* plan      = calloc(1, sizeof(struct linear_map_plan));
+    int*                    canonical = malloc((map->num_elements + 1) * sizeof(int));
+    term_ref_t*             terms     = malloc((total_terms + 1) * sizeof(term_ref_t));
+    // Candidate products, one per (row, element) pair
+    int*           cand_elements = malloc((total_terms + 1) * sizeof(int));
+    size_t*        cand_offsets  = malloc((total_terms + 2) * sizeof(size_t));
+    size_t*        cand_rows     = malloc((total_terms + 1) * sizeof(size_t));
+    int*           cand_scalars  = malloc((total_terms + 1) * sizeof(int));
+    uint8_t*       cand_coeffs   = malloc((total_terms + 1) * CSIGMA_SCALAR_BYTES);
+    int*           cand_product  = malloc((total_terms + 1) * sizeof(int));
+    product_ref_t* products      = malloc((total_terms + 1) * sizeof(product_ref_t));
+    plan_row_t*    rows          = calloc(map->num_constraints + 1, sizeof(plan_row_t));
+    int*           row_storage   = malloc((total_terms + 1) * sizeof(int));
+    int            ret           = -1;
+
+    if (!plan || !canonical || !terms || !cand_elements || !cand_offsets || !cand_rows ||
+        !cand_scalars || !cand_coeffs || !cand_product || !products || !rows || !row_storage)
+        goto done;
+
+    if (canonicalize_elements(map, canonical, stats) != 0)
+        goto done;
+
+    // Merge duplicate terms of each row and group them by element
+    size_t num_cands = 0, num_entries = 0;
+    for (size_t i = 0; i < map->num_constraints; i++) {
+        const linear_combination_t* lc = &map->combinations[i];
+        for (size_t j = 0; j < lc->num_terms; j++) {
+            terms[j].element = canonical[lc->element_indices[j]];
+            terms[j].scalar  = lc->scalar_indices[j];
+            terms[j].coeff   = lc->coefficients ? &lc->coefficients[j * CSIGMA_SCALAR_BYTES] : NULL;
+        }
+        qsort(terms, lc->num_terms, sizeof(term_ref_t), compare_term_refs);
+
+        for (size_t j = 0; j < lc->num_terms;) {
+            int    element = terms[j].element;
+            size_t first   = num_entries;
+            size_t merged  = 0;
+
+            while (j < lc->num_terms && terms[j].element == element) {
+                uint8_t* coeff = &cand_coeffs[num_entries * CSIGMA_SCALAR_BYTES];
+                size_t   k     = j;
+                memset(coeff, 0, CSIGMA_SCALAR_BYTES);
+                while (k < lc->num_terms && terms[k].element == element &&
+                       terms[k].scalar == terms[j].scalar) {
+                    coeff_accumulate(coeff, terms[k].coeff);
+                    k++;
+                }
+                merged += k - j;
+                // Terms whose coefficients cancel out disappear
+                if (!sodium_is_zero(coeff, CSIGMA_SCALAR_BYTES)) {
+                    cand_scalars[num_entries] = terms[j].scalar;
+                    num_entries++;
+                }
+                j = k;
+            }
+            if (num_entries == first) {
+                stats->terms_merged += merged;
+                continue;
+            }
+            // Distinct scalars on the same element fold into one product
+            stats->terms_merged += merged - 1;
+            cand_elements[num_cands] = element;
+            cand_offsets[num_cands]  = first;
+            cand_rows[num_cands]     = i;
+            num_cands++;
+        }
+    }
+    cand_offsets[num_cands] = num_entries;
+
+    // Share identical products across rows
+    for (size_t c = 0; c < num_cands; c++) {
+        products[c].element   = cand_elements[c];
+        products[c].scalars   = &cand_scalars[cand_offsets[c]];
+        products[c].coeffs    = &cand_coeffs[cand_offsets[c] * CSIGMA_SCALAR_BYTES];
+        products[c].len       = cand_offsets[c + 1] - cand_offsets[c];
+        products[c].candidate = c;
+    }
+    qsort(products, num_cands, sizeof(product_ref_t), compare_product_refs);
+
+    plan->product_elements = malloc((num_cands + 1) * sizeof(int));
+    plan->product_offsets  = malloc((num_cands + 2) * sizeof(size_t));
+    plan->product_scalars  = malloc((num_entries + 1) * sizeof(int));
+    plan->product_coeffs   = malloc((num_entries + 1) * CSIGMA_SCALAR_BYTES);
+    if (!plan->product_elements || !plan->product_offsets || !plan->product_scalars ||
+        !plan->product_coeffs)
+        goto done;
+
+    size_t num_products = 0, product_entries = 0;
+    for (size_t c = 0; c < num_cands; c++) {
+        const product_ref_t* p = &products[c];
+        if (c > 0) {
+            product_ref_t prev = products[c - 1];
+            prev.candidate     = p->candidate;
+            if (compare_product_refs(&prev, p) == 0) {
+                cand_product[p->candidate] = (int) num_products - 1;
+                stats->shared_products++;
+                continue;
+            }
+        }
+        plan->product_elements[num_products] = p->element;
+        plan->product_offsets[num_products]   = product_entries;
+        memcpy(&plan->product_scalars[product_entries], p->scalars, p->len * sizeof(int));
+        memcpy(&plan->product_coeffs[product_entries * CSIGMA_SCALAR_BYTES], p->coeffs,
+               p->len * CSIGMA_SCALAR_BYTES);
+        product_entries += p->len;
+        cand_product[p->candidate] = (int) num_products;
+        num_products++;
+    }
+    plan->product_offsets[num_products] = product_entries;
+    plan->num_products                  = num_products;
+
+    // Rows as lists of product nodes
+    for (size_t c = 0, pos = 0; c < num_cands; c++) {
+        plan_row_t* row = &rows[cand_rows[c]];
+        if (!row->nodes)
+            row->nodes = &row_storage[pos];
+        row->nodes[row->len++] = cand_product[c];
+        pos++;
+    }
+
+    // Share partial sums across rows
+    size_t sums_capacity = 0;
+    for (int round = 0; round < CSE_MAX_ROUNDS; round++) {
+        int created = extract_shared_sums(rows, map->num_constraints, &plan->sum_operands,
+                                          &plan->num_sums, &sums_capacity, num_products);
+        if (created < 0)
+            goto done;
+        if (created == 0)
+            break;
+    }
+    stats->shared_sums = plan->num_sums;
+
+    // Flatten rows
+    plan->num_rows    = map->num_constraints;
+    plan->row_offsets = malloc((map->num_constraints + 1) * sizeof(size_t));
+    plan->row_nodes   = malloc((num_cands + 1) * sizeof(int));
+    if (!plan->row_offsets || !plan->row_nodes)
+        goto done;
+
+    size_t pos = 0;
+    for (size_t i = 0; i < map->num_constraints; i++) {
+        plan->row_offsets[i] = pos;
+        if (rows[i].len == 0)
+            continue; // Every term cancelled out: the row evaluates to the identity
+        memcpy(&plan->row_nodes[pos], rows[i].nodes, rows[i].len * sizeof(int));
+        pos += rows[i].len;
+        stats->additions_after += rows[i].len - 1;
+    }
+    plan->row_offsets[map->num_constraints] = pos;
+
+    stats->scalarmults_before = total_terms;
+    stats->scalarmults_after  = num_products;
+    stats->additions_before   = total_terms - map->num_constraints;
+    stats->additions_after += plan->num_sums;
+
+    linear_map_plan_destroy(map->plan);
+    map->plan = plan;
+    plan      = NULL;
+    ret       = 0;
+
+done:
+    linear_map_plan_destroy(plan);
+    free(canonical);
+    free(terms);
+    free(cand_elements);
+    free(cand_offsets);
+    free(cand_rows);
+    free(cand_scalars);
+    free(cand_coeffs);
+    free(cand_product);
+    free(products);
+    free(rows);
+    free(row_storage);
+    return ret;
+}
+
+int
+csigma_relation_optimize(linear_relation_t* relation, csigma_optimize_stats_t* stats)
+{
+    return linear_map_optimize(&relation->map, stats);
+}
+
+// ============================================================================
+// Plan evaluation
+// ============================================================================
+
+int
+linear_map_plan_eval(const linear_map_t* map, const uint8_t* scalars, uint8_t* output)
+{
+    const struct linear_map_plan* plan      = map->plan;
+    size_t                        num_nodes = plan->num_products + plan->num_sums;
+
+    uint8_t* nodes = malloc((num_nodes + 1) * CSIGMA_POINT_BYTES);
+    if (!nodes)
+        return -1;
+
+    // Products: (sum of coeff * scalar) * element
+    for (size_t p = 0; p < plan->num_products; p++) {
+        uint8_t scalar[CSIGMA_SCALAR_BYTES] = { 0 };
+        for (size_t k = plan->product_offsets[p]; k < plan->product_offsets[p + 1]; k++) {
+            uint8_t term[CSIGMA_SCALAR_BYTES];
+            crypto_core_ristretto255_scalar_mul(
+                term, &plan->product_coeffs[k * CSIGMA_SCALAR_BYTES],
+                &scalars[plan->product_scalars[k] * CSIGMA_SCALAR_BYTES]);
+            crypto_core_ristretto255_scalar_add(scalar, scalar, term);
+        }
+
+        // Elements were validated when the plan was built, so a failure here
+        // means the product is the identity
+        uint8_t* node    = &nodes[p * CSIGMA_POINT_BYTES];
+        uint8_t* element = &map->group_elements[plan->product_elements[p] * CSIGMA_POINT_BYTES];
+        if (crypto_scalarmult_ristretto255(node, scalar, element) != 0) {
+            memset(node, 0, CSIGMA_POINT_BYTES);
+        }
+    }
+
+    // Shared partial sums
+    for (size_t s = 0; s < plan->num_sums; s++) {
+        const int* operands = &plan->sum_operands[2 * s];
+        if (crypto_core_ristretto255_add(&nodes[(plan->num_products + s) * CSIGMA_POINT_BYTES],
+                                         &nodes[operands[0] * CSIGMA_POINT_BYTES],
+                                         &nodes[operands[1] * CSIGMA_POINT_BYTES]) != 0) {
+            free(nodes);
+            return -1;
+        }
+    }
+
+    // Rows
+    for (size_t i = 0; i < plan->num_rows; i++) {
+        uint8_t* result = &output[i * CSIGMA_POINT_BYTES];
+        size_t   start  = plan->row_offsets[i];
+        size_t   end    = plan->row_offsets[i + 1];
+
+        if (start == end) {
+            memset(result, 0, CSIGMA_POINT_BYTES);
+            continue;
+        }
+        memcpy(result, &nodes[plan->row_nodes[start] * CSIGMA_POINT_BYTES], CSIGMA_POINT_BYTES);
+        for (size_t k = start + 1; k < end; k++) {
+            if (crypto_core_ristretto255_add(result, result,
+                                             &nodes[plan->row_nodes[k] * CSIGMA_POINT_BYTES]) !=
+                0) {
+                free(nodes);
+                return -1;
+            }
+        }
+    }
+
+    free(nodes);
+    return 0;
+}
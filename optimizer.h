@@ -0,0 +1,45 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "csigma.h"
+#include "linear_relation.h"
+
+// Relation optimizer
+// Rewrites the evaluation of a linear map into a plan that performs every distinct
+// scalar multiplication and every partial sum shared between rows exactly once.
+// The relation itself is unchanged: proofs produced with an optimized relation are
+// identical to proofs produced without it.
+
+// Statistics reported by the optimizer
+typedef struct {
+    size_t elements_merged; // Group elements aliased to an earlier element with the same encoding
+    size_t terms_merged; // Terms folded into another term of the same row
+    size_t shared_products; // Products evaluated once and reused by several rows
+    size_t shared_sums; // Partial sums evaluated once and reused by several rows
+    size_t scalarmults_before; // Scalar multiplications per evaluation without the plan
+    size_t scalarmults_after; // Scalar multiplications per evaluation with the plan
+    size_t additions_before; // Point additions per evaluation without the plan
+    size_t additions_after; // Point additions per evaluation with the plan
+} csigma_optimize_stats_t;
+
+// Optimize a relation for repeated evaluation
+// Validates every scalar and element index and every referenced group element once,
+// then attaches an evaluation plan used by csigma_prover_commit() and csigma_verify().
+// The plan is discarded automatically when the relation is modified.
+// stats: optional output (may be NULL)
+// Returns 0 on success, -1 if the relation is malformed
+int csigma_relation_optimize(linear_relation_t* relation, csigma_optimize_stats_t* stats);
+
+// Number of scalar multiplications saved by the plan
+static inline size_t
+csigma_optimize_scalarmults_saved(const csigma_optimize_stats_t* stats)
+{
+    return stats->scalarmults_before - stats->scalarmults_after;
+}
+
+// Linear map plan operations (internal, for advanced use)
+int  linear_map_optimize(linear_map_t* map, csigma_optimize_stats_t* stats);
+int  linear_map_plan_eval(const linear_map_t* map, const uint8_t* scalars, uint8_t* output);
+void linear_map_plan_destroy(struct linear_map_plan* plan);
+
+#endif
@@ -0,0 +1,156 @@
+#include "partial.h"
+#include "keccak.h"
+#include "msm.h"
+#include <string.h>
+
+#define TAG_BYTES 16
+#define FIRST_OFFSET TAG_BYTES
+#define END_OFFSET (TAG_BYTES + 8)
+#define SUM_OFFSET (TAG_BYTES + 16)
+
+static void
+store_u64(uint8_t out[8], uint64_t value)
+{
+    for (size_t i = 0; i < 8; i++) {
+        out[i] = (uint8_t) (value >> (8 * i));
+    }
+}
+
+static uint64_t
+load_u64(const uint8_t in[8])
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; i++) {
+        value |= (uint64_t) in[i] << (8 * i);
+    }
+    return value;
+}
+
+// Job tag identifying the partials of one verification (internal)
+static void
+job_tag(uint8_t tag[TAG_BYTES], const uint8_t seed[CSIGMA_PARTIAL_SEED_BYTES])
+{
+    shake128_ctx ctx;
+    shake128_init(&ctx);
+    shake128_absorb(&ctx, (const uint8_t*) "csigma_partial_tag", 18);
+    shake128_absorb(&ctx, seed, CSIGMA_PARTIAL_SEED_BYTES);
+    shake128_squeeze(&ctx, tag, TAG_BYTES);
+}
+
+// Weight of a row, the same in every worker (internal)
+static void
+row_weight(uint8_t rho[CSIGMA_SCALAR_BYTES], const uint8_t seed[CSIGMA_PARTIAL_SEED_BYTES],
+           size_t row)
+{
+    uint8_t      index[8], wide[64];
+    shake128_ctx ctx;
+    shake128_init(&ctx);
+    shake128_absorb(&ctx, (const uint8_t*) "csigma_partial_weight", 21);
+    shake128_absorb(&ctx, seed, CSIGMA_PARTIAL_SEED_BYTES);
+    store_u64(index, row);
+    shake128_absorb(&ctx, index, sizeof(index));
+    shake128_squeeze(&ctx, wide, sizeof(wide));
+    crypto_core_ristretto255_scalar_reduce(rho, wide);
+}
+
+size_t
+csigma_partial_num_terms(const linear_relation_t* relation)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < relation->map.num_constraints; i++) {
+        total += linear_relation_row_check_terms(relation, i);
+    }
+    return total;
+}
+
+int
+csigma_partial_eval(uint8_t partial[CSIGMA_PARTIAL_BYTES], const linear_relation_t* relation,
+                    const uint8_t* commitment, const uint8_t challenge[CSIGMA_SCALAR_BYTES],
+                    const uint8_t* response, const uint8_t seed[CSIGMA_PARTIAL_SEED_BYTES],
+                    size_t first, size_t end)
+{
+    if (linear_relation_validate(relation) != 0 || first > end ||
+        end > csigma_partial_num_terms(relation))
+        return -1;
+
+    job_tag(partial, seed);
+    store_u64(&partial[FIRST_OFFSET], first);
+    store_u64(&partial[END_OFFSET], end);
+
+    // Append the part of each row that falls in the slice
+    msm_t msm;
+    msm_init(&msm);
+    int    ret    = 0;
+    size_t offset = 0;
+    for (size_t i = 0; i < relation->map.num_constraints && offset < end && ret == 0; i++) {
+        size_t num_terms = linear_relation_row_check_terms(relation, i);
+        if (offset + num_terms > first) {
+            size_t  lo = first > offset ? first - offset : 0;
+            size_t  hi = end - offset < num_terms ? end - offset : num_terms;
+            uint8_t rho[CSIGMA_SCALAR_BYTES];
+            row_weight(rho, seed, i);
+            ret = linear_relation_append_row_terms(relation, i, rho, commitment, challenge,
+                                                   response, lo, hi, &msm);
+        }
+        offset += num_terms;
+    }
+    if (ret == 0) {
+        ret = msm_eval(&msm, &partial[SUM_OFFSET]);
+    }
+    msm_destroy(&msm);
+    return ret;
+}
+
+int
+csigma_partial_merge(uint8_t out[CSIGMA_PARTIAL_BYTES], const uint8_t a[CSIGMA_PARTIAL_BYTES],
+                     const uint8_t b[CSIGMA_PARTIAL_BYTES])
+{
+    if (sodium_memcmp(a, b, TAG_BYTES) != 0)
+        return -1;
+
+    uint64_t a_first = load_u64(&a[FIRST_OFFSET]), a_end = load_u64(&a[END_OFFSET]);
+    uint64_t b_first = load_u64(&b[FIRST_OFFSET]), b_end = load_u64(&b[END_OFFSET]);
+    uint64_t first, end;
+    if (a_end == b_first) {
+        first = a_first;
+        end   = b_end;
+    } else if (b_end == a_first) {
+        first = b_first;
+        end   = a_end;
+    } else {
+        return -1;
+    }
+    if (first > end)
+        return -1;
+
+    // The identity is encoded as zeros and needs no addition
+    uint8_t sum[CSIGMA_POINT_BYTES];
+    if (sodium_is_zero(&a[SUM_OFFSET], CSIGMA_POINT_BYTES)) {
+        memcpy(sum, &b[SUM_OFFSET], CSIGMA_POINT_BYTES);
+    } else if (sodium_is_zero(&b[SUM_OFFSET], CSIGMA_POINT_BYTES)) {
+        memcpy(sum, &a[SUM_OFFSET], CSIGMA_POINT_BYTES);
+    } else if (crypto_core_ristretto255_add(sum, &a[SUM_OFFSET], &b[SUM_OFFSET]) != 0) {
+        return -1;
+    }
+
+    memmove(out, a, TAG_BYTES);
+    store_u64(&out[FIRST_OFFSET], first);
+    store_u64(&out[END_OFFSET], end);
+    memcpy(&out[SUM_OFFSET], sum, CSIGMA_POINT_BYTES);
+    return 0;
+}
+
+bool
+csigma_partial_finish(const uint8_t            partial[CSIGMA_PARTIAL_BYTES],
+                      const linear_relation_t* relation,
+                      const uint8_t            seed[CSIGMA_PARTIAL_SEED_BYTES])
+{
+    uint8_t tag[TAG_BYTES];
+    job_tag(tag, seed);
+
+    return sodium_memcmp(partial, tag, TAG_BYTES) == 0 &&
+           linear_relation_validate(relation) == 0 &&
+           load_u64(&partial[FIRST_OFFSET]) == 0 &&
+           load_u64(&partial[END_OFFSET]) == csigma_partial_num_terms(relation) &&
+           sodium_is_zero(&partial[SUM_OFFSET], CSIGMA_POINT_BYTES);
+}
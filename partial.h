@@ -0,0 +1,52 @@
+#ifndef PARTIAL_H
+#define PARTIAL_H
+
+#include "csigma.h"
+#include "linear_relation.h"
+
+// Partial evaluation of a verification
+// Splits the verification of one large transcript across processes or machines. The
+// verification equations of all rows are combined with weights derived from a seed, and
+// the resulting sum of terms is cut into slices: each worker evaluates a slice of terms
+// into a serialized partial sum, the coordinator merges the partials and checks that
+// they cover every term and add up to the identity.
+//
+// Terms are numbered row by row: the terms of each linear combination, then the
+// commitment, the image and the constant term of the row, if any. A slice may span rows
+// or cut a row, so that a single huge equation can be split too.
+//
+// The seed must be drawn at random by the coordinator after the proof was received
+// (for example with csigma_random_bytes()), and kept from the prover.
+//
+// Partial format (CSIGMA_PARTIAL_BYTES bytes):
+//   job tag (16 bytes, derived from the seed) || first term (8 bytes, little-endian) ||
+//   end term (8 bytes, little-endian) || sum of the terms (32-byte point)
+
+#define CSIGMA_PARTIAL_SEED_BYTES 32
+#define CSIGMA_PARTIAL_BYTES 64
+
+// Total number of terms of the verification of a relation
+size_t csigma_partial_num_terms(const linear_relation_t* relation);
+
+// Evaluate terms first to end - 1 of the verification
+// Returns 0 on success, -1 if the relation is malformed, the slice is out of range or a
+// point is invalid
+int csigma_partial_eval(uint8_t partial[CSIGMA_PARTIAL_BYTES], const linear_relation_t* relation,
+                        const uint8_t* commitment, const uint8_t challenge[CSIGMA_SCALAR_BYTES],
+                        const uint8_t* response, const uint8_t seed[CSIGMA_PARTIAL_SEED_BYTES],
+                        size_t first, size_t end);
+
+// Merge two partials of the same job covering adjacent slices (in either order)
+// Returns 0 on success, -1 if the partials belong to different jobs, are not adjacent
+// or are malformed
+int csigma_partial_merge(uint8_t out[CSIGMA_PARTIAL_BYTES], const uint8_t a[CSIGMA_PARTIAL_BYTES],
+                         const uint8_t b[CSIGMA_PARTIAL_BYTES]);
+
+// Check a fully merged partial: it must belong to the job of seed, cover every term of
+// the relation's verification and sum to the identity
+// Returns true if the transcript is valid, false otherwise
+bool csigma_partial_finish(const uint8_t            partial[CSIGMA_PARTIAL_BYTES],
+                           const linear_relation_t* relation,
+                           const uint8_t            seed[CSIGMA_PARTIAL_SEED_BYTES]);
+
+#endif
@@ -1,37 +1,67 @@
 #include "pedersen.h"
-#include "keccak.h"
+#include "transcript.h"
+#include <pthread.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
-// Fiat-Shamir challenge generation for Pedersen proofs (internal)
+// Batches from this size use several threads by default
+#define PEDERSEN_PARALLEL_THRESHOLD 64
+#define PEDERSEN_MAX_THREADS 8
+
+// Start a Pedersen proof transcript: domain and bases, shared by every commitment
+// under the same G and H (internal)
 static void
-generate_challenge(uint8_t challenge[CSIGMA_SCALAR_BYTES], const uint8_t G[CSIGMA_POINT_BYTES],
-                   const uint8_t H[CSIGMA_POINT_BYTES], const uint8_t C[CSIGMA_POINT_BYTES],
-                   const uint8_t* commitment, size_t commitment_len, const uint8_t* message,
-                   size_t message_len)
+pedersen_transcript_init(csigma_transcript_t* transcript, const uint8_t G[CSIGMA_POINT_BYTES],
+                         const uint8_t H[CSIGMA_POINT_BYTES])
 {
-    shake128_ctx ctx;
-    shake128_init(&ctx);
-
     // Domain separation
-    shake128_absorb(&ctx, (const uint8_t*) "pedersen_repr", 13);
+    csigma_transcript_init(transcript, "pedersen_repr");
 
-    // Public inputs: G, H, C
-    shake128_absorb(&ctx, G, CSIGMA_POINT_BYTES);
-    shake128_absorb(&ctx, H, CSIGMA_POINT_BYTES);
-    shake128_absorb(&ctx, C, CSIGMA_POINT_BYTES);
+    // Public inputs G || H || C, of which C is absorbed per proof
+    csigma_transcript_begin(transcript, 3 * CSIGMA_POINT_BYTES);
+    csigma_transcript_update(transcript, G, CSIGMA_POINT_BYTES);
+    csigma_transcript_update(transcript, H, CSIGMA_POINT_BYTES);
+}
 
-    // Commitment
-    shake128_absorb(&ctx, commitment, commitment_len);
+// Fiat-Shamir challenge from a started transcript (internal)
+static void
+pedersen_challenge(uint8_t challenge[CSIGMA_SCALAR_BYTES], const csigma_transcript_t* transcript,
+                   const uint8_t C[CSIGMA_POINT_BYTES], const uint8_t* commitment,
+                   size_t commitment_len, const uint8_t* message, size_t message_len)
+{
+    csigma_transcript_t ctx = *transcript;
 
-    // Message
-    if (message && message_len > 0) {
-        shake128_absorb(&ctx, message, message_len);
-    }
+    // Public input C, then the commitment and the message
+    csigma_transcript_update(&ctx, C, CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb(&ctx, commitment, commitment_len);
+    csigma_transcript_absorb(&ctx, message, message ? message_len : 0);
+    csigma_transcript_challenge(&ctx, challenge);
+}
 
-    // Generate and reduce challenge
-    uint8_t challenge_bytes[64];
-    shake128_squeeze(&ctx, challenge_bytes, 64);
-    crypto_core_ristretto255_scalar_reduce(challenge, challenge_bytes);
+// Nonce context of a proof from a started transcript: public input C and the
+// message (internal)
+static void
+pedersen_nonce_context(uint8_t context[CSIGMA_NONCE_CONTEXT_BYTES],
+                       const csigma_transcript_t* transcript, const uint8_t C[CSIGMA_POINT_BYTES],
+                       const uint8_t* message, size_t message_len)
+{
+    csigma_transcript_t ctx = *transcript;
+    csigma_transcript_update(&ctx, C, CSIGMA_POINT_BYTES);
+    csigma_transcript_nonce_context(&ctx, message, message_len, context);
+}
+
+// Fiat-Shamir challenge generation for Pedersen proofs (internal)
+static void
+generate_challenge(uint8_t challenge[CSIGMA_SCALAR_BYTES], const uint8_t G[CSIGMA_POINT_BYTES],
+                   const uint8_t H[CSIGMA_POINT_BYTES], const uint8_t C[CSIGMA_POINT_BYTES],
+                   const uint8_t* commitment, size_t commitment_len, const uint8_t* message,
+                   size_t message_len)
+{
+    csigma_transcript_t transcript;
+    pedersen_transcript_init(&transcript, G, H);
+    pedersen_challenge(challenge, &transcript, C, commitment, commitment_len, message,
+                       message_len);
 }
 
 int
@@ -40,13 +70,13 @@ csigma_pedersen_commit(uint8_t       commitment[CSIGMA_POINT_BYTES],
                        const uint8_t randomness[CSIGMA_SCALAR_BYTES],
                        const uint8_t G[CSIGMA_POINT_BYTES], const uint8_t H[CSIGMA_POINT_BYTES])
 {
-    // C = value*G + randomness*H
+    // C = value*G + randomness*H; a zero value (or randomness) is a valid commitment
     uint8_t value_G[CSIGMA_POINT_BYTES], randomness_H[CSIGMA_POINT_BYTES];
 
-    if (crypto_scalarmult_ristretto255(value_G, value, G) != 0) {
+    if (csigma_scalarmult(value_G, value, G) != 0) {
         return -1;
     }
-    if (crypto_scalarmult_ristretto255(randomness_H, randomness, H) != 0) {
+    if (csigma_scalarmult(randomness_H, randomness, H) != 0) {
         return -1;
     }
     if (crypto_core_ristretto255_add(commitment, value_G, randomness_H) != 0) {
@@ -107,17 +137,24 @@ csigma_pedersen_prove(uint8_t       proof[CSIGMA_PEDERSEN_PROOF_SIZE],
     memcpy(&witness[0 * CSIGMA_SCALAR_BYTES], value, CSIGMA_SCALAR_BYTES);
     memcpy(&witness[1 * CSIGMA_SCALAR_BYTES], randomness, CSIGMA_SCALAR_BYTES);
 
-    // Prover commit phase
+    // Prover commit phase, with nonces bound to the transcript prefix and the message
+    csigma_transcript_t transcript;
+    uint8_t             context[CSIGMA_NONCE_CONTEXT_BYTES];
+    pedersen_transcript_init(&transcript, G, H);
+    pedersen_nonce_context(context, &transcript, C, message, message_len);
+
     prover_state_t state;
     uint8_t        commitment[CSIGMA_POINT_BYTES]; // One equation = one commitment point
-    if (csigma_prover_commit(&relation, witness, commitment, &state) != 0) {
+    if (csigma_prover_commit_with_context(&relation, witness, context, sizeof(context), commitment,
+                                          &state) != 0) {
         csigma_relation_destroy(&relation);
         return -1;
     }
 
     // Generate Fiat-Shamir challenge
     uint8_t challenge[CSIGMA_SCALAR_BYTES];
-    generate_challenge(challenge, G, H, C, commitment, CSIGMA_POINT_BYTES, message, message_len);
+    pedersen_challenge(challenge, &transcript, C, commitment, CSIGMA_POINT_BYTES, message,
+                       message_len);
 
     // Prover response phase
     uint8_t response[2 * CSIGMA_SCALAR_BYTES]; // Two scalars in witness
@@ -164,3 +201,373 @@ csigma_pedersen_verify(const uint8_t proof[CSIGMA_PEDERSEN_PROOF_SIZE],
 
     return valid;
 }
+
+// ============================================================================
+// Batch Commitments and Proofs
+// ============================================================================
+
+// One share of a batch (internal)
+typedef struct {
+    uint8_t*              out;
+    const uint8_t*        values;
+    const uint8_t*        randomness;
+    const uint8_t*        commitments;
+    const uint8_t*        G;
+    const uint8_t*        H;
+    const uint8_t* const* messages;
+    const size_t*         message_lens;
+    size_t                first;
+    size_t                last;
+    int                   ret;
+} pedersen_job_t;
+
+static void*
+commit_worker(void* arg)
+{
+    pedersen_job_t* job = arg;
+
+    job->ret = 0;
+    for (size_t i = job->first; i < job->last; i++) {
+        if (csigma_pedersen_commit(&job->out[i * CSIGMA_POINT_BYTES],
+                                   &job->values[i * CSIGMA_SCALAR_BYTES],
+                                   &job->randomness[i * CSIGMA_SCALAR_BYTES], job->G,
+                                   job->H) != 0) {
+            job->ret = -1;
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+// The linear map only depends on G and H, and the transcript prefix is absorbed once:
+// each proof sets its own C in the relation, then costs one commitment evaluation and
+// one transcript completion
+static void*
+prove_worker(void* arg)
+{
+    pedersen_job_t* job = arg;
+
+    job->ret = 0;
+    if (job->first == job->last)
+        return NULL;
+
+    linear_relation_t   relation;
+    csigma_transcript_t transcript;
+    pedersen_build_relation(&relation, job->G, job->H, &job->commitments[0]);
+    pedersen_transcript_init(&transcript, job->G, job->H);
+
+    uint8_t witness[2 * CSIGMA_SCALAR_BYTES];
+    for (size_t i = job->first; i < job->last; i++) {
+        uint8_t*       proof   = &job->out[i * CSIGMA_PEDERSEN_PROOF_SIZE];
+        const uint8_t* C       = &job->commitments[i * CSIGMA_POINT_BYTES];
+        const uint8_t* message = job->messages ? job->messages[i] : NULL;
+        size_t         len     = job->messages ? job->message_lens[i] : 0;
+
+        memcpy(&witness[0], &job->values[i * CSIGMA_SCALAR_BYTES], CSIGMA_SCALAR_BYTES);
+        memcpy(&witness[CSIGMA_SCALAR_BYTES], &job->randomness[i * CSIGMA_SCALAR_BYTES],
+               CSIGMA_SCALAR_BYTES);
+
+        // Statement of this proof: C is element 2 and the image (see pedersen_build_relation())
+        csigma_relation_set_element(&relation, 2, C);
+        memcpy(relation.image, C, CSIGMA_POINT_BYTES);
+
+        uint8_t context[CSIGMA_NONCE_CONTEXT_BYTES];
+        pedersen_nonce_context(context, &transcript, C, message, len);
+
+        prover_state_t state;
+        if (csigma_prover_commit_with_context(&relation, witness, context, sizeof(context), proof,
+                                              &state) != 0) {
+            job->ret = -1;
+            break;
+        }
+        uint8_t challenge[CSIGMA_SCALAR_BYTES];
+        pedersen_challenge(challenge, &transcript, C, proof, CSIGMA_POINT_BYTES, message, len);
+        csigma_prover_response(&state, challenge, proof + CSIGMA_POINT_BYTES);
+        csigma_prover_state_destroy(&state);
+    }
+
+    sodium_memzero(witness, sizeof(witness));
+    csigma_relation_destroy(&relation);
+    return NULL;
+}
+
+// Split a batch evenly across threads; the calling thread takes the first share
+// num_threads: 0 to use the online processors for large batches
+static int
+run_batch(const pedersen_job_t* template, size_t n, size_t num_threads, void* (*worker)(void*))
+{
+    if (num_threads == 0) {
+        long online = 1;
+        if (n >= PEDERSEN_PARALLEL_THRESHOLD) {
+            online = sysconf(_SC_NPROCESSORS_ONLN);
+        }
+        num_threads = online < 1 ? 1 : (size_t) online;
+    }
+    if (num_threads > PEDERSEN_MAX_THREADS) {
+        num_threads = PEDERSEN_MAX_THREADS;
+    }
+    if (num_threads > n) {
+        num_threads = n > 0 ? n : 1;
+    }
+
+    pthread_t      threads[PEDERSEN_MAX_THREADS];
+    bool           started[PEDERSEN_MAX_THREADS] = { false };
+    pedersen_job_t jobs[PEDERSEN_MAX_THREADS];
+    for (size_t t = 0; t < num_threads; t++) {
+        jobs[t]       = *template;
+        jobs[t].first = n * t / num_threads;
+        jobs[t].last  = n * (t + 1) / num_threads;
+    }
+    for (size_t t = 1; t < num_threads; t++) {
+        started[t] = pthread_create(&threads[t], NULL, worker, &jobs[t]) == 0;
+        if (!started[t]) {
+            worker(&jobs[t]);
+        }
+    }
+    worker(&jobs[0]);
+
+    int ret = jobs[0].ret;
+    for (size_t t = 1; t < num_threads; t++) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        }
+        if (jobs[t].ret != 0) {
+            ret = -1;
+        }
+    }
+    return ret;
+}
+
+int
+csigma_pedersen_commit_batch(uint8_t* commitments, const uint8_t* values,
+                             const uint8_t* randomness, size_t n,
+                             const uint8_t G[CSIGMA_POINT_BYTES],
+                             const uint8_t H[CSIGMA_POINT_BYTES], size_t num_threads)
+{
+    if (n == 0)
+        return 0;
+    if (!commitments || !values || !randomness || !G || !H)
+        return -1;
+
+    pedersen_job_t job = { .out = commitments, .values = values, .randomness = randomness,
+                           .G = G, .H = H };
+    return run_batch(&job, n, num_threads, commit_worker);
+}
+
+int
+csigma_pedersen_prove_batch(uint8_t* proofs, const uint8_t* values, const uint8_t* randomness,
+                            size_t n, const uint8_t G[CSIGMA_POINT_BYTES],
+                            const uint8_t H[CSIGMA_POINT_BYTES], const uint8_t* commitments,
+                            const uint8_t* const* messages, const size_t* message_lens,
+                            size_t num_threads)
+{
+    if (n == 0)
+        return 0;
+    if (!proofs || !values || !randomness || !G || !H || !commitments ||
+        (messages && !message_lens))
+        return -1;
+
+    pedersen_job_t job = { .out          = proofs,
+                           .values       = values,
+                           .randomness   = randomness,
+                           .commitments  = commitments,
+                           .G            = G,
+                           .H            = H,
+                           .messages     = messages,
+                           .message_lens = message_lens };
+    return run_batch(&job, n, num_threads, prove_worker);
+}
+
+// ============================================================================
+// Vector Pedersen Commitments
+// ============================================================================
+
+// Start a vector Pedersen proof transcript: domain and statement (internal)
+// The relation encoding covers the generators, H and C
+static void
+vector_transcript_init(csigma_transcript_t* transcript, const linear_relation_t* relation)
+{
+    csigma_transcript_init(transcript, "pedersen_vector_repr");
+    csigma_transcript_absorb_relation(transcript, relation);
+}
+
+// Fiat-Shamir challenge for vector Pedersen proofs: commitment and message (internal)
+static void
+generate_vector_challenge(uint8_t challenge[CSIGMA_SCALAR_BYTES], csigma_transcript_t* transcript,
+                          const uint8_t* commitment, const uint8_t* message, size_t message_len)
+{
+    csigma_transcript_absorb(transcript, commitment, CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb(transcript, message, message ? message_len : 0);
+    csigma_transcript_challenge(transcript, challenge);
+}
+
+int
+csigma_pedersen_vector_commit(uint8_t commitment[CSIGMA_POINT_BYTES], const uint8_t* values,
+                              const uint8_t  randomness[CSIGMA_SCALAR_BYTES],
+                              const uint8_t* generators, size_t n,
+                              const uint8_t H[CSIGMA_POINT_BYTES])
+{
+    if (!commitment || (n > 0 && (!values || !generators)) || !randomness || !H) {
+        return -1;
+    }
+
+    // C = sum of values[i]*generators[i] + randomness*H in one multi-scalar multiplication
+    uint8_t* scalars = malloc((n + 1) * CSIGMA_SCALAR_BYTES);
+    uint8_t* points  = malloc((n + 1) * CSIGMA_POINT_BYTES);
+    int      ret     = -1;
+
+    if (scalars && points) {
+        if (n > 0) {
+            memcpy(scalars, values, n * CSIGMA_SCALAR_BYTES);
+            memcpy(points, generators, n * CSIGMA_POINT_BYTES);
+        }
+        memcpy(&scalars[n * CSIGMA_SCALAR_BYTES], randomness, CSIGMA_SCALAR_BYTES);
+        memcpy(&points[n * CSIGMA_POINT_BYTES], H, CSIGMA_POINT_BYTES);
+        ret = csigma_msm(commitment, scalars, points, n + 1);
+    }
+
+    if (scalars) {
+        sodium_memzero(scalars, (n + 1) * CSIGMA_SCALAR_BYTES);
+    }
+    free(scalars);
+    free(points);
+    return ret;
+}
+
+// Build vector Pedersen relation: C = sum of x_i*G_i + r*H (internal helper)
+// Scalars: x_1..x_n, r; elements: G_1..G_n, H, C
+static int
+pedersen_build_vector_relation(linear_relation_t* relation, const uint8_t* generators, size_t n,
+                               const uint8_t H[CSIGMA_POINT_BYTES],
+                               const uint8_t C[CSIGMA_POINT_BYTES])
+{
+    int* scalar_indices  = malloc((n + 1) * sizeof(int));
+    int* element_indices = malloc((n + 1) * sizeof(int));
+    if (!scalar_indices || !element_indices) {
+        free(scalar_indices);
+        free(element_indices);
+        return -1;
+    }
+
+    csigma_relation_init(relation);
+
+    int var_x = csigma_relation_allocate_scalars(relation, n + 1);
+    int var_G = csigma_relation_allocate_elements(relation, n + 2);
+    int var_C = var_G + (int) n + 1;
+
+    for (size_t i = 0; i < n; i++) {
+        csigma_relation_set_element(relation, var_G + (int) i, &generators[i * CSIGMA_POINT_BYTES]);
+    }
+    csigma_relation_set_element(relation, var_G + (int) n, H);
+    csigma_relation_set_element(relation, var_C, C);
+
+    // Single equation: C = x_1*G_1 + ... + x_n*G_n + r*H
+    for (size_t i = 0; i <= n; i++) {
+        scalar_indices[i]  = var_x + (int) i;
+        element_indices[i] = var_G + (int) i;
+    }
+    csigma_relation_add_equation(relation, var_C, scalar_indices, element_indices, n + 1);
+    memcpy(relation->image, C, CSIGMA_POINT_BYTES);
+
+    free(scalar_indices);
+    free(element_indices);
+    return 0;
+}
+
+int
+csigma_pedersen_vector_prove(uint8_t* proof, const uint8_t* values,
+                             const uint8_t  randomness[CSIGMA_SCALAR_BYTES],
+                             const uint8_t* generators, size_t n,
+                             const uint8_t H[CSIGMA_POINT_BYTES],
+                             const uint8_t C[CSIGMA_POINT_BYTES], const uint8_t* message,
+                             size_t message_len)
+{
+    if (!proof || (n > 0 && (!values || !generators)) || !randomness || !H || !C) {
+        return -1;
+    }
+
+    // Build the linear relation
+    linear_relation_t relation;
+    if (pedersen_build_vector_relation(&relation, generators, n, H, C) != 0) {
+        return -1;
+    }
+
+    // Prepare witness: [values, randomness]
+    uint8_t* witness = malloc((n + 1) * CSIGMA_SCALAR_BYTES);
+    if (!witness) {
+        csigma_relation_destroy(&relation);
+        return -1;
+    }
+    if (n > 0) {
+        memcpy(witness, values, n * CSIGMA_SCALAR_BYTES);
+    }
+    memcpy(&witness[n * CSIGMA_SCALAR_BYTES], randomness, CSIGMA_SCALAR_BYTES);
+
+    // Prover commit phase: one commitment point written directly into the proof
+    csigma_transcript_t transcript;
+    uint8_t             context[CSIGMA_NONCE_CONTEXT_BYTES];
+    vector_transcript_init(&transcript, &relation);
+    csigma_transcript_nonce_context(&transcript, message, message_len, context);
+
+    prover_state_t state;
+    int            ret = -1;
+    if (csigma_prover_commit_with_context(&relation, witness, context, sizeof(context), proof,
+                                          &state) == 0) {
+        // Generate Fiat-Shamir challenge
+        uint8_t challenge[CSIGMA_SCALAR_BYTES];
+        generate_vector_challenge(challenge, &transcript, proof, message, message_len);
+
+        // Prover response phase
+        csigma_prover_response(&state, challenge, proof + CSIGMA_POINT_BYTES);
+        csigma_prover_state_destroy(&state);
+        ret = 0;
+    }
+
+    // Clean up
+    sodium_memzero(witness, (n + 1) * CSIGMA_SCALAR_BYTES);
+    free(witness);
+    csigma_relation_destroy(&relation);
+
+    return ret;
+}
+
+bool
+csigma_pedersen_vector_verify(const uint8_t* proof, size_t proof_len, const uint8_t* generators,
+                              size_t n, const uint8_t H[CSIGMA_POINT_BYTES],
+                              const uint8_t C[CSIGMA_POINT_BYTES], const uint8_t* message,
+                              size_t message_len)
+{
+    if (!proof || (n > 0 && !generators) || !H || !C ||
+        proof_len != csigma_pedersen_vector_proof_size(n)) {
+        return false;
+    }
+
+    // Unpack proof
+    const uint8_t* commitment = proof;
+    const uint8_t* response   = proof + CSIGMA_POINT_BYTES;
+
+    // Build the linear relation
+    linear_relation_t relation;
+    if (pedersen_build_vector_relation(&relation, generators, n, H, C) != 0) {
+        return false;
+    }
+
+    // Regenerate challenge
+    csigma_transcript_t transcript;
+    uint8_t             challenge[CSIGMA_SCALAR_BYTES];
+    vector_transcript_init(&transcript, &relation);
+    generate_vector_challenge(challenge, &transcript, commitment, message, message_len);
+
+    // Check sum of z_i*G_i + z_r*H - T - c*C = 0 with one multi-scalar multiplication
+    msm_t msm;
+    msm_init(&msm);
+    bool valid =
+        linear_relation_append_check(&relation, commitment, challenge, response, &msm) == 0 &&
+        msm_is_identity(&msm);
+
+    // Clean up
+    msm_destroy(&msm);
+    csigma_relation_destroy(&relation);
+
+    return valid;
+}
@@ -39,4 +39,64 @@ bool csigma_pedersen_verify(const uint8_t proof[CSIGMA_PEDERSEN_PROOF_SIZE],
                             const uint8_t C[CSIGMA_POINT_BYTES], const uint8_t* message,
                             size_t message_len);
 
+// Batch commitments and opening proofs
+// values, randomness: arrays of n 32-byte scalars
+// commitments: array of n 32-byte points; proofs: array of n 96-byte proofs
+// messages, message_lens: one message per proof, or NULL for no messages
+// num_threads: number of threads to use, or 0 to use the online processors for large
+// batches; results are the same as calling the single-item functions in a loop
+// Return 0 on success, -1 on error
+int csigma_pedersen_commit_batch(uint8_t* commitments, const uint8_t* values,
+                                 const uint8_t* randomness, size_t n,
+                                 const uint8_t G[CSIGMA_POINT_BYTES],
+                                 const uint8_t H[CSIGMA_POINT_BYTES], size_t num_threads);
+
+int csigma_pedersen_prove_batch(uint8_t* proofs, const uint8_t* values,
+                                const uint8_t* randomness, size_t n,
+                                const uint8_t G[CSIGMA_POINT_BYTES],
+                                const uint8_t H[CSIGMA_POINT_BYTES], const uint8_t* commitments,
+                                const uint8_t* const* messages, const size_t* message_lens,
+                                size_t num_threads);
+
+// Vector Pedersen commitments
+// VREPR(G_1..G_n, H, C) = PoK{(x_1..x_n, r): C = x_1*G_1 + ... + x_n*G_n + r*H}
+// Commits to n values at once; the opening proof is a single-equation linear relation
+// with one commitment point and n + 1 responses.
+// generators: array of n 32-byte points G_1..G_n
+// values: array of n 32-byte scalars x_1..x_n
+
+// Vector proof size: commitment + n + 1 responses
+static inline size_t
+csigma_pedersen_vector_proof_size(size_t n)
+{
+    return CSIGMA_POINT_BYTES + (n + 1) * CSIGMA_SCALAR_BYTES;
+}
+
+// Create vector Pedersen commitment: C = sum of x_i*G_i + r*H
+// Computed with a single multi-scalar multiplication
+// Returns 0 on success, -1 on failure
+int csigma_pedersen_vector_commit(uint8_t commitment[CSIGMA_POINT_BYTES], const uint8_t* values,
+                                  const uint8_t  randomness[CSIGMA_SCALAR_BYTES],
+                                  const uint8_t* generators, size_t n,
+                                  const uint8_t H[CSIGMA_POINT_BYTES]);
+
+// Prove knowledge of a vector Pedersen commitment opening
+// proof: output buffer of csigma_pedersen_vector_proof_size(n) bytes
+// Returns 0 on success, -1 on error
+int csigma_pedersen_vector_prove(uint8_t* proof, const uint8_t* values,
+                                 const uint8_t  randomness[CSIGMA_SCALAR_BYTES],
+                                 const uint8_t* generators, size_t n,
+                                 const uint8_t H[CSIGMA_POINT_BYTES],
+                                 const uint8_t C[CSIGMA_POINT_BYTES], const uint8_t* message,
+                                 size_t message_len);
+
+// Verify a vector Pedersen commitment opening proof with a single multi-scalar
+// multiplication
+// Returns true if valid, false otherwise
+bool csigma_pedersen_vector_verify(const uint8_t* proof, size_t proof_len,
+                                   const uint8_t* generators, size_t n,
+                                   const uint8_t H[CSIGMA_POINT_BYTES],
+                                   const uint8_t C[CSIGMA_POINT_BYTES], const uint8_t* message,
+                                   size_t message_len);
+
 #endif
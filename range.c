@@ -0,0 +1,283 @@
+#include "range.h"
+#include "transcript.h"
+#include "msm.h"
+#include "nonce.h"
+#include "pedersen.h"
+#include <string.h>
+
+// Points: C_i (bit commitments), T_i,0, T_i,1 (OR proof commitments)
+// Scalars: c_i,0 (challenge share of the 0 branch), z_i,0, z_i,1
+#define POINTS_PER_BIT 3
+#define SCALARS_PER_BIT 3
+
+size_t
+csigma_range_proof_size(size_t bits)
+{
+    if (bits == 0 || bits > CSIGMA_RANGE_MAX_BITS)
+        return 0;
+    return bits * (POINTS_PER_BIT * CSIGMA_POINT_BYTES + SCALARS_PER_BIT * CSIGMA_SCALAR_BYTES);
+}
+
+// 2^i as a scalar, i < 64 (internal)
+static void
+power_of_two(uint8_t out[CSIGMA_SCALAR_BYTES], size_t i)
+{
+    memset(out, 0, CSIGMA_SCALAR_BYTES);
+    out[i / 8] = (uint8_t) (1 << (i % 8));
+}
+
+// Start a proof transcript: the generators, the bit length and C (internal)
+static void
+start_transcript(csigma_transcript_t* transcript, size_t bits, const uint8_t G[CSIGMA_POINT_BYTES],
+                 const uint8_t H[CSIGMA_POINT_BYTES], const uint8_t C[CSIGMA_POINT_BYTES])
+{
+    csigma_transcript_init(transcript, "range_proof");
+
+    csigma_transcript_absorb(transcript, G, CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb(transcript, H, CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb_u64(transcript, bits);
+    csigma_transcript_absorb(transcript, C, CSIGMA_POINT_BYTES);
+}
+
+// Fiat-Shamir challenge shared by all the bit proofs, over a started transcript
+// (internal)
+static void
+generate_challenge(uint8_t challenge[CSIGMA_SCALAR_BYTES], csigma_transcript_t* transcript,
+                   size_t bits, const uint8_t* points, const uint8_t* message, size_t message_len)
+{
+    csigma_transcript_absorb(transcript, points, POINTS_PER_BIT * bits * CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb(transcript, message, message ? message_len : 0);
+    csigma_transcript_challenge(transcript, challenge);
+}
+
+int
+csigma_range_prove(uint8_t* proof, uint64_t value, const uint8_t randomness[CSIGMA_SCALAR_BYTES],
+                   size_t bits, const uint8_t G[CSIGMA_POINT_BYTES],
+                   const uint8_t H[CSIGMA_POINT_BYTES], const uint8_t C[CSIGMA_POINT_BYTES],
+                   const uint8_t* message, size_t message_len)
+{
+    if (!proof || !randomness || !G || !H || !C || csigma_range_proof_size(bits) == 0)
+        return -1;
+    if (bits < 64 && (value >> bits) != 0)
+        return -1;
+
+    uint8_t* Ci = proof;
+    uint8_t* T0 = &Ci[bits * CSIGMA_POINT_BYTES];
+    uint8_t* T1 = &T0[bits * CSIGMA_POINT_BYTES];
+    uint8_t* c0 = &T1[bits * CSIGMA_POINT_BYTES];
+    uint8_t* z0 = &c0[bits * CSIGMA_SCALAR_BYTES];
+    uint8_t* z1 = &z0[bits * CSIGMA_SCALAR_BYTES];
+
+    // Every random scalar is a hedged nonce bound to the statement, the message, the
+    // value and the randomness: bit blinders r_i, real-branch nonces, then the
+    // challenge shares and responses of the simulated branches
+    uint8_t             draws[4 * CSIGMA_RANGE_MAX_BITS][CSIGMA_SCALAR_BYTES];
+    uint8_t(*r)[CSIGMA_SCALAR_BYTES]      = &draws[0];
+    uint8_t(*nonces)[CSIGMA_SCALAR_BYTES] = &draws[bits];
+    uint8_t             power[CSIGMA_SCALAR_BYTES], tmp[CSIGMA_SCALAR_BYTES];
+    uint8_t             rest[CSIGMA_SCALAR_BYTES];
+    uint8_t             context[CSIGMA_NONCE_CONTEXT_BYTES];
+    uint8_t             witness[8 + CSIGMA_SCALAR_BYTES];
+    csigma_transcript_t transcript;
+    shake128_ctx        nonce_transcript;
+    int                 ret = -1;
+
+    start_transcript(&transcript, bits, G, H, C);
+    csigma_transcript_nonce_context(&transcript, message, message_len, context);
+    for (size_t i = 0; i < 8; i++) {
+        witness[i] = (uint8_t) (value >> (8 * i));
+    }
+    memcpy(&witness[8], randomness, CSIGMA_SCALAR_BYTES);
+    csigma_nonce_init(&nonce_transcript);
+    csigma_nonce_absorb_context(&nonce_transcript, context, sizeof(context));
+    csigma_nonce_derive(draws[0], 4 * bits, &nonce_transcript, witness, sizeof(witness));
+    sodium_memzero(witness, sizeof(witness));
+
+    // Bit blinders r_i, with the last one fixed so that sum of 2^i * r_i = randomness
+    memcpy(rest, randomness, CSIGMA_SCALAR_BYTES);
+    for (size_t i = 0; i + 1 < bits; i++) {
+        power_of_two(power, i);
+        crypto_core_ristretto255_scalar_mul(tmp, r[i], power);
+        crypto_core_ristretto255_scalar_sub(rest, rest, tmp);
+    }
+    power_of_two(power, bits - 1);
+    crypto_core_ristretto255_scalar_invert(power, power);
+    crypto_core_ristretto255_scalar_mul(r[bits - 1], rest, power);
+
+    for (size_t i = 0; i < bits; i++) {
+        int      bit = (int) ((value >> i) & 1);
+        uint8_t  b[CSIGMA_SCALAR_BYTES] = { (uint8_t) bit };
+        uint8_t* C_i = &Ci[i * CSIGMA_POINT_BYTES];
+        uint8_t* T_real = bit ? &T1[i * CSIGMA_POINT_BYTES] : &T0[i * CSIGMA_POINT_BYTES];
+        uint8_t* T_sim  = bit ? &T0[i * CSIGMA_POINT_BYTES] : &T1[i * CSIGMA_POINT_BYTES];
+        uint8_t* z_sim  = bit ? &z0[i * CSIGMA_SCALAR_BYTES] : &z1[i * CSIGMA_SCALAR_BYTES];
+        uint8_t  Y_sim[CSIGMA_POINT_BYTES];
+
+        if (csigma_pedersen_commit(C_i, b, r[i], G, H) != 0)
+            goto done;
+
+        // Real branch: T = w*H
+        if (csigma_scalarmult(T_real, nonces[i], H) != 0)
+            goto done;
+
+        // Simulated branch on Y = C_i - G (bit 0) or Y = C_i (bit 1): T = z*H - c*Y,
+        // with its challenge share stored in the c_i,0 slot for now
+        if (bit) {
+            memcpy(Y_sim, C_i, CSIGMA_POINT_BYTES);
+        } else if (crypto_core_ristretto255_sub(Y_sim, C_i, G) != 0) {
+            goto done;
+        }
+        uint8_t* c_sim = &c0[i * CSIGMA_SCALAR_BYTES];
+        uint8_t  scalars[2 * CSIGMA_SCALAR_BYTES], points[2 * CSIGMA_POINT_BYTES];
+        memcpy(c_sim, draws[2 * bits + i], CSIGMA_SCALAR_BYTES);
+        memcpy(z_sim, draws[3 * bits + i], CSIGMA_SCALAR_BYTES);
+        memcpy(&scalars[0], z_sim, CSIGMA_SCALAR_BYTES);
+        crypto_core_ristretto255_scalar_negate(&scalars[CSIGMA_SCALAR_BYTES], c_sim);
+        memcpy(&points[0], H, CSIGMA_POINT_BYTES);
+        memcpy(&points[CSIGMA_POINT_BYTES], Y_sim, CSIGMA_POINT_BYTES);
+        if (csigma_msm(T_sim, scalars, points, 2) != 0)
+            goto done;
+    }
+
+    uint8_t c[CSIGMA_SCALAR_BYTES];
+    generate_challenge(c, &transcript, bits, proof, message, message_len);
+
+    // Real branch: c_real = c - c_sim, z = w + c_real * r_i
+    for (size_t i = 0; i < bits; i++) {
+        int      bit    = (int) ((value >> i) & 1);
+        uint8_t* c_i0   = &c0[i * CSIGMA_SCALAR_BYTES];
+        uint8_t* z_real = bit ? &z1[i * CSIGMA_SCALAR_BYTES] : &z0[i * CSIGMA_SCALAR_BYTES];
+        uint8_t  c_real[CSIGMA_SCALAR_BYTES];
+
+        crypto_core_ristretto255_scalar_sub(c_real, c, c_i0);
+        crypto_core_ristretto255_scalar_mul(tmp, c_real, r[i]);
+        crypto_core_ristretto255_scalar_add(z_real, nonces[i], tmp);
+        if (!bit) {
+            memcpy(c_i0, c_real, CSIGMA_SCALAR_BYTES);
+        }
+    }
+    ret = 0;
+
+done:
+    sodium_memzero(draws, sizeof(draws));
+    sodium_memzero(rest, sizeof(rest));
+    sodium_memzero(tmp, sizeof(tmp));
+    return ret;
+}
+
+// Add the checks of one range proof to a multi-scalar multiplication (internal)
+// The terms on G and H are accumulated into g_scalar and h_scalar, so that a batch
+// adds them once. With random weights rho_i,0, rho_i,1 and sigma:
+//   rho_i,0 * (z_i,0*H - T_i,0 - c_i,0*C_i)
+//   rho_i,1 * (z_i,1*H - T_i,1 - c_i,1*(C_i - G))      with c_i,1 = c - c_i,0
+//   sigma * (sum of 2^i * C_i - C)
+static int
+range_append_checks(msm_t* msm, uint8_t g_scalar[CSIGMA_SCALAR_BYTES],
+                    uint8_t h_scalar[CSIGMA_SCALAR_BYTES], const uint8_t* proof, size_t bits,
+                    const uint8_t G[CSIGMA_POINT_BYTES], const uint8_t H[CSIGMA_POINT_BYTES],
+                    const uint8_t C[CSIGMA_POINT_BYTES], const uint8_t* message,
+                    size_t message_len)
+{
+    const uint8_t* Ci = proof;
+    const uint8_t* T0 = &Ci[bits * CSIGMA_POINT_BYTES];
+    const uint8_t* T1 = &T0[bits * CSIGMA_POINT_BYTES];
+    const uint8_t* c0 = &T1[bits * CSIGMA_POINT_BYTES];
+    const uint8_t* z0 = &c0[bits * CSIGMA_SCALAR_BYTES];
+    const uint8_t* z1 = &z0[bits * CSIGMA_SCALAR_BYTES];
+
+    csigma_transcript_t transcript;
+    uint8_t c[CSIGMA_SCALAR_BYTES], sigma[CSIGMA_SCALAR_BYTES], scalar[CSIGMA_SCALAR_BYTES];
+    start_transcript(&transcript, bits, G, H, C);
+    generate_challenge(c, &transcript, bits, proof, message, message_len);
+
+    crypto_core_ristretto255_scalar_random(sigma);
+    crypto_core_ristretto255_scalar_negate(scalar, sigma);
+    if (msm_add_term(msm, scalar, C) != 0)
+        return -1;
+
+    for (size_t i = 0; i < bits; i++) {
+        const uint8_t* c_i0 = &c0[i * CSIGMA_SCALAR_BYTES];
+        uint8_t        rho0[CSIGMA_SCALAR_BYTES], rho1[CSIGMA_SCALAR_BYTES];
+        uint8_t        c_i1[CSIGMA_SCALAR_BYTES], tmp[CSIGMA_SCALAR_BYTES];
+
+        crypto_core_ristretto255_scalar_random(rho0);
+        crypto_core_ristretto255_scalar_random(rho1);
+        crypto_core_ristretto255_scalar_sub(c_i1, c, c_i0);
+
+        // C_i: sigma*2^i - rho_i,0*c_i,0 - rho_i,1*c_i,1
+        power_of_two(tmp, i);
+        crypto_core_ristretto255_scalar_mul(scalar, sigma, tmp);
+        crypto_core_ristretto255_scalar_mul(tmp, rho0, c_i0);
+        crypto_core_ristretto255_scalar_sub(scalar, scalar, tmp);
+        crypto_core_ristretto255_scalar_mul(tmp, rho1, c_i1);
+        crypto_core_ristretto255_scalar_sub(scalar, scalar, tmp);
+        if (msm_add_term(msm, scalar, &Ci[i * CSIGMA_POINT_BYTES]) != 0)
+            return -1;
+
+        // T_i,0 and T_i,1: -rho
+        crypto_core_ristretto255_scalar_negate(scalar, rho0);
+        if (msm_add_term(msm, scalar, &T0[i * CSIGMA_POINT_BYTES]) != 0)
+            return -1;
+        crypto_core_ristretto255_scalar_negate(scalar, rho1);
+        if (msm_add_term(msm, scalar, &T1[i * CSIGMA_POINT_BYTES]) != 0)
+            return -1;
+
+        // G: rho_i,1*c_i,1; H: rho_i,0*z_i,0 + rho_i,1*z_i,1
+        crypto_core_ristretto255_scalar_mul(tmp, rho1, c_i1);
+        crypto_core_ristretto255_scalar_add(g_scalar, g_scalar, tmp);
+        crypto_core_ristretto255_scalar_mul(tmp, rho0, &z0[i * CSIGMA_SCALAR_BYTES]);
+        crypto_core_ristretto255_scalar_add(h_scalar, h_scalar, tmp);
+        crypto_core_ristretto255_scalar_mul(tmp, rho1, &z1[i * CSIGMA_SCALAR_BYTES]);
+        crypto_core_ristretto255_scalar_add(h_scalar, h_scalar, tmp);
+    }
+    return 0;
+}
+
+bool
+csigma_range_verify(const uint8_t* proof, size_t proof_len, size_t bits,
+                    const uint8_t G[CSIGMA_POINT_BYTES], const uint8_t H[CSIGMA_POINT_BYTES],
+                    const uint8_t C[CSIGMA_POINT_BYTES], const uint8_t* message,
+                    size_t message_len)
+{
+    if (!proof || !C || proof_len == 0 || proof_len != csigma_range_proof_size(bits))
+        return false;
+
+    const uint8_t* messages[1]     = { message };
+    size_t         message_lens[1] = { message_len };
+    return csigma_range_batch_verify(proof, C, 1, bits, G, H, messages, message_lens);
+}
+
+bool
+csigma_range_batch_verify(const uint8_t* proofs, const uint8_t* commitments, size_t n,
+                          size_t bits, const uint8_t G[CSIGMA_POINT_BYTES],
+                          const uint8_t H[CSIGMA_POINT_BYTES], const uint8_t* const* messages,
+                          const size_t* message_lens)
+{
+    size_t proof_len = csigma_range_proof_size(bits);
+
+    if (!proofs || !commitments || !G || !H || n == 0 || proof_len == 0)
+        return false;
+
+    uint8_t g_scalar[CSIGMA_SCALAR_BYTES] = { 0 };
+    uint8_t h_scalar[CSIGMA_SCALAR_BYTES] = { 0 };
+    bool    valid                         = false;
+    msm_t   msm;
+    msm_init(&msm);
+
+    for (size_t j = 0; j < n; j++) {
+        const uint8_t* message     = messages ? messages[j] : NULL;
+        size_t         message_len = message_lens ? message_lens[j] : 0;
+
+        if (range_append_checks(&msm, g_scalar, h_scalar, &proofs[j * proof_len], bits, G, H,
+                                &commitments[j * CSIGMA_POINT_BYTES], message, message_len) != 0)
+            goto done;
+    }
+    if (msm_add_term(&msm, g_scalar, G) != 0 || msm_add_term(&msm, h_scalar, H) != 0)
+        goto done;
+
+    valid = msm_is_identity(&msm);
+
+done:
+    msm_destroy(&msm);
+    return valid;
+}
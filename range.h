@@ -0,0 +1,54 @@
+#ifndef RANGE_H
+#define RANGE_H
+
+#include "csigma.h"
+
+// Range proofs by bit decomposition
+// Proves that a Pedersen commitment C = v*G + r*H (from csigma_pedersen_commit())
+// holds a value v in [0, 2^bits), 1 <= bits <= 64.
+//
+// The prover commits to every bit, C_i = b_i*G + r_i*H, with blinders chosen so that
+//   C = sum of 2^i * C_i
+// and proves that each C_i opens to 0 or 1 with an OR proof of knowledge of the
+// discrete logarithm of C_i or C_i - G in base H. All OR proofs share one
+// Fiat-Shamir challenge.
+//
+// The verifier checks every bit proof and the sum with one randomized multi-scalar
+// multiplication. Batches of range proofs under the same G and H go into a single
+// multi-scalar multiplication, where the terms on G and H are merged.
+//
+// Proof layout: C_i, T_i,0, T_i,1 (points) then c_i,0, z_i,0, z_i,1 (scalars),
+// each array having one entry per bit: 192 bytes per bit.
+
+#define CSIGMA_RANGE_MAX_BITS 64
+
+// Range proof size in bytes for the given number of bits (0 if bits is out of range)
+size_t csigma_range_proof_size(size_t bits);
+
+// Prove that C = value*G + randomness*H with value < 2^bits
+// proof: output buffer of csigma_range_proof_size(bits) bytes
+// Returns 0 on success, -1 on error (including a value out of range)
+int csigma_range_prove(uint8_t* proof, uint64_t value,
+                       const uint8_t randomness[CSIGMA_SCALAR_BYTES], size_t bits,
+                       const uint8_t G[CSIGMA_POINT_BYTES], const uint8_t H[CSIGMA_POINT_BYTES],
+                       const uint8_t C[CSIGMA_POINT_BYTES], const uint8_t* message,
+                       size_t message_len);
+
+// Verify a range proof with a single multi-scalar multiplication
+// Returns true if valid, false otherwise
+bool csigma_range_verify(const uint8_t* proof, size_t proof_len, size_t bits,
+                         const uint8_t G[CSIGMA_POINT_BYTES], const uint8_t H[CSIGMA_POINT_BYTES],
+                         const uint8_t C[CSIGMA_POINT_BYTES], const uint8_t* message,
+                         size_t message_len);
+
+// Verify n range proofs of the same bit length together
+// proofs: n contiguous proofs of csigma_range_proof_size(bits) bytes
+// commitments: n commitments (32 bytes each)
+// messages, message_lens: per-proof messages (both may be NULL for no messages)
+// Returns true only if every proof is valid
+bool csigma_range_batch_verify(const uint8_t* proofs, const uint8_t* commitments, size_t n,
+                               size_t bits, const uint8_t G[CSIGMA_POINT_BYTES],
+                               const uint8_t H[CSIGMA_POINT_BYTES],
+                               const uint8_t* const* messages, const size_t* message_lens);
+
+#endif
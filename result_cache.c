@@ -0,0 +1,316 @@
+#include "result_cache.h"
+#include "keccak.h"
+#include "pedersen.h"
+#include "sigma.h"
+#include "transcript.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Monotonic clock in milliseconds (never 0, which marks free slots)
+static uint64_t
+now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000 + (uint64_t) ts.tv_nsec / 1000000 + 1;
+}
+
+int
+csigma_result_cache_init(csigma_result_cache_t* cache, size_t max_entries, uint64_t ttl_ms)
+{
+    // Every shard holds a whole number of windows
+    size_t windows = max_entries / (CSIGMA_RESULT_CACHE_SHARDS * CSIGMA_RESULT_CACHE_WAYS);
+    if (windows == 0) {
+        windows = 1;
+    }
+
+    memset(cache, 0, sizeof(*cache));
+    cache->ttl_ms = ttl_ms;
+
+    for (size_t s = 0; s < CSIGMA_RESULT_CACHE_SHARDS; s++) {
+        csigma_result_shard_t* shard = &cache->shards[s];
+        shard->capacity              = windows * CSIGMA_RESULT_CACHE_WAYS;
+        shard->entries               = calloc(shard->capacity, sizeof(csigma_result_entry_t));
+        if (!shard->entries || pthread_mutex_init(&shard->lock, NULL) != 0) {
+            free(shard->entries);
+            shard->entries = NULL;
+            csigma_result_cache_destroy(cache);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void
+csigma_result_cache_destroy(csigma_result_cache_t* cache)
+{
+    for (size_t s = 0; s < CSIGMA_RESULT_CACHE_SHARDS; s++) {
+        csigma_result_shard_t* shard = &cache->shards[s];
+        if (shard->entries) {
+            pthread_mutex_destroy(&shard->lock);
+        }
+        free(shard->entries);
+        shard->entries  = NULL;
+        shard->capacity = 0;
+    }
+}
+
+void
+csigma_result_cache_clear(csigma_result_cache_t* cache)
+{
+    for (size_t s = 0; s < CSIGMA_RESULT_CACHE_SHARDS; s++) {
+        csigma_result_shard_t* shard = &cache->shards[s];
+        pthread_mutex_lock(&shard->lock);
+        memset(shard->entries, 0, shard->capacity * sizeof(csigma_result_entry_t));
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
+
+void
+csigma_result_cache_stats(csigma_result_cache_t* cache, uint64_t* hits, uint64_t* misses)
+{
+    *hits   = 0;
+    *misses = 0;
+    for (size_t s = 0; s < CSIGMA_RESULT_CACHE_SHARDS; s++) {
+        csigma_result_shard_t* shard = &cache->shards[s];
+        pthread_mutex_lock(&shard->lock);
+        *hits += shard->hits;
+        *misses += shard->misses;
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
+
+// Digest of a verification under a given transcript backend (internal)
+static void
+digest_with(uint8_t digest[CSIGMA_RESULT_CACHE_DIGEST_BYTES], csigma_hash_t hash,
+            const char* label, const uint8_t* const* inputs, const size_t* input_lens,
+            size_t num_inputs)
+{
+    uint8_t      backend = (uint8_t) hash;
+    shake128_ctx ctx;
+    shake128_init(&ctx);
+    shake128_absorb(&ctx, (const uint8_t*) "csigma_result_cache", 19);
+    shake128_absorb(&ctx, (const uint8_t*) label, strlen(label) + 1);
+    shake128_absorb(&ctx, &backend, 1);
+
+    for (size_t i = 0; i < num_inputs; i++) {
+        uint8_t len[8];
+        for (size_t j = 0; j < 8; j++) {
+            len[j] = (uint8_t) ((uint64_t) input_lens[i] >> (8 * j));
+        }
+        shake128_absorb(&ctx, len, sizeof(len));
+        if (input_lens[i] > 0)
+            shake128_absorb(&ctx, inputs[i], input_lens[i]);
+    }
+    shake128_squeeze(&ctx, digest, CSIGMA_RESULT_CACHE_DIGEST_BYTES);
+}
+
+void
+csigma_result_cache_digest(uint8_t digest[CSIGMA_RESULT_CACHE_DIGEST_BYTES], const char* label,
+                           const uint8_t* const* inputs, const size_t* input_lens,
+                           size_t num_inputs)
+{
+    digest_with(digest, csigma_transcript_get_hash(), label, inputs, input_lens, num_inputs);
+}
+
+// The digest is uniformly distributed: its first bytes pick the shard and the window
+// (internal)
+static csigma_result_shard_t*
+locate(csigma_result_cache_t* cache, const uint8_t digest[CSIGMA_RESULT_CACHE_DIGEST_BYTES],
+       csigma_result_entry_t** window)
+{
+    uint64_t h = 0;
+    for (size_t i = 0; i < 8; i++) {
+        h |= (uint64_t) digest[i] << (8 * i);
+    }
+
+    csigma_result_shard_t* shard   = &cache->shards[h % CSIGMA_RESULT_CACHE_SHARDS];
+    size_t                 windows = shard->capacity / CSIGMA_RESULT_CACHE_WAYS;
+    size_t                 first   = (h / CSIGMA_RESULT_CACHE_SHARDS) % windows;
+    *window                        = &shard->entries[first * CSIGMA_RESULT_CACHE_WAYS];
+    return shard;
+}
+
+bool
+csigma_result_cache_lookup(csigma_result_cache_t* cache,
+                           const uint8_t digest[CSIGMA_RESULT_CACHE_DIGEST_BYTES])
+{
+    csigma_result_entry_t* window;
+    csigma_result_shard_t* shard = locate(cache, digest, &window);
+    uint64_t               now   = now_ms();
+    bool                   found = false;
+
+    pthread_mutex_lock(&shard->lock);
+    for (size_t w = 0; w < CSIGMA_RESULT_CACHE_WAYS; w++) {
+        if (window[w].expires != 0 &&
+            memcmp(window[w].digest, digest, CSIGMA_RESULT_CACHE_DIGEST_BYTES) == 0) {
+            if (window[w].expires > now) {
+                found = true;
+            } else {
+                window[w].expires = 0;
+            }
+            break;
+        }
+    }
+    if (found) {
+        shard->hits++;
+    } else {
+        shard->misses++;
+    }
+    pthread_mutex_unlock(&shard->lock);
+    return found;
+}
+
+void
+csigma_result_cache_insert(csigma_result_cache_t* cache,
+                           const uint8_t digest[CSIGMA_RESULT_CACHE_DIGEST_BYTES])
+{
+    csigma_result_entry_t* window;
+    csigma_result_shard_t* shard   = locate(cache, digest, &window);
+    uint64_t               now     = now_ms();
+    uint64_t               expires = now + cache->ttl_ms;
+    if (expires < now) {
+        expires = UINT64_MAX;
+    }
+
+    pthread_mutex_lock(&shard->lock);
+
+    // Reuse the slot of the same digest, else a free or expired slot, else the oldest
+    csigma_result_entry_t* slot = &window[0];
+    for (size_t w = 0; w < CSIGMA_RESULT_CACHE_WAYS; w++) {
+        csigma_result_entry_t* entry = &window[w];
+        if (entry->expires != 0 &&
+            memcmp(entry->digest, digest, CSIGMA_RESULT_CACHE_DIGEST_BYTES) == 0) {
+            slot = entry;
+            break;
+        }
+        if (entry->expires <= now) {
+            if (slot->expires > now) {
+                slot = entry;
+            }
+        } else if (slot->expires > now && entry->expires < slot->expires) {
+            slot = entry;
+        }
+    }
+    memcpy(slot->digest, digest, CSIGMA_RESULT_CACHE_DIGEST_BYTES);
+    slot->expires = expires;
+
+    pthread_mutex_unlock(&shard->lock);
+}
+
+// ============================================================================
+// Cached Verifiers
+// ============================================================================
+
+// Look a digest made under backend hash up, else run the verification and remember a
+// success, unless the backend has changed meanwhile (internal)
+static bool
+memo_verify(csigma_result_cache_t* cache, csigma_hash_t hash,
+            const uint8_t digest[CSIGMA_RESULT_CACHE_DIGEST_BYTES], bool (*verify)(const void*),
+            const void* args)
+{
+    if (csigma_result_cache_lookup(cache, digest))
+        return true;
+    if (!verify(args))
+        return false;
+    if (csigma_transcript_get_hash() == hash)
+        csigma_result_cache_insert(cache, digest);
+    return true;
+}
+
+// Arguments of the wrapped verifiers (internal)
+typedef struct {
+    const uint8_t* proof;
+    const uint8_t* points[4];
+    const uint8_t* message;
+    size_t         message_len;
+} verify_args_t;
+
+static bool
+schnorr_verify(const void* arg)
+{
+    const verify_args_t* a = arg;
+    return csigma_schnorr_verify(a->proof, a->points[0], a->message, a->message_len);
+}
+
+static bool
+dleq_verify(const void* arg)
+{
+    const verify_args_t* a = arg;
+    return csigma_dleq_verify(a->proof, a->points[0], a->points[1], a->points[2], a->points[3],
+                              a->message, a->message_len);
+}
+
+static bool
+pedersen_verify(const void* arg)
+{
+    const verify_args_t* a = arg;
+    return csigma_pedersen_verify(a->proof, a->points[0], a->points[1], a->points[2], a->message,
+                                  a->message_len);
+}
+
+bool
+csigma_schnorr_verify_memo(csigma_result_cache_t* cache,
+                           const uint8_t          proof[CSIGMA_SCHNORR_PROOF_SIZE],
+                           const uint8_t          public_key[CSIGMA_POINT_BYTES],
+                           const uint8_t* message, size_t message_len)
+{
+    if (!cache || !proof || !public_key)
+        return false;
+
+    const uint8_t* inputs[] = { public_key, proof, message };
+    size_t         lens[]   = { CSIGMA_POINT_BYTES, CSIGMA_SCHNORR_PROOF_SIZE,
+                                message ? message_len : 0 };
+    uint8_t        digest[CSIGMA_RESULT_CACHE_DIGEST_BYTES];
+    csigma_hash_t  hash = csigma_transcript_get_hash();
+    digest_with(digest, hash, "schnorr", inputs, lens, 3);
+
+    verify_args_t args = { proof, { public_key }, message, message_len };
+    return memo_verify(cache, hash, digest, schnorr_verify, &args);
+}
+
+bool
+csigma_dleq_verify_memo(csigma_result_cache_t* cache, const uint8_t proof[CSIGMA_DLEQ_PROOF_SIZE],
+                        const uint8_t g1[CSIGMA_POINT_BYTES],
+                        const uint8_t h1[CSIGMA_POINT_BYTES],
+                        const uint8_t g2[CSIGMA_POINT_BYTES],
+                        const uint8_t h2[CSIGMA_POINT_BYTES], const uint8_t* message,
+                        size_t message_len)
+{
+    if (!cache || !proof || !g1 || !h1 || !g2 || !h2)
+        return false;
+
+    const uint8_t* inputs[] = { g1, h1, g2, h2, proof, message };
+    size_t         lens[]   = { CSIGMA_POINT_BYTES,     CSIGMA_POINT_BYTES,
+                                CSIGMA_POINT_BYTES,     CSIGMA_POINT_BYTES,
+                                CSIGMA_DLEQ_PROOF_SIZE, message ? message_len : 0 };
+    uint8_t        digest[CSIGMA_RESULT_CACHE_DIGEST_BYTES];
+    csigma_hash_t  hash = csigma_transcript_get_hash();
+    digest_with(digest, hash, "dleq", inputs, lens, 6);
+
+    verify_args_t args = { proof, { g1, h1, g2, h2 }, message, message_len };
+    return memo_verify(cache, hash, digest, dleq_verify, &args);
+}
+
+bool
+csigma_pedersen_verify_memo(csigma_result_cache_t* cache,
+                            const uint8_t          proof[CSIGMA_PEDERSEN_PROOF_SIZE],
+                            const uint8_t          G[CSIGMA_POINT_BYTES],
+                            const uint8_t          H[CSIGMA_POINT_BYTES],
+                            const uint8_t C[CSIGMA_POINT_BYTES], const uint8_t* message,
+                            size_t message_len)
+{
+    if (!cache || !proof || !G || !H || !C)
+        return false;
+
+    const uint8_t* inputs[] = { G, H, C, proof, message };
+    size_t         lens[]   = { CSIGMA_POINT_BYTES, CSIGMA_POINT_BYTES, CSIGMA_POINT_BYTES,
+                                CSIGMA_PEDERSEN_PROOF_SIZE, message ? message_len : 0 };
+    uint8_t        digest[CSIGMA_RESULT_CACHE_DIGEST_BYTES];
+    csigma_hash_t  hash = csigma_transcript_get_hash();
+    digest_with(digest, hash, "pedersen", inputs, lens, 5);
+
+    verify_args_t args = { proof, { G, H, C }, message, message_len };
+    return memo_verify(cache, hash, digest, pedersen_verify, &args);
+}
@@ -0,0 +1,95 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "csigma.h"
+#include <pthread.h>
+
+// Verification result cache
+// Remembers proofs that verified successfully, so that a retried or duplicated
+// (statement, proof, message) tuple is accepted again after a single hash instead
+// of a full verification. Only positive results are stored: a rejected proof is
+// always verified again.
+//
+// Entries are keyed by a 32-byte SHAKE128 digest over a protocol label, the transcript
+// backend and every verification input, each prefixed with its length, so that a result
+// is not reused after csigma_transcript_set_hash() selects another backend. They expire
+// after a TTL, and the cache holds at most a fixed number of entries: each digest has a
+// window of CSIGMA_RESULT_CACHE_WAYS slots, and a full window replaces its oldest entry.
+// All functions are thread-safe; entries are spread over independently locked shards.
+
+#define CSIGMA_RESULT_CACHE_SHARDS 16
+#define CSIGMA_RESULT_CACHE_WAYS 8
+#define CSIGMA_RESULT_CACHE_DIGEST_BYTES 32
+
+// Cached result (internal)
+typedef struct {
+    uint8_t  digest[CSIGMA_RESULT_CACHE_DIGEST_BYTES];
+    uint64_t expires; // Monotonic time in milliseconds; 0 for a free slot
+} csigma_result_entry_t;
+
+// One shard (internal)
+typedef struct {
+    pthread_mutex_t        lock;
+    csigma_result_entry_t* entries;
+    size_t                 capacity;
+    uint64_t               hits;
+    uint64_t               misses;
+} csigma_result_shard_t;
+
+typedef struct {
+    csigma_result_shard_t shards[CSIGMA_RESULT_CACHE_SHARDS];
+    uint64_t              ttl_ms;
+} csigma_result_cache_t;
+
+// Create a cache of about max_entries entries, each valid for ttl_ms milliseconds
+// Returns 0 on success, -1 on error
+int csigma_result_cache_init(csigma_result_cache_t* cache, size_t max_entries, uint64_t ttl_ms);
+
+// Release the cache
+void csigma_result_cache_destroy(csigma_result_cache_t* cache);
+
+// Drop every entry
+void csigma_result_cache_clear(csigma_result_cache_t* cache);
+
+// Read the hit and miss counters
+void csigma_result_cache_stats(csigma_result_cache_t* cache, uint64_t* hits, uint64_t* misses);
+
+// Digest of a verification: label, current transcript backend, then every input with its
+// length
+// inputs, input_lens: num_inputs byte strings (NULL inputs must have length 0)
+void csigma_result_cache_digest(uint8_t     digest[CSIGMA_RESULT_CACHE_DIGEST_BYTES],
+                                const char* label, const uint8_t* const* inputs,
+                                const size_t* input_lens, size_t num_inputs);
+
+// Check whether a digest is cached and has not expired
+bool csigma_result_cache_lookup(csigma_result_cache_t* cache,
+                                const uint8_t digest[CSIGMA_RESULT_CACHE_DIGEST_BYTES]);
+
+// Record a successful verification
+void csigma_result_cache_insert(csigma_result_cache_t* cache,
+                                const uint8_t digest[CSIGMA_RESULT_CACHE_DIGEST_BYTES]);
+
+// csigma_schnorr_verify() with result caching
+bool csigma_schnorr_verify_memo(csigma_result_cache_t* cache,
+                                const uint8_t          proof[CSIGMA_SCHNORR_PROOF_SIZE],
+                                const uint8_t          public_key[CSIGMA_POINT_BYTES],
+                                const uint8_t* message, size_t message_len);
+
+// csigma_dleq_verify() with result caching
+bool csigma_dleq_verify_memo(csigma_result_cache_t* cache,
+                             const uint8_t proof[CSIGMA_DLEQ_PROOF_SIZE],
+                             const uint8_t g1[CSIGMA_POINT_BYTES],
+                             const uint8_t h1[CSIGMA_POINT_BYTES],
+                             const uint8_t g2[CSIGMA_POINT_BYTES],
+                             const uint8_t h2[CSIGMA_POINT_BYTES], const uint8_t* message,
+                             size_t message_len);
+
+// csigma_pedersen_verify() with result caching
+bool csigma_pedersen_verify_memo(csigma_result_cache_t* cache,
+                                 const uint8_t proof[CSIGMA_PEDERSEN_PROOF_SIZE],
+                                 const uint8_t G[CSIGMA_POINT_BYTES],
+                                 const uint8_t H[CSIGMA_POINT_BYTES],
+                                 const uint8_t C[CSIGMA_POINT_BYTES], const uint8_t* message,
+                                 size_t message_len);
+
+#endif
@@ -0,0 +1,107 @@
+#include "resumable.h"
+#include <string.h>
+
+int
+csigma_verifier_init(csigma_verifier_t* verifier, const linear_relation_t* relation,
+                     const uint8_t* commitment, const uint8_t challenge[CSIGMA_SCALAR_BYTES],
+                     const uint8_t* response)
+{
+    verifier->relation   = relation;
+    verifier->commitment = commitment;
+    verifier->response   = response;
+    verifier->next_row   = 0;
+    verifier->next_term  = 0;
+    verifier->has_sum    = false;
+    verifier->status     = CSIGMA_VERIFY_PENDING;
+    memcpy(verifier->challenge, challenge, CSIGMA_SCALAR_BYTES);
+    memset(verifier->sum, 0, CSIGMA_POINT_BYTES);
+    msm_init(&verifier->terms);
+
+    if (linear_relation_validate(relation) != 0) {
+        verifier->status = CSIGMA_VERIFY_INVALID;
+        return -1;
+    }
+    return 0;
+}
+
+void
+csigma_verifier_destroy(csigma_verifier_t* verifier)
+{
+    msm_destroy(&verifier->terms);
+}
+
+// Append whole rows until there are budget terms to evaluate (internal)
+// Batching rows lets terms on the same point merge before any point arithmetic
+static int
+refill(csigma_verifier_t* verifier, size_t budget)
+{
+    const linear_relation_t* relation = verifier->relation;
+
+    msm_reset(&verifier->terms);
+    verifier->next_term = 0;
+    while (verifier->next_row < relation->map.num_constraints &&
+           verifier->terms.num_terms < budget) {
+        if (linear_relation_append_row_check(relation, verifier->next_row, verifier->commitment,
+                                             verifier->challenge, verifier->response,
+                                             &verifier->terms) != 0) {
+            return -1;
+        }
+        verifier->next_row++;
+    }
+    return 0;
+}
+
+csigma_verify_status_t
+csigma_verifier_step(csigma_verifier_t* verifier, size_t budget)
+{
+    if (verifier->status != CSIGMA_VERIFY_PENDING)
+        return verifier->status;
+    if (budget == 0)
+        budget = 1;
+
+    msm_t* terms = &verifier->terms;
+    while (budget > 0) {
+        if (verifier->next_term == terms->num_terms) {
+            if (verifier->next_row == verifier->relation->map.num_constraints)
+                break;
+            if (refill(verifier, budget) != 0) {
+                verifier->status = CSIGMA_VERIFY_INVALID;
+                return verifier->status;
+            }
+            continue;
+        }
+
+        // Evaluate the next slice of terms and add it to the running sum
+        size_t  n = terms->num_terms - verifier->next_term;
+        uint8_t partial[CSIGMA_POINT_BYTES];
+        if (n > budget)
+            n = budget;
+        if (csigma_msm(partial, &terms->scalars[verifier->next_term * CSIGMA_SCALAR_BYTES],
+                       &terms->points[verifier->next_term * CSIGMA_POINT_BYTES], n) != 0) {
+            verifier->status = CSIGMA_VERIFY_INVALID;
+            return verifier->status;
+        }
+        if (!sodium_is_zero(partial, CSIGMA_POINT_BYTES)) {
+            if (!verifier->has_sum) {
+                memcpy(verifier->sum, partial, CSIGMA_POINT_BYTES);
+                verifier->has_sum = true;
+            } else {
+                if (crypto_core_ristretto255_add(verifier->sum, verifier->sum, partial) != 0) {
+                    verifier->status = CSIGMA_VERIFY_INVALID;
+                    return verifier->status;
+                }
+                verifier->has_sum = !sodium_is_zero(verifier->sum, CSIGMA_POINT_BYTES);
+            }
+        }
+        verifier->next_term += n;
+        budget -= n;
+    }
+
+    if (verifier->next_term == terms->num_terms &&
+        verifier->next_row == verifier->relation->map.num_constraints) {
+        verifier->status = sodium_is_zero(verifier->sum, CSIGMA_POINT_BYTES) ?
+                               CSIGMA_VERIFY_VALID :
+                               CSIGMA_VERIFY_INVALID;
+    }
+    return verifier->status;
+}
@@ -0,0 +1,52 @@
+#ifndef RESUMABLE_H
+#define RESUMABLE_H
+
+#include "csigma.h"
+#include "linear_relation.h"
+#include "msm.h"
+
+// Resumable verification
+// Verifies a (commitment, challenge, response) transcript in bounded slices, so that an
+// event loop can interleave a large verification with other work. Each call to
+// csigma_verifier_step() evaluates at most budget multi-scalar multiplication terms
+// (one scalar multiplication each, at most) and returns.
+//
+// The verification equations of all rows are combined with random weights, as in batch
+// verification: the result is the same as csigma_verify() except with negligible
+// probability.
+
+typedef enum {
+    CSIGMA_VERIFY_PENDING = 0, // More steps are needed
+    CSIGMA_VERIFY_VALID, // The transcript is valid
+    CSIGMA_VERIFY_INVALID // The transcript is invalid
+} csigma_verify_status_t;
+
+typedef struct {
+    const linear_relation_t* relation;
+    const uint8_t*           commitment;
+    const uint8_t*           response;
+    uint8_t                  challenge[CSIGMA_SCALAR_BYTES];
+    msm_t                    terms; // Terms of the current rows
+    size_t                   next_row; // First row not yet appended to terms
+    size_t                   next_term; // First term not yet evaluated
+    uint8_t                  sum[CSIGMA_POINT_BYTES]; // Sum of the evaluated terms
+    bool                     has_sum; // false while sum is the identity
+    csigma_verify_status_t   status;
+} csigma_verifier_t;
+
+// Start verifying a transcript
+// relation, commitment and response must stay valid until the verifier is destroyed
+// Returns 0 on success, -1 if the relation is malformed (the verifier then reports
+// CSIGMA_VERIFY_INVALID)
+int csigma_verifier_init(csigma_verifier_t* verifier, const linear_relation_t* relation,
+                         const uint8_t* commitment, const uint8_t challenge[CSIGMA_SCALAR_BYTES],
+                         const uint8_t* response);
+
+// Perform up to budget terms of work (at least one)
+// Returns CSIGMA_VERIFY_PENDING until the outcome is known, then the outcome
+csigma_verify_status_t csigma_verifier_step(csigma_verifier_t* verifier, size_t budget);
+
+// Release the verifier
+void csigma_verifier_destroy(csigma_verifier_t* verifier);
+
+#endif
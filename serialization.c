@@ -15,16 +15,13 @@ deserialize_commitment(uint8_t* commitment, const uint8_t* data, size_t data_len
         return -1;
     }
 
-    // Verify each point is valid by attempting to use it
+    // Verify each point is a valid Ristretto255 encoding other than the identity
+    // (decoding only: much cheaper than a scalar multiplication)
     for (size_t i = 0; i < num_elements; i++) {
         const uint8_t* point = &data[i * CSIGMA_POINT_BYTES];
 
-        // Validate by checking if it's a valid Ristretto255 point
-        // Scalar multiplication by 1 will fail for invalid points
-        uint8_t one[CSIGMA_SCALAR_BYTES] = { 1 };
-        uint8_t result[CSIGMA_POINT_BYTES];
-
-        if (crypto_scalarmult_ristretto255(result, one, point) != 0) {
+        if (crypto_core_ristretto255_is_valid_point(point) != 1 ||
+            sodium_is_zero(point, CSIGMA_POINT_BYTES)) {
             return -1;
         }
     }
@@ -0,0 +1,340 @@
+#include "session.h"
+#include "nonce.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Steps that can be offloaded (internal)
+enum { STEP_COMMIT, STEP_VERIFY };
+
+// Terms needed to evaluate and to verify a relation (internal)
+// Verification adds the commitment, the image and the constant of every equation
+static size_t
+relation_terms(const linear_relation_t* relation)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < relation->map.num_constraints; i++) {
+        total += linear_relation_row_check_terms(relation, i);
+    }
+    return total;
+}
+
+// Run a heavy step and return the resulting state (internal)
+static csigma_session_state_t
+run_step(csigma_session_t* session, int step)
+{
+    if (step == STEP_COMMIT) {
+        // Interactive sessions have no transcript to bind the nonces to
+        if (linear_relation_commit_compact(session->relation, session->witness, NULL, 0,
+                                           session->commitment, &session->prover,
+                                           session->nonces, &session->msm) != 0) {
+            return CSIGMA_SESSION_FAILED;
+        }
+        return CSIGMA_SESSION_AWAIT_CHALLENGE;
+    }
+
+    msm_reset(&session->msm);
+    if (linear_relation_append_check(session->relation, session->commitment,
+                                     session->challenge, session->response,
+                                     &session->msm) != 0) {
+        return CSIGMA_SESSION_FAILED;
+    }
+    return msm_is_identity(&session->msm) ? CSIGMA_SESSION_ACCEPTED : CSIGMA_SESSION_REJECTED;
+}
+
+static void*
+worker_main(void* arg)
+{
+    csigma_session_pool_t* pool = arg;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (pool->queue_len == 0 && !pool->stopping) {
+            pthread_cond_wait(&pool->wakeup, &pool->lock);
+        }
+        if (pool->queue_len == 0) {
+            break;
+        }
+        csigma_session_t* session = pool->queue[pool->queue_head];
+        pool->queue_head          = (pool->queue_head + 1) % pool->max_sessions;
+        pool->queue_len--;
+        pthread_mutex_unlock(&pool->lock);
+
+        // The session stays BUSY until the callback returns, so that it cannot be closed
+        // and reopened under the callback
+        csigma_session_state_t state = run_step(session, session->step);
+        if (pool->on_complete) {
+            pool->on_complete(session, state, pool->arg);
+        }
+        atomic_store(&session->state, state);
+
+        pthread_mutex_lock(&pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+int
+csigma_session_pool_init(csigma_session_pool_t* pool, const linear_relation_t* shape,
+                         size_t max_sessions, size_t num_workers,
+                         csigma_session_callback_t on_complete, void* arg)
+{
+    memset(pool, 0, sizeof(*pool));
+    if (!shape || max_sessions == 0)
+        return -1;
+
+    pool->max_sessions    = max_sessions;
+    pool->max_scalars     = shape->map.num_scalars;
+    pool->max_constraints = shape->map.num_constraints;
+    pool->max_terms       = relation_terms(shape);
+    pool->on_complete     = on_complete;
+    pool->arg             = arg;
+
+    // One slab for the sessions, one for their buffers
+    size_t stride =
+        pool->max_constraints * CSIGMA_POINT_BYTES + 2 * pool->max_scalars * CSIGMA_SCALAR_BYTES;
+    pool->sessions  = calloc(max_sessions, sizeof(csigma_session_t));
+    pool->buffers   = malloc(max_sessions * stride + 1);
+    pool->free_list = malloc(max_sessions * sizeof(size_t));
+    pool->queue     = malloc(max_sessions * sizeof(csigma_session_t*));
+    pool->workers   = malloc((num_workers + 1) * sizeof(pthread_t));
+    if (!pool->sessions || !pool->buffers || !pool->free_list || !pool->queue ||
+        !pool->workers) {
+        free(pool->sessions);
+        free(pool->buffers);
+        free(pool->free_list);
+        free(pool->queue);
+        free(pool->workers);
+        memset(pool, 0, sizeof(*pool));
+        return -1;
+    }
+
+    for (size_t i = 0; i < max_sessions; i++) {
+        csigma_session_t* session = &pool->sessions[i];
+        uint8_t*          buffer  = &pool->buffers[i * stride];
+        atomic_init(&session->state, CSIGMA_SESSION_FREE);
+        session->commitment = buffer;
+        session->response   = &buffer[pool->max_constraints * CSIGMA_POINT_BYTES];
+        session->nonces     = &session->response[pool->max_scalars * CSIGMA_SCALAR_BYTES];
+        session->pool       = pool;
+        msm_init(&session->msm);
+        pool->free_list[max_sessions - 1 - i] = i;
+    }
+    pool->num_free = max_sessions;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wakeup, NULL);
+
+    for (size_t i = 0; i < max_sessions; i++) {
+        if (msm_reserve(&pool->sessions[i].msm, pool->max_terms) != 0) {
+            csigma_session_pool_destroy(pool);
+            return -1;
+        }
+    }
+
+    // Offloaded steps run inline if no worker could be started
+    for (size_t i = 0; i < num_workers; i++) {
+        if (pthread_create(&pool->workers[pool->num_workers], NULL, worker_main, pool) != 0) {
+            break;
+        }
+        pool->num_workers++;
+    }
+    return 0;
+}
+
+void
+csigma_session_pool_destroy(csigma_session_pool_t* pool)
+{
+    if (!pool->sessions)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->wakeup);
+    pthread_mutex_unlock(&pool->lock);
+    for (size_t i = 0; i < pool->num_workers; i++) {
+        pthread_join(pool->workers[i], NULL);
+    }
+
+    size_t stride =
+        pool->max_constraints * CSIGMA_POINT_BYTES + 2 * pool->max_scalars * CSIGMA_SCALAR_BYTES;
+    for (size_t i = 0; i < pool->max_sessions; i++) {
+        csigma_prover_state_destroy(&pool->sessions[i].prover);
+        msm_destroy(&pool->sessions[i].msm);
+    }
+    sodium_memzero(pool->buffers, pool->max_sessions * stride);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wakeup);
+    free(pool->sessions);
+    free(pool->buffers);
+    free(pool->free_list);
+    free(pool->queue);
+    free(pool->workers);
+    memset(pool, 0, sizeof(*pool));
+}
+
+// Take a free session for a relation that fits the pool (internal)
+static csigma_session_t*
+session_open(csigma_session_pool_t* pool, const linear_relation_t* relation,
+             csigma_session_state_t state)
+{
+    if (!relation || relation->map.num_scalars > pool->max_scalars ||
+        relation->map.num_constraints > pool->max_constraints ||
+        relation_terms(relation) > pool->max_terms || linear_relation_validate(relation) != 0)
+        return NULL;
+
+    pthread_mutex_lock(&pool->lock);
+    csigma_session_t* session = NULL;
+    if (pool->num_free > 0) {
+        session = &pool->sessions[pool->free_list[--pool->num_free]];
+    }
+    pthread_mutex_unlock(&pool->lock);
+    if (!session)
+        return NULL;
+
+    session->relation           = relation;
+    session->witness            = NULL;
+    session->user_data          = NULL;
+    session->prover.witness     = NULL;
+    session->prover.nonces      = NULL;
+    session->prover.witness_ref = NULL;
+    session->prover.num_scalars = 0;
+    atomic_store(&session->state, state);
+    return session;
+}
+
+csigma_session_t*
+csigma_session_open_prover(csigma_session_pool_t* pool, const linear_relation_t* relation,
+                           const uint8_t* witness)
+{
+    if (!witness)
+        return NULL;
+
+    csigma_session_t* session = session_open(pool, relation, CSIGMA_SESSION_COMMIT);
+    if (session) {
+        session->witness = witness;
+    }
+    return session;
+}
+
+csigma_session_t*
+csigma_session_open_verifier(csigma_session_pool_t* pool, const linear_relation_t* relation)
+{
+    return session_open(pool, relation, CSIGMA_SESSION_AWAIT_COMMITMENT);
+}
+
+int
+csigma_session_close(csigma_session_t* session)
+{
+    csigma_session_pool_t* pool  = session->pool;
+    int                    state = atomic_load(&session->state);
+    if (state == CSIGMA_SESSION_FREE || state == CSIGMA_SESSION_BUSY)
+        return -1;
+
+    csigma_prover_state_destroy(&session->prover);
+    session->witness  = NULL;
+    session->relation = NULL;
+    atomic_store(&session->state, CSIGMA_SESSION_FREE);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->free_list[pool->num_free++] = (size_t) (session - pool->sessions);
+    pthread_mutex_unlock(&pool->lock);
+    return 0;
+}
+
+csigma_session_state_t
+csigma_session_state(const csigma_session_t* session)
+{
+    return (csigma_session_state_t) atomic_load(&session->state);
+}
+
+// Move from the expected state to BUSY, so that a step runs at most once (internal)
+static bool
+session_acquire(csigma_session_t* session, csigma_session_state_t expected)
+{
+    int state = expected;
+    return atomic_compare_exchange_strong(&session->state, &state, CSIGMA_SESSION_BUSY);
+}
+
+// Run a heavy step inline or queue it for a worker (internal)
+static int
+session_dispatch(csigma_session_t* session, int step, bool offload)
+{
+    csigma_session_pool_t* pool = session->pool;
+
+    if (offload && pool->num_workers > 0) {
+        session->step = step;
+        pthread_mutex_lock(&pool->lock);
+        pool->queue[(pool->queue_head + pool->queue_len) % pool->max_sessions] = session;
+        pool->queue_len++;
+        pthread_cond_signal(&pool->wakeup);
+        pthread_mutex_unlock(&pool->lock);
+        return 0;
+    }
+
+    csigma_session_state_t state = run_step(session, step);
+    atomic_store(&session->state, state);
+    return state == CSIGMA_SESSION_FAILED ? -1 : 0;
+}
+
+int
+csigma_session_commit(csigma_session_t* session, bool offload)
+{
+    if (!session_acquire(session, CSIGMA_SESSION_COMMIT))
+        return -1;
+    return session_dispatch(session, STEP_COMMIT, offload);
+}
+
+int
+csigma_session_respond(csigma_session_t* session, const uint8_t challenge[CSIGMA_SCALAR_BYTES])
+{
+    if (!session_acquire(session, CSIGMA_SESSION_AWAIT_CHALLENGE))
+        return -1;
+
+    // The state is dropped with the response: a second challenge cannot be answered
+    csigma_prover_response(&session->prover, challenge, session->response);
+    csigma_prover_state_destroy(&session->prover);
+    atomic_store(&session->state, CSIGMA_SESSION_RESPONDED);
+    return 0;
+}
+
+int
+csigma_session_receive_commitment(csigma_session_t* session, const uint8_t* commitment)
+{
+    if (!session_acquire(session, CSIGMA_SESSION_AWAIT_COMMITMENT))
+        return -1;
+
+    uint8_t wide[64];
+    memcpy(session->commitment, commitment,
+           session->relation->map.num_constraints * CSIGMA_POINT_BYTES);
+    csigma_random_bytes(wide, sizeof(wide));
+    crypto_core_ristretto255_scalar_reduce(session->challenge, wide);
+    atomic_store(&session->state, CSIGMA_SESSION_AWAIT_RESPONSE);
+    return 0;
+}
+
+int
+csigma_session_verify(csigma_session_t* session, const uint8_t* response, bool offload)
+{
+    if (!session_acquire(session, CSIGMA_SESSION_AWAIT_RESPONSE))
+        return -1;
+
+    memcpy(session->response, response, session->relation->map.num_scalars * CSIGMA_SCALAR_BYTES);
+    return session_dispatch(session, STEP_VERIFY, offload);
+}
+
+const uint8_t*
+csigma_session_commitment(const csigma_session_t* session)
+{
+    return session->commitment;
+}
+
+const uint8_t*
+csigma_session_challenge(const csigma_session_t* session)
+{
+    return session->challenge;
+}
+
+const uint8_t*
+csigma_session_response(const csigma_session_t* session)
+{
+    return session->response;
+}
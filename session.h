@@ -0,0 +1,150 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include "csigma.h"
+#include "linear_relation.h"
+#include "msm.h"
+#include <pthread.h>
+#include <stdatomic.h>
+
+// Interactive session engine
+// Runs many interactive proofs at once, for servers that identify large numbers of
+// clients from a few event-loop threads. Sessions come from a pool created once: their
+// states and buffers are slab-allocated up front and reused, so that no step allocates
+// memory (except when committing to a relation optimized with csigma_relation_optimize(),
+// whose evaluation plan uses a temporary buffer).
+//
+// Each session follows an explicit state machine:
+//
+//   prover:   COMMIT --commit--> AWAIT_CHALLENGE --respond--> RESPONDED
+//   verifier: AWAIT_COMMITMENT --receive_commitment--> AWAIT_RESPONSE --verify--> ACCEPTED
+//                                                                            or REJECTED
+//
+// Step functions never block. The heavy steps (commit and verify) can be offloaded to the
+// pool's worker threads: the pool's callback runs on the worker thread once the step
+// completes, and the session is BUSY until the callback has returned. A prover session
+// answers a single challenge, since two responses to the same commitment reveal the
+// witness.
+
+typedef enum {
+    CSIGMA_SESSION_FREE = 0, // Not in use
+    CSIGMA_SESSION_COMMIT, // Prover: waiting for csigma_session_commit()
+    CSIGMA_SESSION_AWAIT_CHALLENGE, // Prover: commitment ready, waiting for the challenge
+    CSIGMA_SESSION_RESPONDED, // Prover: response ready
+    CSIGMA_SESSION_AWAIT_COMMITMENT, // Verifier: waiting for the prover's commitment
+    CSIGMA_SESSION_AWAIT_RESPONSE, // Verifier: challenge ready, waiting for the response
+    CSIGMA_SESSION_ACCEPTED, // Verifier: the response is valid
+    CSIGMA_SESSION_REJECTED, // Verifier: the response is invalid
+    CSIGMA_SESSION_BUSY, // A step is running on a worker thread
+    CSIGMA_SESSION_FAILED // A step failed (invalid relation or points)
+} csigma_session_state_t;
+
+struct csigma_session_pool;
+
+// Session (allocated by the pool)
+typedef struct {
+    atomic_int                  state; // csigma_session_state_t
+    int                         step; // Step offloaded to a worker (internal)
+    const linear_relation_t*    relation;
+    const uint8_t*              witness; // Caller-owned witness (prover sessions)
+    prover_state_t              prover; // Compact prover state
+    uint8_t*                    commitment; // num_constraints 32-byte points
+    uint8_t*                    response; // num_scalars 32-byte scalars
+    uint8_t*                    nonces; // Commit scratch space (internal)
+    uint8_t                     challenge[CSIGMA_SCALAR_BYTES];
+    msm_t                       msm; // Preallocated term buffer (internal)
+    struct csigma_session_pool* pool;
+    void*                       user_data; // Free for the application
+} csigma_session_t;
+
+// Called on a worker thread when an offloaded step has completed
+// state: the state the session enters once the callback returns
+typedef void (*csigma_session_callback_t)(csigma_session_t* session,
+                                          csigma_session_state_t state, void* arg);
+
+typedef struct csigma_session_pool {
+    csigma_session_t*         sessions; // Slab of max_sessions sessions
+    uint8_t*                  buffers; // Slab of session buffers
+    size_t                    max_sessions;
+    size_t                    max_scalars;
+    size_t                    max_constraints;
+    size_t                    max_terms; // Terms of the largest verification equation
+    size_t*                   free_list; // Stack of free session indices
+    size_t                    num_free;
+    csigma_session_t**        queue; // Ring of sessions waiting for a worker
+    size_t                    queue_head;
+    size_t                    queue_len;
+    pthread_mutex_t           lock;
+    pthread_cond_t            wakeup;
+    pthread_t*                workers;
+    size_t                    num_workers;
+    bool                      stopping;
+    csigma_session_callback_t on_complete;
+    void*                     arg;
+} csigma_session_pool_t;
+
+// Create a pool of max_sessions sessions
+// shape: the largest relation the sessions will use; relations with more scalars,
+// equations or terms are refused by csigma_session_open_*()
+// num_workers: threads running offloaded steps (0 runs every step inline)
+// on_complete: optional callback for offloaded steps, called with arg
+// Returns 0 on success, -1 on error
+int csigma_session_pool_init(csigma_session_pool_t* pool, const linear_relation_t* shape,
+                             size_t max_sessions, size_t num_workers,
+                             csigma_session_callback_t on_complete, void* arg);
+
+// Finish the offloaded steps, stop the workers and release the pool
+void csigma_session_pool_destroy(csigma_session_pool_t* pool);
+
+// Start a prover session for relation and witness, which must stay unchanged until the
+// session is closed
+// Returns NULL if the pool is exhausted or the relation does not fit the pool
+csigma_session_t* csigma_session_open_prover(csigma_session_pool_t*   pool,
+                                             const linear_relation_t* relation,
+                                             const uint8_t*           witness);
+
+// Start a verifier session for relation
+// Returns NULL if the pool is exhausted or the relation does not fit the pool
+csigma_session_t* csigma_session_open_verifier(csigma_session_pool_t*   pool,
+                                               const linear_relation_t* relation);
+
+// Return a session to its pool (wiping its secrets)
+// Returns 0 on success, -1 if a step is still running
+int csigma_session_close(csigma_session_t* session);
+
+// Current state of a session (safe to poll from any thread)
+csigma_session_state_t csigma_session_state(const csigma_session_t* session);
+
+// Prover: compute the commitment (COMMIT -> AWAIT_CHALLENGE)
+// offload: run on a worker thread; the session is BUSY until it completes
+// Returns 0 on success or once queued, -1 in the wrong state or if the step failed
+int csigma_session_commit(csigma_session_t* session, bool offload);
+
+// Prover: answer the challenge (AWAIT_CHALLENGE -> RESPONDED)
+// Returns 0 on success, -1 in the wrong state
+int csigma_session_respond(csigma_session_t* session,
+                           const uint8_t     challenge[CSIGMA_SCALAR_BYTES]);
+
+// Verifier: take the prover's commitment and draw a random challenge
+// (AWAIT_COMMITMENT -> AWAIT_RESPONSE)
+// commitment: num_constraints 32-byte points
+// Returns 0 on success, -1 in the wrong state
+int csigma_session_receive_commitment(csigma_session_t* session, const uint8_t* commitment);
+
+// Verifier: check the prover's response (AWAIT_RESPONSE -> ACCEPTED or REJECTED)
+// response: num_scalars 32-byte scalars
+// offload: run on a worker thread; the session is BUSY until it completes
+// Returns 0 once checked or queued (the outcome is the session state), -1 in the wrong
+// state or if the check could not run
+int csigma_session_verify(csigma_session_t* session, const uint8_t* response, bool offload);
+
+// Prover commitment (valid from AWAIT_CHALLENGE, or AWAIT_RESPONSE for verifiers)
+const uint8_t* csigma_session_commitment(const csigma_session_t* session);
+
+// Verifier challenge (valid from AWAIT_RESPONSE)
+const uint8_t* csigma_session_challenge(const csigma_session_t* session);
+
+// Prover response (valid in RESPONDED)
+const uint8_t* csigma_session_response(const csigma_session_t* session);
+
+#endif
@@ -1,30 +1,40 @@
 #include "sigma.h"
-#include "keccak.h"
 #include "linear_relation.h"
+#include "serialization.h"
+#include <stdlib.h>
 #include <string.h>
 
+// Start a proof transcript: protocol name and public inputs (internal)
+// The public inputs are gathered from their buffers into a single transcript message
+static void
+start_transcript(csigma_transcript_t* transcript, const char* protocol_name,
+                 const csigma_iovec_t* public_inputs, size_t num_public_inputs)
+{
+    csigma_transcript_init(transcript, protocol_name);
+    csigma_transcript_absorbv(transcript, public_inputs, num_public_inputs);
+}
+
+// Fiat-Shamir challenge from a started transcript (internal)
+static void
+finish_challenge(uint8_t challenge[CSIGMA_SCALAR_BYTES], csigma_transcript_t* transcript,
+                 const uint8_t* commitment, size_t commitment_len, const uint8_t* message,
+                 size_t message_len)
+{
+    csigma_transcript_absorb(transcript, commitment, commitment_len);
+    csigma_transcript_absorb(transcript, message, message ? message_len : 0);
+    csigma_transcript_challenge(transcript, challenge);
+}
+
 // Fiat-Shamir challenge generation (internal)
 static void
 generate_challenge(uint8_t challenge[CSIGMA_SCALAR_BYTES], const char* protocol_name,
-                   const uint8_t* public_inputs, size_t public_inputs_len,
+                   const csigma_iovec_t* public_inputs, size_t num_public_inputs,
                    const uint8_t* commitment, size_t commitment_len, const uint8_t* message,
                    size_t message_len)
 {
-    shake128_ctx ctx;
-    shake128_init(&ctx);
-    shake128_absorb(&ctx, (const uint8_t*) protocol_name, strlen(protocol_name));
-
-    if (public_inputs && public_inputs_len > 0)
-        shake128_absorb(&ctx, public_inputs, public_inputs_len);
-
-    shake128_absorb(&ctx, commitment, commitment_len);
-
-    if (message && message_len > 0)
-        shake128_absorb(&ctx, message, message_len);
-
-    uint8_t challenge_bytes[64];
-    shake128_squeeze(&ctx, challenge_bytes, 64);
-    crypto_core_ristretto255_scalar_reduce(challenge, challenge_bytes);
+    csigma_transcript_t transcript;
+    start_transcript(&transcript, protocol_name, public_inputs, num_public_inputs);
+    finish_challenge(challenge, &transcript, commitment, commitment_len, message, message_len);
 }
 
 // Build Schnorr relation: Y = x*G (internal)
@@ -77,16 +87,16 @@ build_dleq_relation(linear_relation_t* relation, const uint8_t g1[CSIGMA_POINT_B
     memcpy(&relation->image[CSIGMA_POINT_BYTES], h2, CSIGMA_POINT_BYTES);
 }
 
-// Pack DLEQ public inputs (internal)
+// DLEQ public inputs, in place (internal)
 static void
-pack_dleq_inputs(uint8_t out[4 * CSIGMA_POINT_BYTES], const uint8_t g1[CSIGMA_POINT_BYTES],
-                 const uint8_t h1[CSIGMA_POINT_BYTES], const uint8_t g2[CSIGMA_POINT_BYTES],
-                 const uint8_t h2[CSIGMA_POINT_BYTES])
+dleq_iovecs(csigma_iovec_t out[4], const uint8_t g1[CSIGMA_POINT_BYTES],
+            const uint8_t h1[CSIGMA_POINT_BYTES], const uint8_t g2[CSIGMA_POINT_BYTES],
+            const uint8_t h2[CSIGMA_POINT_BYTES])
 {
-    memcpy(&out[0], g1, CSIGMA_POINT_BYTES);
-    memcpy(&out[CSIGMA_POINT_BYTES], h1, CSIGMA_POINT_BYTES);
-    memcpy(&out[2 * CSIGMA_POINT_BYTES], g2, CSIGMA_POINT_BYTES);
-    memcpy(&out[3 * CSIGMA_POINT_BYTES], h2, CSIGMA_POINT_BYTES);
+    out[0] = (csigma_iovec_t) { g1, CSIGMA_POINT_BYTES };
+    out[1] = (csigma_iovec_t) { h1, CSIGMA_POINT_BYTES };
+    out[2] = (csigma_iovec_t) { g2, CSIGMA_POINT_BYTES };
+    out[3] = (csigma_iovec_t) { h2, CSIGMA_POINT_BYTES };
 }
 
 int
@@ -101,16 +111,22 @@ csigma_schnorr_prove(uint8_t       proof[CSIGMA_SCHNORR_PROOF_SIZE],
     linear_relation_t relation;
     build_schnorr_relation(&relation, public_key);
 
+    csigma_iovec_t      inputs = { public_key, CSIGMA_POINT_BYTES };
+    csigma_transcript_t transcript;
+    uint8_t             context[CSIGMA_NONCE_CONTEXT_BYTES];
+    start_transcript(&transcript, "schnorr", &inputs, 1);
+    csigma_transcript_nonce_context(&transcript, message, message_len, context);
+
     prover_state_t state;
     uint8_t        commitment[CSIGMA_POINT_BYTES];
-    if (csigma_prover_commit(&relation, witness, commitment, &state) != 0) {
+    if (csigma_prover_commit_with_context(&relation, witness, context, sizeof(context), commitment,
+                                          &state) != 0) {
         csigma_relation_destroy(&relation);
         return -1;
     }
 
     uint8_t challenge[CSIGMA_SCALAR_BYTES];
-    generate_challenge(challenge, "schnorr", public_key, CSIGMA_POINT_BYTES, commitment,
-                       CSIGMA_POINT_BYTES, message, message_len);
+    finish_challenge(challenge, &transcript, commitment, CSIGMA_POINT_BYTES, message, message_len);
 
     csigma_prover_response(&state, challenge, &proof[CSIGMA_POINT_BYTES]);
     memcpy(proof, commitment, CSIGMA_POINT_BYTES);
@@ -131,40 +147,44 @@ csigma_schnorr_verify(const uint8_t proof[CSIGMA_SCHNORR_PROOF_SIZE],
     linear_relation_t relation;
     build_schnorr_relation(&relation, public_key);
 
-    uint8_t challenge[CSIGMA_SCALAR_BYTES];
-    generate_challenge(challenge, "schnorr", public_key, CSIGMA_POINT_BYTES, proof,
-                       CSIGMA_POINT_BYTES, message, message_len);
+    csigma_iovec_t inputs = { public_key, CSIGMA_POINT_BYTES };
+    uint8_t        challenge[CSIGMA_SCALAR_BYTES];
+    generate_challenge(challenge, "schnorr", &inputs, 1, proof, CSIGMA_POINT_BYTES, message,
+                       message_len);
 
     bool valid = csigma_verify(&relation, proof, challenge, &proof[CSIGMA_POINT_BYTES]);
     csigma_relation_destroy(&relation);
     return valid;
 }
 
-int
-csigma_dleq_prove(uint8_t proof[CSIGMA_DLEQ_PROOF_SIZE], const uint8_t witness[CSIGMA_SCALAR_BYTES],
-                  const uint8_t g1[CSIGMA_POINT_BYTES], const uint8_t h1[CSIGMA_POINT_BYTES],
-                  const uint8_t g2[CSIGMA_POINT_BYTES], const uint8_t h2[CSIGMA_POINT_BYTES],
-                  const uint8_t* message, size_t message_len)
+// DLEQ prover and verifier under a protocol name (internal)
+static int
+dleq_prove(uint8_t proof[CSIGMA_DLEQ_PROOF_SIZE], const char* protocol_name,
+           const uint8_t witness[CSIGMA_SCALAR_BYTES], const uint8_t g1[CSIGMA_POINT_BYTES],
+           const uint8_t h1[CSIGMA_POINT_BYTES], const uint8_t g2[CSIGMA_POINT_BYTES],
+           const uint8_t h2[CSIGMA_POINT_BYTES], const uint8_t* message, size_t message_len)
 {
-    if (!proof || !witness || !g1 || !h1 || !g2 || !h2)
-        return -1;
-
     linear_relation_t relation;
     build_dleq_relation(&relation, g1, h1, g2, h2);
 
+    csigma_iovec_t      public_inputs[4];
+    csigma_transcript_t transcript;
+    uint8_t             context[CSIGMA_NONCE_CONTEXT_BYTES];
+    dleq_iovecs(public_inputs, g1, h1, g2, h2);
+    start_transcript(&transcript, protocol_name, public_inputs, 4);
+    csigma_transcript_nonce_context(&transcript, message, message_len, context);
+
     prover_state_t state;
     uint8_t        commitment[2 * CSIGMA_POINT_BYTES];
-    if (csigma_prover_commit(&relation, witness, commitment, &state) != 0) {
+    if (csigma_prover_commit_with_context(&relation, witness, context, sizeof(context), commitment,
+                                          &state) != 0) {
         csigma_relation_destroy(&relation);
         return -1;
     }
 
-    uint8_t public_inputs[4 * CSIGMA_POINT_BYTES];
-    pack_dleq_inputs(public_inputs, g1, h1, g2, h2);
-
     uint8_t challenge[CSIGMA_SCALAR_BYTES];
-    generate_challenge(challenge, "dleq", public_inputs, sizeof(public_inputs), commitment,
-                       2 * CSIGMA_POINT_BYTES, message, message_len);
+    finish_challenge(challenge, &transcript, commitment, 2 * CSIGMA_POINT_BYTES, message,
+                     message_len);
 
     csigma_prover_response(&state, challenge, &proof[2 * CSIGMA_POINT_BYTES]);
     memcpy(proof, commitment, 2 * CSIGMA_POINT_BYTES);
@@ -174,6 +194,39 @@ csigma_dleq_prove(uint8_t proof[CSIGMA_DLEQ_PROOF_SIZE], const uint8_t witness[C
     return 0;
 }
 
+static bool
+dleq_verify(const uint8_t proof[CSIGMA_DLEQ_PROOF_SIZE], const char* protocol_name,
+            const uint8_t g1[CSIGMA_POINT_BYTES], const uint8_t h1[CSIGMA_POINT_BYTES],
+            const uint8_t g2[CSIGMA_POINT_BYTES], const uint8_t h2[CSIGMA_POINT_BYTES],
+            const uint8_t* message, size_t message_len)
+{
+    linear_relation_t relation;
+    build_dleq_relation(&relation, g1, h1, g2, h2);
+
+    csigma_iovec_t public_inputs[4];
+    dleq_iovecs(public_inputs, g1, h1, g2, h2);
+
+    uint8_t challenge[CSIGMA_SCALAR_BYTES];
+    generate_challenge(challenge, protocol_name, public_inputs, 4, proof, 2 * CSIGMA_POINT_BYTES,
+                       message, message_len);
+
+    bool valid = csigma_verify(&relation, proof, challenge, &proof[2 * CSIGMA_POINT_BYTES]);
+    csigma_relation_destroy(&relation);
+    return valid;
+}
+
+int
+csigma_dleq_prove(uint8_t proof[CSIGMA_DLEQ_PROOF_SIZE], const uint8_t witness[CSIGMA_SCALAR_BYTES],
+                  const uint8_t g1[CSIGMA_POINT_BYTES], const uint8_t h1[CSIGMA_POINT_BYTES],
+                  const uint8_t g2[CSIGMA_POINT_BYTES], const uint8_t h2[CSIGMA_POINT_BYTES],
+                  const uint8_t* message, size_t message_len)
+{
+    if (!proof || !witness || !g1 || !h1 || !g2 || !h2)
+        return -1;
+
+    return dleq_prove(proof, "dleq", witness, g1, h1, g2, h2, message, message_len);
+}
+
 bool
 csigma_dleq_verify(const uint8_t proof[CSIGMA_DLEQ_PROOF_SIZE],
                    const uint8_t g1[CSIGMA_POINT_BYTES], const uint8_t h1[CSIGMA_POINT_BYTES],
@@ -183,17 +236,438 @@ csigma_dleq_verify(const uint8_t proof[CSIGMA_DLEQ_PROOF_SIZE],
     if (!proof || !g1 || !h1 || !g2 || !h2)
         return false;
 
+    return dleq_verify(proof, "dleq", g1, h1, g2, h2, message, message_len);
+}
+
+// ============================================================================
+// Multi-Witness Provers
+// ============================================================================
+
+// Proofs committed at once; bounds the prover states held in memory
+#define PROVE_MANY_CHUNK 64
+
+// Prove k statements of one relation shape (internal)
+// The relation is built once from the first statement; its map only involves the
+// shared bases, so it serves every statement. Per proof, public_inputs() points the
+// buffers absorbed into the challenge at the statement's public inputs, and image()
+// writes the statement's image, from which the proof's nonces are derived.
+#define MAX_PUBLIC_INPUTS 4
+
+typedef size_t (*public_inputs_fn)(csigma_iovec_t out[MAX_PUBLIC_INPUTS], size_t index,
+                                   const void* arg);
+typedef void (*image_fn)(uint8_t* out, size_t index, const void* arg);
+
+static int
+prove_many(uint8_t* proofs, size_t proof_size, const linear_relation_t* relation,
+           const char* protocol_name, const uint8_t* witnesses, size_t k,
+           public_inputs_fn public_inputs, image_fn image, const void* arg,
+           const uint8_t* const* messages, const size_t* message_lens)
+{
+    size_t               num_scalars    = relation->map.num_scalars;
+    size_t               commitment_len = relation->map.num_constraints * CSIGMA_POINT_BYTES;
+    prover_state_t*      states         = malloc(PROVE_MANY_CHUNK * sizeof(prover_state_t));
+    csigma_transcript_t* transcripts    = malloc(PROVE_MANY_CHUNK * sizeof(csigma_transcript_t));
+    uint8_t*             contexts       = malloc(PROVE_MANY_CHUNK * CSIGMA_NONCE_CONTEXT_BYTES);
+    uint8_t*             images         = malloc(PROVE_MANY_CHUNK * commitment_len);
+    int                  ret            = -1;
+    if (!states || !transcripts || !contexts || !images)
+        goto done;
+
+    ret = 0;
+    for (size_t first = 0; first < k && ret == 0; first += PROVE_MANY_CHUNK) {
+        size_t         count   = k - first < PROVE_MANY_CHUNK ? k - first : PROVE_MANY_CHUNK;
+        const uint8_t* witness = &witnesses[first * num_scalars * CSIGMA_SCALAR_BYTES];
+
+        uint8_t* commitments = malloc(count * commitment_len);
+        if (!commitments) {
+            ret = -1;
+            break;
+        }
+
+        // Each proof's nonces are bound to its own image and transcript prefix
+        for (size_t j = 0; j < count; j++) {
+            size_t         index   = first + j;
+            const uint8_t* message = messages ? messages[index] : NULL;
+            size_t         len     = messages ? message_lens[index] : 0;
+
+            csigma_iovec_t inputs[MAX_PUBLIC_INPUTS];
+            size_t         num_inputs = public_inputs(inputs, index, arg);
+            start_transcript(&transcripts[j], protocol_name, inputs, num_inputs);
+            csigma_transcript_nonce_context(&transcripts[j], message, len,
+                                            &contexts[j * CSIGMA_NONCE_CONTEXT_BYTES]);
+            image(&images[j * commitment_len], index, arg);
+        }
+
+        ret = csigma_prover_commit_batch(relation, witness, count, images, contexts,
+                                         CSIGMA_NONCE_CONTEXT_BYTES, commitments, states);
+        for (size_t j = 0; j < count && ret == 0; j++) {
+            size_t         index      = first + j;
+            uint8_t*       proof      = &proofs[index * proof_size];
+            const uint8_t* commitment = &commitments[j * commitment_len];
+            const uint8_t* message    = messages ? messages[index] : NULL;
+            size_t         len        = messages ? message_lens[index] : 0;
+
+            uint8_t challenge[CSIGMA_SCALAR_BYTES];
+            finish_challenge(challenge, &transcripts[j], commitment, commitment_len, message, len);
+            memcpy(proof, commitment, commitment_len);
+            csigma_prover_response(&states[j], challenge, &proof[commitment_len]);
+            csigma_prover_state_destroy(&states[j]);
+        }
+        free(commitments);
+    }
+
+done:
+    free(states);
+    free(transcripts);
+    free(contexts);
+    free(images);
+    return ret;
+}
+
+// Public inputs of the i-th Schnorr statement: its public key (internal)
+static size_t
+schnorr_inputs(csigma_iovec_t out[MAX_PUBLIC_INPUTS], size_t index, const void* arg)
+{
+    const uint8_t* public_keys = arg;
+    out[0] = (csigma_iovec_t) { &public_keys[index * CSIGMA_POINT_BYTES], CSIGMA_POINT_BYTES };
+    return 1;
+}
+
+// Image of the i-th Schnorr statement: its public key (internal)
+static void
+schnorr_image(uint8_t* out, size_t index, const void* arg)
+{
+    const uint8_t* public_keys = arg;
+    memcpy(out, &public_keys[index * CSIGMA_POINT_BYTES], CSIGMA_POINT_BYTES);
+}
+
+int
+csigma_schnorr_prove_many(uint8_t* proofs, const uint8_t* witnesses, const uint8_t* public_keys,
+                          size_t k, const uint8_t* const* messages, const size_t* message_lens)
+{
+    if (k == 0)
+        return 0;
+    if (!proofs || !witnesses || !public_keys || (messages && !message_lens))
+        return -1;
+
     linear_relation_t relation;
-    build_dleq_relation(&relation, g1, h1, g2, h2);
+    build_schnorr_relation(&relation, public_keys);
 
-    uint8_t public_inputs[4 * CSIGMA_POINT_BYTES];
-    pack_dleq_inputs(public_inputs, g1, h1, g2, h2);
+    int ret = prove_many(proofs, CSIGMA_SCHNORR_PROOF_SIZE, &relation, "schnorr", witnesses, k,
+                         schnorr_inputs, schnorr_image, public_keys, messages, message_lens);
+    csigma_relation_destroy(&relation);
+    return ret;
+}
 
-    uint8_t challenge[CSIGMA_SCALAR_BYTES];
-    generate_challenge(challenge, "dleq", public_inputs, sizeof(public_inputs), proof,
-                       2 * CSIGMA_POINT_BYTES, message, message_len);
+// Shared bases and per-statement images of DLEQ statements (internal)
+typedef struct {
+    const uint8_t* g1;
+    const uint8_t* h1;
+    const uint8_t* g2;
+    const uint8_t* h2;
+} dleq_many_t;
 
-    bool valid = csigma_verify(&relation, proof, challenge, &proof[2 * CSIGMA_POINT_BYTES]);
+static size_t
+dleq_inputs(csigma_iovec_t out[MAX_PUBLIC_INPUTS], size_t index, const void* arg)
+{
+    const dleq_many_t* statements = arg;
+    dleq_iovecs(out, statements->g1, &statements->h1[index * CSIGMA_POINT_BYTES], statements->g2,
+                &statements->h2[index * CSIGMA_POINT_BYTES]);
+    return 4;
+}
+
+static void
+dleq_image(uint8_t* out, size_t index, const void* arg)
+{
+    const dleq_many_t* statements = arg;
+    memcpy(&out[0], &statements->h1[index * CSIGMA_POINT_BYTES], CSIGMA_POINT_BYTES);
+    memcpy(&out[CSIGMA_POINT_BYTES], &statements->h2[index * CSIGMA_POINT_BYTES],
+           CSIGMA_POINT_BYTES);
+}
+
+int
+csigma_dleq_prove_many(uint8_t* proofs, const uint8_t* witnesses,
+                       const uint8_t g1[CSIGMA_POINT_BYTES], const uint8_t* h1,
+                       const uint8_t g2[CSIGMA_POINT_BYTES], const uint8_t* h2, size_t k,
+                       const uint8_t* const* messages, const size_t* message_lens)
+{
+    if (k == 0)
+        return 0;
+    if (!proofs || !witnesses || !g1 || !h1 || !g2 || !h2 || (messages && !message_lens))
+        return -1;
+
+    linear_relation_t relation;
+    build_dleq_relation(&relation, g1, h1, g2, h2);
+
+    dleq_many_t statements = { g1, h1, g2, h2 };
+    int         ret = prove_many(proofs, CSIGMA_DLEQ_PROOF_SIZE, &relation, "dleq", witnesses, k,
+                                 dleq_inputs, dleq_image, &statements, messages, message_lens);
     csigma_relation_destroy(&relation);
+    return ret;
+}
+
+// ============================================================================
+// Batched DLEQ
+// ============================================================================
+
+// Random linear combination coefficients over the key and every pair (internal)
+// A single squeeze yields 64 bytes per coefficient
+static int
+batch_coefficients(uint8_t* coefficients, const uint8_t g[CSIGMA_POINT_BYTES],
+                   const uint8_t h[CSIGMA_POINT_BYTES], const uint8_t* g_batch,
+                   const uint8_t* h_batch, size_t n)
+{
+    uint8_t* wide = malloc(n * 64);
+    if (!wide)
+        return -1;
+
+    csigma_transcript_t transcript;
+    csigma_transcript_init(&transcript, "dleq_batch_coefficients");
+    csigma_transcript_absorb(&transcript, g, CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb(&transcript, h, CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb_u64(&transcript, n);
+    csigma_transcript_absorb(&transcript, g_batch, n * CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb(&transcript, h_batch, n * CSIGMA_POINT_BYTES);
+    csigma_transcript_squeeze(&transcript, wide, n * 64);
+
+    for (size_t i = 0; i < n; i++) {
+        crypto_core_ristretto255_scalar_reduce(&coefficients[i * CSIGMA_SCALAR_BYTES],
+                                               &wide[i * 64]);
+    }
+    free(wide);
+    return 0;
+}
+
+int
+csigma_dleq_batch_prove(uint8_t proof[CSIGMA_DLEQ_PROOF_SIZE],
+                        const uint8_t witness[CSIGMA_SCALAR_BYTES],
+                        const uint8_t g[CSIGMA_POINT_BYTES], const uint8_t h[CSIGMA_POINT_BYTES],
+                        const uint8_t* g_batch, const uint8_t* h_batch, size_t n,
+                        const uint8_t* message, size_t message_len)
+{
+    if (!proof || !witness || !g || !h || !g_batch || !h_batch || n == 0)
+        return -1;
+
+    uint8_t* coefficients = malloc(n * CSIGMA_SCALAR_BYTES);
+    if (!coefficients)
+        return -1;
+    if (batch_coefficients(coefficients, g, h, g_batch, h_batch, n) != 0) {
+        free(coefficients);
+        return -1;
+    }
+
+    // M = sum of d_i*g_i; the prover knows Z = sum of d_i*h_i = x*M
+    uint8_t M[CSIGMA_POINT_BYTES], Z[CSIGMA_POINT_BYTES];
+    int     ret = -1;
+    if (csigma_msm(M, coefficients, g_batch, n) == 0 && csigma_scalarmult(Z, witness, M) == 0)
+        ret = dleq_prove(proof, "dleq_batch", witness, g, h, M, Z, message, message_len);
+
+    free(coefficients);
+    return ret;
+}
+
+bool
+csigma_dleq_batch_verify(const uint8_t proof[CSIGMA_DLEQ_PROOF_SIZE],
+                         const uint8_t g[CSIGMA_POINT_BYTES], const uint8_t h[CSIGMA_POINT_BYTES],
+                         const uint8_t* g_batch, const uint8_t* h_batch, size_t n,
+                         const uint8_t* message, size_t message_len)
+{
+    if (!proof || !g || !h || !g_batch || !h_batch || n == 0)
+        return false;
+
+    uint8_t* coefficients = malloc(n * CSIGMA_SCALAR_BYTES);
+    if (!coefficients)
+        return false;
+    if (batch_coefficients(coefficients, g, h, g_batch, h_batch, n) != 0) {
+        free(coefficients);
+        return false;
+    }
+
+    // M = sum of d_i*g_i, Z = sum of d_i*h_i
+    uint8_t M[CSIGMA_POINT_BYTES], Z[CSIGMA_POINT_BYTES];
+    bool    valid = false;
+    if (csigma_msm(M, coefficients, g_batch, n) == 0 &&
+        csigma_msm(Z, coefficients, h_batch, n) == 0)
+        valid = dleq_verify(proof, "dleq_batch", g, h, M, Z, message, message_len);
+
+    free(coefficients);
+    return valid;
+}
+
+// ============================================================================
+// Schnorr Half-Aggregation
+// ============================================================================
+
+// Initial capacity for the commitment array
+#define INITIAL_AGGREGATE_CAPACITY 16
+
+void
+csigma_schnorr_aggregate_init(csigma_schnorr_aggregate_t* aggregate)
+{
+    csigma_transcript_init(&aggregate->transcript, "schnorr_halfagg");
+    memset(aggregate->response, 0, CSIGMA_SCALAR_BYTES);
+    aggregate->commitments = NULL;
+    aggregate->num_proofs  = 0;
+    aggregate->capacity    = 0;
+}
+
+void
+csigma_schnorr_aggregate_destroy(csigma_schnorr_aggregate_t* aggregate)
+{
+    free(aggregate->commitments);
+    csigma_schnorr_aggregate_init(aggregate);
+}
+
+// Absorb proof i into the randomizer transcript and derive z_i (internal)
+// z_i depends on the keys, commitments and messages of proofs 1..i only
+static void
+next_randomizer(uint8_t z[CSIGMA_SCALAR_BYTES], csigma_transcript_t* transcript,
+                const uint8_t public_key[CSIGMA_POINT_BYTES],
+                const uint8_t commitment[CSIGMA_POINT_BYTES], const uint8_t* message,
+                size_t message_len)
+{
+    csigma_transcript_absorb(transcript, public_key, CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb(transcript, commitment, CSIGMA_POINT_BYTES);
+    csigma_transcript_absorb(transcript, message, message ? message_len : 0);
+
+    // The transcript keeps absorbing later proofs after the squeeze
+    csigma_transcript_challenge(transcript, z);
+}
+
+// Append a commitment to the aggregate (internal)
+static int
+append_commitment(csigma_schnorr_aggregate_t* aggregate,
+                  const uint8_t               commitment[CSIGMA_POINT_BYTES])
+{
+    if (aggregate->num_proofs >= aggregate->capacity) {
+        size_t capacity =
+            aggregate->capacity ? aggregate->capacity * 2 : INITIAL_AGGREGATE_CAPACITY;
+        uint8_t* commitments = realloc(aggregate->commitments, capacity * CSIGMA_POINT_BYTES);
+        if (!commitments)
+            return -1;
+        aggregate->commitments = commitments;
+        aggregate->capacity    = capacity;
+    }
+    memcpy(&aggregate->commitments[aggregate->num_proofs * CSIGMA_POINT_BYTES], commitment,
+           CSIGMA_POINT_BYTES);
+    aggregate->num_proofs++;
+    return 0;
+}
+
+int
+csigma_schnorr_aggregate_add(csigma_schnorr_aggregate_t* aggregate,
+                             const uint8_t               proof[CSIGMA_SCHNORR_PROOF_SIZE],
+                             const uint8_t               public_key[CSIGMA_POINT_BYTES],
+                             const uint8_t* message, size_t message_len)
+{
+    if (!aggregate || !proof || !public_key)
+        return -1;
+
+    // The transcript must not advance if the commitment cannot be stored
+    csigma_transcript_t transcript = aggregate->transcript;
+    uint8_t             z[CSIGMA_SCALAR_BYTES];
+    next_randomizer(z, &transcript, public_key, proof, message, message_len);
+    if (append_commitment(aggregate, proof) != 0)
+        return -1;
+    aggregate->transcript = transcript;
+
+    // s += z_i * s_i
+    uint8_t term[CSIGMA_SCALAR_BYTES];
+    crypto_core_ristretto255_scalar_mul(term, z, &proof[CSIGMA_POINT_BYTES]);
+    crypto_core_ristretto255_scalar_add(aggregate->response, aggregate->response, term);
+    return 0;
+}
+
+int
+csigma_schnorr_aggregate_serialize(uint8_t* output, const csigma_schnorr_aggregate_t* aggregate)
+{
+    if (!output || !aggregate || aggregate->num_proofs == 0)
+        return -1;
+    return csigma_serialize_proof(output, aggregate->commitments, aggregate->num_proofs,
+                                  aggregate->response, 1);
+}
+
+int
+csigma_schnorr_aggregate_load(csigma_schnorr_aggregate_t* aggregate, const uint8_t* data,
+                              size_t data_len, const uint8_t* public_keys,
+                              const uint8_t* const* messages, const size_t* message_lens,
+                              size_t n)
+{
+    if (!aggregate || !data || !public_keys || !messages || !message_lens || n == 0 ||
+        data_len != csigma_schnorr_aggregate_size(n))
+        return -1;
+
+    csigma_schnorr_aggregate_destroy(aggregate);
+    aggregate->commitments = malloc(n * CSIGMA_POINT_BYTES);
+    if (!aggregate->commitments)
+        return -1;
+    aggregate->capacity = n;
+
+    if (csigma_deserialize_proof(aggregate->commitments, n, aggregate->response, 1, data,
+                                 data_len) != 0) {
+        csigma_schnorr_aggregate_destroy(aggregate);
+        return -1;
+    }
+
+    // Replay the randomizer transcript
+    for (size_t i = 0; i < n; i++) {
+        uint8_t z[CSIGMA_SCALAR_BYTES];
+        next_randomizer(z, &aggregate->transcript, &public_keys[i * CSIGMA_POINT_BYTES],
+                        &aggregate->commitments[i * CSIGMA_POINT_BYTES], messages[i],
+                        message_lens[i]);
+    }
+    aggregate->num_proofs = n;
+    return 0;
+}
+
+bool
+csigma_schnorr_aggregate_verify(const uint8_t* data, size_t data_len, const uint8_t* public_keys,
+                                const uint8_t* const* messages, const size_t* message_lens,
+                                size_t n)
+{
+    if (!data || !public_keys || !messages || !message_lens || n == 0 ||
+        data_len != csigma_schnorr_aggregate_size(n))
+        return false;
+
+    const uint8_t* commitments = data;
+    const uint8_t* response    = &data[n * CSIGMA_POINT_BYTES];
+
+    // Check s*G = sum of z_i*(R_i + c_i*Y_i) with one multi-scalar multiplication
+    csigma_transcript_t transcript;
+    csigma_transcript_init(&transcript, "schnorr_halfagg");
+
+    uint8_t generator[CSIGMA_POINT_BYTES];
+    uint8_t one[CSIGMA_SCALAR_BYTES] = { 1 };
+    crypto_scalarmult_ristretto255_base(generator, one);
+
+    msm_t msm;
+    msm_init(&msm);
+    bool valid = msm_add_term(&msm, response, generator) == 0;
+
+    for (size_t i = 0; i < n && valid; i++) {
+        const uint8_t* public_key = &public_keys[i * CSIGMA_POINT_BYTES];
+        const uint8_t* commitment = &commitments[i * CSIGMA_POINT_BYTES];
+        uint8_t        z[CSIGMA_SCALAR_BYTES], c[CSIGMA_SCALAR_BYTES], scalar[CSIGMA_SCALAR_BYTES];
+
+        // Per-proof Schnorr challenge, exactly as in csigma_schnorr_verify()
+        csigma_iovec_t inputs = { public_key, CSIGMA_POINT_BYTES };
+        generate_challenge(c, "schnorr", &inputs, 1, commitment, CSIGMA_POINT_BYTES, messages[i],
+                           message_lens[i]);
+        next_randomizer(z, &transcript, public_key, commitment, messages[i], message_lens[i]);
+
+        // Commitments must not be the identity, as in csigma_deserialize_proof()
+        if (sodium_is_zero(commitment, CSIGMA_POINT_BYTES)) {
+            valid = false;
+            break;
+        }
+
+        crypto_core_ristretto255_scalar_negate(scalar, z);
+        valid = msm_add_term(&msm, scalar, commitment) == 0;
+        crypto_core_ristretto255_scalar_mul(scalar, scalar, c);
+        valid = valid && msm_add_term(&msm, scalar, public_key) == 0;
+    }
+
+    valid = valid && msm_is_identity(&msm);
+    msm_destroy(&msm);
     return valid;
 }
@@ -2,6 +2,7 @@
 #define SIGMA_H
 
 #include "csigma.h"
+#include "transcript.h"
 
 // Simple Sigma protocol API for Schnorr and DLEQ
 // For more complex protocols, use the general linear_relation.h framework
@@ -37,4 +38,105 @@ bool csigma_dleq_verify(const uint8_t proof[CSIGMA_DLEQ_PROOF_SIZE],
                         const uint8_t g2[CSIGMA_POINT_BYTES], const uint8_t h2[CSIGMA_POINT_BYTES],
                         const uint8_t* message, size_t message_len);
 
+// Multi-witness provers: k independent proofs of the same relation shape
+// Produce exactly the proofs csigma_schnorr_prove() and csigma_dleq_prove() would, but
+// build the relation once and commit to every nonce vector in one batch
+// (see csigma_prover_commit_batch())
+// proofs: output array of k proofs
+// witnesses: array of k 32-byte scalars
+// messages, message_lens: one message per proof, or NULL for no messages
+// Returns 0 on success, -1 on error
+
+// Schnorr proofs for k keys: public_keys is an array of k 32-byte points
+int csigma_schnorr_prove_many(uint8_t* proofs, const uint8_t* witnesses,
+                              const uint8_t* public_keys, size_t k,
+                              const uint8_t* const* messages, const size_t* message_lens);
+
+// DLEQ proofs under shared bases g1, g2: h1 and h2 are arrays of k 32-byte points
+int csigma_dleq_prove_many(uint8_t* proofs, const uint8_t* witnesses,
+                           const uint8_t g1[CSIGMA_POINT_BYTES], const uint8_t* h1,
+                           const uint8_t g2[CSIGMA_POINT_BYTES], const uint8_t* h2, size_t k,
+                           const uint8_t* const* messages, const size_t* message_lens);
+
+// Batched DLEQ - one proof for many pairs under one key
+// Proves: I know x such that h = x*g AND h_i = x*g_i for every i
+// The pairs are folded into a single pair (M, Z) = (sum of d_i*g_i, sum of d_i*h_i)
+// with coefficients d_i derived from a hash of the key and every pair, and a single
+// DLEQ proof is made for (g, h, M, Z). The proof is CSIGMA_DLEQ_PROOF_SIZE bytes for
+// any batch size.
+// g_batch, h_batch: arrays of n 32-byte points
+// Returns 0 on success, -1 on error
+int csigma_dleq_batch_prove(uint8_t        proof[CSIGMA_DLEQ_PROOF_SIZE],
+                            const uint8_t  witness[CSIGMA_SCALAR_BYTES], // x
+                            const uint8_t  g[CSIGMA_POINT_BYTES],
+                            const uint8_t  h[CSIGMA_POINT_BYTES], // h = x*g
+                            const uint8_t* g_batch, const uint8_t* h_batch, size_t n,
+                            const uint8_t* message, size_t message_len);
+
+// Verify batched DLEQ proof
+// Returns true if valid, false otherwise
+bool csigma_dleq_batch_verify(const uint8_t  proof[CSIGMA_DLEQ_PROOF_SIZE],
+                              const uint8_t  g[CSIGMA_POINT_BYTES],
+                              const uint8_t  h[CSIGMA_POINT_BYTES], const uint8_t* g_batch,
+                              const uint8_t* h_batch, size_t n, const uint8_t* message,
+                              size_t message_len);
+
+// Schnorr half-aggregation
+// Merges n Schnorr proofs (R_i, s_i) into the n commitments R_i and one scalar
+// s = sum of z_i*s_i, where z_i is derived from a hash of the keys, commitments and
+// messages of proofs 1..i. Since z_i only depends on the proofs added so far, proofs
+// can be appended to an aggregate as they arrive.
+// Serialized layout: R_1 || ... || R_n || s (csigma_schnorr_aggregate_size(n) bytes)
+// An aggregate is valid if and only if every merged proof was valid (with
+// overwhelming probability); adding an invalid proof spoils the aggregate.
+
+// Incremental aggregator
+typedef struct {
+    csigma_transcript_t transcript; // Randomizer transcript over the proofs added so far
+    uint8_t*            commitments; // Commitments R_i (32 bytes each)
+    uint8_t             response[CSIGMA_SCALAR_BYTES]; // Aggregated response s
+    size_t              num_proofs; // Number of proofs merged
+    size_t              capacity; // Allocated capacity
+} csigma_schnorr_aggregate_t;
+
+// Serialized aggregate size in bytes
+static inline size_t
+csigma_schnorr_aggregate_size(size_t num_proofs)
+{
+    return (num_proofs + 1) * CSIGMA_POINT_BYTES;
+}
+
+void csigma_schnorr_aggregate_init(csigma_schnorr_aggregate_t* aggregate);
+void csigma_schnorr_aggregate_destroy(csigma_schnorr_aggregate_t* aggregate);
+
+// Merge one Schnorr proof made with csigma_schnorr_prove()
+// Returns 0 on success, -1 on error
+int csigma_schnorr_aggregate_add(csigma_schnorr_aggregate_t* aggregate,
+                                 const uint8_t               proof[CSIGMA_SCHNORR_PROOF_SIZE],
+                                 const uint8_t               public_key[CSIGMA_POINT_BYTES],
+                                 const uint8_t* message, size_t message_len);
+
+// Serialize the aggregate
+// output: buffer of csigma_schnorr_aggregate_size(num_proofs) bytes
+// Returns 0 on success, -1 on error
+int csigma_schnorr_aggregate_serialize(uint8_t*                          output,
+                                       const csigma_schnorr_aggregate_t* aggregate);
+
+// Resume aggregation from a serialized aggregate of n proofs
+// The keys and messages of the aggregated proofs are needed to replay the transcript
+// (hashing only, no group operation)
+// Returns 0 on success, -1 on error
+int csigma_schnorr_aggregate_load(csigma_schnorr_aggregate_t* aggregate, const uint8_t* data,
+                                  size_t data_len, const uint8_t* public_keys,
+                                  const uint8_t* const* messages, const size_t* message_lens,
+                                  size_t n);
+
+// Verify a serialized aggregate of n proofs with one multi-scalar multiplication
+// public_keys: array of n 32-byte points
+// messages, message_lens: the n messages
+// Returns true if valid, false otherwise
+bool csigma_schnorr_aggregate_verify(const uint8_t* data, size_t data_len,
+                                     const uint8_t* public_keys, const uint8_t* const* messages,
+                                     const size_t* message_lens, size_t n);
+
 #endif
@@ -0,0 +1,124 @@
+#include "../amortized.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Shared DLEQ shape: image = (x*G, x*H) + (0, K)
+static void
+build_shape(linear_relation_t* relation, uint8_t G[CSIGMA_POINT_BYTES],
+            uint8_t H[CSIGMA_POINT_BYTES], uint8_t K[CSIGMA_POINT_BYTES])
+{
+    crypto_core_ristretto255_random(G);
+    crypto_core_ristretto255_random(H);
+    crypto_core_ristretto255_random(K);
+
+    csigma_relation_init(relation);
+    int var_x = csigma_relation_add_scalar(relation);
+    int var_G = csigma_relation_add_element(relation, G);
+    int var_H = csigma_relation_add_element(relation, H);
+    int var_K = csigma_relation_add_element(relation, K);
+    csigma_relation_add_equation_simple(relation, 0, var_x, var_G);
+    csigma_relation_add_equation_simple(relation, 0, var_x, var_H);
+    csigma_relation_set_constant(relation, 1, var_K, NULL);
+}
+
+// Instance j: witness x_j, image (x_j*G, x_j*H + K)
+static void
+make_instance(uint8_t* image, uint8_t* witness, const uint8_t G[CSIGMA_POINT_BYTES],
+              const uint8_t H[CSIGMA_POINT_BYTES], const uint8_t K[CSIGMA_POINT_BYTES])
+{
+    crypto_core_ristretto255_scalar_random(witness);
+    crypto_scalarmult_ristretto255(&image[0], witness, G);
+    crypto_scalarmult_ristretto255(&image[CSIGMA_POINT_BYTES], witness, H);
+    crypto_core_ristretto255_add(&image[CSIGMA_POINT_BYTES], &image[CSIGMA_POINT_BYTES], K);
+}
+
+int
+main()
+{
+    printf("\n=== Testing Amortized Multi-Instance Proofs ===\n");
+
+    if (sodium_init() < 0) {
+        printf("Failed to initialize libsodium\n");
+        return 1;
+    }
+
+    const size_t      k = 32;
+    uint8_t           G[CSIGMA_POINT_BYTES], H[CSIGMA_POINT_BYTES], K[CSIGMA_POINT_BYTES];
+    uint8_t*          images    = malloc(k * 2 * CSIGMA_POINT_BYTES);
+    uint8_t*          witnesses = malloc(k * CSIGMA_SCALAR_BYTES);
+    uint8_t           message[] = "amortized test";
+    linear_relation_t relation;
+
+    build_shape(&relation, G, H, K);
+    for (size_t j = 0; j < k; j++) {
+        make_instance(&images[j * 2 * CSIGMA_POINT_BYTES], &witnesses[j * CSIGMA_SCALAR_BYTES], G,
+                      H, K);
+    }
+
+    size_t  len = csigma_amortized_proof_size(&relation);
+    uint8_t proof[3 * CSIGMA_POINT_BYTES];
+
+    // Test 1: k instances in one single-instance-sized proof
+    printf("Test 1: %zu instances in %zu bytes... ", k, len);
+    if (len != 2 * CSIGMA_POINT_BYTES + CSIGMA_SCALAR_BYTES) {
+        printf("Unexpected proof size\n");
+        return 1;
+    }
+    if (csigma_amortized_prove(proof, &relation, images, witnesses, k, message, sizeof(message)) !=
+        0) {
+        printf("Prove failed\n");
+        return 1;
+    }
+    if (!csigma_amortized_verify(proof, len, &relation, images, k, message, sizeof(message))) {
+        printf("Valid proof rejected\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 2: Dropped instances, swapped instances and wrong messages are rejected
+    printf("Test 2: Statement binding... ");
+    if (csigma_amortized_verify(proof, len, &relation, images, k - 1, message, sizeof(message)) ||
+        csigma_amortized_verify(proof, len, &relation, images, k, message, sizeof(message) - 1)) {
+        printf("Modified statement accepted\n");
+        return 1;
+    }
+    uint8_t swap[2 * CSIGMA_POINT_BYTES];
+    memcpy(swap, &images[0], sizeof(swap));
+    memcpy(&images[0], &images[sizeof(swap)], sizeof(swap));
+    memcpy(&images[sizeof(swap)], swap, sizeof(swap));
+    if (csigma_amortized_verify(proof, len, &relation, images, k, message, sizeof(message))) {
+        printf("Swapped instances accepted\n");
+        return 1;
+    }
+    memcpy(&images[sizeof(swap)], &images[0], sizeof(swap));
+    memcpy(&images[0], swap, sizeof(swap));
+    printf("PASS\n");
+
+    // Test 3: One instance without a valid witness spoils the whole proof
+    printf("Test 3: Invalid instance... ");
+    uint8_t* bad_image = &images[7 * 2 * CSIGMA_POINT_BYTES];
+    crypto_core_ristretto255_add(bad_image, bad_image, G);
+    csigma_amortized_prove(proof, &relation, images, witnesses, k, message, sizeof(message));
+    if (csigma_amortized_verify(proof, len, &relation, images, k, message, sizeof(message))) {
+        printf("Invalid instance accepted\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 4: A single instance works like a regular proof
+    printf("Test 4: Single instance... ");
+    if (csigma_amortized_prove(proof, &relation, images, witnesses, 1, NULL, 0) != 0 ||
+        !csigma_amortized_verify(proof, len, &relation, images, 1, NULL, 0)) {
+        printf("Single instance failed\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    csigma_relation_destroy(&relation);
+    free(images);
+    free(witnesses);
+
+    printf("\nAll amortized proof tests passed\n");
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include "../cmz.h"
+#include "../generators.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_ATTRIBUTES 5
+
+int
+main()
+{
+    printf("\n=== Testing Keyed-Verification Credentials ===\n");
+
+    if (sodium_init() < 0) {
+        printf("Failed to initialize libsodium\n");
+        return 1;
+    }
+
+    uint8_t generators[2 * CSIGMA_POINT_BYTES];
+    csigma_derive_generators("cmz test", 2, generators);
+    const uint8_t* G = &generators[0];
+    const uint8_t* H = &generators[CSIGMA_POINT_BYTES];
+
+    csigma_cmz_issuer_t issuer;
+    if (csigma_cmz_issuer_init(&issuer, NUM_ATTRIBUTES, G, H) != 0) {
+        printf("Issuer setup failed\n");
+        return 1;
+    }
+
+    uint8_t attributes[NUM_ATTRIBUTES * CSIGMA_SCALAR_BYTES];
+    for (size_t i = 0; i < NUM_ATTRIBUTES; i++) {
+        crypto_core_ristretto255_scalar_random(&attributes[i * CSIGMA_SCALAR_BYTES]);
+    }
+
+    // Test 1: Issuance with a proof checked against the published parameters
+    printf("Test 1: Issuance... ");
+    uint8_t             params_bytes[(NUM_ATTRIBUTES + 3) * CSIGMA_POINT_BYTES];
+    uint8_t             credential[CSIGMA_CMZ_CREDENTIAL_BYTES];
+    size_t              issuance_len = csigma_cmz_issuance_proof_size(NUM_ATTRIBUTES);
+    uint8_t*            issuance     = malloc(issuance_len);
+    csigma_cmz_params_t params;
+
+    csigma_cmz_params_serialize(params_bytes, &issuer.params);
+    if (csigma_cmz_params_load(&params, params_bytes, sizeof(params_bytes)) != 0 ||
+        params.num_attributes != NUM_ATTRIBUTES) {
+        printf("Failed to load parameters\n");
+        return 1;
+    }
+    if (csigma_cmz_issue(credential, issuance, &issuer, attributes) != 0 ||
+        !csigma_cmz_issuance_verify(issuance, issuance_len, &params, credential, attributes)) {
+        printf("Valid issuance rejected\n");
+        return 1;
+    }
+    attributes[0] ^= 1;
+    if (csigma_cmz_issuance_verify(issuance, issuance_len, &params, credential, attributes)) {
+        printf("Issuance proof accepted for other attributes\n");
+        return 1;
+    }
+    attributes[0] ^= 1;
+    printf("PASS\n");
+
+    // Test 2: Presentation with the holder's copy of the parameters
+    printf("Test 2: Presentation... ");
+    size_t   len          = csigma_cmz_presentation_size(NUM_ATTRIBUTES);
+    uint8_t* presentation = malloc(len);
+    uint8_t  message[]    = "login nonce 42";
+    if (csigma_cmz_present(presentation, &params, credential, attributes, message,
+                           sizeof(message)) != 0 ||
+        !csigma_cmz_verify(presentation, len, &issuer, message, sizeof(message))) {
+        printf("Valid presentation rejected\n");
+        return 1;
+    }
+    if (csigma_cmz_verify(presentation, len, &issuer, message, sizeof(message) - 1) ||
+        csigma_cmz_verify(presentation, len - 1, &issuer, message, sizeof(message))) {
+        printf("Modified statement accepted\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 3: Presentations are unlinkable re-randomizations
+    printf("Test 3: Re-randomization... ");
+    uint8_t* second = malloc(len);
+    csigma_cmz_present(second, &params, credential, attributes, message, sizeof(message));
+    if (memcmp(second, presentation, 2 * CSIGMA_POINT_BYTES) == 0 ||
+        memcmp(second, credential, CSIGMA_POINT_BYTES) == 0) {
+        printf("Presentation reveals the credential\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 4: Forged credentials, wrong attributes and other issuers are rejected
+    printf("Test 4: Forgeries... ");
+    uint8_t forged[CSIGMA_CMZ_CREDENTIAL_BYTES];
+    memcpy(forged, credential, sizeof(forged));
+    crypto_core_ristretto255_add(&forged[CSIGMA_POINT_BYTES], &forged[CSIGMA_POINT_BYTES], G);
+    csigma_cmz_present(presentation, &params, forged, attributes, NULL, 0);
+    if (csigma_cmz_verify(presentation, len, &issuer, NULL, 0)) {
+        printf("Forged credential accepted\n");
+        return 1;
+    }
+    attributes[3 * CSIGMA_SCALAR_BYTES] ^= 1;
+    csigma_cmz_present(presentation, &params, credential, attributes, NULL, 0);
+    attributes[3 * CSIGMA_SCALAR_BYTES] ^= 1;
+    if (csigma_cmz_verify(presentation, len, &issuer, NULL, 0)) {
+        printf("Wrong attributes accepted\n");
+        return 1;
+    }
+    csigma_cmz_issuer_t other;
+    csigma_cmz_issuer_init(&other, NUM_ATTRIBUTES, G, H);
+    csigma_cmz_present(presentation, &params, credential, attributes, NULL, 0);
+    if (!csigma_cmz_verify(presentation, len, &issuer, NULL, 0) ||
+        csigma_cmz_verify(presentation, len, &other, NULL, 0)) {
+        printf("Presentation accepted by another issuer\n");
+        return 1;
+    }
+    csigma_cmz_issuer_destroy(&other);
+    memset(presentation, 0, 2 * CSIGMA_POINT_BYTES);
+    if (csigma_cmz_verify(presentation, len, &issuer, NULL, 0)) {
+        printf("Identity presentation accepted\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 5: Batch verification
+    printf("Test 5: Batch of 8 presentations... ");
+    const size_t   n     = 8;
+    uint8_t*       batch = malloc(n * len);
+    const uint8_t* messages[8];
+    size_t         message_lens[8];
+    for (size_t j = 0; j < n; j++) {
+        messages[j]     = message;
+        message_lens[j] = j;
+        if (csigma_cmz_present(&batch[j * len], &params, credential, attributes, messages[j],
+                               message_lens[j]) != 0) {
+            printf("Presentation failed\n");
+            return 1;
+        }
+    }
+    if (!csigma_cmz_batch_verify(batch, n, &issuer, messages, message_lens)) {
+        printf("Valid batch rejected\n");
+        return 1;
+    }
+    batch[3 * len + len - 1] ^= 1;
+    if (csigma_cmz_batch_verify(batch, n, &issuer, messages, message_lens)) {
+        printf("Batch with a tampered presentation accepted\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 6: Parameters set up under one transcript backend work under another
+    printf("Test 6: Backend switch... ");
+    csigma_cmz_present(presentation, &params, credential, attributes, message, sizeof(message));
+    csigma_transcript_set_hash(CSIGMA_HASH_BLAKE2B);
+    csigma_cmz_present(second, &params, credential, attributes, message, sizeof(message));
+    bool blake2b_accepted = csigma_cmz_verify(second, len, &issuer, message, sizeof(message));
+    bool stale_accepted = csigma_cmz_verify(presentation, len, &issuer, message, sizeof(message));
+    csigma_transcript_set_hash(CSIGMA_HASH_SHAKE128);
+    if (!blake2b_accepted || stale_accepted ||
+        csigma_cmz_verify(second, len, &issuer, message, sizeof(message)) ||
+        !csigma_cmz_verify(presentation, len, &issuer, message, sizeof(message))) {
+        printf("Parameter transcript used under another backend\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    free(batch);
+    free(second);
+    free(presentation);
+    free(issuance);
+    csigma_cmz_params_destroy(&params);
+    csigma_cmz_issuer_destroy(&issuer);
+
+    printf("\nAll credential tests passed\n");
+    return 0;
+}
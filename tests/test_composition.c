@@ -0,0 +1,179 @@
+#include "../composition.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Schnorr relation Y = x*G with a fresh key pair
+static void
+build_schnorr(linear_relation_t* relation, uint8_t witness[CSIGMA_SCALAR_BYTES])
+{
+    uint8_t one[CSIGMA_SCALAR_BYTES] = { 1 };
+    uint8_t G[CSIGMA_POINT_BYTES], Y[CSIGMA_POINT_BYTES];
+
+    crypto_scalarmult_ristretto255_base(G, one);
+    crypto_core_ristretto255_scalar_random(witness);
+    crypto_scalarmult_ristretto255_base(Y, witness);
+
+    csigma_relation_init(relation);
+    int var_x = csigma_relation_add_scalar(relation);
+    int var_G = csigma_relation_add_element(relation, G);
+    int var_Y = csigma_relation_add_element(relation, Y);
+    csigma_relation_add_equation_simple(relation, var_Y, var_x, var_G);
+    memcpy(relation->image, Y, CSIGMA_POINT_BYTES);
+}
+
+// DLEQ relation h1 = x*G, h2 = x*H
+static void
+build_dleq(linear_relation_t* relation, uint8_t witness[CSIGMA_SCALAR_BYTES])
+{
+    uint8_t one[CSIGMA_SCALAR_BYTES] = { 1 }, temp[CSIGMA_SCALAR_BYTES];
+    uint8_t G[CSIGMA_POINT_BYTES], H[CSIGMA_POINT_BYTES];
+    uint8_t h1[CSIGMA_POINT_BYTES], h2[CSIGMA_POINT_BYTES];
+
+    crypto_scalarmult_ristretto255_base(G, one);
+    crypto_core_ristretto255_scalar_random(temp);
+    crypto_scalarmult_ristretto255_base(H, temp);
+    crypto_core_ristretto255_scalar_random(witness);
+    crypto_scalarmult_ristretto255_base(h1, witness);
+    crypto_scalarmult_ristretto255(h2, witness, H);
+
+    csigma_relation_init(relation);
+    int var_x = csigma_relation_add_scalar(relation);
+    int var_G = csigma_relation_add_element(relation, G);
+    int var_H = csigma_relation_add_element(relation, H);
+    csigma_relation_add_equation_simple(relation, 0, var_x, var_G);
+    csigma_relation_add_equation_simple(relation, 0, var_x, var_H);
+    memcpy(&relation->image[0], h1, CSIGMA_POINT_BYTES);
+    memcpy(&relation->image[CSIGMA_POINT_BYTES], h2, CSIGMA_POINT_BYTES);
+}
+
+static int
+prove_and_check(const csigma_composition_t* composition, const uint8_t* const* witnesses,
+                const char* label)
+{
+    uint8_t message[] = "composition test";
+    size_t  len       = csigma_composition_proof_size(composition);
+    uint8_t proof[4096];
+
+    if (len == 0 || len > sizeof(proof)) {
+        printf("%s: bad proof size\n", label);
+        return 1;
+    }
+    if (csigma_composition_prove(proof, composition, witnesses, message, sizeof(message)) != 0) {
+        printf("%s: prove failed\n", label);
+        return 1;
+    }
+    if (!csigma_composition_verify(proof, len, composition, message, sizeof(message))) {
+        printf("%s: valid proof rejected\n", label);
+        return 1;
+    }
+    if (csigma_composition_verify(proof, len, composition, (const uint8_t*) "other", 5)) {
+        printf("%s: proof accepted with wrong message\n", label);
+        return 1;
+    }
+    proof[len - 1] ^= 1;
+    if (csigma_composition_verify(proof, len, composition, message, sizeof(message))) {
+        printf("%s: tampered proof accepted\n", label);
+        return 1;
+    }
+    return 0;
+}
+
+int
+main()
+{
+    printf("\n=== Testing AND/OR Composition ===\n");
+
+    if (sodium_init() < 0) {
+        printf("Failed to initialize libsodium\n");
+        return 1;
+    }
+
+    linear_relation_t a, b, c, d;
+    uint8_t           wa[CSIGMA_SCALAR_BYTES], wb[CSIGMA_SCALAR_BYTES];
+    uint8_t           wc[CSIGMA_SCALAR_BYTES], wd[CSIGMA_SCALAR_BYTES];
+    build_schnorr(&a, wa);
+    build_schnorr(&b, wb);
+    build_schnorr(&c, wc);
+    build_dleq(&d, wd);
+
+    // Test 1: Conjunction sharing one challenge
+    printf("Test 1: AND(Schnorr, DLEQ)... ");
+    csigma_composition_t composition;
+    csigma_composition_init(&composition);
+    int leaves[3];
+    leaves[0] = csigma_composition_add_relation(&composition, &a);
+    leaves[1] = csigma_composition_add_relation(&composition, &d);
+    csigma_composition_add_and(&composition, leaves, 2);
+    const uint8_t* and_witnesses[] = { wa, wd, NULL };
+    if (prove_and_check(&composition, and_witnesses, "AND") != 0)
+        return 1;
+    if (csigma_composition_proof_size(&composition) != 3 * CSIGMA_POINT_BYTES + 2 * 32) {
+        printf("Unexpected proof size\n");
+        return 1;
+    }
+    csigma_composition_destroy(&composition);
+    printf("PASS\n");
+
+    // Test 2: Disjunction where only the middle branch is known
+    printf("Test 2: OR(A, B, C) knowing B... ");
+    csigma_composition_init(&composition);
+    leaves[0] = csigma_composition_add_relation(&composition, &a);
+    leaves[1] = csigma_composition_add_relation(&composition, &b);
+    leaves[2] = csigma_composition_add_relation(&composition, &c);
+    csigma_composition_add_or(&composition, leaves, 3);
+    const uint8_t* or_witnesses[] = { NULL, wb, NULL, NULL };
+    if (prove_and_check(&composition, or_witnesses, "OR") != 0)
+        return 1;
+    printf("PASS\n");
+
+    // Test 3: No branch known
+    printf("Test 3: OR with no witness... ");
+    const uint8_t* no_witnesses[] = { NULL, NULL, NULL, NULL };
+    uint8_t        proof[1024];
+    if (csigma_composition_prove(proof, &composition, no_witnesses, NULL, 0) == 0) {
+        printf("Proved without a witness\n");
+        return 1;
+    }
+    csigma_composition_destroy(&composition);
+    printf("PASS\n");
+
+    // Test 4: Nested AND(OR(A, B), DLEQ) knowing A and the DLEQ witness
+    printf("Test 4: AND(OR(A, B), DLEQ)... ");
+    csigma_composition_init(&composition);
+    leaves[0]          = csigma_composition_add_relation(&composition, &a);
+    leaves[1]          = csigma_composition_add_relation(&composition, &b);
+    int or_node        = csigma_composition_add_or(&composition, leaves, 2);
+    int dleq_node      = csigma_composition_add_relation(&composition, &d);
+    int and_children[] = { or_node, dleq_node };
+    csigma_composition_add_and(&composition, and_children, 2);
+    const uint8_t* nested_witnesses[] = { wa, NULL, NULL, wd, NULL };
+    if (prove_and_check(&composition, nested_witnesses, "Nested") != 0)
+        return 1;
+    printf("PASS\n");
+
+    // Test 5: Malformed trees are rejected
+    printf("Test 5: Tree validation... ");
+    if (csigma_composition_add_or(&composition, leaves, 2) != -1) {
+        printf("Node accepted a second parent\n");
+        return 1;
+    }
+    csigma_composition_destroy(&composition);
+    csigma_composition_init(&composition);
+    csigma_composition_add_relation(&composition, &a);
+    csigma_composition_add_relation(&composition, &b);
+    if (csigma_composition_proof_size(&composition) != 0) {
+        printf("Forest accepted\n");
+        return 1;
+    }
+    csigma_composition_destroy(&composition);
+    printf("PASS\n");
+
+    csigma_relation_destroy(&a);
+    csigma_relation_destroy(&b);
+    csigma_relation_destroy(&c);
+    csigma_relation_destroy(&d);
+
+    printf("\nAll composition tests passed\n");
+    return 0;
+}
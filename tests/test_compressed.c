@@ -0,0 +1,235 @@
+#include "../compressed.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Vector commitment C = sum of m_i * G_i + r * H with n messages
+static void
+build_vector_commitment(linear_relation_t* relation, uint8_t* witness, size_t n)
+{
+    uint8_t* generators = malloc((n + 1) * CSIGMA_POINT_BYTES);
+    uint8_t  C[CSIGMA_POINT_BYTES];
+
+    for (size_t i = 0; i <= n; i++) {
+        crypto_core_ristretto255_random(&generators[i * CSIGMA_POINT_BYTES]);
+        crypto_core_ristretto255_scalar_random(&witness[i * CSIGMA_SCALAR_BYTES]);
+    }
+    csigma_msm(C, witness, generators, n + 1);
+
+    int* scalars  = malloc((n + 1) * sizeof(int));
+    int* elements = malloc((n + 1) * sizeof(int));
+
+    csigma_relation_init(relation);
+    for (size_t i = 0; i <= n; i++) {
+        scalars[i]  = csigma_relation_add_scalar(relation);
+        elements[i] = csigma_relation_add_element(relation, &generators[i * CSIGMA_POINT_BYTES]);
+    }
+    int var_C = csigma_relation_add_element(relation, C);
+    csigma_relation_add_equation(relation, var_C, scalars, elements, n + 1);
+    memcpy(relation->image, C, CSIGMA_POINT_BYTES);
+
+    free(scalars);
+    free(elements);
+    free(generators);
+}
+
+static int
+prove_and_check(const linear_relation_t* relation, const uint8_t* witness, const char* label)
+{
+    uint8_t message[] = "compressed test";
+    size_t  len       = csigma_compressed_proof_size(relation);
+    uint8_t proof[4096];
+
+    if (len == 0 || len > sizeof(proof)) {
+        printf("%s: bad proof size\n", label);
+        return 1;
+    }
+    if (csigma_compressed_prove(proof, relation, witness, message, sizeof(message)) != 0) {
+        printf("%s: prove failed\n", label);
+        return 1;
+    }
+    if (!csigma_compressed_verify(proof, len, relation, message, sizeof(message))) {
+        printf("%s: valid proof rejected\n", label);
+        return 1;
+    }
+    if (csigma_compressed_verify(proof, len, relation, message, sizeof(message) - 1)) {
+        printf("%s: proof accepted with wrong message\n", label);
+        return 1;
+    }
+    if (csigma_compressed_verify(proof, len - 1, relation, message, sizeof(message))) {
+        printf("%s: truncated proof accepted\n", label);
+        return 1;
+    }
+    proof[len - 1] ^= 0x01;
+    if (csigma_compressed_verify(proof, len, relation, message, sizeof(message))) {
+        printf("%s: tampered response accepted\n", label);
+        return 1;
+    }
+    proof[len - 1] ^= 0x01;
+    if (len > CSIGMA_POINT_BYTES + CSIGMA_SCALAR_BYTES) {
+        // Replace the first cross term with the commitment
+        memcpy(&proof[CSIGMA_POINT_BYTES], proof, CSIGMA_POINT_BYTES);
+        if (csigma_compressed_verify(proof, len, relation, message, sizeof(message))) {
+            printf("%s: tampered cross term accepted\n", label);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int
+main()
+{
+    printf("\n=== Testing Compressed Sigma Protocols ===\n");
+
+    if (sodium_init() < 0) {
+        printf("Failed to initialize libsodium\n");
+        return 1;
+    }
+
+    // Test 1: Vector commitment with 32 messages (33 scalars, 6 rounds)
+    printf("Test 1: Vector commitment opening... ");
+    {
+        linear_relation_t relation;
+        uint8_t           witness[33 * CSIGMA_SCALAR_BYTES];
+        build_vector_commitment(&relation, witness, 32);
+
+        size_t expected = (1 + 2 * 6) * CSIGMA_POINT_BYTES + CSIGMA_SCALAR_BYTES;
+        if (csigma_compressed_proof_size(&relation) != expected) {
+            printf("Unexpected proof size\n");
+            return 1;
+        }
+        if (prove_and_check(&relation, witness, "Vector commitment") != 0)
+            return 1;
+        csigma_relation_destroy(&relation);
+    }
+    printf("PASS\n");
+
+    // Test 2: Two equations with coefficients and a constant term
+    // V = 2*x0*G + 3*x1*H and W = x1*G + x2*H + K
+    printf("Test 2: Coefficients and constants... ");
+    {
+        uint8_t G[CSIGMA_POINT_BYTES], H[CSIGMA_POINT_BYTES], K[CSIGMA_POINT_BYTES];
+        uint8_t V[CSIGMA_POINT_BYTES], W[CSIGMA_POINT_BYTES];
+        uint8_t witness[3 * CSIGMA_SCALAR_BYTES];
+        uint8_t coefficients[2 * CSIGMA_SCALAR_BYTES] = { 0 };
+        uint8_t scalars[2 * CSIGMA_SCALAR_BYTES];
+        uint8_t points[2 * CSIGMA_POINT_BYTES];
+
+        crypto_core_ristretto255_random(G);
+        crypto_core_ristretto255_random(H);
+        crypto_core_ristretto255_random(K);
+        for (size_t i = 0; i < 3; i++) {
+            crypto_core_ristretto255_scalar_random(&witness[i * CSIGMA_SCALAR_BYTES]);
+        }
+        coefficients[0]                   = 2;
+        coefficients[CSIGMA_SCALAR_BYTES] = 3;
+
+        crypto_core_ristretto255_scalar_mul(&scalars[0], &coefficients[0], &witness[0]);
+        crypto_core_ristretto255_scalar_mul(&scalars[CSIGMA_SCALAR_BYTES],
+                                            &coefficients[CSIGMA_SCALAR_BYTES],
+                                            &witness[CSIGMA_SCALAR_BYTES]);
+        memcpy(&points[0], G, CSIGMA_POINT_BYTES);
+        memcpy(&points[CSIGMA_POINT_BYTES], H, CSIGMA_POINT_BYTES);
+        csigma_msm(V, scalars, points, 2);
+
+        csigma_msm(W, &witness[CSIGMA_SCALAR_BYTES], points, 2);
+        crypto_core_ristretto255_add(W, W, K);
+
+        linear_relation_t relation;
+        csigma_relation_init(&relation);
+        int x0    = csigma_relation_add_scalar(&relation);
+        int x1    = csigma_relation_add_scalar(&relation);
+        int x2    = csigma_relation_add_scalar(&relation);
+        int var_G = csigma_relation_add_element(&relation, G);
+        int var_H = csigma_relation_add_element(&relation, H);
+        int var_K = csigma_relation_add_element(&relation, K);
+
+        int first_scalars[]  = { x0, x1 };
+        int second_scalars[] = { x1, x2 };
+        int elements[]       = { var_G, var_H };
+        csigma_relation_add_weighted_equation(&relation, 0, first_scalars, elements, coefficients,
+                                              2);
+        csigma_relation_add_equation(&relation, 0, second_scalars, elements, 2);
+        csigma_relation_set_constant(&relation, 1, var_K, NULL);
+        memcpy(&relation.image[0], V, CSIGMA_POINT_BYTES);
+        memcpy(&relation.image[CSIGMA_POINT_BYTES], W, CSIGMA_POINT_BYTES);
+
+        if (prove_and_check(&relation, witness, "Weighted") != 0)
+            return 1;
+        csigma_relation_destroy(&relation);
+    }
+    printf("PASS\n");
+
+    // Test 3: A single scalar needs no folding round
+    printf("Test 3: Schnorr (no rounds)... ");
+    {
+        uint8_t one[CSIGMA_SCALAR_BYTES] = { 1 };
+        uint8_t G[CSIGMA_POINT_BYTES], Y[CSIGMA_POINT_BYTES], x[CSIGMA_SCALAR_BYTES];
+
+        crypto_scalarmult_ristretto255_base(G, one);
+        crypto_core_ristretto255_scalar_random(x);
+        crypto_scalarmult_ristretto255_base(Y, x);
+
+        linear_relation_t relation;
+        csigma_relation_init(&relation);
+        int var_x = csigma_relation_add_scalar(&relation);
+        int var_G = csigma_relation_add_element(&relation, G);
+        int var_Y = csigma_relation_add_element(&relation, Y);
+        csigma_relation_add_equation_simple(&relation, var_Y, var_x, var_G);
+        memcpy(relation.image, Y, CSIGMA_POINT_BYTES);
+
+        if (csigma_compressed_proof_size(&relation) != CSIGMA_SCHNORR_PROOF_SIZE) {
+            printf("Unexpected proof size\n");
+            return 1;
+        }
+        if (prove_and_check(&relation, x, "Schnorr") != 0)
+            return 1;
+        csigma_relation_destroy(&relation);
+    }
+    printf("PASS\n");
+
+    // Test 4: A wrong witness does not verify
+    printf("Test 4: Wrong witness rejected... ");
+    {
+        linear_relation_t relation;
+        uint8_t           witness[5 * CSIGMA_SCALAR_BYTES];
+        uint8_t           proof[4096];
+        build_vector_commitment(&relation, witness, 4);
+        witness[0] ^= 0x01;
+
+        size_t len = csigma_compressed_proof_size(&relation);
+        if (csigma_compressed_prove(proof, &relation, witness, NULL, 0) != 0) {
+            printf("Prove failed\n");
+            return 1;
+        }
+        if (csigma_compressed_verify(proof, len, &relation, NULL, 0)) {
+            printf("Wrong witness accepted\n");
+            return 1;
+        }
+        csigma_relation_destroy(&relation);
+    }
+    printf("PASS\n");
+
+    // Test 5: Proof size grows logarithmically
+    printf("Test 5: Proof size for 1000 messages... ");
+    {
+        linear_relation_t relation;
+        uint8_t*          witness = malloc(1001 * CSIGMA_SCALAR_BYTES);
+        build_vector_commitment(&relation, witness, 1000);
+
+        size_t compressed = csigma_compressed_proof_size(&relation);
+        size_t standard   = CSIGMA_POINT_BYTES + 1001 * CSIGMA_SCALAR_BYTES;
+        if (compressed != (1 + 2 * 10) * CSIGMA_POINT_BYTES + CSIGMA_SCALAR_BYTES) {
+            printf("Unexpected proof size\n");
+            return 1;
+        }
+        printf("%zu bytes instead of %zu... ", compressed, standard);
+        csigma_relation_destroy(&relation);
+        free(witness);
+    }
+    printf("PASS\n");
+
+    printf("\nAll compressed proof tests passed\n");
+    return 0;
+}
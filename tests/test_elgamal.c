@@ -0,0 +1,121 @@
+#include "../elgamal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int
+main()
+{
+    printf("\n=== Testing ElGamal Re-encryption Proofs ===\n");
+
+    if (sodium_init() < 0) {
+        printf("Failed to initialize libsodium\n");
+        return 1;
+    }
+
+    uint8_t G[CSIGMA_POINT_BYTES], Y[CSIGMA_POINT_BYTES], x[CSIGMA_SCALAR_BYTES];
+    uint8_t one[CSIGMA_SCALAR_BYTES] = { 1 };
+    crypto_scalarmult_ristretto255_base(G, one);
+    crypto_core_ristretto255_scalar_random(x);
+    crypto_scalarmult_ristretto255_base(Y, x);
+
+    // Test 1: Encryption round trip, before and after re-encryption
+    printf("Test 1: Encrypt, re-encrypt, decrypt... ");
+    uint8_t M[CSIGMA_POINT_BYTES], decrypted[CSIGMA_POINT_BYTES];
+    uint8_t r[CSIGMA_SCALAR_BYTES], s[CSIGMA_SCALAR_BYTES];
+    uint8_t ct[CSIGMA_ELGAMAL_CIPHERTEXT_BYTES], ct2[CSIGMA_ELGAMAL_CIPHERTEXT_BYTES];
+    crypto_core_ristretto255_random(M);
+    crypto_core_ristretto255_scalar_random(r);
+    crypto_core_ristretto255_scalar_random(s);
+    if (csigma_elgamal_encrypt(ct, M, r, G, Y) != 0 ||
+        csigma_elgamal_decrypt(decrypted, ct, x) != 0 || memcmp(decrypted, M, sizeof(M)) != 0) {
+        printf("Round trip failed\n");
+        return 1;
+    }
+    if (csigma_elgamal_reencrypt(ct2, ct, s, G, Y) != 0 || memcmp(ct2, ct, sizeof(ct)) == 0 ||
+        csigma_elgamal_decrypt(decrypted, ct2, x) != 0 || memcmp(decrypted, M, sizeof(M)) != 0) {
+        printf("Re-encryption failed\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 2: Batch re-encryption and proof (large enough to use several threads)
+    const size_t n          = 300;
+    uint8_t*     inputs     = malloc(n * CSIGMA_ELGAMAL_CIPHERTEXT_BYTES);
+    uint8_t*     outputs    = malloc(n * CSIGMA_ELGAMAL_CIPHERTEXT_BYTES);
+    uint8_t*     randomness = malloc(n * CSIGMA_SCALAR_BYTES);
+    uint8_t      message[]  = "mix round 1";
+    uint8_t      proof[CSIGMA_ELGAMAL_REENCRYPTION_PROOF_SIZE];
+
+    printf("Test 2: Batch of %zu re-encryptions... ", n);
+    for (size_t j = 0; j < n; j++) {
+        crypto_core_ristretto255_random(M);
+        crypto_core_ristretto255_scalar_random(r);
+        csigma_elgamal_encrypt(&inputs[j * CSIGMA_ELGAMAL_CIPHERTEXT_BYTES], M, r, G, Y);
+        crypto_core_ristretto255_scalar_random(&randomness[j * CSIGMA_SCALAR_BYTES]);
+    }
+    if (csigma_elgamal_reencrypt_batch(outputs, inputs, randomness, n, G, Y) != 0) {
+        printf("Batch re-encryption failed\n");
+        return 1;
+    }
+    csigma_elgamal_decrypt(M, &inputs[17 * CSIGMA_ELGAMAL_CIPHERTEXT_BYTES], x);
+    csigma_elgamal_decrypt(decrypted, &outputs[17 * CSIGMA_ELGAMAL_CIPHERTEXT_BYTES], x);
+    if (memcmp(decrypted, M, sizeof(M)) != 0) {
+        printf("Batch re-encryption changed a plaintext\n");
+        return 1;
+    }
+    if (csigma_elgamal_reencryption_prove(proof, inputs, outputs, randomness, n, G, Y, message,
+                                          sizeof(message)) != 0 ||
+        !csigma_elgamal_reencryption_verify(proof, sizeof(proof), inputs, outputs, n, G, Y,
+                                            message, sizeof(message))) {
+        printf("Valid proof rejected\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 3: Changed plaintexts, swapped outputs and wrong keys are rejected
+    printf("Test 3: Invalid re-encryptions... ");
+    if (csigma_elgamal_reencryption_verify(proof, sizeof(proof), inputs, outputs, n, G, Y, message,
+                                           sizeof(message) - 1) ||
+        csigma_elgamal_reencryption_verify(proof, sizeof(proof), inputs, outputs, n, G, G, message,
+                                           sizeof(message))) {
+        printf("Modified statement accepted\n");
+        return 1;
+    }
+    uint8_t  saved[CSIGMA_ELGAMAL_CIPHERTEXT_BYTES];
+    uint8_t* tampered = &outputs[123 * CSIGMA_ELGAMAL_CIPHERTEXT_BYTES];
+    memcpy(saved, tampered, sizeof(saved));
+    crypto_core_ristretto255_add(&tampered[CSIGMA_POINT_BYTES], &tampered[CSIGMA_POINT_BYTES], G);
+    if (csigma_elgamal_reencryption_verify(proof, sizeof(proof), inputs, outputs, n, G, Y, message,
+                                           sizeof(message))) {
+        printf("Changed plaintext accepted\n");
+        return 1;
+    }
+    // Even a fresh proof cannot cover a changed plaintext
+    csigma_elgamal_reencryption_prove(proof, inputs, outputs, randomness, n, G, Y, message,
+                                      sizeof(message));
+    if (csigma_elgamal_reencryption_verify(proof, sizeof(proof), inputs, outputs, n, G, Y, message,
+                                           sizeof(message))) {
+        printf("Proof for a changed plaintext accepted\n");
+        return 1;
+    }
+    memcpy(tampered, saved, sizeof(saved));
+    csigma_elgamal_reencryption_prove(proof, inputs, outputs, randomness, n, G, Y, message,
+                                      sizeof(message));
+    memcpy(saved, &outputs[0], sizeof(saved));
+    memcpy(&outputs[0], &outputs[CSIGMA_ELGAMAL_CIPHERTEXT_BYTES], sizeof(saved));
+    memcpy(&outputs[CSIGMA_ELGAMAL_CIPHERTEXT_BYTES], saved, sizeof(saved));
+    if (csigma_elgamal_reencryption_verify(proof, sizeof(proof), inputs, outputs, n, G, Y, message,
+                                           sizeof(message))) {
+        printf("Swapped outputs accepted\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    free(inputs);
+    free(outputs);
+    free(randomness);
+
+    printf("\nAll ElGamal tests passed\n");
+    return 0;
+}
@@ -1,6 +1,8 @@
 #include "../keccak.h"
 #include "../linear_relation.h"
+#include "../optimizer.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 // Generate Fiat-Shamir challenge
@@ -189,11 +191,209 @@ test_dleq_with_framework()
     csigma_relation_destroy(&relation);
 }
 
+// Prove and verify a relation with a random challenge
+static bool
+prove_and_verify(linear_relation_t* relation, const uint8_t* witness, size_t num_scalars)
+{
+    prover_state_t state;
+    uint8_t*       commitment = malloc(relation->map.num_constraints * CSIGMA_POINT_BYTES);
+    uint8_t*       response   = malloc(num_scalars * CSIGMA_SCALAR_BYTES);
+    uint8_t        challenge[CSIGMA_SCALAR_BYTES];
+
+    if (csigma_prover_commit(relation, witness, commitment, &state) != 0) {
+        free(commitment);
+        free(response);
+        return false;
+    }
+    crypto_core_ristretto255_scalar_random(challenge);
+    csigma_prover_response(&state, challenge, response);
+    csigma_prover_state_destroy(&state);
+
+    bool valid = csigma_verify(relation, commitment, challenge, response);
+    free(commitment);
+    free(response);
+    return valid;
+}
+
+int
+test_weighted_equations()
+{
+    printf("\n=== Testing Public Coefficients and Constant Terms ===\n");
+
+    uint8_t one[CSIGMA_SCALAR_BYTES] = { 1 };
+    uint8_t G[CSIGMA_POINT_BYTES], H[CSIGMA_POINT_BYTES], temp[CSIGMA_SCALAR_BYTES];
+    crypto_scalarmult_ristretto255_base(G, one);
+    crypto_core_ristretto255_scalar_random(temp);
+    crypto_scalarmult_ristretto255_base(H, temp);
+
+    // Balance proof: C1 = C2 + r*H with C1, C2 public (C1 - C2 opens to zero)
+    uint8_t r[CSIGMA_SCALAR_BYTES], v[CSIGMA_SCALAR_BYTES];
+    uint8_t C1[CSIGMA_POINT_BYTES], C2[CSIGMA_POINT_BYTES], rH[CSIGMA_POINT_BYTES];
+    crypto_core_ristretto255_scalar_random(r);
+    crypto_core_ristretto255_scalar_random(v);
+    crypto_scalarmult_ristretto255_base(C2, v);
+    crypto_scalarmult_ristretto255(rH, r, H);
+    crypto_core_ristretto255_add(C1, C2, rH);
+
+    linear_relation_t relation;
+    csigma_relation_init(&relation);
+    int var_r  = csigma_relation_add_scalar(&relation);
+    int var_H  = csigma_relation_add_element(&relation, H);
+    int var_C1 = csigma_relation_add_element(&relation, C1);
+    int var_C2 = csigma_relation_add_element(&relation, C2);
+    csigma_relation_add_equation_simple(&relation, var_C1, var_r, var_H);
+    csigma_relation_set_constant(&relation, 0, var_C2, NULL);
+    memcpy(relation.image, C1, CSIGMA_POINT_BYTES);
+
+    bool valid = prove_and_verify(&relation, r, 1);
+    printf("Balance proof: %s\n", valid ? "VALID" : "INVALID");
+    if (!valid) {
+        return 1;
+    }
+
+    // Wrong constant must be rejected
+    csigma_relation_set_constant(&relation, 0, var_H, NULL);
+    valid = prove_and_verify(&relation, r, 1);
+    printf("Wrong constant: %s\n", valid ? "INCORRECTLY ACCEPTED" : "CORRECTLY REJECTED");
+    csigma_relation_destroy(&relation);
+    if (valid) {
+        return 1;
+    }
+
+    // Bit decomposition: V = sum of 2^i * b_i * G + s*H, with 2^i as public coefficients
+    enum { BITS = 8 };
+    uint8_t witness[(BITS + 1) * CSIGMA_SCALAR_BYTES]      = { 0 };
+    uint8_t coefficients[(BITS + 1) * CSIGMA_SCALAR_BYTES] = { 0 };
+    int     scalar_indices[BITS + 1], element_indices[BITS + 1];
+    uint8_t value = 0xa5;
+
+    csigma_relation_init(&relation);
+    int var_G = csigma_relation_add_element(&relation, G);
+    var_H     = csigma_relation_add_element(&relation, H);
+    for (int i = 0; i < BITS; i++) {
+        scalar_indices[i]                     = csigma_relation_add_scalar(&relation);
+        element_indices[i]                    = var_G;
+        witness[i * CSIGMA_SCALAR_BYTES]      = (value >> i) & 1;
+        coefficients[i * CSIGMA_SCALAR_BYTES] = (uint8_t) (1u << i);
+    }
+    scalar_indices[BITS]  = csigma_relation_add_scalar(&relation);
+    element_indices[BITS] = var_H;
+    memcpy(&coefficients[BITS * CSIGMA_SCALAR_BYTES], one, CSIGMA_SCALAR_BYTES);
+    crypto_core_ristretto255_scalar_random(&witness[BITS * CSIGMA_SCALAR_BYTES]);
+
+    csigma_relation_add_weighted_equation(&relation, 0, scalar_indices, element_indices,
+                                          coefficients, BITS + 1);
+
+    uint8_t V[CSIGMA_POINT_BYTES], sH[CSIGMA_POINT_BYTES], vG[CSIGMA_POINT_BYTES];
+    uint8_t value_scalar[CSIGMA_SCALAR_BYTES] = { value };
+    crypto_scalarmult_ristretto255_base(vG, value_scalar);
+    crypto_scalarmult_ristretto255(sH, &witness[BITS * CSIGMA_SCALAR_BYTES], H);
+    crypto_core_ristretto255_add(V, vG, sH);
+    memcpy(relation.image, V, CSIGMA_POINT_BYTES);
+
+    valid = prove_and_verify(&relation, witness, BITS + 1);
+    printf("Bit decomposition: %s\n", valid ? "VALID" : "INVALID");
+    if (!valid) {
+        return 1;
+    }
+
+    // The optimizer folds all bit terms on G into one scalar multiplication
+    csigma_optimize_stats_t stats;
+    if (csigma_relation_optimize(&relation, &stats) != 0 || stats.scalarmults_after != 2) {
+        printf("Optimizer did not fold weighted terms\n");
+        return 1;
+    }
+    valid = prove_and_verify(&relation, witness, BITS + 1);
+    printf("Bit decomposition (optimized): %s\n", valid ? "VALID" : "INVALID");
+    csigma_relation_destroy(&relation);
+
+    return valid ? 0 : 1;
+}
+
+int
+test_compact_state()
+{
+    printf("\n=== Testing Compact Prover State ===\n");
+
+    // V = sum of w_i * G_i over many scalars and two alternating bases
+    enum { SCALARS = 20000 };
+    uint8_t  one[CSIGMA_SCALAR_BYTES] = { 1 }, temp[CSIGMA_SCALAR_BYTES];
+    uint8_t  G[CSIGMA_POINT_BYTES], H[CSIGMA_POINT_BYTES], V[CSIGMA_POINT_BYTES];
+    uint8_t* witness         = malloc(SCALARS * CSIGMA_SCALAR_BYTES);
+    uint8_t* response        = malloc(SCALARS * CSIGMA_SCALAR_BYTES);
+    int*     scalar_indices  = malloc(SCALARS * sizeof(int));
+    int*     element_indices = malloc(SCALARS * sizeof(int));
+    crypto_scalarmult_ristretto255_base(G, one);
+    crypto_core_ristretto255_scalar_random(temp);
+    crypto_scalarmult_ristretto255_base(H, temp);
+
+    linear_relation_t relation;
+    csigma_relation_init(&relation);
+    int var_G = csigma_relation_add_element(&relation, G);
+    int var_H = csigma_relation_add_element(&relation, H);
+    for (int i = 0; i < SCALARS; i++) {
+        scalar_indices[i]  = csigma_relation_add_scalar(&relation);
+        element_indices[i] = i % 2 == 0 ? var_G : var_H;
+        crypto_core_ristretto255_scalar_random(&witness[i * CSIGMA_SCALAR_BYTES]);
+    }
+    csigma_relation_add_equation(&relation, 0, scalar_indices, element_indices, SCALARS);
+    linear_map_eval(&relation.map, witness, V);
+    memcpy(relation.image, V, CSIGMA_POINT_BYTES);
+
+    // The compact state holds no copy of the witness or the nonces
+    prover_state_t state;
+    uint8_t        commitment[CSIGMA_POINT_BYTES], challenge[CSIGMA_SCALAR_BYTES];
+    if (csigma_prover_commit_compact(&relation, witness, commitment, &state) != 0 ||
+        state.witness != NULL || state.nonces != NULL) {
+        printf("Compact commit failed\n");
+        return 1;
+    }
+    printf("Compact state: %zu bytes for %d scalars\n", sizeof(state), SCALARS);
+
+    // Responses can be computed more than once and always verify
+    crypto_core_ristretto255_scalar_random(challenge);
+    for (int pass = 0; pass < 2; pass++) {
+        csigma_prover_response(&state, challenge, response);
+        if (!csigma_verify(&relation, commitment, challenge, response)) {
+            printf("Compact response rejected\n");
+            return 1;
+        }
+    }
+    csigma_prover_state_destroy(&state);
+    printf("Compact response: VALID\n");
+
+    // A wrong witness still gives a rejected proof
+    witness[0] ^= 1;
+    csigma_prover_commit_compact(&relation, witness, commitment, &state);
+    csigma_prover_response(&state, challenge, response);
+    csigma_prover_state_destroy(&state);
+    if (csigma_verify(&relation, commitment, challenge, response)) {
+        printf("Wrong witness: INCORRECTLY ACCEPTED\n");
+        return 1;
+    }
+    printf("Wrong witness: CORRECTLY REJECTED\n");
+
+    csigma_relation_destroy(&relation);
+    free(witness);
+    free(response);
+    free(scalar_indices);
+    free(element_indices);
+    return 0;
+}
+
 int
 main()
 {
     test_schnorr_with_framework();
     test_dleq_with_framework();
+    if (test_weighted_equations() != 0) {
+        printf("\nWeighted equation tests failed\n");
+        return 1;
+    }
+    if (test_compact_state() != 0) {
+        printf("\nCompact prover state tests failed\n");
+        return 1;
+    }
 
     printf("\nAll framework tests passed\n");
     return 0;
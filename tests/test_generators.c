@@ -0,0 +1,124 @@
+#include "../generators.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHE_PATH "test_generators.cache"
+
+int
+main()
+{
+    printf("\n=== Testing Generator Derivation ===\n");
+
+    if (sodium_init() < 0) {
+        printf("Failed to initialize libsodium\n");
+        return 1;
+    }
+
+    const size_t n = 3000; // Large enough to use several threads
+    uint8_t*     a = malloc(n * CSIGMA_POINT_BYTES);
+    uint8_t*     b = malloc(n * CSIGMA_POINT_BYTES);
+    uint8_t      small[10 * CSIGMA_POINT_BYTES];
+
+    // Test 1: Derivation is deterministic and prefix-stable
+    printf("Test 1: Determinism... ");
+    if (csigma_derive_generators("csigma-test", n, a) != 0 ||
+        csigma_derive_generators("csigma-test", n, b) != 0 ||
+        csigma_derive_generators("csigma-test", 10, small) != 0) {
+        printf("Derivation failed\n");
+        return 1;
+    }
+    if (memcmp(a, b, n * CSIGMA_POINT_BYTES) != 0 || memcmp(a, small, sizeof(small)) != 0) {
+        printf("Derivation is not deterministic\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 2: Generators are valid, distinct and not the identity
+    printf("Test 2: Validity and distinctness... ");
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t* g = &a[i * CSIGMA_POINT_BYTES];
+        if (crypto_core_ristretto255_is_valid_point(g) != 1 ||
+            sodium_is_zero(g, CSIGMA_POINT_BYTES)) {
+            printf("Invalid generator %zu\n", i);
+            return 1;
+        }
+    }
+    for (size_t i = 0; i < 200; i++) {
+        for (size_t j = i + 1; j < n; j++) {
+            if (memcmp(&a[i * CSIGMA_POINT_BYTES], &a[j * CSIGMA_POINT_BYTES],
+                       CSIGMA_POINT_BYTES) == 0) {
+                printf("Generators %zu and %zu collide\n", i, j);
+                return 1;
+            }
+        }
+    }
+    printf("PASS\n");
+
+    // Test 3: Labels separate domains
+    printf("Test 3: Domain separation... ");
+    uint8_t other[10 * CSIGMA_POINT_BYTES];
+    csigma_derive_generators("csigma-test2", 10, other);
+    for (size_t i = 0; i < 10; i++) {
+        if (memcmp(&other[i * CSIGMA_POINT_BYTES], &small[i * CSIGMA_POINT_BYTES],
+                   CSIGMA_POINT_BYTES) == 0) {
+            printf("Labels share generator %zu\n", i);
+            return 1;
+        }
+    }
+    printf("PASS\n");
+
+    // Test 4: Persistent cache
+    printf("Test 4: Cache round-trip... ");
+    remove(CACHE_PATH);
+    memset(b, 0, n * CSIGMA_POINT_BYTES);
+    if (csigma_derive_generators_cached("csigma-test", n, b, CACHE_PATH) != 0 ||
+        memcmp(a, b, n * CSIGMA_POINT_BYTES) != 0) {
+        printf("Cold derivation mismatch\n");
+        return 1;
+    }
+    memset(b, 0, n * CSIGMA_POINT_BYTES);
+    if (csigma_derive_generators_cached("csigma-test", n, b, CACHE_PATH) != 0 ||
+        memcmp(a, b, n * CSIGMA_POINT_BYTES) != 0) {
+        printf("Cached derivation mismatch\n");
+        return 1;
+    }
+    memset(small, 0, sizeof(small));
+    if (csigma_derive_generators_cached("csigma-test", 10, small, CACHE_PATH) != 0 ||
+        memcmp(a, small, sizeof(small)) != 0) {
+        printf("Cached prefix mismatch\n");
+        return 1;
+    }
+    if (csigma_derive_generators_cached("csigma-test2", 10, small, CACHE_PATH) != 0 ||
+        memcmp(other, small, sizeof(small)) != 0) {
+        printf("Cache served another label\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 5: A corrupted cache is ignored
+    printf("Test 5: Corrupted cache... ");
+    csigma_derive_generators_cached("csigma-test", 100, b, CACHE_PATH);
+    FILE* fp = fopen(CACHE_PATH, "r+b");
+    if (!fp) {
+        printf("Cache file missing\n");
+        return 1;
+    }
+    fseek(fp, 100, SEEK_SET);
+    fputc(0xff, fp);
+    fclose(fp);
+    memset(b, 0, n * CSIGMA_POINT_BYTES);
+    if (csigma_derive_generators_cached("csigma-test", 100, b, CACHE_PATH) != 0 ||
+        memcmp(a, b, 100 * CSIGMA_POINT_BYTES) != 0) {
+        printf("Corrupted cache was used\n");
+        return 1;
+    }
+    remove(CACHE_PATH);
+    printf("PASS\n");
+
+    free(a);
+    free(b);
+
+    printf("\nAll generator tests passed\n");
+    return 0;
+}
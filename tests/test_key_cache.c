@@ -0,0 +1,186 @@
+#include "../key_cache.h"
+#include "../sigma.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_KEYS 8
+#define NUM_THREADS 4
+#define ROUNDS 8
+
+static uint8_t            keys[NUM_KEYS][CSIGMA_POINT_BYTES];
+static uint8_t            proofs[NUM_KEYS][CSIGMA_SCHNORR_PROOF_SIZE];
+static const uint8_t      message[] = "key cache test";
+static csigma_key_cache_t shared_cache;
+
+static void*
+verify_worker(void* arg)
+{
+    int* failures = arg;
+    for (size_t round = 0; round < ROUNDS; round++) {
+        for (size_t k = 0; k < NUM_KEYS; k++) {
+            if (!csigma_schnorr_verify_cached(&shared_cache, proofs[k], keys[k], message,
+                                              sizeof(message))) {
+                (*failures)++;
+            }
+        }
+    }
+    return NULL;
+}
+
+int
+main()
+{
+    printf("\n=== Testing Verifier Key Cache ===\n");
+
+    if (sodium_init() < 0) {
+        printf("Failed to initialize libsodium\n");
+        return 1;
+    }
+
+    for (size_t k = 0; k < NUM_KEYS; k++) {
+        uint8_t x[CSIGMA_SCALAR_BYTES];
+        crypto_core_ristretto255_scalar_random(x);
+        crypto_scalarmult_ristretto255_base(keys[k], x);
+        csigma_schnorr_prove(proofs[k], x, keys[k], message, sizeof(message));
+    }
+
+    // Test 1: Cached Schnorr verification agrees with the regular verifier
+    printf("Test 1: Schnorr through the cache... ");
+    if (csigma_key_cache_init(&shared_cache, 1 << 20) != 0) {
+        printf("Cache setup failed\n");
+        return 1;
+    }
+    for (size_t pass = 0; pass < 2; pass++) {
+        if (!csigma_schnorr_verify_cached(&shared_cache, proofs[0], keys[0], message,
+                                          sizeof(message)) ||
+            csigma_schnorr_verify_cached(&shared_cache, proofs[0], keys[0], message,
+                                         sizeof(message) - 1) ||
+            csigma_schnorr_verify_cached(&shared_cache, proofs[0], keys[1], message,
+                                         sizeof(message))) {
+            printf("Cached verification disagrees\n");
+            return 1;
+        }
+    }
+    uint8_t tampered[CSIGMA_SCHNORR_PROOF_SIZE];
+    for (size_t offset = 0; offset < sizeof(tampered); offset += 7) {
+        memcpy(tampered, proofs[2], sizeof(tampered));
+        tampered[offset] ^= 1;
+        if (csigma_schnorr_verify_cached(&shared_cache, tampered, keys[2], message,
+                                         sizeof(message)) !=
+            csigma_schnorr_verify(tampered, keys[2], message, sizeof(message))) {
+            printf("Cached verification disagrees on a tampered proof\n");
+            return 1;
+        }
+    }
+    uint8_t invalid_key[CSIGMA_POINT_BYTES];
+    memset(invalid_key, 0xff, sizeof(invalid_key));
+    if (csigma_schnorr_verify_cached(&shared_cache, proofs[0], invalid_key, message,
+                                     sizeof(message))) {
+        printf("Invalid key accepted\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 2: Cached DLEQ verification
+    printf("Test 2: DLEQ through the cache... ");
+    uint8_t x[CSIGMA_SCALAR_BYTES], g1[CSIGMA_POINT_BYTES], h1[CSIGMA_POINT_BYTES];
+    uint8_t g2[CSIGMA_POINT_BYTES], h2[CSIGMA_POINT_BYTES], dleq[CSIGMA_DLEQ_PROOF_SIZE];
+    crypto_core_ristretto255_scalar_random(x);
+    crypto_core_ristretto255_random(g1);
+    crypto_core_ristretto255_random(g2);
+    crypto_scalarmult_ristretto255(h1, x, g1);
+    crypto_scalarmult_ristretto255(h2, x, g2);
+    csigma_dleq_prove(dleq, x, g1, h1, g2, h2, message, sizeof(message));
+    for (size_t pass = 0; pass < 2; pass++) {
+        if (!csigma_dleq_verify_cached(&shared_cache, dleq, g1, h1, g2, h2, message,
+                                       sizeof(message)) ||
+            csigma_dleq_verify_cached(&shared_cache, dleq, g1, h1, g2, g2, message,
+                                      sizeof(message))) {
+            printf("Cached DLEQ verification disagrees\n");
+            return 1;
+        }
+    }
+    printf("PASS\n");
+
+    // Test 3: Concurrent verification of hot keys, with hit counters
+    printf("Test 3: Concurrent hot keys... ");
+    csigma_key_cache_stats_t before, after;
+    csigma_key_cache_stats(&shared_cache, &before);
+    pthread_t threads[NUM_THREADS];
+    int       failures[NUM_THREADS] = { 0 };
+    for (size_t t = 0; t < NUM_THREADS; t++) {
+        pthread_create(&threads[t], NULL, verify_worker, &failures[t]);
+    }
+    for (size_t t = 0; t < NUM_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+        if (failures[t] != 0) {
+            printf("Valid proofs rejected\n");
+            return 1;
+        }
+    }
+    csigma_key_cache_stats(&shared_cache, &after);
+    uint64_t lookups = after.hits + after.misses - before.hits - before.misses;
+    if (lookups != NUM_THREADS * ROUNDS * NUM_KEYS || after.misses - before.misses > NUM_KEYS ||
+        after.evictions != 0) {
+        printf("Unexpected counters\n");
+        return 1;
+    }
+    csigma_key_cache_destroy(&shared_cache);
+    printf("PASS\n");
+
+    // Test 4: The byte budget bounds the number of entries
+    printf("Test 4: Eviction under a small budget... ");
+    csigma_key_cache_t small;
+    csigma_key_cache_init(&small, 0);
+    for (size_t round = 0; round < 2; round++) {
+        for (size_t k = 0; k < NUM_KEYS; k++) {
+            if (!csigma_schnorr_verify_cached(&small, proofs[k], keys[k], message,
+                                              sizeof(message))) {
+                printf("Valid proof rejected\n");
+                return 1;
+            }
+        }
+    }
+    csigma_key_cache_stats(&small, &after);
+    if (after.entries > CSIGMA_KEY_CACHE_SHARDS || after.hits + after.misses != 2 * NUM_KEYS ||
+        after.misses != after.evictions + after.entries) {
+        printf("Unexpected counters\n");
+        return 1;
+    }
+    csigma_key_cache_destroy(&small);
+    printf("PASS\n");
+
+    // Test 5: Entries follow the transcript backend
+    printf("Test 5: Backend switch... ");
+    csigma_key_cache_t cache;
+    uint8_t            shake_proof[CSIGMA_SCHNORR_PROOF_SIZE];
+    uint8_t            blake2b_proof[CSIGMA_SCHNORR_PROOF_SIZE];
+    crypto_core_ristretto255_scalar_random(x);
+    crypto_scalarmult_ristretto255_base(keys[0], x);
+    csigma_schnorr_prove(shake_proof, x, keys[0], message, sizeof(message));
+    csigma_key_cache_init(&cache, 1 << 20);
+    bool shake_accepted =
+        csigma_schnorr_verify_cached(&cache, shake_proof, keys[0], message, sizeof(message));
+
+    csigma_transcript_set_hash(CSIGMA_HASH_BLAKE2B);
+    csigma_schnorr_prove(blake2b_proof, x, keys[0], message, sizeof(message));
+    bool blake2b_accepted =
+        csigma_schnorr_verify_cached(&cache, blake2b_proof, keys[0], message, sizeof(message));
+    bool stale_accepted =
+        csigma_schnorr_verify_cached(&cache, shake_proof, keys[0], message, sizeof(message));
+    csigma_transcript_set_hash(CSIGMA_HASH_SHAKE128);
+
+    if (!shake_accepted || !blake2b_accepted || stale_accepted ||
+        !csigma_schnorr_verify_cached(&cache, shake_proof, keys[0], message, sizeof(message)) ||
+        csigma_schnorr_verify_cached(&cache, blake2b_proof, keys[0], message, sizeof(message))) {
+        printf("Cached transcript used under another backend\n");
+        return 1;
+    }
+    csigma_key_cache_destroy(&cache);
+    printf("PASS\n");
+
+    printf("\nAll key cache tests passed\n");
+    return 0;
+}
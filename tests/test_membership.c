@@ -0,0 +1,172 @@
+#include "../generators.h"
+#include "../membership.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Random set of public keys; C is a re-randomization of the key at index
+static void
+make_statement(uint8_t* points, size_t num_points, size_t index, uint8_t r[CSIGMA_SCALAR_BYTES],
+               const uint8_t H[CSIGMA_POINT_BYTES], uint8_t C[CSIGMA_POINT_BYTES])
+{
+    for (size_t i = 0; i < num_points; i++) {
+        crypto_core_ristretto255_random(&points[i * CSIGMA_POINT_BYTES]);
+    }
+    crypto_core_ristretto255_scalar_random(r);
+    crypto_scalarmult_ristretto255(C, r, H);
+    crypto_core_ristretto255_add(C, C, &points[index * CSIGMA_POINT_BYTES]);
+}
+
+static int
+test_set(size_t num_points, size_t index, const uint8_t G[CSIGMA_POINT_BYTES],
+         const uint8_t H[CSIGMA_POINT_BYTES])
+{
+    uint8_t*           points = malloc(num_points * CSIGMA_POINT_BYTES);
+    size_t             len    = csigma_membership_proof_size(num_points);
+    uint8_t*           proof  = malloc(len);
+    uint8_t            r[CSIGMA_SCALAR_BYTES], C[CSIGMA_POINT_BYTES];
+    uint8_t            message[] = "membership test";
+    csigma_point_set_t set;
+    int                ret = 1;
+
+    make_statement(points, num_points, index, r, H, C);
+    csigma_point_set_init(&set, points, num_points);
+
+    if (csigma_membership_prove(proof, &set, index, r, G, H, C, message, sizeof(message)) != 0) {
+        printf("Prove failed\n");
+        goto done;
+    }
+    if (!csigma_membership_verify(proof, len, &set, G, H, C, message, sizeof(message))) {
+        printf("Valid proof rejected\n");
+        goto done;
+    }
+    if (csigma_membership_verify(proof, len, &set, G, H, C, message, sizeof(message) - 1)) {
+        printf("Wrong message accepted\n");
+        goto done;
+    }
+    proof[len - 1] ^= 1;
+    if (csigma_membership_verify(proof, len, &set, G, H, C, message, sizeof(message))) {
+        printf("Tampered proof accepted\n");
+        goto done;
+    }
+    ret = 0;
+
+done:
+    free(points);
+    free(proof);
+    return ret;
+}
+
+int
+main()
+{
+    printf("\n=== Testing One-out-of-Many Membership Proofs ===\n");
+
+    if (sodium_init() < 0) {
+        printf("Failed to initialize libsodium\n");
+        return 1;
+    }
+
+    uint8_t generators[2 * CSIGMA_POINT_BYTES];
+    csigma_derive_generators("membership test", 2, generators);
+    const uint8_t* G = &generators[0];
+    const uint8_t* H = &generators[CSIGMA_POINT_BYTES];
+
+    // Test 1: Proof size is logarithmic in the set size
+    printf("Test 1: Proof size... ");
+    if (csigma_membership_proof_size(1) != 224 + 32 ||
+        csigma_membership_proof_size(64) != 6 * 224 + 32 ||
+        csigma_membership_proof_size(65) != 7 * 224 + 32 ||
+        csigma_membership_proof_size(1 << 16) != 16 * 224 + 32) {
+        printf("Unexpected proof size\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 2: Power-of-two sets, including the first and last index
+    printf("Test 2: Sets of 64 points... ");
+    if (test_set(64, 0, G, H) != 0 || test_set(64, 37, G, H) != 0 ||
+        test_set(64, 63, G, H) != 0) {
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 3: Padded sets, with the prover's key before and at the padding boundary
+    printf("Test 3: Padded sets... ");
+    if (test_set(100, 42, G, H) != 0 || test_set(100, 99, G, H) != 0 ||
+        test_set(1, 0, G, H) != 0 || test_set(3, 2, G, H) != 0) {
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 4: A commitment to a key outside the set cannot be proven
+    printf("Test 4: Non-member rejected... ");
+    const size_t       num_points = 32;
+    uint8_t            points[32 * CSIGMA_POINT_BYTES];
+    uint8_t            r[CSIGMA_SCALAR_BYTES], C[CSIGMA_POINT_BYTES];
+    size_t             len = csigma_membership_proof_size(num_points);
+    uint8_t*           proof = malloc(len);
+    csigma_point_set_t set;
+
+    make_statement(points, num_points, 5, r, H, C);
+    csigma_point_set_init(&set, points, num_points);
+    if (csigma_membership_prove(proof, &set, 6, r, G, H, C, NULL, 0) != 0 ||
+        csigma_membership_verify(proof, len, &set, G, H, C, NULL, 0)) {
+        printf("Wrong index accepted\n");
+        return 1;
+    }
+    uint8_t wrong_r[CSIGMA_SCALAR_BYTES];
+    crypto_core_ristretto255_scalar_random(wrong_r);
+    if (csigma_membership_prove(proof, &set, 5, wrong_r, G, H, C, NULL, 0) != 0 ||
+        csigma_membership_verify(proof, len, &set, G, H, C, NULL, 0)) {
+        printf("Wrong randomness accepted\n");
+        return 1;
+    }
+    if (csigma_membership_prove(proof, &set, 5, r, G, H, C, NULL, 0) != 0 ||
+        !csigma_membership_verify(proof, len, &set, G, H, C, NULL, 0) ||
+        csigma_membership_verify(proof, len, &set, H, G, C, NULL, 0) ||
+        csigma_membership_verify(proof, len - 1, &set, G, H, C, NULL, 0)) {
+        printf("Statement binding failed\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 5: Memory-mapped point set
+    printf("Test 5: Memory-mapped set... ");
+    char  path[] = "/tmp/csigma_membership_XXXXXX";
+    int   fd     = mkstemp(path);
+    FILE* fp     = fd >= 0 ? fdopen(fd, "wb") : NULL;
+    if (!fp || fwrite(points, 1, sizeof(points), fp) != sizeof(points)) {
+        printf("Failed to write set\n");
+        return 1;
+    }
+    fclose(fp);
+
+    csigma_point_set_t mapped;
+    if (csigma_point_set_map(&mapped, path) != 0 || mapped.num_points != num_points) {
+        printf("Failed to map set\n");
+        unlink(path);
+        return 1;
+    }
+    if (!csigma_membership_verify(proof, len, &mapped, G, H, C, NULL, 0)) {
+        printf("Proof rejected with mapped set\n");
+        unlink(path);
+        return 1;
+    }
+    csigma_point_set_destroy(&mapped);
+
+    // A truncated file is not a set of points
+    if (truncate(path, sizeof(points) - 1) != 0 || csigma_point_set_map(&mapped, path) == 0) {
+        printf("Truncated set accepted\n");
+        unlink(path);
+        return 1;
+    }
+    unlink(path);
+    printf("PASS\n");
+
+    free(proof);
+
+    printf("\nAll membership proof tests passed\n");
+    return 0;
+}
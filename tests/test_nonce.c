@@ -0,0 +1,219 @@
+#include "../linear_relation.h"
+#include "../nonce.h"
+#include "../sigma.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define NUM_THREADS 4
+
+static void*
+random_worker(void* arg)
+{
+    csigma_random_bytes(arg, 32);
+    return NULL;
+}
+
+// A broken generator: every seed is the same
+static void
+constant_seed(uint8_t* seed, size_t len)
+{
+    memset(seed, 0x42, len);
+}
+
+int
+main()
+{
+    printf("\n=== Testing Hedged Nonces ===\n");
+
+    if (sodium_init() < 0) {
+        printf("Failed to initialize libsodium\n");
+        return 1;
+    }
+
+    // Test 1: The generator never repeats itself, across refills and reseeds
+    printf("Test 1: Buffered generator output... ");
+    size_t   len  = CSIGMA_RANDOM_RESEED_BYTES + 4096;
+    uint8_t* data = malloc(len);
+    for (size_t offset = 0; offset < len;) {
+        size_t count = 1 + offset % 97; // Reads of varying sizes straddle the buffer ends
+        if (count > len - offset) {
+            count = len - offset;
+        }
+        csigma_random_bytes(&data[offset], count);
+        offset += count;
+    }
+    for (size_t block = 1; block < len / 32; block++) {
+        if (memcmp(&data[0], &data[block * 32], 32) == 0) {
+            printf("Repeated output\n");
+            return 1;
+        }
+    }
+    if (sodium_is_zero(&data[len - 32], 32)) {
+        printf("Zero output\n");
+        return 1;
+    }
+    free(data);
+    printf("PASS\n");
+
+    // Test 2: Threads have independent streams
+    printf("Test 2: Per-thread streams... ");
+    uint8_t   outputs[NUM_THREADS][32];
+    pthread_t threads[NUM_THREADS];
+    for (size_t t = 0; t < NUM_THREADS; t++) {
+        pthread_create(&threads[t], NULL, random_worker, outputs[t]);
+    }
+    for (size_t t = 0; t < NUM_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    for (size_t t = 0; t < NUM_THREADS; t++) {
+        for (size_t u = t + 1; u < NUM_THREADS; u++) {
+            if (memcmp(outputs[t], outputs[u], 32) == 0) {
+                printf("Threads share a stream\n");
+                return 1;
+            }
+        }
+    }
+    printf("PASS\n");
+
+    // Test 3: A forked child does not replay the parent's stream
+    printf("Test 3: Fork safety... ");
+    uint8_t warm[1];
+    csigma_random_bytes(warm, sizeof(warm)); // Leave buffered bytes behind
+    int fds[2];
+    if (pipe(fds) != 0) {
+        printf("pipe() failed\n");
+        return 1;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        uint8_t child[32];
+        csigma_random_bytes(child, sizeof(child));
+        ssize_t written = write(fds[1], child, sizeof(child));
+        _exit(written == (ssize_t) sizeof(child) ? 0 : 1);
+    }
+    uint8_t parent[32], child[32];
+    csigma_random_bytes(parent, sizeof(parent));
+    int status;
+    if (pid < 0 || read(fds[0], child, sizeof(child)) != (ssize_t) sizeof(child) ||
+        waitpid(pid, &status, 0) != pid || status != 0) {
+        printf("Child failed\n");
+        return 1;
+    }
+    close(fds[0]);
+    close(fds[1]);
+    if (memcmp(parent, child, sizeof(parent)) == 0) {
+        printf("Child replayed the parent's stream\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 4: Nonces depend on the statement, the witness and the seed
+    printf("Test 4: Nonce derivation... ");
+    shake128_ctx transcript, other;
+    uint8_t      witness[2 * CSIGMA_SCALAR_BYTES];
+    uint8_t      a[3 * CSIGMA_SCALAR_BYTES], b[3 * CSIGMA_SCALAR_BYTES];
+    crypto_core_ristretto255_scalar_random(&witness[0]);
+    crypto_core_ristretto255_scalar_random(&witness[CSIGMA_SCALAR_BYTES]);
+    csigma_nonce_init(&transcript);
+    shake128_absorb(&transcript, (const uint8_t*) "statement", 9);
+    other = transcript;
+    csigma_nonce_derive(a, 3, &transcript, witness, sizeof(witness));
+    csigma_nonce_derive(b, 3, &other, witness, sizeof(witness));
+    if (memcmp(a, b, sizeof(a)) == 0 || memcmp(&a[0], &a[CSIGMA_SCALAR_BYTES], 32) == 0 ||
+        sodium_is_zero(&a[2 * CSIGMA_SCALAR_BYTES], 32)) {
+        printf("Nonces repeat\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 5: Proofs made with hedged nonces verify and differ from run to run
+    printf("Test 5: Proofs with hedged nonces... ");
+    uint8_t x[CSIGMA_SCALAR_BYTES], Y[CSIGMA_POINT_BYTES];
+    uint8_t p1[CSIGMA_SCHNORR_PROOF_SIZE], p2[CSIGMA_SCHNORR_PROOF_SIZE];
+    crypto_core_ristretto255_scalar_random(x);
+    crypto_scalarmult_ristretto255_base(Y, x);
+    csigma_schnorr_prove(p1, x, Y, NULL, 0);
+    csigma_schnorr_prove(p2, x, Y, NULL, 0);
+    if (!csigma_schnorr_verify(p1, Y, NULL, 0) || !csigma_schnorr_verify(p2, Y, NULL, 0) ||
+        memcmp(p1, p2, CSIGMA_POINT_BYTES) == 0) {
+        printf("Unexpected proofs\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 6: With a constant seed, nonces still differ whenever the challenge does
+    printf("Test 6: Nonces bound to the message... ");
+    uint8_t p3[CSIGMA_SCHNORR_PROOF_SIZE];
+    csigma_nonce_set_seed_source(constant_seed);
+    csigma_schnorr_prove(p1, x, Y, (const uint8_t*) "message 1", 9);
+    csigma_schnorr_prove(p2, x, Y, (const uint8_t*) "message 2", 9);
+    csigma_schnorr_prove(p3, x, Y, (const uint8_t*) "message 1", 9);
+    csigma_nonce_set_seed_source(NULL);
+    if (memcmp(p1, p3, CSIGMA_SCHNORR_PROOF_SIZE) != 0) {
+        printf("Seed source not used\n");
+        return 1;
+    }
+    if (memcmp(p1, p2, CSIGMA_POINT_BYTES) == 0) {
+        printf("Two messages share a commitment\n");
+        return 1;
+    }
+    if (!csigma_schnorr_verify(p1, Y, (const uint8_t*) "message 1", 9) ||
+        !csigma_schnorr_verify(p2, Y, (const uint8_t*) "message 2", 9)) {
+        printf("Proofs do not verify\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 7: Batched commitments derive each witness's nonces from its own statement
+    printf("Test 7: Batched nonces bound to each statement... ");
+    linear_relation_t relation;
+    uint8_t           generator[CSIGMA_POINT_BYTES], one[CSIGMA_SCALAR_BYTES] = { 1 };
+    uint8_t           witnesses[2 * CSIGMA_SCALAR_BYTES], images[2 * CSIGMA_POINT_BYTES];
+    uint8_t           contexts[2 * CSIGMA_NONCE_CONTEXT_BYTES];
+    uint8_t           batched[2 * CSIGMA_POINT_BYTES], single[CSIGMA_POINT_BYTES];
+    prover_state_t    states[2], state;
+    crypto_scalarmult_ristretto255_base(generator, one);
+    for (size_t j = 0; j < 2; j++) {
+        crypto_core_ristretto255_scalar_random(&witnesses[j * CSIGMA_SCALAR_BYTES]);
+        crypto_scalarmult_ristretto255_base(&images[j * CSIGMA_POINT_BYTES],
+                                            &witnesses[j * CSIGMA_SCALAR_BYTES]);
+    }
+    randombytes_buf(contexts, sizeof(contexts));
+    csigma_relation_init(&relation);
+    int G = csigma_relation_add_element(&relation, generator);
+    int X = csigma_relation_add_element(&relation, &images[0]);
+    csigma_relation_add_equation_simple(&relation, X, csigma_relation_add_scalar(&relation), G);
+    memcpy(relation.image, &images[0], CSIGMA_POINT_BYTES);
+
+    csigma_nonce_set_seed_source(constant_seed);
+    int ret = csigma_prover_commit_batch(&relation, witnesses, 2, images, contexts,
+                                         CSIGMA_NONCE_CONTEXT_BYTES, batched, states);
+    memcpy(relation.image, &images[CSIGMA_POINT_BYTES], CSIGMA_POINT_BYTES);
+    if (ret == 0) {
+        ret = csigma_prover_commit_with_context(&relation, &witnesses[CSIGMA_SCALAR_BYTES],
+                                                &contexts[CSIGMA_NONCE_CONTEXT_BYTES],
+                                                CSIGMA_NONCE_CONTEXT_BYTES, single, &state);
+    }
+    csigma_nonce_set_seed_source(NULL);
+    if (ret != 0) {
+        printf("Commit failed\n");
+        return 1;
+    }
+    bool same = memcmp(&batched[CSIGMA_POINT_BYTES], single, CSIGMA_POINT_BYTES) == 0;
+    csigma_prover_state_destroy(&states[0]);
+    csigma_prover_state_destroy(&states[1]);
+    csigma_prover_state_destroy(&state);
+    csigma_relation_destroy(&relation);
+    if (!same) {
+        printf("Second witness not committed under its own statement\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    printf("\nAll nonce tests passed\n");
+    return 0;
+}
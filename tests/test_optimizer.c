@@ -0,0 +1,151 @@
+#include "../optimizer.h"
+#include <stdio.h>
+#include <string.h>
+
+static void
+random_point(uint8_t point[CSIGMA_POINT_BYTES])
+{
+    uint8_t scalar[CSIGMA_SCALAR_BYTES];
+    crypto_core_ristretto255_scalar_random(scalar);
+    crypto_scalarmult_ristretto255_base(point, scalar);
+}
+
+// Builds three rows over G, H, K where G is added twice:
+//   row 0: x*G + r*H + y*K
+//   row 1: x*G' + r*H + z*K   (G' has the same encoding as G)
+//   row 2: x*G + x*G + r*H
+static void
+build_relation(linear_relation_t* relation, const uint8_t G[CSIGMA_POINT_BYTES],
+               const uint8_t H[CSIGMA_POINT_BYTES], const uint8_t K[CSIGMA_POINT_BYTES])
+{
+    csigma_relation_init(relation);
+
+    int x = csigma_relation_add_scalar(relation);
+    int r = csigma_relation_add_scalar(relation);
+    int y = csigma_relation_add_scalar(relation);
+    int z = csigma_relation_add_scalar(relation);
+
+    int var_G  = csigma_relation_add_element(relation, G);
+    int var_H  = csigma_relation_add_element(relation, H);
+    int var_K  = csigma_relation_add_element(relation, K);
+    int var_G2 = csigma_relation_add_element(relation, G);
+
+    int s0[] = { x, r, y }, e0[] = { var_G, var_H, var_K };
+    int s1[] = { x, r, z }, e1[] = { var_G2, var_H, var_K };
+    int s2[] = { x, x, r }, e2[] = { var_G, var_G2, var_H };
+    csigma_relation_add_equation(relation, 0, s0, e0, 3);
+    csigma_relation_add_equation(relation, 0, s1, e1, 3);
+    csigma_relation_add_equation(relation, 0, s2, e2, 3);
+}
+
+int
+main()
+{
+    printf("\n=== Testing Relation Optimizer ===\n");
+
+    if (sodium_init() < 0) {
+        printf("Failed to initialize libsodium\n");
+        return 1;
+    }
+
+    uint8_t G[CSIGMA_POINT_BYTES], H[CSIGMA_POINT_BYTES], K[CSIGMA_POINT_BYTES];
+    random_point(G);
+    random_point(H);
+    random_point(K);
+
+    uint8_t witness[4 * CSIGMA_SCALAR_BYTES];
+    for (int i = 0; i < 4; i++) {
+        crypto_core_ristretto255_scalar_random(&witness[i * CSIGMA_SCALAR_BYTES]);
+    }
+
+    // Test 1: Optimized evaluation matches the plain evaluation
+    printf("Test 1: Evaluation equivalence... ");
+    linear_relation_t relation;
+    build_relation(&relation, G, H, K);
+
+    uint8_t expected[3 * CSIGMA_POINT_BYTES], got[3 * CSIGMA_POINT_BYTES];
+    if (linear_map_eval(&relation.map, witness, expected) != 0) {
+        printf("Plain evaluation failed\n");
+        return 1;
+    }
+
+    csigma_optimize_stats_t stats;
+    if (csigma_relation_optimize(&relation, &stats) != 0) {
+        printf("Optimization failed\n");
+        return 1;
+    }
+    if (linear_map_eval(&relation.map, witness, got) != 0 ||
+        memcmp(expected, got, sizeof(expected)) != 0) {
+        printf("Optimized evaluation mismatch\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 2: Statistics
+    printf("Test 2: Statistics... ");
+    if (stats.elements_merged != 1 || stats.scalarmults_before != 9 ||
+        stats.scalarmults_after != 5 || csigma_optimize_scalarmults_saved(&stats) != 4 ||
+        stats.shared_products != 3 || stats.shared_sums != 1 ||
+        stats.additions_after >= stats.additions_before) {
+        printf("Unexpected statistics\n");
+        return 1;
+    }
+    printf("PASS (%zu scalar multiplications saved)\n", csigma_optimize_scalarmults_saved(&stats));
+
+    // Test 3: Prove and verify with the optimized relation
+    printf("Test 3: Proof with optimized relation... ");
+    memcpy(relation.image, expected, sizeof(expected));
+
+    prover_state_t state;
+    uint8_t        commitment[3 * CSIGMA_POINT_BYTES];
+    uint8_t        challenge[CSIGMA_SCALAR_BYTES];
+    uint8_t        response[4 * CSIGMA_SCALAR_BYTES];
+    if (csigma_prover_commit(&relation, witness, commitment, &state) != 0) {
+        printf("Prover commit failed\n");
+        return 1;
+    }
+    crypto_core_ristretto255_scalar_random(challenge);
+    csigma_prover_response(&state, challenge, response);
+    csigma_prover_state_destroy(&state);
+
+    if (!csigma_verify(&relation, commitment, challenge, response)) {
+        printf("Valid proof rejected\n");
+        return 1;
+    }
+    response[0] ^= 1;
+    if (csigma_verify(&relation, commitment, challenge, response)) {
+        printf("Invalid proof accepted\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 4: Modifying the relation discards the plan
+    printf("Test 4: Plan invalidation... ");
+    csigma_relation_set_element(&relation, 1, K);
+    if (relation.map.plan != NULL) {
+        printf("Plan survived modification\n");
+        return 1;
+    }
+    csigma_relation_destroy(&relation);
+    printf("PASS\n");
+
+    // Test 5: Malformed relations are rejected
+    printf("Test 5: Index validation... ");
+    csigma_relation_init(&relation);
+    int x = csigma_relation_add_scalar(&relation);
+    int g = csigma_relation_add_element(&relation, G);
+    csigma_relation_add_equation_simple(&relation, g, x, g + 1);
+    if (csigma_relation_optimize(&relation, NULL) == 0) {
+        printf("Out-of-range element index accepted\n");
+        return 1;
+    }
+    if (linear_map_eval(&relation.map, witness, got) == 0) {
+        printf("Out-of-range element index evaluated\n");
+        return 1;
+    }
+    csigma_relation_destroy(&relation);
+    printf("PASS\n");
+
+    printf("\nAll optimizer tests passed\n");
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include "../nonce.h"
+#include "../partial.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define NUM_WORKERS 4
+#define WIDE_TERMS 400
+#define NUM_ROWS 6
+
+static linear_relation_t relation;
+static uint8_t           commitment[NUM_ROWS * CSIGMA_POINT_BYTES];
+static uint8_t           challenge[CSIGMA_SCALAR_BYTES];
+static uint8_t*          response;
+
+// Evaluate the terms of the verification in worker processes, then merge the partials
+// in reverse order
+static bool
+verify_sharded(const uint8_t seed[CSIGMA_PARTIAL_SEED_BYTES])
+{
+    size_t total = csigma_partial_num_terms(&relation);
+    int    fds[NUM_WORKERS][2];
+    pid_t  pids[NUM_WORKERS];
+
+    for (size_t w = 0; w < NUM_WORKERS; w++) {
+        if (pipe(fds[w]) != 0)
+            return false;
+        pids[w] = fork();
+        if (pids[w] == 0) {
+            uint8_t partial[CSIGMA_PARTIAL_BYTES];
+            if (csigma_partial_eval(partial, &relation, commitment, challenge, response, seed,
+                                    total * w / NUM_WORKERS, total * (w + 1) / NUM_WORKERS) != 0)
+                _exit(1);
+            ssize_t written = write(fds[w][1], partial, sizeof(partial));
+            _exit(written == (ssize_t) sizeof(partial) ? 0 : 1);
+        }
+    }
+
+    uint8_t merged[CSIGMA_PARTIAL_BYTES];
+    bool    ok = true;
+    for (size_t i = 0; i < NUM_WORKERS; i++) {
+        size_t  w = NUM_WORKERS - 1 - i;
+        uint8_t partial[CSIGMA_PARTIAL_BYTES];
+        int     status;
+        if (pids[w] < 0 || read(fds[w][0], partial, sizeof(partial)) != (ssize_t) sizeof(partial) ||
+            waitpid(pids[w], &status, 0) != pids[w] || status != 0) {
+            ok = false;
+        } else if (i == 0) {
+            memcpy(merged, partial, sizeof(merged));
+        } else if (csigma_partial_merge(merged, partial, merged) != 0) {
+            ok = false;
+        }
+        close(fds[w][0]);
+        close(fds[w][1]);
+    }
+    return ok && csigma_partial_finish(merged, &relation, seed);
+}
+
+int
+main()
+{
+    printf("\n=== Testing Partial Evaluation ===\n");
+
+    if (sodium_init() < 0) {
+        printf("Failed to initialize libsodium\n");
+        return 1;
+    }
+
+    // One wide equation over many elements, then narrow equations sharing them
+    uint8_t  elements[WIDE_TERMS][CSIGMA_POINT_BYTES];
+    uint8_t* witness = malloc(WIDE_TERMS * CSIGMA_SCALAR_BYTES);
+    int      scalars[WIDE_TERMS], indices[WIDE_TERMS];
+    response = malloc(WIDE_TERMS * CSIGMA_SCALAR_BYTES);
+    csigma_relation_init(&relation);
+    csigma_relation_allocate_scalars(&relation, WIDE_TERMS);
+    for (size_t i = 0; i < WIDE_TERMS; i++) {
+        crypto_core_ristretto255_random(elements[i]);
+        crypto_core_ristretto255_scalar_random(&witness[i * CSIGMA_SCALAR_BYTES]);
+        scalars[i] = (int) i;
+        indices[i] = csigma_relation_add_element(&relation, elements[i]);
+    }
+    csigma_relation_add_equation(&relation, 0, scalars, indices, WIDE_TERMS);
+    for (size_t row = 1; row < NUM_ROWS; row++) {
+        csigma_relation_add_equation(&relation, (int) row, &scalars[row], &indices[2 * row], 3);
+    }
+    csigma_relation_set_constant(&relation, 2, indices[0], NULL);
+    linear_map_eval(&relation.map, witness, relation.image);
+    crypto_core_ristretto255_add(&relation.image[2 * CSIGMA_POINT_BYTES],
+                                 &relation.image[2 * CSIGMA_POINT_BYTES], elements[0]);
+
+    prover_state_t state;
+    crypto_core_ristretto255_scalar_random(challenge);
+    csigma_prover_commit(&relation, witness, commitment, &state);
+    csigma_prover_response(&state, challenge, response);
+    csigma_prover_state_destroy(&state);
+
+    uint8_t seed[CSIGMA_PARTIAL_SEED_BYTES];
+    csigma_random_bytes(seed, sizeof(seed));
+
+    // Test 1: Sharded verification agrees with csigma_verify()
+    printf("Test 1: Multi-process verification... ");
+    if (!csigma_verify(&relation, commitment, challenge, response) || !verify_sharded(seed)) {
+        printf("Valid transcript rejected\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 2: Invalid transcripts are rejected, wherever the error lies
+    printf("Test 2: Invalid transcripts... ");
+    uint8_t saved[CSIGMA_SCALAR_BYTES];
+    memcpy(saved, &response[WIDE_TERMS / 2 * CSIGMA_SCALAR_BYTES], sizeof(saved));
+    crypto_core_ristretto255_scalar_random(&response[WIDE_TERMS / 2 * CSIGMA_SCALAR_BYTES]);
+    if (verify_sharded(seed)) {
+        printf("Tampered response accepted\n");
+        return 1;
+    }
+    memcpy(&response[WIDE_TERMS / 2 * CSIGMA_SCALAR_BYTES], saved, sizeof(saved));
+    memcpy(&commitment[4 * CSIGMA_POINT_BYTES], elements[1], CSIGMA_POINT_BYTES);
+    if (verify_sharded(seed)) {
+        printf("Tampered commitment accepted\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 3: Partials must be adjacent, of the same job, and cover every term
+    printf("Test 3: Merging rules... ");
+    size_t  total = csigma_partial_num_terms(&relation);
+    uint8_t a[CSIGMA_PARTIAL_BYTES], b[CSIGMA_PARTIAL_BYTES], c[CSIGMA_PARTIAL_BYTES];
+    uint8_t other_seed[CSIGMA_PARTIAL_SEED_BYTES], merged[CSIGMA_PARTIAL_BYTES];
+    csigma_random_bytes(other_seed, sizeof(other_seed));
+    csigma_partial_eval(a, &relation, commitment, challenge, response, seed, 0, 10);
+    csigma_partial_eval(b, &relation, commitment, challenge, response, seed, 11, total);
+    csigma_partial_eval(c, &relation, commitment, challenge, response, other_seed, 10, 11);
+    if (csigma_partial_merge(merged, a, b) == 0 || csigma_partial_merge(merged, a, c) == 0 ||
+        csigma_partial_finish(a, &relation, seed) ||
+        csigma_partial_eval(a, &relation, commitment, challenge, response, seed, 0, total + 1) ==
+            0) {
+        printf("Invalid merge accepted\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    free(witness);
+    free(response);
+    csigma_relation_destroy(&relation);
+    printf("\nAll partial evaluation tests passed\n");
+    return 0;
+}
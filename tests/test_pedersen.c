@@ -1,7 +1,16 @@
+#include "../nonce.h"
 #include "../pedersen.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+// A broken generator: every seed is the same
+static void
+constant_seed(uint8_t* seed, size_t len)
+{
+    memset(seed, 0x42, len);
+}
+
 void
 test_pedersen()
 {
@@ -78,10 +87,213 @@ test_pedersen()
     }
 }
 
+int
+test_vector_pedersen()
+{
+    printf("\n=== Testing Vector Pedersen Commitment Proof ===\n");
+
+    const size_t n          = 64;
+    uint8_t*     generators = malloc(n * CSIGMA_POINT_BYTES);
+    uint8_t*     values     = malloc(n * CSIGMA_SCALAR_BYTES);
+    uint8_t*     proof      = malloc(csigma_pedersen_vector_proof_size(n));
+    uint8_t      H[CSIGMA_POINT_BYTES], C[CSIGMA_POINT_BYTES], expected[CSIGMA_POINT_BYTES];
+    uint8_t      randomness[CSIGMA_SCALAR_BYTES];
+    size_t       proof_len = csigma_pedersen_vector_proof_size(n);
+    uint8_t      message[] = "Vector Pedersen commitment proof test";
+
+    for (size_t i = 0; i < n; i++) {
+        crypto_core_ristretto255_random(&generators[i * CSIGMA_POINT_BYTES]);
+        crypto_core_ristretto255_scalar_random(&values[i * CSIGMA_SCALAR_BYTES]);
+    }
+    crypto_core_ristretto255_random(H);
+    crypto_core_ristretto255_scalar_random(randomness);
+
+    // Commitment matches the term-by-term definition
+    if (csigma_pedersen_vector_commit(C, values, randomness, generators, n, H) != 0) {
+        printf("Failed to create vector commitment\n");
+        return 1;
+    }
+    crypto_scalarmult_ristretto255(expected, randomness, H);
+    for (size_t i = 0; i < n; i++) {
+        uint8_t term[CSIGMA_POINT_BYTES];
+        crypto_scalarmult_ristretto255(term, &values[i * CSIGMA_SCALAR_BYTES],
+                                       &generators[i * CSIGMA_POINT_BYTES]);
+        crypto_core_ristretto255_add(expected, expected, term);
+    }
+    if (memcmp(C, expected, CSIGMA_POINT_BYTES) != 0) {
+        printf("Vector commitment mismatch\n");
+        return 1;
+    }
+    printf("Created vector commitment to %zu values\n", n);
+
+    if (csigma_pedersen_vector_prove(proof, values, randomness, generators, n, H, C, message,
+                                     sizeof(message)) != 0) {
+        printf("Failed to create proof\n");
+        return 1;
+    }
+    printf("Created proof (%zu bytes)\n", proof_len);
+
+    if (!csigma_pedersen_vector_verify(proof, proof_len, generators, n, H, C, message,
+                                       sizeof(message))) {
+        printf("Proof verification failed\n");
+        return 1;
+    }
+    printf("Proof verified successfully\n");
+
+    // Wrong message, wrong length, swapped generators and tampered responses
+    if (csigma_pedersen_vector_verify(proof, proof_len, generators, n, H, C, message,
+                                      sizeof(message) - 1) ||
+        csigma_pedersen_vector_verify(proof, proof_len - 1, generators, n, H, C, message,
+                                      sizeof(message)) ||
+        csigma_pedersen_vector_verify(proof, proof_len, generators, n - 1, H, C, message,
+                                      sizeof(message))) {
+        printf("Incorrectly accepted invalid proof\n");
+        return 1;
+    }
+    uint8_t swap[CSIGMA_POINT_BYTES];
+    memcpy(swap, &generators[0], CSIGMA_POINT_BYTES);
+    memcpy(&generators[0], &generators[CSIGMA_POINT_BYTES], CSIGMA_POINT_BYTES);
+    memcpy(&generators[CSIGMA_POINT_BYTES], swap, CSIGMA_POINT_BYTES);
+    if (csigma_pedersen_vector_verify(proof, proof_len, generators, n, H, C, message,
+                                      sizeof(message))) {
+        printf("Incorrectly accepted proof with swapped generators\n");
+        return 1;
+    }
+    memcpy(&generators[CSIGMA_POINT_BYTES], &generators[0], CSIGMA_POINT_BYTES);
+    memcpy(&generators[0], swap, CSIGMA_POINT_BYTES);
+    proof[proof_len - 1] ^= 0x01;
+    if (csigma_pedersen_vector_verify(proof, proof_len, generators, n, H, C, message,
+                                      sizeof(message))) {
+        printf("Incorrectly accepted tampered proof\n");
+        return 1;
+    }
+    printf("Correctly rejected invalid proofs\n");
+
+    // A vector of length one is an ordinary Pedersen commitment
+    uint8_t single[CSIGMA_POINT_BYTES];
+    csigma_pedersen_commit(expected, values, randomness, generators, H);
+    csigma_pedersen_vector_commit(single, values, randomness, generators, 1, H);
+    if (memcmp(single, expected, CSIGMA_POINT_BYTES) != 0) {
+        printf("Single-value vector commitment mismatch\n");
+        return 1;
+    }
+
+    free(generators);
+    free(values);
+    free(proof);
+    return 0;
+}
+
+int
+test_batch_pedersen()
+{
+    printf("\n=== Testing Batch Pedersen Commitments and Proofs ===\n");
+
+    const size_t    n          = 48;
+    uint8_t*        values     = malloc(n * CSIGMA_SCALAR_BYTES);
+    uint8_t*        randomness = malloc(n * CSIGMA_SCALAR_BYTES);
+    uint8_t*        C          = malloc(n * CSIGMA_POINT_BYTES);
+    uint8_t*        proofs     = malloc(n * CSIGMA_PEDERSEN_PROOF_SIZE);
+    const uint8_t** messages   = malloc(n * sizeof(uint8_t*));
+    size_t*         lens       = malloc(n * sizeof(size_t));
+    uint8_t         G[CSIGMA_POINT_BYTES], H[CSIGMA_POINT_BYTES];
+    static uint8_t  labels[48][16];
+
+    crypto_core_ristretto255_random(G);
+    crypto_core_ristretto255_random(H);
+    for (size_t i = 0; i < n; i++) {
+        crypto_core_ristretto255_scalar_random(&values[i * CSIGMA_SCALAR_BYTES]);
+        crypto_core_ristretto255_scalar_random(&randomness[i * CSIGMA_SCALAR_BYTES]);
+        snprintf((char*) labels[i], sizeof(labels[i]), "amount %zu", i);
+        messages[i] = labels[i];
+        lens[i]     = strlen((const char*) labels[i]);
+    }
+    memset(&values[5 * CSIGMA_SCALAR_BYTES], 0, CSIGMA_SCALAR_BYTES); // Zero amount
+
+    // Commitments match the single-item function, with any number of threads
+    for (size_t threads = 0; threads <= 4; threads += 2) {
+        if (csigma_pedersen_commit_batch(C, values, randomness, n, G, H, threads) != 0) {
+            printf("Failed to create batch commitments\n");
+            return 1;
+        }
+        for (size_t i = 0; i < n; i++) {
+            uint8_t expected[CSIGMA_POINT_BYTES];
+            csigma_pedersen_commit(expected, &values[i * CSIGMA_SCALAR_BYTES],
+                                   &randomness[i * CSIGMA_SCALAR_BYTES], G, H);
+            if (memcmp(expected, &C[i * CSIGMA_POINT_BYTES], CSIGMA_POINT_BYTES) != 0) {
+                printf("Batch commitment mismatch\n");
+                return 1;
+            }
+        }
+    }
+    printf("Created %zu commitments\n", n);
+
+    // Every proof verifies on its own, with and without messages
+    for (size_t pass = 0; pass < 2; pass++) {
+        const uint8_t* const* msgs = pass == 0 ? messages : NULL;
+        if (csigma_pedersen_prove_batch(proofs, values, randomness, n, G, H, C, msgs, lens,
+                                        pass == 0 ? 3 : 0) != 0) {
+            printf("Failed to create batch proofs\n");
+            return 1;
+        }
+        for (size_t i = 0; i < n; i++) {
+            const uint8_t* proof = &proofs[i * CSIGMA_PEDERSEN_PROOF_SIZE];
+            const uint8_t* Ci    = &C[i * CSIGMA_POINT_BYTES];
+            if (!csigma_pedersen_verify(proof, G, H, Ci, msgs ? messages[i] : NULL,
+                                        msgs ? lens[i] : 0)) {
+                printf("Batch proof %zu rejected\n", i);
+                return 1;
+            }
+        }
+    }
+    printf("Verified %zu proofs\n", n);
+
+    // Proofs are bound to their own commitment and message
+    int ret = csigma_pedersen_prove_batch(proofs, values, randomness, n, G, H, C, messages, lens, 0);
+    if (ret != 0 ||
+        csigma_pedersen_verify(&proofs[0], G, H, &C[CSIGMA_POINT_BYTES], messages[0], lens[0]) ||
+        csigma_pedersen_verify(&proofs[0], G, H, &C[0], messages[1], lens[1])) {
+        printf("Incorrectly accepted a swapped proof\n");
+        return 1;
+    }
+    printf("Correctly rejected swapped proofs\n");
+
+    // With a fixed seed, batch proofs equal single proofs: nonces follow each proof's C
+    csigma_nonce_set_seed_source(constant_seed);
+    ret = csigma_pedersen_prove_batch(proofs, values, randomness, n, G, H, C, messages, lens, 2);
+    for (size_t i = 0; i < n && ret == 0; i++) {
+        uint8_t expected[CSIGMA_PEDERSEN_PROOF_SIZE];
+        ret = csigma_pedersen_prove(expected, &values[i * CSIGMA_SCALAR_BYTES],
+                                    &randomness[i * CSIGMA_SCALAR_BYTES], G, H,
+                                    &C[i * CSIGMA_POINT_BYTES], messages[i], lens[i]);
+        if (ret == 0 && memcmp(expected, &proofs[i * CSIGMA_PEDERSEN_PROOF_SIZE],
+                               CSIGMA_PEDERSEN_PROOF_SIZE) != 0) {
+            ret = -1;
+        }
+    }
+    csigma_nonce_set_seed_source(NULL);
+    if (ret != 0) {
+        printf("Batch proof differs from single proof\n");
+        return 1;
+    }
+    printf("Batch proofs match single proofs\n");
+
+    free(values);
+    free(randomness);
+    free(C);
+    free(proofs);
+    free(messages);
+    free(lens);
+    return 0;
+}
+
 int
 main()
 {
     test_pedersen();
+    if (test_vector_pedersen() != 0 || test_batch_pedersen() != 0) {
+        return 1;
+    }
     printf("\nPedersen tests passed\n");
     return 0;
 }
@@ -0,0 +1,145 @@
+#include "../generators.h"
+#include "../pedersen.h"
+#include "../range.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// C = value*G + r*H
+static void
+commit_value(uint8_t C[CSIGMA_POINT_BYTES], uint8_t r[CSIGMA_SCALAR_BYTES], uint64_t value,
+             const uint8_t G[CSIGMA_POINT_BYTES], const uint8_t H[CSIGMA_POINT_BYTES])
+{
+    uint8_t v[CSIGMA_SCALAR_BYTES] = { 0 };
+    for (size_t i = 0; i < 8; i++) {
+        v[i] = (uint8_t) (value >> (8 * i));
+    }
+    crypto_core_ristretto255_scalar_random(r);
+    csigma_pedersen_commit(C, v, r, G, H);
+}
+
+int
+main()
+{
+    printf("\n=== Testing Range Proofs ===\n");
+
+    if (sodium_init() < 0) {
+        printf("Failed to initialize libsodium\n");
+        return 1;
+    }
+
+    uint8_t generators[2 * CSIGMA_POINT_BYTES];
+    csigma_derive_generators("range test", 2, generators);
+    const uint8_t* G = &generators[0];
+    const uint8_t* H = &generators[CSIGMA_POINT_BYTES];
+
+    uint8_t message[] = "range test";
+    uint8_t C[CSIGMA_POINT_BYTES], r[CSIGMA_SCALAR_BYTES];
+
+    // Test 1: Values across the whole range, including both ends
+    printf("Test 1: 32-bit values... ");
+    const size_t   bits     = 32;
+    size_t         len      = csigma_range_proof_size(bits);
+    uint8_t*       proof    = malloc(len);
+    const uint64_t values[] = { 0, 1, 12345, 0x80000000u, 0xffffffffu };
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        commit_value(C, r, values[i], G, H);
+        if (csigma_range_prove(proof, values[i], r, bits, G, H, C, message, sizeof(message)) != 0 ||
+            !csigma_range_verify(proof, len, bits, G, H, C, message, sizeof(message))) {
+            printf("Value %llu failed\n", (unsigned long long) values[i]);
+            return 1;
+        }
+    }
+    printf("PASS\n");
+
+    // Test 2: Out-of-range values cannot be proven
+    printf("Test 2: Out-of-range values... ");
+    commit_value(C, r, 1ull << bits, G, H);
+    if (csigma_range_prove(proof, 1ull << bits, r, bits, G, H, C, NULL, 0) == 0) {
+        printf("Out-of-range value proven\n");
+        return 1;
+    }
+    // A proof for the truncated value does not match the commitment
+    if (csigma_range_prove(proof, 0, r, bits, G, H, C, NULL, 0) != 0 ||
+        csigma_range_verify(proof, len, bits, G, H, C, NULL, 0)) {
+        printf("Proof for a different value accepted\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 3: Tampering and statement binding
+    printf("Test 3: Tampered proofs... ");
+    commit_value(C, r, 77, G, H);
+    csigma_range_prove(proof, 77, r, bits, G, H, C, message, sizeof(message));
+    if (csigma_range_verify(proof, len, bits, G, H, C, message, sizeof(message) - 1) ||
+        csigma_range_verify(proof, len, bits, H, G, C, message, sizeof(message)) ||
+        csigma_range_verify(proof, len - 1, bits, G, H, C, message, sizeof(message))) {
+        printf("Modified statement accepted\n");
+        return 1;
+    }
+    for (size_t offset = 0; offset < len; offset += len / 6) {
+        proof[offset] ^= 1;
+        if (csigma_range_verify(proof, len, bits, G, H, C, message, sizeof(message))) {
+            printf("Tampered proof accepted at offset %zu\n", offset);
+            return 1;
+        }
+        proof[offset] ^= 1;
+    }
+    printf("PASS\n");
+
+    // Test 4: 64-bit and 1-bit ranges
+    printf("Test 4: Range bounds... ");
+    uint8_t* proof64 = malloc(csigma_range_proof_size(64));
+    commit_value(C, r, UINT64_MAX, G, H);
+    if (csigma_range_prove(proof64, UINT64_MAX, r, 64, G, H, C, NULL, 0) != 0 ||
+        !csigma_range_verify(proof64, csigma_range_proof_size(64), 64, G, H, C, NULL, 0)) {
+        printf("64-bit range failed\n");
+        return 1;
+    }
+    commit_value(C, r, 1, G, H);
+    if (csigma_range_prove(proof64, 1, r, 1, G, H, C, NULL, 0) != 0 ||
+        !csigma_range_verify(proof64, csigma_range_proof_size(1), 1, G, H, C, NULL, 0) ||
+        csigma_range_proof_size(0) != 0 || csigma_range_proof_size(65) != 0) {
+        printf("1-bit range failed\n");
+        return 1;
+    }
+    free(proof64);
+    printf("PASS\n");
+
+    // Test 5: Batch verification
+    printf("Test 5: Batch of 16 proofs... ");
+    const size_t   n           = 16;
+    uint8_t*       proofs      = malloc(n * len);
+    uint8_t*       commitments = malloc(n * CSIGMA_POINT_BYTES);
+    const uint8_t* messages[16];
+    size_t         message_lens[16];
+    for (size_t j = 0; j < n; j++) {
+        uint64_t value = (uint64_t) j * 1000003u;
+        commit_value(&commitments[j * CSIGMA_POINT_BYTES], r, value, G, H);
+        messages[j]     = message;
+        message_lens[j] = j % sizeof(message);
+        if (csigma_range_prove(&proofs[j * len], value, r, bits, G, H,
+                               &commitments[j * CSIGMA_POINT_BYTES], messages[j],
+                               message_lens[j]) != 0) {
+            printf("Prove failed\n");
+            return 1;
+        }
+    }
+    if (!csigma_range_batch_verify(proofs, commitments, n, bits, G, H, messages, message_lens)) {
+        printf("Valid batch rejected\n");
+        return 1;
+    }
+    proofs[5 * len + 3 * CSIGMA_POINT_BYTES] ^= 1;
+    if (csigma_range_batch_verify(proofs, commitments, n, bits, G, H, messages, message_lens)) {
+        printf("Batch with a tampered proof accepted\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    free(proofs);
+    free(commitments);
+    free(proof);
+
+    printf("\nAll range proof tests passed\n");
+    return 0;
+}
@@ -0,0 +1,232 @@
+#include "../pedersen.h"
+#include "../result_cache.h"
+#include "../sigma.h"
+#include "../transcript.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define NUM_PROOFS 8
+#define NUM_THREADS 4
+#define ROUNDS 8
+
+static uint8_t               keys[NUM_PROOFS][CSIGMA_POINT_BYTES];
+static uint8_t               proofs[NUM_PROOFS][CSIGMA_SCHNORR_PROOF_SIZE];
+static const uint8_t         message[] = "result cache test";
+static csigma_result_cache_t shared_cache;
+
+static void*
+verify_worker(void* arg)
+{
+    int* failures = arg;
+    for (size_t round = 0; round < ROUNDS; round++) {
+        for (size_t k = 0; k < NUM_PROOFS; k++) {
+            if (!csigma_schnorr_verify_memo(&shared_cache, proofs[k], keys[k], message,
+                                            sizeof(message))) {
+                (*failures)++;
+            }
+        }
+    }
+    return NULL;
+}
+
+int
+main()
+{
+    printf("\n=== Testing Verification Result Cache ===\n");
+
+    if (sodium_init() < 0) {
+        printf("Failed to initialize libsodium\n");
+        return 1;
+    }
+
+    for (size_t k = 0; k < NUM_PROOFS; k++) {
+        uint8_t x[CSIGMA_SCALAR_BYTES];
+        crypto_core_ristretto255_scalar_random(x);
+        crypto_scalarmult_ristretto255_base(keys[k], x);
+        csigma_schnorr_prove(proofs[k], x, keys[k], message, sizeof(message));
+    }
+
+    // Test 1: A repeated proof is a hit; changing any input is a miss
+    printf("Test 1: Duplicate Schnorr proofs... ");
+    if (csigma_result_cache_init(&shared_cache, 1 << 12, 60 * 1000) != 0) {
+        printf("Cache setup failed\n");
+        return 1;
+    }
+    uint64_t hits, misses;
+    for (size_t pass = 0; pass < 3; pass++) {
+        if (!csigma_schnorr_verify_memo(&shared_cache, proofs[0], keys[0], message,
+                                        sizeof(message))) {
+            printf("Valid proof rejected\n");
+            return 1;
+        }
+    }
+    csigma_result_cache_stats(&shared_cache, &hits, &misses);
+    if (hits != 2 || misses != 1) {
+        printf("Unexpected counters\n");
+        return 1;
+    }
+    if (csigma_schnorr_verify_memo(&shared_cache, proofs[0], keys[0], message,
+                                   sizeof(message) - 1) ||
+        csigma_schnorr_verify_memo(&shared_cache, proofs[0], keys[1], message, sizeof(message)) ||
+        csigma_schnorr_verify_memo(&shared_cache, proofs[0], keys[0], NULL, 0)) {
+        printf("Cached result reused for different inputs\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 2: Rejections are never stored
+    printf("Test 2: Negative results are not cached... ");
+    uint8_t tampered[CSIGMA_SCHNORR_PROOF_SIZE];
+    memcpy(tampered, proofs[1], sizeof(tampered));
+    tampered[CSIGMA_POINT_BYTES] ^= 1;
+    csigma_result_cache_stats(&shared_cache, &hits, &misses);
+    uint64_t hits_before = hits;
+    for (size_t pass = 0; pass < 3; pass++) {
+        if (csigma_schnorr_verify_memo(&shared_cache, tampered, keys[1], message,
+                                       sizeof(message))) {
+            printf("Tampered proof accepted\n");
+            return 1;
+        }
+    }
+    csigma_result_cache_stats(&shared_cache, &hits, &misses);
+    if (hits != hits_before) {
+        printf("Rejected proof was cached\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 3: DLEQ and Pedersen wrappers
+    printf("Test 3: DLEQ and Pedersen proofs... ");
+    uint8_t x[CSIGMA_SCALAR_BYTES], r[CSIGMA_SCALAR_BYTES];
+    uint8_t g1[CSIGMA_POINT_BYTES], h1[CSIGMA_POINT_BYTES], g2[CSIGMA_POINT_BYTES];
+    uint8_t h2[CSIGMA_POINT_BYTES], C[CSIGMA_POINT_BYTES];
+    uint8_t dleq[CSIGMA_DLEQ_PROOF_SIZE], pedersen[CSIGMA_PEDERSEN_PROOF_SIZE];
+    crypto_core_ristretto255_scalar_random(x);
+    crypto_core_ristretto255_scalar_random(r);
+    crypto_core_ristretto255_random(g1);
+    crypto_core_ristretto255_random(g2);
+    crypto_scalarmult_ristretto255(h1, x, g1);
+    crypto_scalarmult_ristretto255(h2, x, g2);
+    csigma_dleq_prove(dleq, x, g1, h1, g2, h2, message, sizeof(message));
+    csigma_pedersen_commit(C, x, r, g1, g2);
+    csigma_pedersen_prove(pedersen, x, r, g1, g2, C, message, sizeof(message));
+    for (size_t pass = 0; pass < 2; pass++) {
+        if (!csigma_dleq_verify_memo(&shared_cache, dleq, g1, h1, g2, h2, message,
+                                     sizeof(message)) ||
+            csigma_dleq_verify_memo(&shared_cache, dleq, g1, h1, g2, g2, message,
+                                    sizeof(message)) ||
+            !csigma_pedersen_verify_memo(&shared_cache, pedersen, g1, g2, C, message,
+                                         sizeof(message)) ||
+            csigma_pedersen_verify_memo(&shared_cache, pedersen, g2, g1, C, message,
+                                        sizeof(message))) {
+            printf("Cached verification disagrees\n");
+            return 1;
+        }
+    }
+    printf("PASS\n");
+
+    // Test 4: Concurrent duplicates
+    printf("Test 4: Concurrent duplicates... ");
+    csigma_result_cache_clear(&shared_cache);
+    csigma_result_cache_stats(&shared_cache, &hits_before, &misses);
+    uint64_t  misses_before = misses;
+    pthread_t threads[NUM_THREADS];
+    int       failures[NUM_THREADS] = { 0 };
+    for (size_t t = 0; t < NUM_THREADS; t++) {
+        pthread_create(&threads[t], NULL, verify_worker, &failures[t]);
+    }
+    for (size_t t = 0; t < NUM_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+        if (failures[t] != 0) {
+            printf("Valid proofs rejected\n");
+            return 1;
+        }
+    }
+    csigma_result_cache_stats(&shared_cache, &hits, &misses);
+    if (hits + misses - hits_before - misses_before != NUM_THREADS * ROUNDS * NUM_PROOFS ||
+        misses - misses_before > NUM_THREADS * NUM_PROOFS) {
+        printf("Unexpected counters\n");
+        return 1;
+    }
+    csigma_result_cache_destroy(&shared_cache);
+    printf("PASS\n");
+
+    // Test 5: Entries expire after the TTL
+    printf("Test 5: TTL expiry... ");
+    csigma_result_cache_t cache;
+    csigma_result_cache_init(&cache, 1 << 10, 50);
+    uint8_t digest[CSIGMA_RESULT_CACHE_DIGEST_BYTES];
+    const uint8_t* inputs[] = { message };
+    size_t         lens[]   = { sizeof(message) };
+    csigma_result_cache_digest(digest, "test", inputs, lens, 1);
+    csigma_result_cache_insert(&cache, digest);
+    if (!csigma_result_cache_lookup(&cache, digest)) {
+        printf("Fresh entry missing\n");
+        return 1;
+    }
+    struct timespec delay = { 0, 120 * 1000 * 1000 };
+    nanosleep(&delay, NULL);
+    if (csigma_result_cache_lookup(&cache, digest)) {
+        printf("Expired entry still valid\n");
+        return 1;
+    }
+    csigma_result_cache_destroy(&cache);
+    printf("PASS\n");
+
+    // Test 6: The number of entries is bounded
+    printf("Test 6: Size bound... ");
+    size_t capacity = CSIGMA_RESULT_CACHE_SHARDS * CSIGMA_RESULT_CACHE_WAYS;
+    csigma_result_cache_init(&cache, capacity, 60 * 1000);
+    size_t present = 0;
+    for (uint32_t i = 0; i < 4 * capacity; i++) {
+        const uint8_t* counter[] = { (const uint8_t*) &i };
+        size_t         len[]     = { sizeof(i) };
+        csigma_result_cache_digest(digest, "test", counter, len, 1);
+        csigma_result_cache_insert(&cache, digest);
+    }
+    for (uint32_t i = 0; i < 4 * capacity; i++) {
+        const uint8_t* counter[] = { (const uint8_t*) &i };
+        size_t         len[]     = { sizeof(i) };
+        csigma_result_cache_digest(digest, "test", counter, len, 1);
+        present += csigma_result_cache_lookup(&cache, digest);
+    }
+    if (present > capacity || present == 0) {
+        printf("Unexpected occupancy\n");
+        return 1;
+    }
+    csigma_result_cache_destroy(&cache);
+    printf("PASS\n");
+
+    // Test 7: Results are not reused under another transcript backend
+    printf("Test 7: Backend switch... ");
+    uint8_t Y[CSIGMA_POINT_BYTES];
+    uint8_t shake_proof[CSIGMA_SCHNORR_PROOF_SIZE], blake2b_proof[CSIGMA_SCHNORR_PROOF_SIZE];
+    crypto_core_ristretto255_scalar_random(x);
+    crypto_scalarmult_ristretto255_base(Y, x);
+    csigma_schnorr_prove(shake_proof, x, Y, message, sizeof(message));
+    csigma_result_cache_init(&cache, 1 << 12, 60 * 1000);
+    bool shake_accepted =
+        csigma_schnorr_verify_memo(&cache, shake_proof, Y, message, sizeof(message));
+
+    csigma_transcript_set_hash(CSIGMA_HASH_BLAKE2B);
+    csigma_schnorr_prove(blake2b_proof, x, Y, message, sizeof(message));
+    bool stale_accepted =
+        csigma_schnorr_verify_memo(&cache, shake_proof, Y, message, sizeof(message));
+    bool blake2b_accepted =
+        csigma_schnorr_verify_memo(&cache, blake2b_proof, Y, message, sizeof(message));
+    csigma_transcript_set_hash(CSIGMA_HASH_SHAKE128);
+
+    if (!shake_accepted || stale_accepted || !blake2b_accepted ||
+        csigma_schnorr_verify_memo(&cache, blake2b_proof, Y, message, sizeof(message))) {
+        printf("Cached result used under another backend\n");
+        return 1;
+    }
+    csigma_result_cache_destroy(&cache);
+    printf("PASS\n");
+
+    printf("\nAll result cache tests passed\n");
+    return 0;
+}
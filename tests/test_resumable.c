@@ -0,0 +1,138 @@
+#include "../resumable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_ROWS 8
+#define TERMS_PER_ROW 24
+
+// Run a verifier to completion with a fixed budget, counting the steps
+static csigma_verify_status_t
+run(const linear_relation_t* relation, const uint8_t* commitment, const uint8_t* challenge,
+    const uint8_t* response, size_t budget, size_t* steps)
+{
+    csigma_verifier_t      verifier;
+    csigma_verify_status_t status;
+    csigma_verifier_init(&verifier, relation, commitment, challenge, response);
+    *steps = 0;
+    do {
+        status = csigma_verifier_step(&verifier, budget);
+        (*steps)++;
+    } while (status == CSIGMA_VERIFY_PENDING);
+    csigma_verifier_destroy(&verifier);
+    return status;
+}
+
+int
+main()
+{
+    printf("\n=== Testing Resumable Verification ===\n");
+
+    if (sodium_init() < 0) {
+        printf("Failed to initialize libsodium\n");
+        return 1;
+    }
+
+    // Rows of weighted terms over shared elements, with constant terms
+    size_t            num_scalars = NUM_ROWS * TERMS_PER_ROW / 2;
+    linear_relation_t relation;
+    uint8_t           elements[4][CSIGMA_POINT_BYTES];
+    int               element_indices[4];
+    csigma_relation_init(&relation);
+    csigma_relation_allocate_scalars(&relation, num_scalars);
+    for (size_t e = 0; e < 4; e++) {
+        crypto_core_ristretto255_random(elements[e]);
+        element_indices[e] = csigma_relation_add_element(&relation, elements[e]);
+    }
+    uint8_t* witness = malloc(num_scalars * CSIGMA_SCALAR_BYTES);
+    for (size_t i = 0; i < num_scalars; i++) {
+        crypto_core_ristretto255_scalar_random(&witness[i * CSIGMA_SCALAR_BYTES]);
+    }
+    for (size_t row = 0; row < NUM_ROWS; row++) {
+        int     scalars[TERMS_PER_ROW], points[TERMS_PER_ROW];
+        uint8_t coefficients[TERMS_PER_ROW * CSIGMA_SCALAR_BYTES];
+        for (size_t j = 0; j < TERMS_PER_ROW; j++) {
+            scalars[j] = (int) ((row * TERMS_PER_ROW / 2 + j) % num_scalars);
+            points[j]  = element_indices[(row + j) % 4];
+            crypto_core_ristretto255_scalar_random(&coefficients[j * CSIGMA_SCALAR_BYTES]);
+        }
+        csigma_relation_add_weighted_equation(&relation, (int) row, scalars, points, coefficients,
+                                              TERMS_PER_ROW);
+        csigma_relation_set_constant(&relation, row, element_indices[row % 4], NULL);
+    }
+
+    // image = map(witness) + constant
+    uint8_t* image = malloc(NUM_ROWS * CSIGMA_POINT_BYTES);
+    linear_map_eval(&relation.map, witness, image);
+    for (size_t row = 0; row < NUM_ROWS; row++) {
+        crypto_core_ristretto255_add(&relation.image[row * CSIGMA_POINT_BYTES],
+                                     &image[row * CSIGMA_POINT_BYTES], elements[row % 4]);
+    }
+
+    uint8_t        commitment[NUM_ROWS * CSIGMA_POINT_BYTES];
+    uint8_t        challenge[CSIGMA_SCALAR_BYTES];
+    uint8_t*       response = malloc(num_scalars * CSIGMA_SCALAR_BYTES);
+    prover_state_t state;
+    crypto_core_ristretto255_scalar_random(challenge);
+    csigma_prover_commit(&relation, witness, commitment, &state);
+    csigma_prover_response(&state, challenge, response);
+    csigma_prover_state_destroy(&state);
+
+    // Test 1: Small budgets take many steps and reach the same outcome as csigma_verify()
+    printf("Test 1: Valid transcript... ");
+    size_t budgets[] = { 1, 7, 32, 1000 };
+    size_t steps[4];
+    if (!csigma_verify(&relation, commitment, challenge, response)) {
+        printf("Reference verification failed\n");
+        return 1;
+    }
+    for (size_t b = 0; b < 4; b++) {
+        if (run(&relation, commitment, challenge, response, budgets[b], &steps[b]) !=
+            CSIGMA_VERIFY_VALID) {
+            printf("Rejected with budget %zu\n", budgets[b]);
+            return 1;
+        }
+    }
+    if (steps[0] < NUM_ROWS || steps[0] <= steps[1] || steps[1] <= steps[2] || steps[3] != 1) {
+        printf("Unexpected step counts\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 2: Tampered transcripts are rejected
+    printf("Test 2: Invalid transcripts... ");
+    size_t  count;
+    uint8_t tampered[CSIGMA_SCALAR_BYTES];
+    memcpy(tampered, &response[5 * CSIGMA_SCALAR_BYTES], CSIGMA_SCALAR_BYTES);
+    crypto_core_ristretto255_scalar_random(&response[5 * CSIGMA_SCALAR_BYTES]);
+    if (run(&relation, commitment, challenge, response, 16, &count) != CSIGMA_VERIFY_INVALID) {
+        printf("Tampered response accepted\n");
+        return 1;
+    }
+    memcpy(&response[5 * CSIGMA_SCALAR_BYTES], tampered, CSIGMA_SCALAR_BYTES);
+    memcpy(&commitment[3 * CSIGMA_POINT_BYTES], elements[0], CSIGMA_POINT_BYTES);
+    if (run(&relation, commitment, challenge, response, 16, &count) != CSIGMA_VERIFY_INVALID) {
+        printf("Tampered commitment accepted\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 3: Malformed relations are rejected at once
+    printf("Test 3: Malformed relation... ");
+    csigma_verifier_t verifier;
+    relation.map.combinations[2].element_indices[0] = 99;
+    if (csigma_verifier_init(&verifier, &relation, commitment, challenge, response) == 0 ||
+        csigma_verifier_step(&verifier, 16) != CSIGMA_VERIFY_INVALID) {
+        printf("Malformed relation accepted\n");
+        return 1;
+    }
+    csigma_verifier_destroy(&verifier);
+    printf("PASS\n");
+
+    free(witness);
+    free(image);
+    free(response);
+    csigma_relation_destroy(&relation);
+    printf("\nAll resumable verification tests passed\n");
+    return 0;
+}
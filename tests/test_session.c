@@ -0,0 +1,224 @@
+#include "../session.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_SESSIONS 32
+#define NUM_WORKERS 4
+
+static pthread_mutex_t done_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  done_cond = PTHREAD_COND_INITIALIZER;
+static size_t          done      = 0;
+static size_t          unsafe    = 0; // Callbacks that ran on a session that could be closed
+
+static void
+on_complete(csigma_session_t* session, csigma_session_state_t state, void* arg)
+{
+    (void) arg;
+    // The session must stay BUSY, and thus impossible to close, under the callback
+    bool busy = csigma_session_state(session) == CSIGMA_SESSION_BUSY &&
+                csigma_session_close(session) != 0 && state != CSIGMA_SESSION_BUSY;
+    pthread_mutex_lock(&done_lock);
+    done++;
+    unsafe += !busy;
+    pthread_cond_signal(&done_cond);
+    pthread_mutex_unlock(&done_lock);
+}
+
+// Wait until the callback has run count times in total
+static void
+wait_done(size_t count)
+{
+    pthread_mutex_lock(&done_lock);
+    while (done < count) {
+        pthread_cond_wait(&done_cond, &done_lock);
+    }
+    pthread_mutex_unlock(&done_lock);
+}
+
+// Wait until the callback for session has returned
+static void
+wait_idle(csigma_session_t* session)
+{
+    while (csigma_session_state(session) == CSIGMA_SESSION_BUSY) {
+        sched_yield();
+    }
+}
+
+// DLEQ relation: X = x*G and Y = x*H
+static void
+build_dleq(linear_relation_t* relation, const uint8_t x[CSIGMA_SCALAR_BYTES])
+{
+    uint8_t G[CSIGMA_POINT_BYTES], H[CSIGMA_POINT_BYTES];
+    crypto_core_ristretto255_random(G);
+    crypto_core_ristretto255_random(H);
+
+    csigma_relation_init(relation);
+    int x_idx = csigma_relation_add_scalar(relation);
+    int G_idx = csigma_relation_add_element(relation, G);
+    int H_idx = csigma_relation_add_element(relation, H);
+    csigma_relation_add_equation_simple(relation, 0, x_idx, G_idx);
+    csigma_relation_add_equation_simple(relation, 1, x_idx, H_idx);
+    crypto_scalarmult_ristretto255(&relation->image[0], x, G);
+    crypto_scalarmult_ristretto255(&relation->image[CSIGMA_POINT_BYTES], x, H);
+}
+
+int
+main()
+{
+    printf("\n=== Testing Interactive Sessions ===\n");
+
+    if (sodium_init() < 0) {
+        printf("Failed to initialize libsodium\n");
+        return 1;
+    }
+
+    uint8_t           x[CSIGMA_SCALAR_BYTES];
+    linear_relation_t relation;
+    crypto_core_ristretto255_scalar_random(x);
+    build_dleq(&relation, x);
+
+    // Test 1: Inline steps
+    printf("Test 1: Inline exchange... ");
+    csigma_session_pool_t pool;
+    if (csigma_session_pool_init(&pool, &relation, 4, 0, NULL, NULL) != 0) {
+        printf("Pool setup failed\n");
+        return 1;
+    }
+    csigma_session_t* prover   = csigma_session_open_prover(&pool, &relation, x);
+    csigma_session_t* verifier = csigma_session_open_verifier(&pool, &relation);
+    if (!prover || !verifier || csigma_session_state(prover) != CSIGMA_SESSION_COMMIT ||
+        csigma_session_commit(prover, true) != 0 ||
+        csigma_session_state(prover) != CSIGMA_SESSION_AWAIT_CHALLENGE ||
+        csigma_session_receive_commitment(verifier, csigma_session_commitment(prover)) != 0 ||
+        csigma_session_respond(prover, csigma_session_challenge(verifier)) != 0 ||
+        csigma_session_verify(verifier, csigma_session_response(prover), false) != 0 ||
+        csigma_session_state(verifier) != CSIGMA_SESSION_ACCEPTED) {
+        printf("Exchange failed\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 2: Steps out of order are refused, and a prover answers only once
+    printf("Test 2: State machine... ");
+    uint8_t challenge[CSIGMA_SCALAR_BYTES];
+    crypto_core_ristretto255_scalar_random(challenge);
+    if (csigma_session_respond(prover, challenge) == 0 ||
+        csigma_session_commit(prover, false) == 0 ||
+        csigma_session_verify(verifier, csigma_session_response(prover), false) == 0) {
+        printf("Step accepted in the wrong state\n");
+        return 1;
+    }
+    csigma_session_close(prover);
+    csigma_session_close(verifier);
+    verifier = csigma_session_open_verifier(&pool, &relation);
+    if (csigma_session_verify(verifier, challenge, false) == 0 ||
+        csigma_session_close(verifier) != 0 || csigma_session_close(verifier) == 0) {
+        printf("Step accepted in the wrong state\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 3: Invalid responses are rejected
+    printf("Test 3: Rejection... ");
+    uint8_t wrong[CSIGMA_SCALAR_BYTES];
+    crypto_core_ristretto255_scalar_random(wrong);
+    prover   = csigma_session_open_prover(&pool, &relation, wrong);
+    verifier = csigma_session_open_verifier(&pool, &relation);
+    csigma_session_commit(prover, false);
+    csigma_session_receive_commitment(verifier, csigma_session_commitment(prover));
+    csigma_session_respond(prover, csigma_session_challenge(verifier));
+    csigma_session_verify(verifier, csigma_session_response(prover), false);
+    if (csigma_session_state(verifier) != CSIGMA_SESSION_REJECTED) {
+        printf("Wrong witness accepted\n");
+        return 1;
+    }
+    csigma_session_close(prover);
+    csigma_session_close(verifier);
+    printf("PASS\n");
+
+    // Test 4: The pool is bounded, and refuses relations larger than its shape
+    printf("Test 4: Pool limits... ");
+    csigma_session_t* sessions[4];
+    for (size_t i = 0; i < 4; i++) {
+        sessions[i] = csigma_session_open_verifier(&pool, &relation);
+        if (!sessions[i]) {
+            printf("Pool exhausted too early\n");
+            return 1;
+        }
+    }
+    if (csigma_session_open_verifier(&pool, &relation)) {
+        printf("Pool not bounded\n");
+        return 1;
+    }
+    csigma_session_close(sessions[2]);
+    if (csigma_session_open_verifier(&pool, &relation) != sessions[2]) {
+        printf("Closed session not reused\n");
+        return 1;
+    }
+    for (size_t i = 0; i < 4; i++) {
+        csigma_session_close(sessions[i]);
+    }
+    linear_relation_t larger;
+    build_dleq(&larger, x);
+    csigma_relation_add_equation_simple(&larger, 2, 0, 0);
+    if (csigma_session_open_verifier(&pool, &larger)) {
+        printf("Oversized relation accepted\n");
+        return 1;
+    }
+    csigma_relation_destroy(&larger);
+    csigma_session_pool_destroy(&pool);
+    printf("PASS\n");
+
+    // Test 5: Steps offloaded to workers
+    printf("Test 5: Offloaded steps... ");
+    if (csigma_session_pool_init(&pool, &relation, 2 * NUM_SESSIONS, NUM_WORKERS, on_complete,
+                                 NULL) != 0) {
+        printf("Pool setup failed\n");
+        return 1;
+    }
+    csigma_session_t* provers[NUM_SESSIONS];
+    csigma_session_t* verifiers[NUM_SESSIONS];
+    for (size_t i = 0; i < NUM_SESSIONS; i++) {
+        provers[i]   = csigma_session_open_prover(&pool, &relation, x);
+        verifiers[i] = csigma_session_open_verifier(&pool, &relation);
+        if (!provers[i] || !verifiers[i] || csigma_session_commit(provers[i], true) != 0) {
+            printf("Commit not queued\n");
+            return 1;
+        }
+    }
+    wait_done(NUM_SESSIONS);
+    for (size_t i = 0; i < NUM_SESSIONS; i++) {
+        wait_idle(provers[i]);
+        if (csigma_session_state(provers[i]) != CSIGMA_SESSION_AWAIT_CHALLENGE ||
+            csigma_session_receive_commitment(verifiers[i],
+                                              csigma_session_commitment(provers[i])) != 0 ||
+            csigma_session_respond(provers[i], csigma_session_challenge(verifiers[i])) != 0 ||
+            csigma_session_verify(verifiers[i], csigma_session_response(provers[i]), true) != 0) {
+            printf("Exchange failed\n");
+            return 1;
+        }
+    }
+    wait_done(2 * NUM_SESSIONS);
+    for (size_t i = 0; i < NUM_SESSIONS; i++) {
+        wait_idle(verifiers[i]);
+        if (csigma_session_state(verifiers[i]) != CSIGMA_SESSION_ACCEPTED) {
+            printf("Valid response rejected\n");
+            return 1;
+        }
+        csigma_session_close(provers[i]);
+        csigma_session_close(verifiers[i]);
+    }
+    csigma_session_pool_destroy(&pool);
+    if (unsafe != 0) {
+        printf("Session not BUSY during its callback\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    csigma_relation_destroy(&relation);
+    printf("\nAll session tests passed\n");
+    return 0;
+}
@@ -1,5 +1,6 @@
 #include "sigma.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 void
@@ -115,6 +116,266 @@ test_dleq()
     }
 }
 
+int
+test_dleq_batch()
+{
+    printf("\n=== Testing Batched DLEQ Protocol ===\n");
+
+    const size_t n = 100;
+    uint8_t      witness[CSIGMA_SCALAR_BYTES], temp[CSIGMA_SCALAR_BYTES];
+    uint8_t      g[CSIGMA_POINT_BYTES], h[CSIGMA_POINT_BYTES];
+    uint8_t*     g_batch = malloc(n * CSIGMA_POINT_BYTES);
+    uint8_t*     h_batch = malloc(n * CSIGMA_POINT_BYTES);
+
+    // Key pair h = x*g and blinded elements h_i = x*g_i
+    crypto_core_ristretto255_scalar_random(witness);
+    crypto_core_ristretto255_scalar_random(temp);
+    crypto_scalarmult_ristretto255_base(g, temp);
+    crypto_scalarmult_ristretto255(h, witness, g);
+    for (size_t i = 0; i < n; i++) {
+        crypto_core_ristretto255_random(&g_batch[i * CSIGMA_POINT_BYTES]);
+        crypto_scalarmult_ristretto255(&h_batch[i * CSIGMA_POINT_BYTES], witness,
+                                       &g_batch[i * CSIGMA_POINT_BYTES]);
+    }
+
+    uint8_t proof[CSIGMA_DLEQ_PROOF_SIZE];
+    uint8_t message[] = "Batch test message";
+    if (csigma_dleq_batch_prove(proof, witness, g, h, g_batch, h_batch, n, message,
+                                sizeof(message)) != 0) {
+        printf("Failed to create batch proof\n");
+        return 1;
+    }
+    printf("Created proof for %zu pairs (%zu bytes)\n", n, sizeof(proof));
+
+    if (!csigma_dleq_batch_verify(proof, g, h, g_batch, h_batch, n, message, sizeof(message))) {
+        printf("Batch proof verification failed\n");
+        return 1;
+    }
+    printf("Batch proof verified successfully\n");
+
+    // Dropping a pair, reordering pairs or a wrong message must fail
+    if (csigma_dleq_batch_verify(proof, g, h, g_batch, h_batch, n - 1, message, sizeof(message)) ||
+        csigma_dleq_batch_verify(proof, g, h, &g_batch[CSIGMA_POINT_BYTES],
+                                 &h_batch[CSIGMA_POINT_BYTES], n - 1, message, sizeof(message)) ||
+        csigma_dleq_batch_verify(proof, g, h, g_batch, h_batch, n, message, sizeof(message) - 1)) {
+        printf("Incorrectly accepted modified batch\n");
+        return 1;
+    }
+    uint8_t* g_swapped = malloc(n * CSIGMA_POINT_BYTES);
+    uint8_t* h_swapped = malloc(n * CSIGMA_POINT_BYTES);
+    memcpy(g_swapped, g_batch, n * CSIGMA_POINT_BYTES);
+    memcpy(h_swapped, h_batch, n * CSIGMA_POINT_BYTES);
+    memcpy(&g_swapped[0], &g_batch[CSIGMA_POINT_BYTES], CSIGMA_POINT_BYTES);
+    memcpy(&g_swapped[CSIGMA_POINT_BYTES], &g_batch[0], CSIGMA_POINT_BYTES);
+    memcpy(&h_swapped[0], &h_batch[CSIGMA_POINT_BYTES], CSIGMA_POINT_BYTES);
+    memcpy(&h_swapped[CSIGMA_POINT_BYTES], &h_batch[0], CSIGMA_POINT_BYTES);
+    int swapped_accepted =
+        csigma_dleq_batch_verify(proof, g, h, g_swapped, h_swapped, n, message, sizeof(message));
+    free(g_swapped);
+    free(h_swapped);
+    if (swapped_accepted) {
+        printf("Incorrectly accepted reordered batch\n");
+        return 1;
+    }
+
+    // A single pair under another key must fail
+    crypto_core_ristretto255_scalar_random(temp);
+    crypto_scalarmult_ristretto255(&h_batch[42 * CSIGMA_POINT_BYTES], temp,
+                                   &g_batch[42 * CSIGMA_POINT_BYTES]);
+    if (csigma_dleq_batch_verify(proof, g, h, g_batch, h_batch, n, message, sizeof(message))) {
+        printf("Incorrectly accepted batch with a bad pair\n");
+        return 1;
+    }
+    csigma_dleq_batch_prove(proof, witness, g, h, g_batch, h_batch, n, message, sizeof(message));
+    if (csigma_dleq_batch_verify(proof, g, h, g_batch, h_batch, n, message, sizeof(message))) {
+        printf("Proved a batch with a bad pair\n");
+        return 1;
+    }
+    printf("Correctly rejected invalid batches\n");
+
+    free(g_batch);
+    free(h_batch);
+    return 0;
+}
+
+int
+test_schnorr_aggregate()
+{
+    printf("\n=== Testing Schnorr Half-Aggregation ===\n");
+
+    const size_t   n           = 50;
+    uint8_t*       public_keys = malloc(n * CSIGMA_POINT_BYTES);
+    uint8_t*       proofs      = malloc(n * CSIGMA_SCHNORR_PROOF_SIZE);
+    uint8_t*       messages    = malloc(n * 16);
+    const uint8_t* message_ptrs[50];
+    size_t         message_lens[50];
+
+    for (size_t i = 0; i < n; i++) {
+        uint8_t witness[CSIGMA_SCALAR_BYTES];
+        crypto_core_ristretto255_scalar_random(witness);
+        crypto_scalarmult_ristretto255_base(&public_keys[i * CSIGMA_POINT_BYTES], witness);
+        snprintf((char*) &messages[i * 16], 16, "message %zu", i);
+        message_ptrs[i] = &messages[i * 16];
+        message_lens[i] = strlen((const char*) message_ptrs[i]);
+        csigma_schnorr_prove(&proofs[i * CSIGMA_SCHNORR_PROOF_SIZE], witness,
+                             &public_keys[i * CSIGMA_POINT_BYTES], message_ptrs[i],
+                             message_lens[i]);
+    }
+
+    // Aggregate the first half, store it, then resume with the second half
+    csigma_schnorr_aggregate_t aggregate;
+    csigma_schnorr_aggregate_init(&aggregate);
+    for (size_t i = 0; i < n / 2; i++) {
+        if (csigma_schnorr_aggregate_add(&aggregate, &proofs[i * CSIGMA_SCHNORR_PROOF_SIZE],
+                                         &public_keys[i * CSIGMA_POINT_BYTES], message_ptrs[i],
+                                         message_lens[i]) != 0) {
+            printf("Failed to aggregate proof %zu\n", i);
+            return 1;
+        }
+    }
+    size_t   half_len = csigma_schnorr_aggregate_size(n / 2);
+    uint8_t* stored   = malloc(half_len);
+    csigma_schnorr_aggregate_serialize(stored, &aggregate);
+    csigma_schnorr_aggregate_destroy(&aggregate);
+
+    if (!csigma_schnorr_aggregate_verify(stored, half_len, public_keys, message_ptrs,
+                                         message_lens, n / 2)) {
+        printf("Partial aggregate verification failed\n");
+        return 1;
+    }
+
+    if (csigma_schnorr_aggregate_load(&aggregate, stored, half_len, public_keys, message_ptrs,
+                                      message_lens, n / 2) != 0) {
+        printf("Failed to load aggregate\n");
+        return 1;
+    }
+    for (size_t i = n / 2; i < n; i++) {
+        csigma_schnorr_aggregate_add(&aggregate, &proofs[i * CSIGMA_SCHNORR_PROOF_SIZE],
+                                     &public_keys[i * CSIGMA_POINT_BYTES], message_ptrs[i],
+                                     message_lens[i]);
+    }
+    size_t   len        = csigma_schnorr_aggregate_size(n);
+    uint8_t* serialized = malloc(len);
+    csigma_schnorr_aggregate_serialize(serialized, &aggregate);
+    csigma_schnorr_aggregate_destroy(&aggregate);
+    printf("Aggregated %zu proofs into %zu bytes (instead of %zu)\n", n, len,
+           n * (size_t) CSIGMA_SCHNORR_PROOF_SIZE);
+
+    if (!csigma_schnorr_aggregate_verify(serialized, len, public_keys, message_ptrs, message_lens,
+                                         n)) {
+        printf("Aggregate verification failed\n");
+        return 1;
+    }
+    printf("Aggregate verified successfully\n");
+
+    // Wrong message, missing proof and swapped keys must fail
+    message_lens[3]--;
+    if (csigma_schnorr_aggregate_verify(serialized, len, public_keys, message_ptrs, message_lens,
+                                        n)) {
+        printf("Incorrectly accepted aggregate with wrong message\n");
+        return 1;
+    }
+    message_lens[3]++;
+    if (csigma_schnorr_aggregate_verify(serialized, len - CSIGMA_POINT_BYTES, public_keys,
+                                        message_ptrs, message_lens, n - 1)) {
+        printf("Incorrectly accepted truncated aggregate\n");
+        return 1;
+    }
+    uint8_t swap[CSIGMA_POINT_BYTES];
+    memcpy(swap, public_keys, CSIGMA_POINT_BYTES);
+    memcpy(public_keys, &public_keys[CSIGMA_POINT_BYTES], CSIGMA_POINT_BYTES);
+    memcpy(&public_keys[CSIGMA_POINT_BYTES], swap, CSIGMA_POINT_BYTES);
+    if (csigma_schnorr_aggregate_verify(serialized, len, public_keys, message_ptrs, message_lens,
+                                        n)) {
+        printf("Incorrectly accepted aggregate with swapped keys\n");
+        return 1;
+    }
+    printf("Correctly rejected invalid aggregates\n");
+
+    free(public_keys);
+    free(proofs);
+    free(messages);
+    free(stored);
+    free(serialized);
+    return 0;
+}
+
+int
+test_prove_many()
+{
+    printf("\n=== Testing Multi-Witness Provers ===\n");
+
+    const size_t    k         = 80; // More than one commitment chunk
+    uint8_t*        witnesses = malloc(k * CSIGMA_SCALAR_BYTES);
+    uint8_t*        keys      = malloc(k * CSIGMA_POINT_BYTES);
+    uint8_t*        h1        = malloc(k * CSIGMA_POINT_BYTES);
+    uint8_t*        h2        = malloc(k * CSIGMA_POINT_BYTES);
+    uint8_t*        schnorr   = malloc(k * CSIGMA_SCHNORR_PROOF_SIZE);
+    uint8_t*        dleq      = malloc(k * CSIGMA_DLEQ_PROOF_SIZE);
+    const uint8_t** messages  = malloc(k * sizeof(uint8_t*));
+    size_t*         lens      = malloc(k * sizeof(size_t));
+    uint8_t         g1[CSIGMA_POINT_BYTES], g2[CSIGMA_POINT_BYTES];
+    uint8_t         labels[80][16];
+
+    crypto_core_ristretto255_random(g1);
+    crypto_core_ristretto255_random(g2);
+    for (size_t i = 0; i < k; i++) {
+        uint8_t* x = &witnesses[i * CSIGMA_SCALAR_BYTES];
+        crypto_core_ristretto255_scalar_random(x);
+        crypto_scalarmult_ristretto255_base(&keys[i * CSIGMA_POINT_BYTES], x);
+        crypto_scalarmult_ristretto255(&h1[i * CSIGMA_POINT_BYTES], x, g1);
+        crypto_scalarmult_ristretto255(&h2[i * CSIGMA_POINT_BYTES], x, g2);
+        snprintf((char*) labels[i], sizeof(labels[i]), "user %zu", i);
+        messages[i] = labels[i];
+        lens[i]     = strlen((const char*) labels[i]);
+    }
+
+    if (csigma_schnorr_prove_many(schnorr, witnesses, keys, k, messages, lens) != 0 ||
+        csigma_dleq_prove_many(dleq, witnesses, g1, h1, g2, h2, k, NULL, NULL) != 0) {
+        printf("Failed to create proofs\n");
+        return 1;
+    }
+    for (size_t i = 0; i < k; i++) {
+        if (!csigma_schnorr_verify(&schnorr[i * CSIGMA_SCHNORR_PROOF_SIZE],
+                                   &keys[i * CSIGMA_POINT_BYTES], messages[i], lens[i]) ||
+            !csigma_dleq_verify(&dleq[i * CSIGMA_DLEQ_PROOF_SIZE], g1, &h1[i * CSIGMA_POINT_BYTES],
+                                g2, &h2[i * CSIGMA_POINT_BYTES], NULL, 0)) {
+            printf("Proof %zu rejected\n", i);
+            return 1;
+        }
+    }
+    printf("Created and verified %zu Schnorr and %zu DLEQ proofs\n", k, k);
+
+    // Each proof is bound to its own statement and message
+    if (csigma_schnorr_verify(&schnorr[0], &keys[CSIGMA_POINT_BYTES], messages[0], lens[0]) ||
+        csigma_schnorr_verify(&schnorr[0], &keys[0], messages[1], lens[1]) ||
+        csigma_dleq_verify(&dleq[0], g1, &h1[CSIGMA_POINT_BYTES], g2, &h2[CSIGMA_POINT_BYTES],
+                           NULL, 0)) {
+        printf("Incorrectly accepted a proof for another statement\n");
+        return 1;
+    }
+
+    // A wrong witness gives a proof that does not verify
+    crypto_core_ristretto255_scalar_random(&witnesses[3 * CSIGMA_SCALAR_BYTES]);
+    csigma_schnorr_prove_many(schnorr, witnesses, keys, k, messages, lens);
+    if (csigma_schnorr_verify(&schnorr[3 * CSIGMA_SCHNORR_PROOF_SIZE],
+                              &keys[3 * CSIGMA_POINT_BYTES], messages[3], lens[3])) {
+        printf("Incorrectly accepted a proof with a wrong witness\n");
+        return 1;
+    }
+    printf("Correctly rejected mismatched proofs\n");
+
+    free(witnesses);
+    free(keys);
+    free(h1);
+    free(h2);
+    free(schnorr);
+    free(dleq);
+    free(messages);
+    free(lens);
+    return 0;
+}
+
 int
 main()
 {
@@ -125,6 +386,9 @@ main()
 
     test_schnorr();
     test_dleq();
+    if (test_dleq_batch() != 0 || test_schnorr_aggregate() != 0 || test_prove_many() != 0) {
+        return 1;
+    }
 
     printf("\nAll tests passed\n");
     return 0;
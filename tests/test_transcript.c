@@ -0,0 +1,197 @@
+#include "../sigma.h"
+#include "../transcript.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DATA_BYTES 1000
+
+int
+main()
+{
+    printf("\n=== Testing Transcripts ===\n");
+
+    if (sodium_init() < 0) {
+        printf("Failed to initialize libsodium\n");
+        return 1;
+    }
+
+    uint8_t data[DATA_BYTES];
+    randombytes_buf(data, sizeof(data));
+
+    // Test 1: Block-wise absorption matches byte-by-byte absorption, from every offset
+    printf("Test 1: Block-wise absorption... ");
+    for (size_t split = 0; split < 300; split += 7) {
+        shake128_ctx whole, bytes;
+        uint8_t      a[64], b[64];
+        shake128_init(&whole);
+        shake128_absorb(&whole, data, split);
+        shake128_absorb(&whole, &data[split], DATA_BYTES - split);
+        shake128_init(&bytes);
+        for (size_t i = 0; i < DATA_BYTES; i++) {
+            shake128_absorb(&bytes, &data[i], 1);
+        }
+        shake128_finalize(&whole);
+        shake128_squeeze(&whole, a, sizeof(a));
+        shake128_finalize(&bytes);
+        shake128_squeeze(&bytes, b, sizeof(b));
+        if (memcmp(a, b, sizeof(a)) != 0) {
+            printf("Mismatch after a %zu-byte prefix\n", split);
+            return 1;
+        }
+    }
+    printf("PASS\n");
+
+    // Test 2: Gathered, streamed and contiguous messages are absorbed identically
+    printf("Test 2: Scatter/gather absorption... ");
+    csigma_transcript_t contiguous, gathered, streamed;
+    csigma_iovec_t      iov[3] = { { data, 10 }, { NULL, 0 }, { &data[10], DATA_BYTES - 10 } };
+    uint8_t             c1[CSIGMA_SCALAR_BYTES], c2[CSIGMA_SCALAR_BYTES], c3[CSIGMA_SCALAR_BYTES];
+    csigma_transcript_init(&contiguous, "test");
+    csigma_transcript_absorb(&contiguous, data, DATA_BYTES);
+    csigma_transcript_init(&gathered, "test");
+    csigma_transcript_absorbv(&gathered, iov, 3);
+    csigma_transcript_init(&streamed, "test");
+    csigma_transcript_begin(&streamed, DATA_BYTES);
+    for (size_t offset = 0; offset < DATA_BYTES; offset += 100) {
+        csigma_transcript_update(&streamed, &data[offset], 100);
+    }
+    csigma_transcript_challenge(&contiguous, c1);
+    csigma_transcript_challenge(&gathered, c2);
+    csigma_transcript_challenge(&streamed, c3);
+    if (memcmp(c1, c2, sizeof(c1)) != 0 || memcmp(c1, c3, sizeof(c1)) != 0) {
+        printf("Challenges differ\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 3: Message boundaries and protocol identifiers are bound
+    printf("Test 3: Domain separation... ");
+    csigma_transcript_t split, other;
+    csigma_transcript_init(&split, "test");
+    csigma_transcript_absorb(&split, data, 10);
+    csigma_transcript_absorb(&split, &data[10], DATA_BYTES - 10);
+    csigma_transcript_init(&other, "tes");
+    csigma_transcript_absorb(&other, data, DATA_BYTES);
+    csigma_transcript_challenge(&split, c2);
+    csigma_transcript_challenge(&other, c3);
+    if (memcmp(c1, c2, sizeof(c1)) == 0 || memcmp(c1, c3, sizeof(c1)) == 0) {
+        printf("Distinct transcripts collide\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 4: Squeezing leaves the transcript usable, and the result changes as it grows
+    printf("Test 4: Duplex use... ");
+    csigma_transcript_challenge(&contiguous, c2);
+    if (memcmp(c1, c2, sizeof(c1)) != 0) {
+        printf("Squeezing changed the transcript\n");
+        return 1;
+    }
+    csigma_transcript_absorb(&contiguous, NULL, 0);
+    csigma_transcript_challenge(&contiguous, c2);
+    if (memcmp(c1, c2, sizeof(c1)) == 0) {
+        printf("Empty message not bound\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 5: Proofs over gathered public inputs still verify
+    printf("Test 5: DLEQ over gathered inputs... ");
+    uint8_t x[CSIGMA_SCALAR_BYTES], g1[CSIGMA_POINT_BYTES], h1[CSIGMA_POINT_BYTES];
+    uint8_t g2[CSIGMA_POINT_BYTES], h2[CSIGMA_POINT_BYTES], proof[CSIGMA_DLEQ_PROOF_SIZE];
+    crypto_core_ristretto255_scalar_random(x);
+    crypto_core_ristretto255_random(g1);
+    crypto_core_ristretto255_random(g2);
+    crypto_scalarmult_ristretto255(h1, x, g1);
+    crypto_scalarmult_ristretto255(h2, x, g2);
+    if (csigma_dleq_prove(proof, x, g1, h1, g2, h2, data, 10) != 0 ||
+        !csigma_dleq_verify(proof, g1, h1, g2, h2, data, 10) ||
+        csigma_dleq_verify(proof, g2, h2, g1, h1, data, 10)) {
+        printf("DLEQ proof failed\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 6: Streamed message digests do not depend on chunking, and bind to proofs
+    printf("Test 6: Streaming message binding... ");
+    csigma_message_t msg;
+    uint8_t          streamed_digest[CSIGMA_MESSAGE_DIGEST_BYTES];
+    uint8_t          digest[CSIGMA_MESSAGE_DIGEST_BYTES], shorter[CSIGMA_MESSAGE_DIGEST_BYTES];
+    csigma_message_init(&msg);
+    for (size_t offset = 0, chunk = 1; offset < DATA_BYTES; offset += chunk, chunk += 13) {
+        csigma_message_update(&msg, &data[offset],
+                              chunk < DATA_BYTES - offset ? chunk : DATA_BYTES - offset);
+    }
+    csigma_message_final(&msg, streamed_digest);
+    csigma_message_digest(digest, data, DATA_BYTES);
+    csigma_message_digest(shorter, data, DATA_BYTES - 1);
+    if (memcmp(streamed_digest, digest, sizeof(digest)) != 0 ||
+        memcmp(shorter, digest, sizeof(digest)) == 0) {
+        printf("Digest mismatch\n");
+        return 1;
+    }
+    uint8_t schnorr_proof[CSIGMA_SCHNORR_PROOF_SIZE], Y[CSIGMA_POINT_BYTES];
+    crypto_scalarmult_ristretto255_base(Y, x);
+    if (csigma_schnorr_prove(schnorr_proof, x, Y, digest, sizeof(digest)) != 0 ||
+        !csigma_schnorr_verify(schnorr_proof, Y, streamed_digest, sizeof(streamed_digest)) ||
+        csigma_schnorr_verify(schnorr_proof, Y, shorter, sizeof(shorter)) ||
+        csigma_schnorr_verify(schnorr_proof, Y, &digest[CSIGMA_MESSAGE_DIGEST_LABEL_BYTES],
+                              sizeof(digest) - CSIGMA_MESSAGE_DIGEST_LABEL_BYTES)) {
+        printf("Digest binding failed\n");
+        return 1;
+    }
+    printf("PASS\n");
+
+    // Test 7: Every backend proves and verifies, and proofs are bound to their backend
+    printf("Test 7: Hash backends... ");
+    static const uint8_t turboshake_empty[32] = {
+        0x1E, 0x41, 0x5F, 0x1C, 0x59, 0x83, 0xAF, 0xF2, 0x16, 0x92, 0x17,
+        0x27, 0x7D, 0x17, 0xBB, 0x53, 0x8C, 0xD9, 0x45, 0xA3, 0x97, 0xDD,
+        0xEC, 0x54, 0x1F, 0x1C, 0xE4, 0x1A, 0xF2, 0xC1, 0xB7, 0x4C
+    };
+    shake128_ctx turboshake;
+    uint8_t      out[96];
+    turboshake128_init(&turboshake, 0x1F);
+    shake128_squeeze(&turboshake, out, 32);
+    if (memcmp(out, turboshake_empty, 32) != 0) {
+        printf("TurboSHAKE128 test vector mismatch\n");
+        return 1;
+    }
+    csigma_hash_t hashes[3] = { CSIGMA_HASH_SHAKE128, CSIGMA_HASH_TURBOSHAKE128,
+                                CSIGMA_HASH_BLAKE2B };
+    uint8_t       proofs[3][CSIGMA_SCHNORR_PROOF_SIZE];
+    for (size_t h = 0; h < 3; h++) {
+        csigma_transcript_t t;
+        uint8_t             prefix[64];
+        csigma_transcript_init_with(&t, hashes[h], "test");
+        csigma_transcript_squeeze(&t, out, sizeof(out));
+        csigma_transcript_squeeze(&t, prefix, sizeof(prefix));
+        if (memcmp(out, prefix, sizeof(prefix)) != 0) {
+            printf("Squeezed output is not a stream\n");
+            return 1;
+        }
+        if (csigma_transcript_set_hash(hashes[h]) != 0 ||
+            csigma_schnorr_prove(proofs[h], x, Y, data, 10) != 0 ||
+            !csigma_schnorr_verify(proofs[h], Y, data, 10)) {
+            printf("Backend %zu failed\n", h);
+            return 1;
+        }
+    }
+    for (size_t h = 0; h < 3; h++) {
+        csigma_transcript_set_hash(hashes[(h + 1) % 3]);
+        if (csigma_schnorr_verify(proofs[h], Y, data, 10)) {
+            printf("Proof accepted under another backend\n");
+            return 1;
+        }
+    }
+    if (csigma_transcript_set_hash((csigma_hash_t) 99) == 0) {
+        printf("Unknown backend accepted\n");
+        return 1;
+    }
+    csigma_transcript_set_hash(CSIGMA_HASH_SHAKE128);
+    printf("PASS\n");
+
+    printf("\nAll transcript tests passed\n");
+    return 0;
+}
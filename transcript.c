@@ -0,0 +1,244 @@
+#include "transcript.h"
+#include <stdatomic.h>
+#include <string.h>
+
+static atomic_int default_hash = CSIGMA_HASH_SHAKE128;
+
+// Suffix appended to the protocol identifiers of each backend
+static const char* const hash_suffixes[] = {
+    [CSIGMA_HASH_SHAKE128]      = "",
+    [CSIGMA_HASH_TURBOSHAKE128] = "/turboshake128",
+    [CSIGMA_HASH_BLAKE2B]       = "/blake2b",
+};
+
+// Feed raw bytes to the hash (internal)
+static void
+hash_update(csigma_transcript_t* transcript, const uint8_t* data, size_t len)
+{
+    if (transcript->hash == CSIGMA_HASH_BLAKE2B) {
+        crypto_generichash_blake2b_update(&transcript->state.blake2b, data, len);
+    } else {
+        shake128_absorb(&transcript->state.sponge, data, len);
+    }
+}
+
+// Adapter for the relation encoders (internal)
+static void
+hash_update_fn(void* ctx, const uint8_t* data, size_t len)
+{
+    hash_update(ctx, data, len);
+}
+
+// Absorb a length prefix: I2OSP(len, 8) (internal)
+static void
+absorb_length(csigma_transcript_t* transcript, uint64_t len)
+{
+    uint8_t bytes[8];
+    for (size_t i = 0; i < 8; i++) {
+        bytes[i] = (uint8_t) (len >> (8 * (7 - i)));
+    }
+    hash_update(transcript, bytes, sizeof(bytes));
+}
+
+int
+csigma_transcript_set_hash(csigma_hash_t hash)
+{
+    if ((unsigned) hash > CSIGMA_HASH_BLAKE2B)
+        return -1;
+    atomic_store(&default_hash, (int) hash);
+    return 0;
+}
+
+csigma_hash_t
+csigma_transcript_get_hash(void)
+{
+    return (csigma_hash_t) atomic_load(&default_hash);
+}
+
+void
+csigma_transcript_init(csigma_transcript_t* transcript, const char* protocol_id)
+{
+    csigma_transcript_init_with(transcript, csigma_transcript_get_hash(), protocol_id);
+}
+
+void
+csigma_transcript_init_with(csigma_transcript_t* transcript, csigma_hash_t hash,
+                            const char* protocol_id)
+{
+    transcript->hash = hash;
+    switch (hash) {
+    case CSIGMA_HASH_TURBOSHAKE128:
+        turboshake128_init(&transcript->state.sponge, 0x1F);
+        break;
+    case CSIGMA_HASH_BLAKE2B:
+        crypto_generichash_blake2b_init(&transcript->state.blake2b, NULL, 0,
+                                        crypto_generichash_blake2b_BYTES_MAX);
+        break;
+    default:
+        transcript->hash = CSIGMA_HASH_SHAKE128;
+        shake128_init(&transcript->state.sponge);
+        break;
+    }
+
+    const char*    suffix = hash_suffixes[transcript->hash];
+    csigma_iovec_t id[2]  = { { (const uint8_t*) protocol_id, strlen(protocol_id) },
+                              { (const uint8_t*) suffix, strlen(suffix) } };
+    csigma_transcript_absorbv(transcript, id, 2);
+}
+
+void
+csigma_transcript_absorb(csigma_transcript_t* transcript, const uint8_t* data, size_t len)
+{
+    absorb_length(transcript, len);
+    hash_update(transcript, data, len);
+}
+
+void
+csigma_transcript_absorbv(csigma_transcript_t* transcript, const csigma_iovec_t* buffers,
+                          size_t num_buffers)
+{
+    uint64_t len = 0;
+    for (size_t i = 0; i < num_buffers; i++) {
+        len += buffers[i].len;
+    }
+    absorb_length(transcript, len);
+    for (size_t i = 0; i < num_buffers; i++) {
+        hash_update(transcript, buffers[i].data, buffers[i].len);
+    }
+}
+
+void
+csigma_transcript_absorb_u64(csigma_transcript_t* transcript, uint64_t value)
+{
+    uint8_t bytes[8];
+    for (size_t i = 0; i < 8; i++) {
+        bytes[i] = (uint8_t) (value >> (8 * (7 - i)));
+    }
+    csigma_transcript_absorb(transcript, bytes, sizeof(bytes));
+}
+
+void
+csigma_transcript_absorb_relation(csigma_transcript_t*     transcript,
+                                  const linear_relation_t* relation)
+{
+    absorb_length(transcript, linear_map_encoded_len(&relation->map) +
+                                  (uint64_t) relation->map.num_constraints * CSIGMA_POINT_BYTES);
+    linear_relation_encode(relation, hash_update_fn, transcript);
+}
+
+void
+csigma_transcript_absorb_map(csigma_transcript_t* transcript, const linear_map_t* map)
+{
+    absorb_length(transcript, linear_map_encoded_len(map));
+    linear_map_encode(map, hash_update_fn, transcript);
+}
+
+void
+csigma_transcript_begin(csigma_transcript_t* transcript, uint64_t len)
+{
+    absorb_length(transcript, len);
+}
+
+void
+csigma_transcript_update(csigma_transcript_t* transcript, const uint8_t* data, size_t len)
+{
+    hash_update(transcript, data, len);
+}
+
+// BLAKE2b output stream: the 64-byte digest d, then BLAKE2b(key = d, I2OSP(i, 8)) for
+// i = 1, 2, ... (internal)
+static void
+blake2b_squeeze(const crypto_generichash_blake2b_state* state, uint8_t* out, size_t len)
+{
+    crypto_generichash_blake2b_state copy = *state;
+    uint8_t                          d[crypto_generichash_blake2b_BYTES_MAX];
+    uint8_t                          block[crypto_generichash_blake2b_BYTES_MAX];
+    crypto_generichash_blake2b_final(&copy, d, sizeof(d));
+
+    for (uint64_t i = 0; len > 0; i++) {
+        const uint8_t* src = d;
+        if (i > 0) {
+            uint8_t counter[8];
+            for (size_t j = 0; j < 8; j++) {
+                counter[j] = (uint8_t) (i >> (8 * (7 - j)));
+            }
+            crypto_generichash_blake2b(block, sizeof(block), counter, sizeof(counter), d,
+                                       sizeof(d));
+            src = block;
+        }
+        size_t n = len < sizeof(block) ? len : sizeof(block);
+        memcpy(out, src, n);
+        out += n;
+        len -= n;
+    }
+    sodium_memzero(&copy, sizeof(copy));
+    sodium_memzero(d, sizeof(d));
+    sodium_memzero(block, sizeof(block));
+}
+
+void
+csigma_transcript_squeeze(const csigma_transcript_t* transcript, uint8_t* out, size_t len)
+{
+    if (transcript->hash == CSIGMA_HASH_BLAKE2B) {
+        blake2b_squeeze(&transcript->state.blake2b, out, len);
+        return;
+    }
+    shake128_ctx sponge = transcript->state.sponge;
+    shake128_finalize(&sponge);
+    shake128_squeeze(&sponge, out, len);
+    sodium_memzero(&sponge, sizeof(sponge));
+}
+
+void
+csigma_transcript_challenge(const csigma_transcript_t* transcript,
+                            uint8_t                    challenge[CSIGMA_SCALAR_BYTES])
+{
+    uint8_t wide[64];
+    csigma_transcript_squeeze(transcript, wide, sizeof(wide));
+    crypto_core_ristretto255_scalar_reduce(challenge, wide);
+}
+
+void
+csigma_transcript_nonce_context(const csigma_transcript_t* transcript, const uint8_t* message,
+                                size_t message_len, uint8_t context[CSIGMA_NONCE_CONTEXT_BYTES])
+{
+    csigma_transcript_t fork = *transcript;
+    csigma_transcript_absorb(&fork, (const uint8_t*) "csigma_nonce_context", 20);
+    csigma_transcript_absorb(&fork, message, message ? message_len : 0);
+    csigma_transcript_squeeze(&fork, context, CSIGMA_NONCE_CONTEXT_BYTES);
+    sodium_memzero(&fork, sizeof(fork));
+}
+
+void
+csigma_message_init(csigma_message_t* message)
+{
+    csigma_transcript_init(&message->transcript, "csigma_message");
+    message->len = 0;
+}
+
+void
+csigma_message_update(csigma_message_t* message, const uint8_t* data, size_t len)
+{
+    csigma_transcript_update(&message->transcript, data, len);
+    message->len += len;
+}
+
+void
+csigma_message_final(csigma_message_t* message, uint8_t digest[CSIGMA_MESSAGE_DIGEST_BYTES])
+{
+    memcpy(digest, CSIGMA_MESSAGE_DIGEST_LABEL, CSIGMA_MESSAGE_DIGEST_LABEL_BYTES);
+    csigma_transcript_absorb_u64(&message->transcript, message->len);
+    csigma_transcript_squeeze(&message->transcript, &digest[CSIGMA_MESSAGE_DIGEST_LABEL_BYTES],
+                              CSIGMA_MESSAGE_DIGEST_BYTES - CSIGMA_MESSAGE_DIGEST_LABEL_BYTES);
+    sodium_memzero(message, sizeof(*message));
+}
+
+void
+csigma_message_digest(uint8_t digest[CSIGMA_MESSAGE_DIGEST_BYTES], const uint8_t* data,
+                      size_t len)
+{
+    csigma_message_t message;
+    csigma_message_init(&message);
+    csigma_message_update(&message, data, len);
+    csigma_message_final(&message, digest);
+}
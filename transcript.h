@@ -0,0 +1,137 @@
+#ifndef TRANSCRIPT_H
+#define TRANSCRIPT_H
+
+#include "csigma.h"
+#include "keccak.h"
+#include "linear_relation.h"
+
+// Fiat-Shamir transcript
+// Every protocol derives its challenges from a transcript: a hash (SHAKE128 by
+// default) fed with a length-prefixed, domain-separated encoding. The protocol
+// identifier is absorbed first, then each message as an 8-byte big-endian length
+// followed by its bytes, so that no two sequences of messages share an encoding:
+//
+//   I2OSP(len(protocol_id), 8) || protocol_id || I2OSP(len(m_1), 8) || m_1 || ...
+//
+// A message can be gathered from several buffers (csigma_transcript_absorbv()), which
+// are absorbed in place without being packed first. Challenges are squeezed from a
+// copy of the hash state, so a transcript keeps absorbing after a challenge, and a
+// copy of a transcript (plain struct assignment) forks it.
+
+// Transcript hash backends
+// SHAKE128 is the draft-compatible default. The other backends are faster but only
+// interoperate with peers using the same backend; their name is appended to every
+// protocol identifier ("schnorr/turboshake128"), so their proofs never verify under
+// another backend.
+typedef enum {
+    CSIGMA_HASH_SHAKE128 = 0,
+    CSIGMA_HASH_TURBOSHAKE128, // Keccak-p[1600, 12] sponge (the KangarooTwelve core)
+    CSIGMA_HASH_BLAKE2B, // libsodium's BLAKE2b-512, extended by keyed hashing
+} csigma_hash_t;
+
+// One buffer of a gathered message
+typedef struct {
+    const uint8_t* data;
+    size_t         len;
+} csigma_iovec_t;
+
+typedef struct {
+    csigma_hash_t hash;
+    union {
+        shake128_ctx                     sponge; // SHAKE128 and TurboSHAKE128
+        crypto_generichash_blake2b_state blake2b;
+    } state;
+} csigma_transcript_t;
+
+// Select the backend of the transcripts started by csigma_transcript_init(), and so of
+// every built-in protocol, for the whole process. Select it at startup: key caches,
+// aggregates and credential parameters keep the backend they were created with.
+// Returns 0 on success, -1 if the backend is unknown
+int           csigma_transcript_set_hash(csigma_hash_t hash);
+csigma_hash_t csigma_transcript_get_hash(void);
+
+// Start a transcript for a protocol, with the process-wide backend
+void csigma_transcript_init(csigma_transcript_t* transcript, const char* protocol_id);
+
+// Start a transcript for a protocol with a given backend
+void csigma_transcript_init_with(csigma_transcript_t* transcript, csigma_hash_t hash,
+                                 const char* protocol_id);
+
+// Absorb one message (data may be NULL if len is 0)
+void csigma_transcript_absorb(csigma_transcript_t* transcript, const uint8_t* data, size_t len);
+
+// Absorb one message made of the concatenation of num_buffers buffers
+void csigma_transcript_absorbv(csigma_transcript_t* transcript, const csigma_iovec_t* buffers,
+                               size_t num_buffers);
+
+// Absorb an integer as an 8-byte message, I2OSP(value, 8) like the length prefixes
+void csigma_transcript_absorb_u64(csigma_transcript_t* transcript, uint64_t value);
+
+// Absorb the canonical encoding of a relation (see linear_relation_absorb()), or of its
+// linear map alone, as one message
+void csigma_transcript_absorb_relation(csigma_transcript_t*     transcript,
+                                       const linear_relation_t* relation);
+void csigma_transcript_absorb_map(csigma_transcript_t* transcript, const linear_map_t* map);
+
+// Absorb one message of len bytes in pieces: csigma_transcript_begin() writes the
+// length prefix, then the pieces are passed to csigma_transcript_update()
+void csigma_transcript_begin(csigma_transcript_t* transcript, uint64_t len);
+void csigma_transcript_update(csigma_transcript_t* transcript, const uint8_t* data, size_t len);
+
+// Squeeze len bytes (the transcript itself is left unchanged)
+void csigma_transcript_squeeze(const csigma_transcript_t* transcript, uint8_t* out, size_t len);
+
+// Derive a challenge scalar from 64 squeezed bytes (the transcript is left unchanged)
+void csigma_transcript_challenge(const csigma_transcript_t* transcript,
+                                 uint8_t                    challenge[CSIGMA_SCALAR_BYTES]);
+
+// Prover nonce context
+// Digest of a proof's transcript so far (protocol identifier and public inputs) and of
+// the message, which is only absorbed after the commitment. Prover commit functions
+// bind the nonces to it, so that two proofs reusing a seed never answer two different
+// challenges with the same nonces.
+#define CSIGMA_NONCE_CONTEXT_BYTES 32
+
+void csigma_transcript_nonce_context(const csigma_transcript_t* transcript,
+                                     const uint8_t* message, size_t message_len,
+                                     uint8_t context[CSIGMA_NONCE_CONTEXT_BYTES]);
+
+// Streaming message binding
+// Large messages can be bound to a proof through a digest, computed once in bounded memory
+// from chunks of any size. Provers need the digest before they commit, so the message must
+// be hashed before the proof is started:
+//
+//   csigma_message_t msg;
+//   csigma_message_init(&msg);
+//   while (...) csigma_message_update(&msg, chunk, chunk_len);
+//   csigma_message_final(&msg, digest);
+//   csigma_schnorr_prove(proof, x, Y, digest, CSIGMA_MESSAGE_DIGEST_BYTES);
+//
+// The digest is then passed as the message to any prover and verifier. It is
+// CSIGMA_MESSAGE_DIGEST_LABEL followed by the transcript "csigma_message" || message bytes
+// || I2OSP(8, 8) || I2OSP(len, 8) squeezed to 32 bytes; the trailing length makes it
+// unambiguous although the message is not length-prefixed. The label separates a proof
+// bound to a digest from one bound to the same 32 bytes given as a literal message:
+// literal messages must not start with the label.
+
+#define CSIGMA_MESSAGE_DIGEST_LABEL "csigma_digest_v1"
+#define CSIGMA_MESSAGE_DIGEST_LABEL_BYTES 16
+#define CSIGMA_MESSAGE_DIGEST_BYTES (CSIGMA_MESSAGE_DIGEST_LABEL_BYTES + 32)
+
+typedef struct {
+    csigma_transcript_t transcript;
+    uint64_t            len; // Message bytes absorbed so far
+} csigma_message_t;
+
+void csigma_message_init(csigma_message_t* message);
+void csigma_message_update(csigma_message_t* message, const uint8_t* data, size_t len);
+
+// Write the digest and clear the context
+void csigma_message_final(csigma_message_t* message,
+                          uint8_t           digest[CSIGMA_MESSAGE_DIGEST_BYTES]);
+
+// Digest of a message held in memory, the same as streaming it in any chunks
+void csigma_message_digest(uint8_t digest[CSIGMA_MESSAGE_DIGEST_BYTES], const uint8_t* data,
+                           size_t len);
+
+#endif